@@ -49,6 +49,21 @@ public:
      * @return 0 on success, non-zero on failure.
      */
     int setConfig(const std::string& key, const std::string& value);
+    /**
+     * @brief Get the directory for cache files, such as compiled shaders.
+     * @return The path to the cache directory, or an empty string if not initialized.
+     */
+    std::string getCachePath() const;
+    /**
+     * @brief Get the directory for trace files, such as GPU timings.
+     * @return The path to the trace directory, or an empty string if not initialized.
+     */
+    std::string getTracePath() const;
+    /**
+     * @brief Get the directory for log files.
+     * @return The path to the log directory, or an empty string if not initialized.
+     */
+    std::string getLogPath() const;
 
 private:
     class Impl; // Forward declaration of implementation details
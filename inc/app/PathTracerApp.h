@@ -4,6 +4,8 @@
  */
 #pragma once
 
+#include <fstream>
+
 #include "application.h"
 
 #include "core/Previewer.h"
@@ -12,6 +14,7 @@
 
 #include "utils/FrameTimer.h"
 #include "utils/Stopwatch.h"
+#include "utils/JobSystem.h"
 
 #include "ui/UiMenuBar.hpp"
 #include "ui/UiToolBar.hpp"
@@ -21,6 +24,7 @@
 #include "ui/UiSaveDialog.hpp"
 #include "ui/UiSettingsWindow.hpp"
 #include "ui/UiAboutWindow.hpp"
+#include "ui/UiMemoryWindow.hpp"
 #include "ui/UiLeftPanel.hpp"
 
 /**
@@ -67,6 +71,10 @@ private:
      * @brief Callback function called after drawing is finished.
      */
     void onDrawWindowFinished();
+    /**
+     * @brief Ends the startup profile and starts loading the scene given on the command line.
+     */
+    void onFirstFrameShown();
     /**
      * @brief Callback function for mouse button events.
      * @param button The mouse button.
@@ -111,6 +119,22 @@ private:
      * @return 0 on success, non-zero on failure.
      */
     int initWindow();
+    /**
+     * @brief Initializes ImGui, the fonts and the views of the main window.
+     * @return 0 on success, non-zero on failure.
+     */
+    int initUI();
+    /**
+     * @brief Starts compiling the shaders of the previewer, the path tracer and the post
+     *        processer on worker threads.
+     * @return The compile jobs, empty if the backend requires compiling on the main thread.
+     */
+    std::vector<Job> loadShaders();
+    /**
+     * @brief Selects the workgroup size of the path tracer from the configuration, or starts
+     *        autotuning it with the first scene rendered on a new device.
+     */
+    void initWorkgroupSize();
     /**
      * @brief Synchronizes dirty objects with the database.
      * @param hObjects Set of object handles to synchronize.
@@ -159,6 +183,25 @@ private:
      * @brief Updates the status bar UI.
      */
     void updateUiStatusBar();
+    /**
+     * @brief Collects the GPU timer results of both renderers for the status bar and the
+     *        GPU trace file.
+     */
+    void updateGpuTimings();
+    /**
+     * @brief Derives the throughput metrics of the path tracer and shows them in the status
+     *        bar.
+     */
+    void updateMetrics();
+    /**
+     * @brief Samples the memory of the database and the renderers into the memory tracker and
+     *        shows it in the memory window.
+     */
+    void updateMemoryStats();
+    /**
+     * @brief Writes the memory report to the trace directory.
+     */
+    void saveMemoryReport();
 
     /**
      * @brief Selects a model in the application.
@@ -415,6 +458,7 @@ private:
     std::shared_ptr<UiSaveDialog> m_saveDialog = nullptr; // The save dialog view
     std::shared_ptr<UiSettingsWindow> m_settingsWindow = nullptr; // The settings window view
     std::shared_ptr<UiAboutWindow> m_aboutWindow = nullptr; // The about window view
+    std::shared_ptr<UiMemoryWindow> m_memoryWindow = nullptr; // The memory usage window view
     std::shared_ptr<UiLeftPanel> m_leftPanel = nullptr; // The left panel view
 
     // Lookup map for model list items in the UI
@@ -451,8 +495,19 @@ private:
     };
     RenderState m_currentRenderState = RenderState::IDLE; // Current render state
     int m_targetSample = 0; // Target number of samples for rendering
+    int m_renderFpsCap = 30; // Frame rate cap of the UI while rendering, 0 for no cap
     Stopwatch m_renderStopwatch; // Stopwatch for measuring render time
     int m_nTriangles = 0; // Number of triangles in the scene
 
+    std::ofstream m_gpuTraceFile; // GPU timing trace, only open if enabled in the config
+    std::array<uint64_t, 2> m_gpuTimerSerials = {}; // Last frame serials read per renderer
+
+    bool m_metricsExport = false; // Whether metrics are exported on exit
+    // Sample count and time the sample rate was last derived from
+    uint64_t m_metricsLastSamples = 0; // Path tracer samples at the last update
+    std::chrono::steady_clock::time_point m_metricsLastTime = {}; // Time of the last update
+    std::chrono::steady_clock::time_point m_memoryLastTime = {}; // Last memory window update
+
     GfxImage m_appIcon = nullptr; // Application icon image
+    std::string m_startupScenePath = {}; // Command line scene, loaded after the first frame
 };
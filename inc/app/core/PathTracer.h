@@ -5,6 +5,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+
 #include "utils/Mesh.h"
 #include "gfx/GfxPub.h"
 #include "app/AppDataManager.h"
@@ -16,6 +20,11 @@ class PathTracer {
 public:
     explicit PathTracer(GfxRenderer& renderer) : m_renderer(renderer) {};
 
+    /**
+     * @brief Compile the compute shader, may run on a worker thread ahead of init().
+     * @return 0 on success, non-zero on failure.
+     */
+    int loadShaders();
     /**
      * @brief Initialize the path tracer.
      * @return 0 on success, non-zero on failure.
@@ -49,24 +58,56 @@ public:
      */
     uint32_t getCurrentSample() const;
 
+    /* Display image handoff */
+
+    static constexpr int N_DISPLAY_IMAGES = 3; // Display images cycled between the threads
+
     /**
-     * @brief Get the current display image (front buffer).
+     * @brief Statistics of the display image handoff.
+     */
+    struct DisplayStats {
+        uint64_t published = 0; // Display images published by the render thread
+        uint64_t presented = 0; // Display images taken by the display thread
+        uint64_t skippedCopies = 0; // Samples not copied as the display had not caught up
+        uint64_t dropped = 0; // Published images replaced before the display took them
+        double lastLatencyMs = 0.0; // Time from publishing to taking the latest image
+        double avgLatencyMs = 0.0; // Average time from publishing to taking an image
+    };
+
+    /**
+     * @brief Get the display image owned by the display thread.
      * @return Current display image.
      */
     GfxBuffer getCurrentDisplayImage() const;
     /**
-     * @brief Get the display images (front and back buffers).
-     * @return Array containing front and back display images.
+     * @brief Get all display images, in no particular order.
+     * @return The display images.
+     */
+    std::vector<GfxBuffer> getDisplayImages() const;
+    /**
+     * @brief Publish the display image written by the last frame, if any.
+     * @param syncValue Frame sync value of the path tracer renderer once the image is written,
+     *                  0 if the display renderer cannot wait for it on the device.
+     * @param wait Whether to wait for the frame writing the image if it is still in flight.
+     * @return True if an image was published.
+     * @note Called by the render thread after each frame. Without a sync value the image is
+     *       held back until the fence of its frame signals, later frames skip the display copy
+     *       meanwhile. A published image the display thread has not taken yet is replaced and
+     *       counted as dropped.
      */
-    std::array<GfxBuffer, 2> getDisplayImages() const;
+    bool markDisplayImageReady(uint64_t syncValue, bool wait);
     /**
-     * @brief Mark the display image as ready for presentation.
+     * @brief Take the latest published display image and hand the previous one back.
+     * @param renderer The renderer displaying the image, its next frame waits for the image.
+     * @note Called by the display thread before it reads the current display image.
      */
-    void markDisplayImageReady();
+    void syncDisplayImage(const GfxRenderer& renderer);
     /**
-     * @brief Synchronize the display image by swapping front and back buffers if needed.
+     * @brief Get the statistics of the display image handoff.
+     * @return The statistics since the scene was built.
+     * @note Called by the display thread.
      */
-    void syncDisplayImage();
+    DisplayStats getDisplayStats() const;
 
     /**
      * @brief Get the image data from the output image.
@@ -78,10 +119,92 @@ public:
      */
     int getImageData(std::vector<float>& pixels, int& width, int& height, int& nWaves) const;
 
+    /* Ray statistics */
+
+    static constexpr uint32_t STATS_INTERVAL = 16; // Samples between frames recording stats
+    static constexpr int STATS_PIXEL_STRIDE = 4; // Pixel stride of the stats, see the shader
+
+    /**
+     * @brief Enable or disable recording ray statistics on the GPU.
+     * @param enabled True to record statistics, false otherwise.
+     * @note Every STATS_INTERVAL samples a frame records the statistics of a subset of the
+     *       pixels. They are read back without stalling and published to the metrics registry
+     *       under "path_tracer.".
+     */
+    void setStatsEnabled(bool enabled);
+
+    /* Workgroup size */
+
+    /**
+     * @brief Workgroup shape of the path tracing kernel.
+     */
+    struct WorkgroupSize {
+        int x = 16; // Invocations per workgroup in X
+        int y = 16; // Invocations per workgroup in Y
+
+        /**
+         * @brief Get the name of the size.
+         * @return The name, e.g. "16x8".
+         */
+        std::string getName() const { return std::to_string(x) + "x" + std::to_string(y); };
+        bool operator==(const WorkgroupSize& other) const {
+            return x == other.x && y == other.y;
+        };
+        bool operator!=(const WorkgroupSize& other) const { return !(*this == other); };
+    };
+
+    static constexpr int AUTOTUNE_FRAMES = 8; // Frames dispatched per candidate when autotuning
+
+    /**
+     * @brief Parse a workgroup size.
+     * @param str The size written as its name, e.g. "16x8".
+     * @param[out] size The parsed size.
+     * @return 0 on success, non-zero if the string is not a size.
+     */
+    static int parseWorkgroupSize(const std::string& str, WorkgroupSize& size);
+    /**
+     * @brief Get the workgroup sizes the device supports.
+     * @return The sizes, in the order autotuning tries them.
+     */
+    std::vector<WorkgroupSize> getWorkgroupSizeCandidates() const;
+    /**
+     * @brief Select the workgroup size of the kernel.
+     * @param size The workgroup size.
+     * @return 0 on success, non-zero if the device does not support the size.
+     * @note Call before loadShaders() or before building a scene, the kernel is compiled for
+     *       the new size by the next buildScene().
+     */
+    int setWorkgroupSize(const WorkgroupSize& size);
+    /**
+     * @brief Get the selected workgroup size.
+     * @return The workgroup size.
+     */
+    WorkgroupSize getWorkgroupSize() const;
+    /**
+     * @brief Time the candidate workgroup sizes on the first frames of the next scene and keep
+     *        the fastest.
+     * @param cb Called on the render thread with the fastest size when autotuning ends.
+     * @note Call before buildScene(). Every candidate renders AUTOTUNE_FRAMES samples of the
+     *       scene, timed by GPU timer scopes. The selected size is kept if no timings arrive.
+     */
+    void startWorkgroupAutotune(const std::function<void(const WorkgroupSize&)>& cb);
+
     /* Rendering controls */
 
+    /**
+     * @brief Work for the render thread.
+     */
+    enum class Work {
+        FRAME, // Render a frame
+        PRESENT, // Copy the latest samples to the display without rendering
+        FINISHED, // Rendering was paused or stopped
+        CLOSE, // Exit the render thread
+    };
+
     /**
      * @brief Start rendering.
+     * @note The rendering controls queue a request for the render thread and return at once,
+     *       isRendering and getCurrentSample reflect them once the render thread applied them.
      */
     void render();
     /**
@@ -96,6 +219,16 @@ public:
      * @brief Restart rendering.
      */
     void restart();
+    /**
+     * @brief Ask the render thread to exit.
+     */
+    void close();
+    /**
+     * @brief Apply the queued requests and wait until there is work for the render thread.
+     * @return The work to do.
+     * @note Called by the render thread only. It sleeps while rendering is paused or stopped.
+     */
+    Work waitForWork();
 
     /**
      * @brief Check if rendering is in progress.
@@ -148,19 +281,81 @@ private:
         const DbObjHandle& hScene,
         std::unordered_map<DbObjHandle, uint32_t>& hSpMaterialIdxMap
     );
+    /**
+     * @brief Compile the compute shader, replacing the current one.
+     * @param size Workgroup size of the shader.
+     * @param stackSize Number of entries of the BVH traversal stack.
+     * @return 0 on success, non-zero on failure, the current shader is kept then.
+     */
+    int compileShader(const WorkgroupSize& size, int stackSize);
+    /**
+     * @brief Create the pipeline and descriptor set binding of the compute shader and record
+     *        the frame commands.
+     * @return 0 on success, non-zero on failure.
+     * @note The pipeline binds m_bindings, set up by buildScene.
+     */
+    int createKernel();
+    /**
+     * @brief Collect the timings of the workgroup size candidates and switch to the next
+     *        candidate or the fastest one, called before a frame is dispatched.
+     */
+    void updateAutotune();
+    /**
+     * @brief Record the command lists replayed by renderFrame.
+     * @return 0 on success, non-zero on failure.
+     */
+    int recordFrameCommands();
+    /**
+     * @brief Destroy the command lists replayed by renderFrame.
+     */
+    void destroyFrameCommands();
+    /**
+     * @brief Reset the ownership and statistics of the display images.
+     */
+    void resetDisplayImages();
+    /**
+     * @brief Publish the ray statistics of the pending readback if it has arrived.
+     */
+    void collectStats();
 
 private:
     GfxRenderer m_renderer = nullptr; // Graphics renderer
 
     GfxBuffer m_outImage = nullptr; // Output image
 
-    GfxBuffer m_dspImageFront = nullptr; // Display image front buffer
-    GfxBuffer m_dspImageBack = nullptr; // Display image back buffer
-    std::atomic<bool> m_dspImgSwapPending = false; // Display image swap pending flag
+    /*
+     * The display images form a mailbox. The display thread owns the front image, the render
+     * thread owns the back image and the third one sits in m_dspMailbox. Publishing and taking
+     * swap the owned image with the mailbox, so an image is never written while displayed.
+     */
+    static constexpr uint32_t DSP_MAILBOX_FULL = 1u << 31; // Set while an image is published
+    std::array<GfxBuffer, N_DISPLAY_IMAGES> m_dspImages = {}; // Display images
+    int m_dspFront = 0; // Index of the image owned by the display thread
+    int m_dspBack = 1; // Index of the image owned by the render thread
+    std::atomic<uint32_t> m_dspMailbox = 2; // Index of the handed over image and the full bit
+    // Set on the display images when they are handed over, read by the new owner
+    std::array<uint64_t, N_DISPLAY_IMAGES> m_dspSyncValues = {}; // Write done on the tracer
+    std::array<int64_t, N_DISPLAY_IMAGES> m_dspPublishTimes = {}; // Publish time in ns
+    std::array<GfxRenderer, N_DISPLAY_IMAGES> m_dspReaders = {}; // Last renderer reading them
+    std::array<uint64_t, N_DISPLAY_IMAGES> m_dspReadValues = {}; // Read done on the reader
+    bool m_dspBackWritten = false; // Whether the last frame wrote the back image
+    uint64_t m_dspPendingFrame = 0; // Frame writing the back image, held back until it completes
+    bool m_dspStale = false; // Whether samples were rendered after the last display copy
+    bool m_presentOnly = false; // Whether the next frame only copies to the display
+    std::atomic<uint64_t> m_dspPublished = 0; // Number of published display images
+    std::atomic<uint64_t> m_dspSkippedCopies = 0; // Number of samples not copied
+    std::atomic<uint64_t> m_dspDropped = 0; // Number of replaced display images
+    uint64_t m_dspPresented = 0; // Number of taken images, display thread only
+    double m_dspLastLatencyMs = 0.0; // Latency of the latest taken image, display thread only
+    double m_dspTotalLatencyMs = 0.0; // Summed latency of the taken images, display thread only
 
     GfxPipeline m_pipeline = nullptr; // Compute pipeline
     GfxDescriptorSetBinding m_descriptorSetBinding = nullptr; // Descriptor set binding
 
+    GfxCommandList m_traceCommands = nullptr; // Recorded path trace dispatch
+    // Recorded copies of the output image, one per display image
+    std::array<GfxCommandList, N_DISPLAY_IMAGES> m_copyCommands = {};
+
     GfxBuffer m_uboScene = nullptr; // Scene uniform buffer
     GfxBuffer m_uboCamera = nullptr; // Camera uniform buffer
     GfxBuffer m_uboSpScene = nullptr; // Spectral scene uniform buffer
@@ -169,10 +364,35 @@ private:
     GfxBuffer m_ssboTriangle = nullptr; // Triangle buffer
     GfxBuffer m_ssboMaterial = nullptr; // Material buffer
     GfxBuffer m_ssboBVH = nullptr; // BVH buffer
+    GfxBuffer m_ssboIntersect = nullptr; // Intersection triangle buffer
     GfxBuffer m_ssboWaves = nullptr; // Waves buffer
     GfxBuffer m_ssboSpMaterials = nullptr; // Spectrum materials buffer
+    GfxBuffer m_ssboStats = nullptr; // Ray statistics buffer
+
+    std::atomic<bool> m_statsEnabled = false; // Whether ray statistics are recorded
+    GfxReadback m_statsReadback = nullptr; // Pending readback of the ray statistics
 
     GfxShader m_computeShader = nullptr; // Compute shader
+    static constexpr int MIN_STACK_SIZE = 32; // Smallest BVH traversal stack of the shader
+    WorkgroupSize m_workgroupSize = {}; // Selected workgroup size
+    WorkgroupSize m_shaderWorkgroupSize = {}; // Workgroup size of the compute shader
+    int m_stackSize = MIN_STACK_SIZE; // BVH traversal stack size of the compute shader
+    std::vector<GfxDescriptorBinding> m_bindings = {}; // Resources bound to the pipeline
+
+    /**
+     * @brief State of workgroup size autotuning.
+     * @note Set up by buildScene, then owned by the render thread.
+     */
+    struct Autotune {
+        bool requested = false; // Whether the next scene starts autotuning
+        bool active = false; // Whether candidates are being timed
+        std::vector<WorkgroupSize> candidates = {}; // Sizes to time
+        std::vector<std::vector<double>> times = {}; // GPU times of each candidate in ms
+        size_t current = 0; // Index of the next candidate, past the last while it drains
+        int frames = 0; // Frames dispatched with the current candidate
+        uint64_t lastSerial = 0; // Serial of the last timer results read
+        std::function<void(const WorkgroupSize&)> callback = nullptr; // Called with the winner
+    } m_autotune = {}; // Workgroup size autotuning
     /**
      * @brief Struct for storing graphics descriptors.
      */
@@ -188,18 +408,43 @@ private:
         GfxDescriptor u_spScene = {}; // Spectral scene descriptor
         GfxDescriptor b_waves = {}; // Waves buffer descriptor
         GfxDescriptor b_spMaterials = {}; // Spectrum materials descriptor
+        GfxDescriptor b_stats = {}; // Ray statistics descriptor
+        GfxDescriptor b_intersect = {}; // Intersection triangle buffer descriptor
     } m_descriptors = {}; // Descriptors
 
     int m_resolutionX = 1024; // Resolution in X
     int m_resolutionY = 768; // Resolution in Y
-    uint32_t m_currentSample = 0; // Current sample count
+    std::atomic<uint32_t> m_currentSample = 0; // Current sample count
 
-    bool m_rendering = false; // Rendering flag
+    std::atomic<bool> m_rendering = false; // Rendering flag, written by the render thread
+    /**
+     * @brief Request queued for the render thread.
+     */
+    enum class Request {
+        RENDER,
+        PAUSE,
+        STOP,
+        RESTART,
+        CLOSE,
+    };
+    /**
+     * @brief Queue a request and wake the render thread.
+     * @param request The request.
+     */
+    void pushRequest(Request request);
+    std::mutex m_requestMutex; // Guards the request queue
+    std::condition_variable m_requestCv; // Signaled when a request is queued
+    std::deque<Request> m_requests = {}; // Requests not applied yet, oldest first
+    bool m_closed = false; // Whether the render thread was asked to exit
+    bool m_finishPending = false; // Whether FINISHED is reported after the present-only frame
 
     std::function<void(void)> m_renderFinishCb = nullptr; // Render finish callback
 
     int m_nWaves = 0; // Number of waves (for spectral rendering)
 
+    // CPU port of the kernel in tests/, reads the buffer structures and builds the BVH
+    friend class PathTracerReference;
+
     /* Internal structures definitions */
 private:
     /* Uniform buffer object structures */
@@ -212,6 +457,7 @@ private:
         int resY = 768; // Resolution in Y
         int traceDepth = 3; // Trace depth
         int currentSample = 0; // Current sample count
+        int collectStats = 0; // Whether the frame records ray statistics
     };
     /**
      * @brief Uniform struct representing the camera parameters.
@@ -237,6 +483,19 @@ private:
 
     /* GPU buffer structures */
 
+    /**
+     * @brief Struct representing the ray statistics of the sampled pixels of a frame.
+     */
+    struct GpuStats {
+        uint32_t paths = 0; // Traced paths
+        uint32_t rays = 0; // Rays traced through the BVH
+        uint32_t rrTerminations = 0; // Paths ended by Russian roulette
+        uint32_t nodesVisited = 0; // BVH nodes visited
+        uint32_t triangleTests = 0; // Ray-triangle intersection tests
+        uint32_t boxTests = 0; // Ray-AABB intersection tests
+        uint32_t padding[2] = {}; // Padding for alignment
+    };
+
     /**
      * @brief Struct representing a vertex in the mesh.
      */
@@ -279,12 +538,22 @@ private:
     struct BufferBvhNode {
         uint32_t idx = 0; // Index of this node
         uint32_t rChildOffset = 0; // Offset to the right child node
-        uint32_t idxTriangle = 0; // Index of the triangle (if leaf node)
+        uint32_t idxTriangle = 0; // Index of the intersection triangle (if leaf node)
         uint32_t leafFlag = 0; // Flag indicating if this is a leaf node
 
         Math::Vec4 aabbMin = {}; // Minimum AABB coordinates
         Math::Vec4 aabbMax = {}; // Maximum AABB coordinates
     };
+    /**
+     * @brief Struct representing a triangle in the GPU buffer used only for intersection.
+     * @note Stored in BVH leaf order, so neighbouring leaves read neighbouring triangles.
+     */
+    struct IntersectTriangle {
+        Math::Vec3 p0 = {}; // Position of vertex 0
+        uint32_t idxTriangle = 0; // Index of the triangle in the triangle buffer
+        Math::Vec4 e1 = {}; // Edge from vertex 0 to vertex 1
+        Math::Vec4 e2 = {}; // Edge from vertex 0 to vertex 2
+    };
 
     /**
      * @brief Struct for holding all buffer data.
@@ -295,6 +564,21 @@ private:
         std::vector<Material> materials = {}; // Materials
         std::vector<GfxImage> textures = {}; // Textures
         std::vector<BufferBvhNode> bvhBufferData = {}; // BVH buffer data
+        int bvhDepth = 0; // Number of levels of the BVH
+        std::vector<IntersectTriangle> intersectData = {}; // Intersection triangles
+
+        /**
+         * @brief Get the heap memory held by the buffer data.
+         * @return Size of the vectors in bytes.
+         */
+        size_t getMemorySize() const {
+            return vertices.capacity() * sizeof(Vertex) +
+                triangles.capacity() * sizeof(Triangle) +
+                materials.capacity() * sizeof(Material) +
+                textures.capacity() * sizeof(GfxImage) +
+                bvhBufferData.capacity() * sizeof(BufferBvhNode) +
+                intersectData.capacity() * sizeof(IntersectTriangle);
+        };
     };
 
     /* BVH structures */
@@ -414,18 +698,36 @@ private:
         /**
          * @brief Bufferize the BVH starting from the root node.
          * @param root Root BVH node.
+         * @param vertices Vertices of the mesh.
+         * @param triangles Triangles of the mesh.
+         * @param[out] intersectData Intersection triangles of the leaves in BVH order.
          * @return Vector of BufferBvhNode for GPU usage.
          */
-        std::vector<BufferBvhNode> bufferize(BvhNode* root);
+        std::vector<BufferBvhNode> bufferize(
+            BvhNode* root,
+            const std::vector<Vertex>& vertices,
+            const std::vector<Triangle>& triangles,
+            std::vector<IntersectTriangle>& intersectData
+        );
+        /**
+         * @brief Get the number of levels of the last bufferized BVH.
+         * @return The number of levels, 0 for an empty BVH.
+         */
+        int getDepth() const { return m_depth; };
 
     private:
         /**
          * @brief Recursive function to bufferize the BVH.
          * @param node Current BVH node.
+         * @param depth Level of the node, 1 for the root.
          */
-        void bufferizeRecursive(BvhNode* node);
+        void bufferizeRecursive(BvhNode* node, int depth);
 
     private:
         std::vector<BufferBvhNode> m_bufferData = {}; // Buffer data for GPU
+        std::vector<IntersectTriangle> m_intersectData = {}; // Intersection triangles for GPU
+        const std::vector<Vertex>* m_vertices = nullptr; // Vertices being bufferized
+        const std::vector<Triangle>* m_triangles = nullptr; // Triangles being bufferized
+        int m_depth = 0; // Number of levels of the BVH
     };
 };
@@ -14,6 +14,11 @@ class PostProcesser {
 public:
     explicit PostProcesser(GfxRenderer& renderer) : m_renderer(renderer) {};
 
+    /**
+     * @brief Compile the shaders, may run on a worker thread ahead of init().
+     * @return 0 on success, non-zero on failure.
+     */
+    int loadShaders();
     /**
      * @brief Initialize the post-processor.
      * @return 0 on success, non-zero on failure.
@@ -28,16 +33,16 @@ public:
      * @brief Initialize the post-processor for a new frame.
      * @param width Width of the frame.
      * @param height Height of the frame.
-     * @param inputImages Array of input images (e.g., front and back buffers).
+     * @param inputImages Input images that may be set with setInputImage().
      * @return 0 on success, non-zero on failure.
      */
-    int initFrame(int width, int height, const std::array<GfxBuffer, 2>& inputImages);
+    int initFrame(int width, int height, const std::vector<GfxBuffer>& inputImages);
 
     /**
      * @brief Set the input image for post-processing.
-     * @param image Input image to be processed.
+     * @param image Input image to be processed, one of the images passed to initFrame().
      */
-    void setInputImage(GfxBuffer& image);
+    void setInputImage(const GfxBuffer& image);
     /**
      * @brief Get the output image after post-processing.
      * @return Output image, or a default texture if the output image is not available.
@@ -60,13 +65,13 @@ private:
     GfxRenderer m_renderer = nullptr; // Reference to the graphics renderer
 
     GfxFramebuffer m_framebuffer = nullptr; // Framebuffer for rendering
-    std::array<GfxBuffer, 2> m_inputImages = {}; // Input images for post-processing
+    std::vector<GfxBuffer> m_inputImages = {}; // Input images for post-processing
     GfxBuffer m_currentInputImage = nullptr; // Current input image for post-processing
     GfxImage m_outputImage = nullptr; // Output image after post-processing
     GfxRenderPass m_renderPass = nullptr; // Render pass for post-processing
     GfxPipeline m_pipeline = nullptr; // Graphics pipeline for post-processing
-    // Descriptor set bindings for post-processing
-    std::array<GfxDescriptorSetBinding, 2> m_descriptorSetBindings = {};
+    // Descriptor set bindings for post-processing, one per input image
+    std::vector<GfxDescriptorSetBinding> m_descriptorSetBindings = {};
 
     GfxBuffer m_uboParams = nullptr; // Uniform buffer for post-processing parameters
     /**
@@ -104,6 +104,11 @@ private:
 public:
     explicit Previewer(GfxRenderer& renderer);
 
+    /**
+     * @brief Compile the shaders, may run on a worker thread ahead of init().
+     * @return 0 on success, non-zero on failure.
+     */
+    int loadShaders();
     /**
      * @brief Initialize the previewer with given resolution and MSAA samples.
      * @param resX Horizontal resolution.
@@ -0,0 +1,123 @@
+/**
+ * @file UiMemoryWindow.hpp
+ * @brief UI dialog for the memory usage window.
+ */
+
+#pragma once
+
+#include "app/AppUiManager.h"
+
+/*
+ * @brief The memory usage window UI.
+ */
+class UiMemoryWindow : public GuiDialogView {
+public:
+    static constexpr const char* LABEL = "memory_window";
+
+    enum class ID : int {
+        SAVE_REPORT,
+    };
+
+    /**
+     * @brief A row of the memory table.
+     */
+    struct Row {
+        std::string name; // Name of the tag
+        std::string current; // Formatted current size
+        std::string peak; // Formatted peak size
+        std::string count; // Number of live allocations
+    };
+
+    std::vector<Row> rows; // Rows of the memory table, filled by the application
+    std::string deviceText; // Device memory summary, empty if unavailable
+
+    /**
+     * @brief Check if the window is open.
+     * @return True if the window is open, false otherwise.
+     */
+    bool isOpen() const { return isShown(); };
+
+    void draw() override {
+        bool show = isShown();
+        if (!show)
+            return;
+
+        float dpiScale = AppUiManager::instance().getDpiScale();
+
+        std::string text;
+
+        ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(16.0f, 4.0f));
+        ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(20.0f, 16.0f));
+
+        ImGui::SetNextWindowPos
+        (
+            ImVec2(ImGui::GetIO().DisplaySize.x * 0.5f, ImGui::GetIO().DisplaySize.y * 0.5f),
+            ImGuiCond_Appearing,
+            ImVec2(0.5f, 0.5f)
+        );
+        ImGui::SetNextWindowSize(ImVec2(520.0f * dpiScale, 420.0f * dpiScale), ImGuiCond_Once);
+
+        // Title
+        text = GuiText::get("memory_window.title");
+        ImGuiWindowFlags flags =
+            ImGuiWindowFlags_NoCollapse |
+            ImGuiWindowFlags_NoSavedSettings;
+        ImGui::Begin(text.c_str(), &show, flags);
+        if (!show)
+            close();
+        ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(8.0f, 2.0f));
+
+        // Memory table
+        ImGuiTableFlags tableFlags =
+            ImGuiTableFlags_Borders |
+            ImGuiTableFlags_RowBg |
+            ImGuiTableFlags_ScrollY;
+        float tableHeight = ImGui::GetContentRegionAvail().y - 60.0f * dpiScale;
+        if (ImGui::BeginTable("memoryTable", 4, tableFlags, ImVec2(0.0f, tableHeight))) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            text = GuiText::get("memory_window.tag");
+            ImGui::TableSetupColumn(text.c_str(), ImGuiTableColumnFlags_WidthStretch);
+            text = GuiText::get("memory_window.current");
+            ImGui::TableSetupColumn(text.c_str(), ImGuiTableColumnFlags_WidthFixed,
+                90.0f * dpiScale);
+            text = GuiText::get("memory_window.peak");
+            ImGui::TableSetupColumn(text.c_str(), ImGuiTableColumnFlags_WidthFixed,
+                90.0f * dpiScale);
+            text = GuiText::get("memory_window.count");
+            ImGui::TableSetupColumn(text.c_str(), ImGuiTableColumnFlags_WidthFixed,
+                60.0f * dpiScale);
+            ImGui::TableHeadersRow();
+            for (const auto& row : rows) {
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::Text("%s", row.name.c_str());
+                ImGui::TableSetColumnIndex(1);
+                ImGui::Text("%s", row.current.c_str());
+                ImGui::TableSetColumnIndex(2);
+                ImGui::Text("%s", row.peak.c_str());
+                ImGui::TableSetColumnIndex(3);
+                ImGui::Text("%s", row.count.c_str());
+            }
+            ImGui::EndTable();
+        }
+
+        // Device memory
+        if (!deviceText.empty()) {
+            text = GuiText::get("memory_window.device") + deviceText;
+            ImGui::Text("%s", text.c_str());
+        }
+
+        // Save report button
+        ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(16.0f, 6.0f));
+        text = GuiText::get("memory_window.save_report");
+        if (ImGui::Button(text.c_str()))
+            pushEvent({ LABEL, static_cast<int>(ID::SAVE_REPORT) });
+        ImGui::PopStyleVar();
+
+        ImGui::PopStyleVar();
+        ImGui::End();
+
+        ImGui::PopStyleVar();
+        ImGui::PopStyleVar();
+    }
+};
@@ -34,6 +34,7 @@ public:
 
         VIEW_PREVIEW_MODE,
         VIEW_PATH_TRACER_OUTPUT,
+        VIEW_MEMORY_USAGE,
 
         RENDER_START,
         RENDER_PAUSE,
@@ -65,6 +66,7 @@ public:
 
         m_widgetStates[static_cast<int>(ID::VIEW_PREVIEW_MODE)] = {};
         m_widgetStates[static_cast<int>(ID::VIEW_PATH_TRACER_OUTPUT)] = {};
+        m_widgetStates[static_cast<int>(ID::VIEW_MEMORY_USAGE)] = {};
 
         m_widgetStates[static_cast<int>(ID::RENDER_START)] = {};
         m_widgetStates[static_cast<int>(ID::RENDER_PAUSE)] = {};
@@ -284,6 +286,21 @@ public:
                 if (clicked)
                     pushEvent({ LABEL, static_cast<int>(ID::VIEW_PATH_TRACER_OUTPUT), {} });
 
+                ImGui::Separator();
+
+                // Memory Usage
+                text = GuiText::get("menu_bar.view_menu.memory_usage");
+                enabled = m_widgetStates[static_cast<int>(ID::VIEW_MEMORY_USAGE)].enabled;
+                clicked = ImGui::MenuItemEx(
+                    text.c_str(),
+                    ICON_FK_BAR_CHART,
+                    nullptr,
+                    false,
+                    enabled
+                );
+                if (clicked)
+                    pushEvent({ LABEL, static_cast<int>(ID::VIEW_MEMORY_USAGE), {} });
+
                 ImGui::EndMenu();
             }
 
@@ -23,10 +23,16 @@ public:
         RENDERING_PROGRESS,
         // Average time per sample in seconds
         EFFICIENCY,
+        // Throughput metrics of the path tracer, one metric per line
+        METRICS_DETAILS,
         // Time elapsed since rendering started in seconds
         TIME_ELAPSED,
         // Total number of triangles in the current scene
         TRIANGLE_COUNT,
+        // GPU time of the latest frames in milliseconds
+        GPU_TIME,
+        // GPU time of each timed pass, one pass per line
+        GPU_TIME_DETAILS,
     };
 
     UiStatusBar() {
@@ -40,10 +46,16 @@ public:
         m_widgetStates[static_cast<int>(ID::RENDERING_PROGRESS)].value = 0.0f;
         m_widgetStates[static_cast<int>(ID::EFFICIENCY)] = {};
         m_widgetStates[static_cast<int>(ID::EFFICIENCY)].value = 0.0f;
+        m_widgetStates[static_cast<int>(ID::METRICS_DETAILS)] = {};
+        m_widgetStates[static_cast<int>(ID::METRICS_DETAILS)].value = "";
         m_widgetStates[static_cast<int>(ID::TIME_ELAPSED)] = {};
         m_widgetStates[static_cast<int>(ID::TIME_ELAPSED)].value = 0.0f;
         m_widgetStates[static_cast<int>(ID::TRIANGLE_COUNT)] = {};
         m_widgetStates[static_cast<int>(ID::TRIANGLE_COUNT)].value = 0;
+        m_widgetStates[static_cast<int>(ID::GPU_TIME)] = {};
+        m_widgetStates[static_cast<int>(ID::GPU_TIME)].value = 0.0f;
+        m_widgetStates[static_cast<int>(ID::GPU_TIME_DETAILS)] = {};
+        m_widgetStates[static_cast<int>(ID::GPU_TIME_DETAILS)].value = "";
     }
 
     void draw() override {
@@ -56,11 +68,13 @@ public:
         float effSegWidth = 220.0f * dpiScale;
         float timerSegWidth = 200.0f * dpiScale;
         float triCntSegWidth = 210.0f * dpiScale;
+        float gpuSegWidth = 170.0f * dpiScale;
         float infoSegWidth = windowWidth - 10.0f;
         infoSegWidth -= renderSegWidth + 10.0f;
         infoSegWidth -= effSegWidth + 10.0f;
         infoSegWidth -= timerSegWidth + 10.0f;
         infoSegWidth -= triCntSegWidth + 10.0f;
+        infoSegWidth -= gpuSegWidth + 10.0f;
         float posX = 0.0f;
 
         ImGui::SetNextWindowPos(ImVec2(0.0f, windowHeight - statusBarHeight));
@@ -137,6 +151,9 @@ public:
             text = GuiText::formatString(text, { ss.str() });
         }
         ImGui::Text("%s", text.c_str());
+        text = getWidgetValue<std::string>(static_cast<int>(ID::METRICS_DETAILS));
+        if (!text.empty() && ImGui::IsItemHovered())
+            ImGui::SetTooltip("%s", text.c_str());
         posX += effSegWidth + 10.0f;
 
         // Timer segment
@@ -166,6 +183,26 @@ public:
         iValue = getWidgetValue<int>(static_cast<int>(ID::TRIANGLE_COUNT));
         text = GuiText::get("status_bar.triangle_count") + std::to_string(iValue);
         ImGui::Text("%s", text.c_str());
+        posX += triCntSegWidth + 10.0f;
+
+        // GPU time segment
+        ImGui::SameLine(posX);
+        ImGui::SeparatorEx(ImGuiSeparatorFlags_Vertical);
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(gpuSegWidth);
+        ImGui::Text(ICON_FK_MICROCHIP " ");
+        ImGui::SameLine();
+        fValue = getWidgetValue<float>(static_cast<int>(ID::GPU_TIME));
+        text = GuiText::get("status_bar.gpu_time");
+        {
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(2) << fValue;
+            text = GuiText::formatString(text, { ss.str() });
+        }
+        ImGui::Text("%s", text.c_str());
+        text = getWidgetValue<std::string>(static_cast<int>(ID::GPU_TIME_DETAILS));
+        if (!text.empty() && ImGui::IsItemHovered())
+            ImGui::SetTooltip("%s", text.c_str());
 
         ImGui::End();
 
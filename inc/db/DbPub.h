@@ -138,6 +138,17 @@ public:
 
     using ID = uint32_t;
 
+    /**
+     * @brief Estimated memory held by the database.
+     * @note Object data is estimated by its serialized size.
+     */
+    struct MemoryUsage {
+        uint64_t objectBytes = 0; // Bytes of the object table and the live objects
+        uint64_t objectCount = 0; // Number of live objects
+        uint64_t historyBytes = 0; // Bytes of the undo and redo stacks
+        uint64_t historyCount = 0; // Number of transactions in the undo and redo stacks
+    };
+
     DB() = default;
     DB(const std::vector<uint8_t>& magic, int version) :
         m_magic(magic),
@@ -285,6 +296,12 @@ public:
      * @return True if there are unsaved modifications, false otherwise.
      */
     bool isModified() const;
+    /**
+     * @brief Estimate the memory held by the objects and the transaction history.
+     * @return The estimated memory usage.
+     * @note Serializes every object and recorded operation, do not call it every frame.
+     */
+    MemoryUsage getMemoryUsage() const;
 
 private:
     /**
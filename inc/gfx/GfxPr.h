@@ -79,3 +79,49 @@ public:
         GfxPipelineStateCache stateCache
     );
 };
+
+/**
+ * @brief Graphics memory tracker class.
+ * @note Counts the memory of the buffers and images of all renderers, the backends report
+ *       their allocations and frees to it.
+ */
+class GfxMemoryTracker {
+public:
+    /**
+     * @brief Count a new resource.
+     * @param category The category of the resource.
+     * @param bytes Size of the resource in bytes.
+     */
+    static void track(GfxMemoryCategory category, uint64_t bytes);
+    /**
+     * @brief Remove a destroyed resource.
+     * @param category The category of the resource.
+     * @param bytes Size of the resource in bytes, as tracked.
+     */
+    static void untrack(GfxMemoryCategory category, uint64_t bytes);
+    /**
+     * @brief Update the size of a resource whose storage was reallocated.
+     * @param category The category of the resource.
+     * @param oldBytes Previous size of the resource in bytes.
+     * @param newBytes New size of the resource in bytes.
+     */
+    static void resize(GfxMemoryCategory category, uint64_t oldBytes, uint64_t newBytes);
+    /**
+     * @brief Get the current memory usage.
+     * @return The memory usage, without device statistics.
+     */
+    static GfxMemoryUsage getUsage();
+
+    /**
+     * @brief Get the category of a buffer.
+     * @param usage The usage of the buffer.
+     * @return The memory category.
+     */
+    static GfxMemoryCategory getCategory(GfxBufferUsage usage);
+    /**
+     * @brief Get the category of an image.
+     * @param usages The usages of the image.
+     * @return The memory category.
+     */
+    static GfxMemoryCategory getCategory(GfxFlags<GfxImageUsage> usages);
+};
@@ -31,6 +31,7 @@
 enum class GfxBackend {
     OpenGL,
     Vulkan,
+    Null, // Records commands into host memory without a device, for tests and benchmarks.
 };
 
 /**
@@ -264,7 +265,7 @@ enum class GfxBufferProp {
 class GfxBuffer_T {
 public:
     GfxBuffer_T(
-        int size,
+        size_t size,
         GfxBufferUsage usage,
         GfxBufferProp prop
     ) :
@@ -279,7 +280,7 @@ public:
      * @brief Get the size of the buffer.
      * @return Size of the buffer in bytes.
      */
-    int getSize() const { return m_size; };
+    size_t getSize() const { return m_size; };
     /**
      * @brief Get the usage of the buffer.
      * @return Usage of the buffer.
@@ -292,12 +293,35 @@ public:
     GfxBufferProp getProp() const { return m_prop; };
 
 protected:
-    int m_size = 0; // Size of the buffer in bytes.
+    size_t m_size = 0; // Size of the buffer in bytes.
     GfxBufferUsage m_usage = GfxBufferUsage::VERTEX_BUFFER; // Usage of the buffer.
     GfxBufferProp m_prop = GfxBufferProp::STATIC; // Properties of the buffer.
 };
 using GfxBuffer = std::shared_ptr<GfxBuffer_T>;
 
+/**
+ * @brief Graphics readback class.
+ * @note Represents an asynchronous copy of buffer data into host-visible memory. It acts as a
+         future: poll it with isReadbackReady, then map it to access the data without a copy.
+ */
+class GfxReadback_T {
+public:
+    explicit GfxReadback_T(size_t size) : m_size(size) {};
+    GfxReadback_T(const GfxReadback_T&) = delete;
+    GfxReadback_T& operator=(const GfxReadback_T&) = delete;
+
+public:
+    /**
+     * @brief Get the size of the data being read back.
+     * @return Size of the data in bytes.
+     */
+    size_t getSize() const { return m_size; };
+
+protected:
+    size_t m_size = 0; // Size of the data in bytes.
+};
+using GfxReadback = std::shared_ptr<GfxReadback_T>;
+
 /**
  * @brief Graphics vertex attribute structure.
  * @note Represents a single vertex attribute in a vertex buffer.
@@ -546,6 +570,73 @@ private:
 };
 using GfxDescriptorSetBinding = std::shared_ptr<GfxDescriptorSetBinding_T>;
 
+/**
+ * @brief Graphics command list class.
+ * @note Represents a sequence of commands recorded once and executed in many frames. The
+         backend keeps the recorded commands, the list itself has no public state.
+ */
+class GfxCommandList_T {
+public:
+    GfxCommandList_T() = default;
+    GfxCommandList_T(const GfxCommandList_T&) = delete;
+    GfxCommandList_T& operator=(const GfxCommandList_T&) = delete;
+};
+using GfxCommandList = std::shared_ptr<GfxCommandList_T>;
+
+/**
+ * @brief GPU time spent in a timer scope.
+ */
+struct GfxTimerResult {
+    std::string name = {}; // Name of the scope.
+    int depth = 0; // Nesting depth of the scope, 0 for outermost scopes.
+    double ms = 0.0; // GPU time spent in the scope in milliseconds.
+};
+
+/**
+ * @brief Graphics memory category enumeration.
+ * @note Used to attribute the memory of buffers and images in GfxMemoryUsage.
+ */
+enum class GfxMemoryCategory {
+    VERTEX_BUFFER,
+    INDEX_BUFFER,
+    UNIFORM_BUFFER,
+    STORAGE_BUFFER,
+    TEXTURE, // Sampled images.
+    RENDER_TARGET, // Color and depth attachments.
+    STORAGE_IMAGE,
+    COUNT,
+};
+/**
+ * @brief Memory held by the resources of one category.
+ */
+struct GfxMemoryCategoryUsage {
+    uint64_t bytes = 0; // Bytes held by live resources.
+    uint64_t peakBytes = 0; // Highest number of bytes held since startup.
+    uint64_t count = 0; // Number of live resources.
+};
+/**
+ * @brief Memory held by the buffers and images of all renderers.
+ * @note Buffers kept once per frame in flight are counted with all their copies. The OpenGL
+         backend estimates the sizes from the formats, drivers may pad them.
+ */
+struct GfxMemoryUsage {
+    // Usage per category, indexed by GfxMemoryCategory.
+    std::array<GfxMemoryCategoryUsage, static_cast<size_t>(GfxMemoryCategory::COUNT)>
+        categories = {};
+    uint64_t deviceReservedBytes = 0; // Device memory allocated from the driver, 0 if unknown.
+    uint64_t deviceUsedBytes = 0; // Device memory handed out to resources, 0 if unknown.
+};
+
+/**
+ * @brief Information about the device a renderer runs on.
+ * @note The defaults are the limits every Vulkan device supports.
+ */
+struct GfxDeviceInfo {
+    std::string name = {}; // Name of the device, empty if unknown.
+    uint32_t maxComputeWorkGroupInvocations = 128; // Invocations per compute work group.
+    std::array<uint32_t, 3> maxComputeWorkGroupSize = { 128, 128, 64 }; // Size per dimension.
+};
+
 /**
  * @brief Graphics renderer interface.
  * @note This interface defines the methods that a graphics renderer must implement.
@@ -603,6 +694,82 @@ public:
      *       device are complete.
      */
     virtual void waitDeviceIdle() const {};
+    /**
+     * @brief [Vulkan specific]
+     *        Submit pending data uploads to the device without waiting for them.
+     * @return 0 on success, non-zero on failure.
+     * @note Uploads are batched and submitted at the end of the frame. Call this to start
+     *       them earlier, e.g. after creating resources outside of a frame.
+     */
+    virtual int flushUploads() const { return 0; };
+    /**
+     * @brief [Vulkan specific]
+     *        Wait for all frames submitted by this renderer to complete.
+     * @note Unlike waitDeviceIdle, this does not wait for work of other renderers. Call this
+     *       before another renderer reads the results of the submitted frames.
+     */
+    virtual void waitFrames() const {};
+    /**
+     * @brief [Vulkan specific]
+     *        Move the renderer to a dedicated compute queue so its work does not compete with
+     *        the graphics queues of other renderers.
+     * @return 0 on success, non-zero if the renderer stays on its graphics queue.
+     * @note Only for renderers without a surface that record compute and transfer commands.
+     *       Call it right after the renderer is created, before any resource is created.
+     */
+    virtual int useComputeQueue() { return 1; };
+    /**
+     * @brief [Vulkan specific]
+     *        Get the sync value reached on the device once the last ended frame completes.
+     * @return The sync value, 0 if the renderer cannot be waited for on the device.
+     * @note Pass the value to waitForRenderer of another renderer.
+     */
+    virtual uint64_t getFrameSyncValue() const { return 0; };
+    /**
+     * @brief [Vulkan specific]
+     *        Get the serial number of the last ended frame.
+     * @return The serial number, 0 if frames are not tracked.
+     * @note Pass the value to isFrameComplete.
+     */
+    virtual uint64_t getFrameSerial() const { return 0; };
+    /**
+     * @brief [Vulkan specific]
+     *        Check without waiting whether a frame has completed on the device.
+     * @param serial Serial number returned by getFrameSerial.
+     * @return True if the frame and all frames before it have completed.
+     * @note Call it from the thread recording the frames of this renderer.
+     */
+    virtual bool isFrameComplete(uint64_t serial) const { return true; };
+    /**
+     * @brief [Vulkan specific]
+     *        Make the next frame submitted by this renderer wait on the device until another
+     *        renderer reaches a sync value.
+     * @param renderer The renderer to wait for.
+     * @param value Sync value returned by getFrameSyncValue of that renderer.
+     * @return 0 on success, non-zero if not supported, use waitFrames on the other renderer.
+     * @note Call it from the thread recording the frames of this renderer.
+     */
+    virtual int waitForRenderer(
+        const std::shared_ptr<GfxRendererInterface>& renderer,
+        uint64_t value
+    ) { return 1; };
+    /**
+     * @brief [Vulkan specific]
+     *        Release a buffer written in the current frame to the renderers on the graphics
+     *        queue. Does nothing if this renderer runs on the graphics queue.
+     * @param buffer The buffer to release.
+     * @note The reading renderer calls acquireBuffer before it uses the buffer, in a frame
+     *       that waits for this one with waitForRenderer.
+     */
+    virtual void releaseBuffer(const GfxBuffer& buffer) {};
+    /**
+     * @brief [Vulkan specific]
+     *        Acquire a buffer released by a renderer on another queue in the current frame.
+     *        Does nothing if the buffer has not been released since it was last acquired.
+     * @param buffer The buffer to acquire.
+     * @note Call it outside render passes.
+     */
+    virtual void acquireBuffer(const GfxBuffer& buffer) {};
 
     /**
      * @brief [ImGui specific][Vulkan specific]
@@ -775,7 +942,7 @@ public:
      * @return A shared pointer to the created GfxBuffer.
      */
     virtual GfxBuffer createBuffer(
-        int size,
+        size_t size,
         GfxBufferUsage usage,
         GfxBufferProp prop
     ) const = 0;
@@ -786,7 +953,7 @@ public:
      * @param data Pointer to the data to set.
      * @return 0 on success, non-zero on failure.
      */
-    virtual int setBufferData(const GfxBuffer& buffer, int size, const void* data) const = 0;
+    virtual int setBufferData(const GfxBuffer& buffer, size_t size, const void* data) const = 0;
     /**
      * @brief Update a portion of the data in a graphics buffer.
      * @param buffer The GfxBuffer to update.
@@ -797,8 +964,8 @@ public:
      */
     virtual int updateBufferData(
         const GfxBuffer& buffer,
-        int offset,
-        int size,
+        size_t offset,
+        size_t size,
         const void* data
     ) const = 0;
     /**
@@ -816,8 +983,8 @@ public:
      */
     virtual int readBufferData(
         const GfxBuffer& buffer,
-        int offset,
-        int size,
+        size_t offset,
+        size_t size,
         void* data
     ) const = 0;
     /**
@@ -832,10 +999,43 @@ public:
     virtual int copyBuffer(
         const GfxBuffer& src,
         const GfxBuffer& dst,
-        int srcOffset,
-        int dstOffset,
-        int size
+        size_t srcOffset,
+        size_t dstOffset,
+        size_t size
     ) const = 0;
+    /**
+     * @brief Start reading data from a graphics buffer without waiting for the GPU.
+     * @param buffer The GfxBuffer to read from.
+     * @param offset The offset in bytes where the read should start.
+     * @param size The size of the data to read in bytes.
+     * @return A shared pointer to the readback, or nullptr on failure.
+     * @note The copy is ordered after all work submitted to this renderer so far. Called while
+     *       recording a frame, it is also ordered after the commands recorded so far and the
+     *       data arrives once the frame has completed.
+     */
+    virtual GfxReadback readBufferDataAsync(
+        const GfxBuffer& buffer,
+        size_t offset,
+        size_t size
+    ) const = 0;
+    /**
+     * @brief Check whether the data of a readback has arrived.
+     * @param readback The GfxReadback to check.
+     * @return True if the data can be mapped without waiting, false otherwise.
+     */
+    virtual bool isReadbackReady(const GfxReadback& readback) const = 0;
+    /**
+     * @brief Map the data of a readback.
+     * @param readback The GfxReadback to map.
+     * @param wait True to wait for the data, false to return nullptr if it has not arrived yet.
+     * @return Pointer to the data, valid until the readback is released. nullptr on failure.
+     */
+    virtual const void* mapReadback(const GfxReadback& readback, bool wait) const = 0;
+    /**
+     * @brief Release a readback, its host memory is reused by later readbacks.
+     * @param readback The GfxReadback to release.
+     */
+    virtual void releaseReadback(const GfxReadback& readback) const = 0;
 
     /**
      * @brief Create a vertex array object (VAO) with the specified vertex descriptor,
@@ -1009,7 +1209,7 @@ public:
      */
     virtual void drawIndirect(
         const GfxBuffer& buffer,
-        int offset,
+        size_t offset,
         int drawCount,
         int stride
     ) = 0;
@@ -1022,7 +1222,7 @@ public:
      */
     virtual void drawIndexedIndirect(
         const GfxBuffer& buffer,
-        int offset,
+        size_t offset,
         int drawCount,
         int stride
     ) = 0;
@@ -1038,12 +1238,77 @@ public:
      * @param buffer The buffer containing compute parameters.
      * @param offset Offset in the buffer where compute parameters start.
      */
-    virtual void dispatchComputeIndirect(const GfxBuffer& buffer, int offset) = 0;
+    virtual void dispatchComputeIndirect(const GfxBuffer& buffer, size_t offset) = 0;
     /**
      * @brief Perform a memory barrier to ensure memory visibility and ordering.
      */
     virtual void memoryBarrier() = 0;
 
+    /**
+     * @brief Create an empty command list.
+     * @return The created GfxCommandList, nullptr on failure.
+     */
+    virtual GfxCommandList createCommandList() const = 0;
+    /**
+     * @brief Record the commands of a command list, replacing its previous content.
+     * @param list The GfxCommandList to record.
+     * @param recordFunc Function issuing the commands through this renderer.
+     * @return 0 on success, non-zero on failure.
+     * @note Only compute and transfer commands outside render passes can be recorded:
+     *       bindPipeline, bindDescriptorSetBinding, dispatchCompute, dispatchComputeIndirect,
+     *       memoryBarrier and copyBuffer. Timer scopes are skipped. recordFunc may be called
+     *       once per frame in flight and must issue the same commands every time. Values that
+     *       change between executions are read from dynamic buffers, e.g. a uniform buffer
+     *       updated with updateBufferData. The list must not be in use by a frame in flight.
+     */
+    virtual int recordCommandList(
+        const GfxCommandList& list,
+        const std::function<void()>& recordFunc
+    ) = 0;
+    /**
+     * @brief Execute a recorded command list in the current frame.
+     * @param list The GfxCommandList to execute.
+     * @note Pipeline and descriptor set bindings made before the call must be made again
+     *       before they are used after it.
+     */
+    virtual void executeCommandList(const GfxCommandList& list) = 0;
+    /**
+     * @brief Destroy a command list.
+     * @param list The GfxCommandList to destroy.
+     */
+    virtual void destroyCommandList(const GfxCommandList& list) const = 0;
+
+    /**
+     * @brief Begin a GPU timer scope in the current frame.
+     * @param name Name of the scope, reported with its result.
+     * @return 0 on success, non-zero if the scope is not timed and must not be ended.
+     * @note Scopes can nest and must be ended within the frame they began in. The GPU
+     *       writes timestamps around the commands of the scope, they are resolved a few
+     *       frames later without stalling.
+     */
+    virtual int beginTimer(const std::string& name) = 0;
+    /**
+     * @brief End the innermost open GPU timer scope.
+     */
+    virtual void endTimer() = 0;
+    /**
+     * @brief Get the GPU times of the most recent frame whose timestamps are available.
+     * @param[out] results Timer results of the frame, in the order the scopes began.
+     * @return Serial number of the frame the results belong to, 0 if none is available.
+     */
+    virtual uint64_t getTimerResults(std::vector<GfxTimerResult>& results) const = 0;
+
+    /**
+     * @brief Get the memory held by the buffers and images of all renderers.
+     * @return The memory usage, by category.
+     */
+    virtual GfxMemoryUsage getMemoryUsage() const;
+    /**
+     * @brief Get information about the device the renderer runs on.
+     * @return The device information, the defaults if the backend cannot query it.
+     */
+    virtual GfxDeviceInfo getDeviceInfo() const { return {}; };
+
 protected:
     GfxBackend m_backend = GfxBackend::OpenGL; // Graphics backend used by the renderer.
     GfxPipelineStateMachine m_pipelineStateMachine = nullptr; // Pipeline state machine.
@@ -1051,6 +1316,33 @@ protected:
 };
 using GfxRenderer = std::shared_ptr<GfxRendererInterface>;
 
+/**
+ * @brief Scoped GPU timer, ends the timer scope it began when destroyed.
+ */
+class GfxTimerScope {
+public:
+    /**
+     * @brief Begin a GPU timer scope.
+     * @param renderer The renderer recording the timed commands.
+     * @param name Name of the scope.
+     */
+    GfxTimerScope(const GfxRenderer& renderer, const std::string& name) :
+        m_renderer(renderer)
+    {
+        m_begun = m_renderer && m_renderer->beginTimer(name) == 0;
+    };
+    ~GfxTimerScope() {
+        if (m_begun)
+            m_renderer->endTimer();
+    };
+    GfxTimerScope(const GfxTimerScope&) = delete;
+    GfxTimerScope& operator=(const GfxTimerScope&) = delete;
+
+private:
+    GfxRenderer m_renderer = nullptr; // Renderer the scope was begun on.
+    bool m_begun = false; // Whether the scope was begun and must be ended.
+};
+
 /**
  * @brief Configuration structure for OpenGL renderer.
  * @note Contains a pointer to the OpenGL function loader.
@@ -1060,17 +1352,39 @@ struct GfxGLRendererConfig {
 };
 /**
  * @brief Configuration structure for Vulkan renderer.
- * @note Contains the application name and a list of Vulkan extensions to enable.
+ * @note Contains the application name, a list of Vulkan extensions to enable, the
+ *       directory of the shader and pipeline caches and the optional device features to use.
  */
 struct GfxVulkanRendererConfig {
     std::string appName = {}; // Name of the Vulkan application.
     std::vector<const char*> extensions = {}; // List of Vulkan extensions to enable.
+    std::string cacheDir = {}; // Directory for the shader and pipeline caches, empty to disable.
+    bool timelineSemaphores = true; // Use timeline semaphores if the device supports them.
+};
+/**
+ * @brief Compute dispatch recorded by the null renderer.
+ */
+struct GfxNullDispatch {
+    GfxPipeline pipeline = nullptr; // Compute pipeline bound for the dispatch.
+    std::vector<GfxDescriptorSetBinding> descriptorSetBindings = {}; // Bound sets by set index.
+    int nGroupsX = 0; // Number of work groups in the X dimension.
+    int nGroupsY = 0; // Number of work groups in the Y dimension.
+    int nGroupsZ = 0; // Number of work groups in the Z dimension.
+};
+/**
+ * @brief Configuration structure for the null renderer.
+ * @note The null renderer does not execute shaders. A dispatch callback can run a CPU
+ *       implementation of the compute work on the host memory of the bound buffers.
+ */
+struct GfxNullRendererConfig {
+    std::function<void(const GfxNullDispatch&)> dispatchFunc = nullptr; // Optional callback.
 };
-using GfxRendererConfig = std::variant<GfxGLRendererConfig, GfxVulkanRendererConfig>;
+using GfxRendererConfig =
+    std::variant<GfxGLRendererConfig, GfxVulkanRendererConfig, GfxNullRendererConfig>;
 /**
  * @brief Factory class for creating graphics renderers.
  * @note This class provides methods to initialize, terminate, and create graphics renderers
-         for different backends (OpenGL, Vulkan).
+         for different backends (OpenGL, Vulkan, Null).
  */
 class GfxRendererFactory {
 private:
@@ -1088,19 +1402,19 @@ public:
 
     /**
      * @brief Initialize the global graphics renderer with the specified backend and configuration.
-     * @param backend The graphics backend to use (OpenGL, Vulkan).
+     * @param backend The graphics backend to use (OpenGL, Vulkan, Null).
      * @param config The configuration for the renderer.
      * @return 0 on success, non-zero on failure.
      */
     int initGlobal(GfxBackend backend, const GfxRendererConfig& config);
     /**
      * @brief Terminate the global graphics renderer for the specified backend.
-     * @param backend The graphics backend to terminate (OpenGL, Vulkan).
+     * @param backend The graphics backend to terminate (OpenGL, Vulkan, Null).
      */
     void termGlobal(GfxBackend backend);
     /**
      * @brief Create a graphics renderer for the specified backend.
-     * @param backend The graphics backend to create the renderer for (OpenGL, Vulkan).
+     * @param backend The graphics backend to create the renderer for (OpenGL, Vulkan, Null).
      * @return A shared pointer to the created GfxRenderer.
      */
     GfxRenderer create(GfxBackend backend);
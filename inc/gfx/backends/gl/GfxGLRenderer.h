@@ -47,17 +47,31 @@ public:
 class GfxGLBuffer : public GfxBuffer_T {
 public:
     GfxGLBuffer(
-        int size,
+        size_t size,
         GfxBufferUsage usage,
         GfxBufferProp prop
     ) :
         GfxBuffer_T(size, usage, prop)
     {};
 
-    void setSize(int size) { m_size = size; };
+    void setSize(size_t size) { m_size = size; };
 
 public:
     GLuint m_buffer = 0; // OpenGL buffer object
+    size_t m_storageSize = 0; // Size of the allocated data store, counted by GfxMemoryTracker
+};
+
+/**
+ * @brief OpenGL implementation of GfxReadback.
+ */
+class GfxGLReadback : public GfxReadback_T {
+public:
+    explicit GfxGLReadback(size_t size) : GfxReadback_T(size) {};
+
+public:
+    GLuint m_buffer = 0; // Persistently mapped buffer receiving the data
+    void* m_mappedData = nullptr; // Host pointer to the buffer
+    GLsync m_fence = nullptr; // Fence signaled when the data has arrived
 };
 
 /**
@@ -123,6 +137,15 @@ public:
     GLuint m_program = 0; // OpenGL program object
 };
 
+/**
+ * @brief OpenGL implementation of GfxCommandList.
+ * @note OpenGL has no command buffers, the recorded function is replayed instead.
+ */
+class GfxGLCommandList : public GfxCommandList_T {
+public:
+    std::function<void()> m_recordFunc = nullptr; // Function replayed on execution
+};
+
 /**
  * @brief OpenGL implementation of GfxRenderer.
  */
@@ -172,31 +195,39 @@ public:
     ) const override;
 
     GfxBuffer createBuffer(
-        int size,
+        size_t size,
         GfxBufferUsage usage,
         GfxBufferProp prop
     ) const override;
-    int setBufferData(const GfxBuffer& buffer, int size, const void* data) const override;
+    int setBufferData(const GfxBuffer& buffer, size_t size, const void* data) const override;
     int updateBufferData(
         const GfxBuffer& buffer,
-        int offset,
-        int size,
+        size_t offset,
+        size_t size,
         const void* data
     ) const override;
     void destroyBuffer(const GfxBuffer& buffer) const override;
     int readBufferData(
         const GfxBuffer& buffer,
-        int offset,
-        int size,
+        size_t offset,
+        size_t size,
         void* data
     ) const override;
     int copyBuffer(
         const GfxBuffer& src,
         const GfxBuffer& dst,
-        int srcOffset,
-        int dstOffset,
-        int size
+        size_t srcOffset,
+        size_t dstOffset,
+        size_t size
     ) const override;
+    GfxReadback readBufferDataAsync(
+        const GfxBuffer& buffer,
+        size_t offset,
+        size_t size
+    ) const override;
+    bool isReadbackReady(const GfxReadback& readback) const override;
+    const void* mapReadback(const GfxReadback& readback, bool wait) const override;
+    void releaseReadback(const GfxReadback& readback) const override;
 
     GfxVAO createVAO(
         const GfxVertexDesc& vertexDesc,
@@ -239,7 +270,7 @@ public:
 
     void bindDescriptorSetBinding(const GfxDescriptorSetBinding& binding) override;
 
-    int beginFrame() override { return 0; };
+    int beginFrame() override;
     int endFrame() override { return 0; };
 
     void draw(int nVertices, int nInstances, int firstVertex, int firstInstance) override;
@@ -252,20 +283,69 @@ public:
     ) override;
     void drawIndirect(
         const GfxBuffer& buffer,
-        int offset,
+        size_t offset,
         int drawCount,
         int stride
     ) override;
     void drawIndexedIndirect(
         const GfxBuffer& buffer,
-        int offset,
+        size_t offset,
         int drawCount,
         int stride
     ) override;
     void dispatchCompute(int nGroupsX, int nGroupsY, int nGroupsZ) override;
-    void dispatchComputeIndirect(const GfxBuffer& buffer, int offset) override;
+    void dispatchComputeIndirect(const GfxBuffer& buffer, size_t offset) override;
     void memoryBarrier() override;
 
+    GfxCommandList createCommandList() const override;
+    int recordCommandList(
+        const GfxCommandList& list,
+        const std::function<void()>& recordFunc
+    ) override;
+    void executeCommandList(const GfxCommandList& list) override;
+    void destroyCommandList(const GfxCommandList& list) const override;
+
+    int beginTimer(const std::string& name) override;
+    void endTimer() override;
+    uint64_t getTimerResults(std::vector<GfxTimerResult>& results) const override;
+
+    GfxDeviceInfo getDeviceInfo() const override;
+
+private:
+    /**
+     * @brief A GPU timer scope recorded in a frame.
+     */
+    struct TimerScope {
+        std::string name = {}; // Name of the scope
+        int depth = 0; // Nesting depth of the scope
+        GLuint beginQuery = 0; // Index of the begin timestamp query in the frame
+        GLuint endQuery = UINT32_MAX; // Index of the end timestamp query, UINT32_MAX if open
+    };
+    /**
+     * @brief GPU timer scopes of one frame.
+     */
+    struct TimerFrame {
+        std::vector<GLuint> queries = {}; // Timestamp query objects of the frame
+        std::vector<TimerScope> scopes = {}; // Scopes in the order they began
+        std::vector<int> openScopes = {}; // Indices of the open scopes, innermost last
+        GLuint nQueries = 0; // Number of queries written in the frame
+        uint64_t serial = 0; // Serial number of the frame
+    };
+    /**
+     * @brief Resolves the timer scopes of a frame if its timestamps are available, then
+     *        resets the frame for reuse.
+     * @param frame The frame to resolve.
+     */
+    void resolveTimers(TimerFrame& frame);
+
 private:
     static std::mutex s_mutex; // Mutex for synchronizing access to global OpenGL renderer
+    static GfxDeviceInfo s_deviceInfo; // Device information, queried once the GL is loaded
+
+    uint64_t m_frameSerial = 0; // Number of frames begun by the renderer
+    std::vector<TimerFrame> m_timerFrames = {}; // Ring of timer frames, created on first use
+    int m_currentTimerFrame = 0; // Index of the timer frame being recorded
+    mutable std::mutex m_timerMutex; // Guards the resolved timer results
+    std::vector<GfxTimerResult> m_timerResults = {}; // Results of the latest resolved frame
+    uint64_t m_timerResultsSerial = 0; // Serial number of the frame of m_timerResults
 };
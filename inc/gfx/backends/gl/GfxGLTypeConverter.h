@@ -38,6 +38,12 @@ public:
      * @return Number of components (e.g., 4 for RGBA).
      */
     static int toGLTypeSize(GfxFormat format);
+    /**
+     * @brief Gets the size in bytes of a given GfxFormat.
+     * @param format The GfxFormat to get the size of.
+     * @return The size in bytes of the format, or 0 if unsupported.
+     */
+    static int formatSize(GfxFormat format);
     /**
      * @brief Converts GfxImageFilterMode to OpenGL filter mode.
      * @param filterMode The GfxImageFilterMode to convert.
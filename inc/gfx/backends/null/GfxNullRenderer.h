@@ -0,0 +1,356 @@
+/**
+ * @file GfxNullRenderer.h
+ * @brief Null implementation of the GfxRenderer interface.
+ * @details The null renderer needs no device. Buffers and images live in host memory, so
+            uploads, copies and readbacks behave like on a real device, while draws and
+            dispatches are only counted. It is meant for headless tests and for measuring the
+            CPU cost of recording a frame.
+ */
+
+#pragma once
+
+#include <chrono>
+
+#include "gfx/GfxPr.h"
+
+/**
+ * @brief Command and resource counters of GfxNullRenderer.
+ */
+struct GfxNullRendererStats {
+    // Commands, reset by resetStats() and updated when a frame ends
+    uint64_t frames = 0; // Frames begun
+    uint64_t renderPasses = 0; // Render passes begun
+    uint64_t pipelineBinds = 0; // Pipelines bound
+    uint64_t vaoBinds = 0; // VAOs bound
+    uint64_t descriptorSetBinds = 0; // Descriptor set bindings bound
+    uint64_t stateChanges = 0; // Dynamic pipeline state changes
+    uint64_t clears = 0; // Attachment clears
+    uint64_t draws = 0; // Draw calls, indirect draws count once per draw
+    uint64_t dispatches = 0; // Compute dispatches, indirect dispatches included
+    uint64_t workGroups = 0; // Work groups of the direct dispatches
+    uint64_t barriers = 0; // Memory barriers
+    uint64_t commandLists = 0; // Command lists executed, their commands are counted too
+    uint64_t bufferUploads = 0; // setBufferData and updateBufferData calls
+    uint64_t bytesUploaded = 0; // Bytes written by buffer and image uploads
+    uint64_t bufferCopies = 0; // copyBuffer calls
+    uint64_t bytesCopied = 0; // Bytes copied between buffers
+    uint64_t readbacks = 0; // Buffer, image and framebuffer reads, synchronous or not
+    uint64_t bytesRead = 0; // Bytes read back to the caller
+    uint64_t timerScopes = 0; // Timer scopes begun
+    // Live resources
+    int buffers = 0; // Live buffers
+    size_t bufferBytes = 0; // Host memory held by live buffers
+    int images = 0; // Live images
+    size_t imageBytes = 0; // Host memory held by live images
+    int shaders = 0; // Live shaders
+    int pipelines = 0; // Live pipelines
+    int descriptorSetBindings = 0; // Live descriptor set bindings
+};
+
+/**
+ * @brief Null implementation of GfxImage.
+ */
+class GfxNullImage : public GfxImage_T {
+public:
+    explicit GfxNullImage(const GfxImageInfo& info) :
+        GfxImage_T(info)
+    {};
+
+public:
+    std::vector<char> m_data = {}; // Pixels of the base level, row-major without padding
+    size_t m_pixelSize = 0; // Size of a pixel in bytes
+};
+
+/**
+ * @brief Null implementation of GfxBuffer.
+ */
+class GfxNullBuffer : public GfxBuffer_T {
+public:
+    GfxNullBuffer(
+        size_t size,
+        GfxBufferUsage usage,
+        GfxBufferProp prop
+    ) :
+        GfxBuffer_T(size, usage, prop)
+    {};
+
+    void setSize(size_t size) { m_size = size; };
+
+public:
+    std::vector<char> m_data = {}; // Content of the buffer
+};
+
+/**
+ * @brief Null implementation of GfxReadback.
+ */
+class GfxNullReadback : public GfxReadback_T {
+public:
+    explicit GfxNullReadback(size_t size) : GfxReadback_T(size) {};
+
+public:
+    std::vector<char> m_data = {}; // Data read from the buffer, empty once released
+};
+
+/**
+ * @brief Null implementation of GfxShader.
+ */
+class GfxNullShader : public GfxShader_T {
+public:
+    GfxNullShader(GfxShaderStage stage, const std::string& source) :
+        GfxShader_T(stage),
+        m_source(source)
+    {};
+
+public:
+    std::string m_source = {}; // Source code of the shader, kept for inspection
+};
+
+/**
+ * @brief Null implementation of GfxPipeline.
+ */
+class GfxNullPipeline : public GfxPipeline_T {
+public:
+    GfxNullPipeline(
+        const GfxRenderPass& renderPass,
+        const std::vector<GfxDescriptorSet>& descriptorSets,
+        const std::vector<GfxPipelineState>& dynamicStates
+    ) :
+        GfxPipeline_T(renderPass, descriptorSets, dynamicStates)
+    {};
+
+    /**
+     * @brief Set the shader stage for the pipeline.
+     * @param stage The shader stage to set.
+     */
+    void setStage(GfxShaderStage stage) { m_stages.set(stage); };
+
+public:
+    std::vector<GfxShader> m_shaders = {}; // Shaders the pipeline was created from
+};
+
+/**
+ * @brief Null implementation of GfxCommandList.
+ * @note The recorded function is replayed on execution.
+ */
+class GfxNullCommandList : public GfxCommandList_T {
+public:
+    std::function<void()> m_recordFunc = nullptr; // Function replayed on execution
+};
+
+/**
+ * @brief Null implementation of GfxRenderer.
+ * @note Resources may be created from any thread, commands are recorded by one thread.
+ */
+class GfxNullRenderer : public GfxRendererInterface {
+public:
+    GfxNullRenderer();
+    ~GfxNullRenderer() = default;
+
+public:
+    static int initGlobal(const GfxRendererConfig& config);
+    static void termGlobal();
+
+    /**
+     * @brief Get the command and resource counters of the renderer.
+     * @return The counters.
+     * @note Commands of the frame being recorded are counted once the frame ends.
+     */
+    GfxNullRendererStats getStats() const;
+    /**
+     * @brief Reset the command counters, the resource counters are kept.
+     */
+    void resetStats();
+
+    void setSamples(int samples) override {};
+
+    GfxImage createImage(const GfxImageInfo& info) const override;
+    int setImageData(const GfxImage& image, void* data) const override;
+    int getImageData(const GfxImage& image, void* data) const override;
+    int generateMipmaps(const GfxImage& image) const override { return 0; };
+    void copyImage(const GfxImage& src, const GfxImage& dst, int width, int height) override;
+    void destroyImage(const GfxImage& image) const override;
+
+    GfxRenderPass createRenderPass(
+        const std::vector<GfxAttachment>& colorAttachments,
+        const GfxAttachment& depthAttachment
+    ) const override;
+    void destroyRenderPass(const GfxRenderPass& renderPass) const override {};
+
+    GfxFramebuffer createFramebuffer(
+        const GfxRenderPass& renderPass,
+        const std::vector<GfxImage>& colorImages,
+        const GfxImage& depthImage,
+        const std::vector<GfxImage>& colorResolveImages
+    ) const override;
+    void destroyFramebuffer(const GfxFramebuffer& framebuffer) const override {};
+    int readFramebufferColorAttachmentPixels(
+        const GfxFramebuffer& framebuffer,
+        int index,
+        const GfxRect& rect,
+        void* pixels
+    ) const override;
+
+    GfxBuffer createBuffer(
+        size_t size,
+        GfxBufferUsage usage,
+        GfxBufferProp prop
+    ) const override;
+    int setBufferData(const GfxBuffer& buffer, size_t size, const void* data) const override;
+    int updateBufferData(
+        const GfxBuffer& buffer,
+        size_t offset,
+        size_t size,
+        const void* data
+    ) const override;
+    void destroyBuffer(const GfxBuffer& buffer) const override;
+    int readBufferData(
+        const GfxBuffer& buffer,
+        size_t offset,
+        size_t size,
+        void* data
+    ) const override;
+    int copyBuffer(
+        const GfxBuffer& src,
+        const GfxBuffer& dst,
+        size_t srcOffset,
+        size_t dstOffset,
+        size_t size
+    ) const override;
+    GfxReadback readBufferDataAsync(
+        const GfxBuffer& buffer,
+        size_t offset,
+        size_t size
+    ) const override;
+    bool isReadbackReady(const GfxReadback& readback) const override;
+    const void* mapReadback(const GfxReadback& readback, bool wait) const override;
+    void releaseReadback(const GfxReadback& readback) const override;
+
+    GfxVAO createVAO(
+        const GfxVertexDesc& vertexDesc,
+        const GfxBuffer& vertexBuffer,
+        const GfxBuffer& indexBuffer
+    ) const override;
+    void destroyVAO(const GfxVAO& vao) const override {};
+
+    GfxShader createShader(
+        GfxShaderStage stage,
+        const std::string& source
+    ) const override;
+    void destroyShader(const GfxShader& shader) const override;
+
+    GfxPipeline createPipeline(
+        const std::vector<GfxShader>& shaders,
+        const std::vector<GfxDescriptorSet>& descriptorSets,
+        const GfxVertexDesc& vertexDesc,
+        const std::vector<GfxPipelineState>& dynamicStates,
+        const GfxRenderPass& renderPass
+    ) const override;
+    void destroyPipeline(const GfxPipeline& pipeline) const override;
+
+    GfxDescriptorSetBinding createDescriptorSetBinding(
+        const GfxPipeline& pipeline,
+        int descriptorSetIndex,
+        const std::vector<GfxDescriptorBinding>& bindings
+    ) const override;
+    void destroyDescriptorSetBinding(GfxDescriptorSetBinding& binding) const override;
+
+    int beginRenderPass(const GfxFramebuffer& framebuffer) override;
+    void endRenderPass() override;
+
+    void bindPipeline(const GfxPipeline& pipeline) override;
+    void bindVAO(const GfxVAO& vao) override;
+
+    void clearColorAttachment(int index, const std::array<float, 4>& value) override;
+    void clearDepthAttachment(float value) override;
+    void clearStencilAttachment(int value) override;
+
+    void bindDescriptorSetBinding(const GfxDescriptorSetBinding& binding) override;
+
+    int beginFrame() override;
+    int endFrame() override;
+
+    void draw(int nVertices, int nInstances, int firstVertex, int firstInstance) override;
+    void drawIndexed(
+        int nIndices,
+        int nInstances,
+        int firstIndex,
+        int vertexOffset,
+        int firstInstance
+    ) override;
+    void drawIndirect(
+        const GfxBuffer& buffer,
+        size_t offset,
+        int drawCount,
+        int stride
+    ) override;
+    void drawIndexedIndirect(
+        const GfxBuffer& buffer,
+        size_t offset,
+        int drawCount,
+        int stride
+    ) override;
+    void dispatchCompute(int nGroupsX, int nGroupsY, int nGroupsZ) override;
+    void dispatchComputeIndirect(const GfxBuffer& buffer, size_t offset) override;
+    void memoryBarrier() override;
+
+    GfxCommandList createCommandList() const override;
+    int recordCommandList(
+        const GfxCommandList& list,
+        const std::function<void()>& recordFunc
+    ) override;
+    void executeCommandList(const GfxCommandList& list) override;
+    void destroyCommandList(const GfxCommandList& list) const override;
+
+    /**
+     * @note The null renderer measures the CPU time spent recording the scope.
+     */
+    int beginTimer(const std::string& name) override;
+    void endTimer() override;
+    uint64_t getTimerResults(std::vector<GfxTimerResult>& results) const override;
+
+private:
+    /**
+     * @brief Get the size of a pixel of the given format.
+     * @param format The format.
+     * @return Size of a pixel in bytes, 0 for undefined formats.
+     */
+    static size_t formatSize(GfxFormat format);
+    /**
+     * @brief Run the dispatch callback for the bound pipeline and descriptor sets.
+     * @param nGroupsX Number of work groups in the X dimension.
+     * @param nGroupsY Number of work groups in the Y dimension.
+     * @param nGroupsZ Number of work groups in the Z dimension.
+     */
+    void runDispatch(int nGroupsX, int nGroupsY, int nGroupsZ);
+
+private:
+    /**
+     * @brief A timer scope recorded in a frame.
+     */
+    struct TimerScope {
+        std::string name = {}; // Name of the scope
+        int depth = 0; // Nesting depth of the scope
+        std::chrono::steady_clock::time_point begin = {}; // Time the scope began
+        double ms = 0.0; // Time spent in the scope in milliseconds, once ended
+    };
+
+    static std::mutex s_mutex; // Mutex for synchronizing access to the global configuration
+    static GfxNullRendererConfig s_config; // Global configuration of the null backend
+
+    std::function<void(const GfxNullDispatch&)> m_dispatchFunc = nullptr; // Dispatch callback
+
+    mutable std::mutex m_statsMutex; // Guards the counters
+    mutable GfxNullRendererStats m_stats = {}; // Command and resource counters
+    // Command counters of the frame being recorded, only touched by the recording thread
+    GfxNullRendererStats m_recordedStats = {};
+
+    GfxPipeline m_currentPipeline = nullptr; // Bound pipeline
+    std::vector<GfxDescriptorSetBinding> m_boundDescriptorSets = {}; // Bound sets by set index
+
+    uint64_t m_frameSerial = 0; // Number of frames begun by the renderer
+    std::vector<TimerScope> m_timerScopes = {}; // Timer scopes of the frame being recorded
+    std::vector<int> m_openTimerScopes = {}; // Indices of the open scopes, innermost last
+    mutable std::mutex m_timerMutex; // Guards the resolved timer results
+    std::vector<GfxTimerResult> m_timerResults = {}; // Results of the latest ended frame
+    uint64_t m_timerResultsSerial = 0; // Serial number of the frame of m_timerResults
+};
@@ -0,0 +1,173 @@
+/**
+ * @file GfxVulkanMemoryAllocator.h
+ * @brief Device memory sub-allocator for the Vulkan backend.
+ * @details Resources are placed at aligned offsets inside large VkDeviceMemory blocks, so the
+            number of vkAllocateMemory calls stays far below maxMemoryAllocationCount.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "gfx/GfxPr.h"
+
+/**
+ * @brief A range of device memory handed out by GfxVulkanMemoryAllocator.
+ */
+struct GfxVulkanAllocation {
+    VkDeviceMemory memory = VK_NULL_HANDLE; // Device memory the range lives in
+    VkDeviceSize offset = 0; // Offset of the range in the device memory
+    VkDeviceSize size = 0; // Size of the range in bytes
+    void* mappedData = nullptr; // Persistently mapped host pointer, null if not host visible
+    uint32_t memoryTypeIndex = 0; // Memory type of the device memory
+    int poolIndex = -1; // Index of the owning pool, -1 for dedicated allocations
+    int blockIndex = -1; // Index of the owning block in the pool, -1 for dedicated allocations
+};
+
+/**
+ * @brief Usage statistics of GfxVulkanMemoryAllocator.
+ */
+struct GfxVulkanMemoryStats {
+    int blockCount = 0; // Number of pooled device memory blocks
+    int dedicatedCount = 0; // Number of dedicated device memory allocations
+    int allocationCount = 0; // Number of live sub-allocations, including dedicated ones
+    VkDeviceSize reservedBytes = 0; // Bytes of device memory allocated from the driver
+    VkDeviceSize usedBytes = 0; // Bytes handed out to resources
+    int freeRangeCount = 0; // Number of free ranges in all blocks
+    VkDeviceSize largestFreeRange = 0; // Size of the largest free range in any block
+};
+
+/**
+ * @brief Block sub-allocator for Vulkan device memory.
+ * @note There is one pool per memory type and resource kind (linear buffers or optimal images),
+         so bufferImageGranularity never has to be honored between neighbors. Each block keeps
+         its free ranges ordered by offset and by size, giving best-fit allocation and
+         coalescing on free in logarithmic time. Host-visible blocks are persistently mapped.
+ */
+class GfxVulkanMemoryAllocator {
+public:
+    /**
+     * @brief Construct the allocator for a device.
+     * @param physicalDevice The physical device to query memory properties from.
+     * @param device The logical device to allocate memory from.
+     * @param blockSize Preferred size of a pooled block in bytes.
+     */
+    GfxVulkanMemoryAllocator(
+        VkPhysicalDevice physicalDevice,
+        VkDevice device,
+        VkDeviceSize blockSize = DEFAULT_BLOCK_SIZE
+    );
+    ~GfxVulkanMemoryAllocator();
+    GfxVulkanMemoryAllocator(const GfxVulkanMemoryAllocator&) = delete;
+    GfxVulkanMemoryAllocator& operator=(const GfxVulkanMemoryAllocator&) = delete;
+
+    /**
+     * @brief Allocate a range of device memory.
+     * @param requirements Memory requirements of the resource.
+     * @param memoryTypeIndex Memory type to allocate from.
+     * @param linear True for buffers and linear images, false for optimal images.
+     * @param[out] allocation The allocated range.
+     * @return 0 on success, non-zero on failure.
+     */
+    int allocate(
+        const VkMemoryRequirements& requirements,
+        uint32_t memoryTypeIndex,
+        bool linear,
+        GfxVulkanAllocation& allocation
+    );
+    /**
+     * @brief Return a range to the allocator. The allocation is reset afterwards.
+     * @param allocation The range to free. Empty allocations are ignored.
+     */
+    void free(GfxVulkanAllocation& allocation);
+
+    /**
+     * @brief Release every block that has no live allocations.
+     * @return Number of blocks released.
+     * @note Defragmentation hook: call after large resources were destroyed (e.g. on scene
+             reload) to hand the memory back to the driver.
+     */
+    int releaseEmptyBlocks();
+    /**
+     * @brief Get the usage statistics of the allocator.
+     * @return The usage statistics.
+     */
+    GfxVulkanMemoryStats getStats() const;
+
+public:
+    static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024 * 1024; // 64 MiB
+
+private:
+    /**
+     * @brief A device memory block split into ranges.
+     */
+    struct Block {
+        VkDeviceMemory memory = VK_NULL_HANDLE; // Device memory of the block
+        VkDeviceSize size = 0; // Size of the block in bytes
+        void* mappedData = nullptr; // Persistently mapped pointer, null if not host visible
+        std::map<VkDeviceSize, VkDeviceSize> freeByOffset = {}; // Free ranges: offset -> size
+        std::multimap<VkDeviceSize, VkDeviceSize> freeBySize = {}; // Free ranges: size -> offset
+        int nAllocations = 0; // Number of live allocations in the block
+    };
+    /**
+     * @brief Blocks of one memory type and resource kind.
+     */
+    struct Pool {
+        std::vector<Block> blocks = {}; // Blocks of the pool, empty slots have null memory
+    };
+
+    /**
+     * @brief Allocate a new device memory block.
+     * @param memoryTypeIndex Memory type to allocate from.
+     * @param size Size of the block in bytes.
+     * @param[out] block The new block.
+     * @return 0 on success, non-zero on failure.
+     */
+    int createBlock(uint32_t memoryTypeIndex, VkDeviceSize size, Block& block) const;
+    /**
+     * @brief Free a device memory block.
+     * @param block The block to free.
+     */
+    void destroyBlock(Block& block) const;
+    /**
+     * @brief Carve an aligned range out of a block using best fit.
+     * @param block The block to allocate from.
+     * @param size Size of the range in bytes.
+     * @param alignment Required alignment of the range.
+     * @param[out] offset Offset of the range in the block.
+     * @return True if the range was allocated, false if the block has no fitting range.
+     */
+    static bool allocateFromBlock(
+        Block& block,
+        VkDeviceSize size,
+        VkDeviceSize alignment,
+        VkDeviceSize& offset
+    );
+    /**
+     * @brief Insert a free range into a block, coalescing it with its neighbors.
+     * @param block The block to insert the range into.
+     * @param offset Offset of the range.
+     * @param size Size of the range in bytes.
+     */
+    static void insertFreeRange(Block& block, VkDeviceSize offset, VkDeviceSize size);
+    /**
+     * @brief Remove a free range from the size index of a block.
+     * @param block The block to update.
+     * @param offset Offset of the range.
+     * @param size Size of the range in bytes.
+     */
+    static void eraseFreeSize(Block& block, VkDeviceSize offset, VkDeviceSize size);
+
+private:
+    mutable std::mutex m_mutex; // Guards pools and statistics
+
+    VkDevice m_device = VK_NULL_HANDLE; // Logical device
+    VkPhysicalDeviceMemoryProperties m_memProperties = {}; // Memory properties of the device
+    VkDeviceSize m_blockSize = DEFAULT_BLOCK_SIZE; // Preferred block size
+    std::vector<Pool> m_pools = {}; // Pools indexed by memoryTypeIndex * 2 + (linear ? 0 : 1)
+
+    int m_dedicatedCount = 0; // Number of dedicated allocations
+    VkDeviceSize m_dedicatedBytes = 0; // Bytes in dedicated allocations
+    int m_allocationCount = 0; // Number of live sub-allocations, including dedicated ones
+    VkDeviceSize m_usedBytes = 0; // Bytes handed out to resources
+};
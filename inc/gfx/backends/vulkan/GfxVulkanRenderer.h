@@ -5,7 +5,14 @@
 
 #include <vulkan/vulkan.h>
 
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <thread>
+
 #include "gfx/GfxPr.h"
+#include "gfx/backends/vulkan/GfxVulkanMemoryAllocator.h"
+#include "gfx/backends/vulkan/GfxVulkanShaderCache.h"
 
 /**
  * @brief Vulkan implementation of GfxImage.
@@ -18,9 +25,10 @@ public:
     VkImage m_image = VK_NULL_HANDLE; // Vulkan image object
     VkImageView m_imageView = VK_NULL_HANDLE; // Vulkan image view for the image
     std::vector<VkImageView> m_mipmapViews = {}; // Vulkan image views for each mipmap level
-    VkDeviceMemory m_imageMemory = VK_NULL_HANDLE; // Vulkan device memory for the image
+    GfxVulkanAllocation m_imageAllocation = {}; // Device memory range bound to the image
     VkSampler m_sampler = VK_NULL_HANDLE; // Vulkan sampler for the image
     VkImageLayout m_currentLayout = VK_IMAGE_LAYOUT_UNDEFINED; // Current layout of the image
+    uint64_t m_uploadSerial = 0; // Serial number of the last upload batch writing the image
 };
 
 /**
@@ -71,7 +79,7 @@ public:
 class GfxVulkanBuffer : public GfxBuffer_T {
 public:
     GfxVulkanBuffer(
-        int size,
+        size_t size,
         GfxBufferUsage usage,
         GfxBufferProp prop
     ) :
@@ -82,11 +90,36 @@ public:
      * @brief Set the size of the buffer.
      * @param size The new size of the buffer in bytes.
      */
-    void setSize(int size) { m_size = size; };
+    void setSize(size_t size) { m_size = size; };
+    /**
+     * @brief Get the index of the buffer instance used by a frame in flight.
+     * @param frame The index of the frame in flight.
+     * @return The index into m_vkBuffers and m_vkBufferAllocations.
+     * @note Only uniform buffers are duplicated per frame, other buffers have a single instance.
+     */
+    int getInstanceIndex(int frame) const { return m_vkBuffers.size() > 1 ? frame : 0; };
 
 public:
     std::vector<VkBuffer> m_vkBuffers = {}; // Vulkan buffer objects
-    std::vector<VkDeviceMemory> m_vkBufferMemories = {}; // Vulkan device memory for the buffers
+    std::vector<GfxVulkanAllocation> m_vkBufferAllocations = {}; // Memory bound to the buffers
+    // Queue family that released the buffer, VK_QUEUE_FAMILY_IGNORED once it is acquired
+    std::atomic<uint32_t> m_releasedFamily = VK_QUEUE_FAMILY_IGNORED;
+    uint64_t m_uploadSerial = 0; // Serial number of the last upload batch writing the buffer
+};
+
+/**
+ * @brief Vulkan implementation of GfxReadback.
+ */
+class GfxVulkanReadback : public GfxReadback_T {
+public:
+    explicit GfxVulkanReadback(size_t size) : GfxReadback_T(size) {};
+
+public:
+    VkBuffer m_buffer = VK_NULL_HANDLE; // Host-visible buffer receiving the data
+    GfxVulkanAllocation m_allocation = {}; // Persistently mapped memory of the buffer
+    VkDeviceSize m_capacity = 0; // Size of the buffer, may exceed the readback size
+    VkCommandBuffer m_commandBuffer = VK_NULL_HANDLE; // Command buffer recording the copy
+    VkFence m_fence = VK_NULL_HANDLE; // Fence signaled when the data has arrived
 };
 
 /**
@@ -145,6 +178,15 @@ public:
     std::vector<VkDescriptorSetLayout> m_vkDescriptorSetLayouts = {}; // Vulkan descriptor set layouts
 };
 
+/**
+ * @brief Vulkan implementation of GfxCommandList.
+ */
+class GfxVulkanCommandList : public GfxCommandList_T {
+public:
+    // Secondary command buffers, one per frame in flight
+    std::vector<VkCommandBuffer> m_vkCommandBuffers = {};
+};
+
 /**
  * @brief Vulkan implementation of GfxRenderer.
  */
@@ -156,6 +198,17 @@ public:
 public:
     static int initGlobal(const GfxRendererConfig& config);
     static void termGlobal();
+    /**
+     * @brief Get the usage statistics of the device memory sub-allocator.
+     * @return The memory usage statistics.
+     */
+    static GfxVulkanMemoryStats getMemoryStats();
+    /**
+     * @brief Get the usage statistics of the SPIR-V and pipeline caches.
+     * @return The cache usage statistics.
+     * @note Compare spirvCompileMs of a cold start with spirvLoadMs of a warm start.
+     */
+    static GfxVulkanShaderCacheStats getShaderCacheStats();
 
     void setVSyncMode(GfxVSyncMode mode) override;
 
@@ -163,6 +216,18 @@ public:
     void setVulkanSurface(void* surface) override;
     int setSwapchainSize(int width, int height) override;
     void waitDeviceIdle() const override;
+    int flushUploads() const override;
+    void waitFrames() const override;
+    int useComputeQueue() override;
+    uint64_t getFrameSyncValue() const override;
+    uint64_t getFrameSerial() const override;
+    bool isFrameComplete(uint64_t serial) const override;
+    int waitForRenderer(
+        const std::shared_ptr<GfxRendererInterface>& renderer,
+        uint64_t value
+    ) override;
+    void releaseBuffer(const GfxBuffer& buffer) override;
+    void acquireBuffer(const GfxBuffer& buffer) override;
 
     int initForImGui(const std::function<void(void*)>& initFunc) override;
     void termForImGui(const std::function<void()>& termFunc) override;
@@ -199,31 +264,39 @@ public:
     ) const override;
 
     GfxBuffer createBuffer(
-        int size,
+        size_t size,
         GfxBufferUsage usage,
         GfxBufferProp prop
     ) const override;
-    int setBufferData(const GfxBuffer& buffer, int size, const void* data) const override;
+    int setBufferData(const GfxBuffer& buffer, size_t size, const void* data) const override;
     int updateBufferData(
         const GfxBuffer& buffer,
-        int offset,
-        int size,
+        size_t offset,
+        size_t size,
         const void* data
     ) const override;
     void destroyBuffer(const GfxBuffer& buffer) const override;
     int readBufferData(
         const GfxBuffer& buffer,
-        int offset,
-        int size,
+        size_t offset,
+        size_t size,
         void* data
     ) const override;
     int copyBuffer(
         const GfxBuffer& src,
         const GfxBuffer& dst,
-        int srcOffset,
-        int dstOffset,
-        int size
+        size_t srcOffset,
+        size_t dstOffset,
+        size_t size
+    ) const override;
+    GfxReadback readBufferDataAsync(
+        const GfxBuffer& buffer,
+        size_t offset,
+        size_t size
     ) const override;
+    bool isReadbackReady(const GfxReadback& readback) const override;
+    const void* mapReadback(const GfxReadback& readback, bool wait) const override;
+    void releaseReadback(const GfxReadback& readback) const override;
 
     GfxVAO createVAO(
         const GfxVertexDesc& vertexDesc,
@@ -279,20 +352,35 @@ public:
     ) override;
     void drawIndirect(
         const GfxBuffer& buffer,
-        int offset,
+        size_t offset,
         int drawCount,
         int stride
     ) override;
     void drawIndexedIndirect(
         const GfxBuffer& buffer,
-        int offset,
+        size_t offset,
         int drawCount,
         int stride
     ) override;
     void dispatchCompute(int nGroupsX, int nGroupsY, int nGroupsZ) override;
-    void dispatchComputeIndirect(const GfxBuffer& buffer, int offset) override;
+    void dispatchComputeIndirect(const GfxBuffer& buffer, size_t offset) override;
     void memoryBarrier() override;
 
+    GfxCommandList createCommandList() const override;
+    int recordCommandList(
+        const GfxCommandList& list,
+        const std::function<void()>& recordFunc
+    ) override;
+    void executeCommandList(const GfxCommandList& list) override;
+    void destroyCommandList(const GfxCommandList& list) const override;
+
+    int beginTimer(const std::string& name) override;
+    void endTimer() override;
+    uint64_t getTimerResults(std::vector<GfxTimerResult>& results) const override;
+
+    GfxMemoryUsage getMemoryUsage() const override;
+    GfxDeviceInfo getDeviceInfo() const override;
+
 private:
     /**
      * @brief Structure representing a queue family.
@@ -300,6 +388,7 @@ private:
     struct QueueFamily {
         uint32_t index = 0; // Index of the queue family
         uint32_t queueCount = 0; // Number of queues in the queue family
+        uint32_t timestampValidBits = 0; // Valid bits of timestamps, 0 if not supported
     };
     /**
      * @brief Finds a suitable queue family for graphics operations.
@@ -307,6 +396,12 @@ private:
      * @return The found QueueFamily structure.
      */
     static QueueFamily findQueueFamily(const VkPhysicalDevice& device);
+    /**
+     * @brief Finds a queue family for compute operations without graphics support.
+     * @param device The Vulkan physical device to query.
+     * @return The found QueueFamily structure, queueCount is 0 if there is none.
+     */
+    static QueueFamily findComputeQueueFamily(const VkPhysicalDevice& device);
 
     /**
      * @brief Creates the swapchain.
@@ -363,13 +458,13 @@ private:
      * @brief Creates a Vulkan image with the specified parameters.
      * @param info Structure containing parameters for image creation.
      * @param[out] image Reference to the VkImage to be created.
-     * @param[out] imageMemory Reference to the VkDeviceMemory to be allocated for the image.
+     * @param[out] allocation Reference to the device memory range bound to the image.
      * @return 0 on success, non-zero on failure.
      */
     int createVkImage(
         const CreateVkImageInfo& info,
         VkImage& image,
-        VkDeviceMemory& imageMemory
+        GfxVulkanAllocation& allocation
     ) const;
     /**
      * @brief Creates a Vulkan image view for the specified image.
@@ -448,7 +543,7 @@ private:
      * @param usage Usage flags for the buffer (e.g., vertex buffer, index buffer).
      * @param properties Memory properties for the buffer (e.g., device local, host visible).
      * @param[out] buffer Reference to the VkBuffer to be created.
-     * @param[out] bufferMemory Reference to the VkDeviceMemory to be allocated for the buffer.
+     * @param[out] allocation Reference to the device memory range bound to the buffer.
      * @return 0 on success, non-zero on failure.
      */
     int createVkBuffer(
@@ -456,15 +551,21 @@ private:
         VkBufferUsageFlags usage,
         VkMemoryPropertyFlags properties,
         VkBuffer& buffer,
-        VkDeviceMemory& bufferMemory
+        GfxVulkanAllocation& allocation
     ) const;
+    /**
+     * @brief Destroys a Vulkan buffer and returns its memory to the allocator.
+     * @param[inout] buffer The VkBuffer to destroy, reset to VK_NULL_HANDLE.
+     * @param[inout] allocation The device memory range of the buffer, reset afterwards.
+     */
+    void destroyVkBuffer(VkBuffer& buffer, GfxVulkanAllocation& allocation) const;
     /**
      * @brief Resizes a Vulkan buffer to a new size.
      * @param buffer The GfxVulkanBuffer to resize.
      * @param size New size for the buffer in bytes.
      * @return 0 on success, non-zero on failure.
      */
-    int resizeVkBuffer(const GfxBuffer& buffer, int size) const;
+    int resizeVkBuffer(const GfxBuffer& buffer, size_t size) const;
 
     /**
      * @brief Creates the Vulkan descriptor set layout, descriptor pool, and descriptor sets based
@@ -483,6 +584,106 @@ private:
      */
     void updateVkDescriptorSets(const GfxDescriptorSetBinding& descriptorSetBinding) const;
 
+    /**
+     * @brief A region of staging memory for a transfer.
+     */
+    struct StagingRegion {
+        VkBuffer buffer = VK_NULL_HANDLE; // Staging buffer holding the region
+        VkDeviceSize offset = 0; // Offset of the region in the staging buffer
+        void* mappedData = nullptr; // Host pointer to the region
+    };
+    /**
+     * @brief A batch of transfer commands sharing one queue submission.
+     */
+    struct UploadBatch {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE; // Command buffer of the batch
+        VkFence fence = VK_NULL_HANDLE; // Fence signaled when the batch completes
+        uint64_t serial = 0; // Serial number of the batch, increasing in submission order
+        bool usesRing = false; // Whether the batch holds a range of the staging ring
+        VkDeviceSize ringBegin = 0; // Ring offset of the first byte used by the batch
+        VkDeviceSize ringEnd = 0; // Ring offset past the last byte used by the batch
+        std::vector<VkBuffer> oversizedBuffers = {}; // Staging buffers too large for the ring
+        std::vector<GfxVulkanAllocation> oversizedAllocations = {}; // Memory of the above
+        std::vector<std::function<void()>> releases = {}; // Destroyed once the batch completes
+    };
+    /**
+     * @brief Resources of a released readback, kept for reuse by later readbacks.
+     */
+    struct ReadbackBuffer {
+        VkBuffer buffer = VK_NULL_HANDLE; // Host-visible buffer
+        GfxVulkanAllocation allocation = {}; // Persistently mapped memory of the buffer
+        VkDeviceSize capacity = 0; // Size of the buffer in bytes
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE; // Command buffer for the copy
+        VkFence fence = VK_NULL_HANDLE; // Fence of the copy
+    };
+    /**
+     * @brief A GPU timer scope recorded in a frame.
+     */
+    struct TimerScope {
+        std::string name = {}; // Name of the scope
+        int depth = 0; // Nesting depth of the scope
+        uint32_t beginQuery = 0; // Query index of the begin timestamp
+        uint32_t endQuery = UINT32_MAX; // Query index of the end timestamp, UINT32_MAX if open
+    };
+    /**
+     * @brief GPU timer scopes of one frame in flight.
+     */
+    struct TimerFrame {
+        VkQueryPool queryPool = VK_NULL_HANDLE; // Timestamp queries of the frame
+        std::vector<TimerScope> scopes = {}; // Scopes in the order they began
+        std::vector<int> openScopes = {}; // Indices of the open scopes, innermost last
+        uint32_t nQueries = 0; // Number of queries written in the frame
+        uint64_t serial = 0; // Serial number of the frame
+    };
+    /**
+     * @brief Resolves the timer scopes of the current frame in flight and resets them.
+     * @note The frame must have completed on the GPU. Records the query reset into the
+             frame command buffer, which must be recording.
+     */
+    void resolveTimers();
+
+    /**
+     * @brief Gets the command buffer of the pending upload batch, starting the batch if needed.
+     * @return The command buffer to record transfer commands into.
+     * @note m_uploadMutex must be held by the caller.
+     */
+    VkCommandBuffer getUploadCommandBuffer() const;
+    /**
+     * @brief Acquires a region of staging memory for the pending upload batch.
+     * @param size Size of the region in bytes.
+     * @param[out] region The acquired region.
+     * @return 0 on success, non-zero on failure.
+     * @note Waits for earlier batches only if the ring has to wrap onto memory still in use.
+             m_uploadMutex must be held by the caller.
+     */
+    int acquireStagingRegion(VkDeviceSize size, StagingRegion& region) const;
+    /**
+     * @brief Checks whether a range of the staging ring is not used by any batch.
+     * @param begin Offset of the range.
+     * @param size Size of the range in bytes.
+     * @return True if the range is free.
+     */
+    bool isStagingRangeFree(VkDeviceSize begin, VkDeviceSize size) const;
+    /**
+     * @brief Submits the pending upload batch without waiting for it.
+     * @return 0 on success, non-zero on failure.
+     * @note m_uploadMutex must be held by the caller.
+     */
+    int submitUploads() const;
+    /**
+     * @brief Recycles completed upload batches.
+     * @param wait True to wait for all submitted batches, false to only poll.
+     * @note m_uploadMutex must be held by the caller.
+     */
+    void retireUploads(bool wait) const;
+    /**
+     * @brief Destroys resources once the upload batch that last used them has completed.
+     * @param serial Serial number of the batch, 0 if no upload used the resources.
+     * @param release Function destroying the resources.
+     * @note Runs the function right away if the batch has already completed.
+     */
+    void releaseAfterUploads(uint64_t serial, std::function<void()> release) const;
+
     /**
      * @brief Begins a single-time command buffer for immediate operations.
      * @return A VkCommandBuffer ready for recording commands.
@@ -501,14 +702,25 @@ private:
     static VkPhysicalDevice s_vkPhysicalDevice; // Vulkan physical device (GPU)
     static VkDevice s_vkDevice; // Vulkan logical device
     static int s_nInstances; // Number of Vulkan renderer instances
-
-    VkQueue m_vkGraphicsQueue = VK_NULL_HANDLE; // Vulkan queue for graphics operations
+    static std::unique_ptr<GfxVulkanMemoryAllocator> s_allocator; // Device memory sub-allocator
+    static std::unique_ptr<GfxVulkanShaderCache> s_shaderCache; // SPIR-V and pipeline disk cache
+    static VkPipelineCache s_vkPipelineCache; // Pipeline cache shared by all renderers
+    static uint32_t s_graphicsFamily; // Index of the graphics queue family
+    static uint32_t s_computeFamily; // Index of the compute-only queue family, UINT32_MAX if none
+    static int s_nComputeInstances; // Number of renderers on the compute queue family
+    static bool s_timelineSemaphores; // Whether timeline semaphores are enabled
+
+    VkQueue m_vkGraphicsQueue = VK_NULL_HANDLE; // Vulkan queue the renderer submits to
+    uint32_t m_queueFamily = 0; // Queue family of m_vkGraphicsQueue
+    bool m_computeQueue = false; // Whether the renderer was moved to the compute queue family
     VkQueue m_vkPresentQueue = VK_NULL_HANDLE; // Vulkan queue for presentation operations
 
     VkSampleCountFlagBits m_maxSampleCount = VK_SAMPLE_COUNT_1_BIT; // Maximum sample count
     VkSampleCountFlagBits m_samples = VK_SAMPLE_COUNT_1_BIT; // Number of samples for multisampling
 
     VkCommandPool m_vkCommandPool = VK_NULL_HANDLE; // Command pool for allocating command buffers
+    // Command pool for upload batches and readbacks, guarded by m_uploadMutex
+    VkCommandPool m_vkTransferCommandPool = VK_NULL_HANDLE;
     std::vector<VkCommandBuffer> m_vkCommandBuffers = {}; // Command buffers for recording commands
 
     GfxVSyncMode m_vsyncMode = GfxVSyncMode::FIFO; // VSync mode for the renderer
@@ -520,10 +732,10 @@ private:
     std::vector<VkImageView> m_swapchainImageViews; // Views for the swapchain images
     VkImage m_swapchainColorImage = VK_NULL_HANDLE; // Color image for the swapchain
     VkImageView m_swapchainColorImageView = VK_NULL_HANDLE; // View for the swapchain color image
-    VkDeviceMemory m_swapchainColorImageMemory = VK_NULL_HANDLE; // Memory for swapchainColorImage
+    GfxVulkanAllocation m_swapchainColorImageAllocation = {}; // Memory for swapchainColorImage
     VkImage m_swapchainDepthImage = VK_NULL_HANDLE; // Depth image for the swapchain
     VkImageView m_swapchainDepthImageView = VK_NULL_HANDLE; // View for the swapchain depth image
-    VkDeviceMemory m_swapchainDepthImageMemory = VK_NULL_HANDLE; // Memory for swapchainDepthImage
+    GfxVulkanAllocation m_swapchainDepthImageAllocation = {}; // Memory for swapchainDepthImage
     VkRenderPass m_swapchainRenderPass = VK_NULL_HANDLE; // Render pass for the swapchain
     std::vector<VkFramebuffer> m_swapchainFramebuffers = {}; // Framebuffers for the swapchain
     uint32_t m_imageIndex = 0; // Index of the current image in the swapchain
@@ -531,10 +743,43 @@ private:
     std::vector<VkSemaphore> m_imageAvailableSemaphores = {}; // Semaphores for image availability
     std::vector<VkSemaphore> m_renderFinishedSemaphores = {}; // Semaphores for render completion
     std::vector<VkFence> m_inFlightFences = {}; // Fences for synchronizing frame rendering
+    std::vector<uint64_t> m_inFlightSerials = {}; // Serial of the frame using each fence
+    VkSemaphore m_frameTimeline = VK_NULL_HANDLE; // Signaled with the serial of each frame
+    uint64_t m_frameSyncValue = 0; // Serial of the last submitted frame
+    // Timeline semaphores and values the next submitted frame waits for
+    std::vector<std::pair<VkSemaphore, uint64_t>> m_frameWaits = {};
 
     uint32_t m_currentFrame = 0; // Index of the current frame being rendered
+    uint64_t m_frameSerial = 0; // Number of frames begun by the renderer
+    std::atomic<std::thread::id> m_frameThread = {}; // Thread recording the current frame
+    bool m_inRenderPass = false; // Whether a render pass is being recorded
+    // Commands are recorded into m_recordCommandBuffer with the resources of m_recordFrame,
+    // these are the current frame except while a command list is being recorded
+    VkCommandBuffer m_recordCommandBuffer = VK_NULL_HANDLE; // Command buffer being recorded
+    uint32_t m_recordFrame = 0; // Frame in flight whose resources the commands use
+    std::atomic<std::thread::id> m_listThread = {}; // Thread recording a command list
+
+    std::vector<TimerFrame> m_timerFrames = {}; // Timer scopes per frame in flight
+    uint64_t m_timestampMask = 0; // Mask of valid timestamp bits, 0 if timers are disabled
+    double m_timestampPeriod = 0.0; // Nanoseconds per timestamp tick
+    mutable std::mutex m_timerMutex; // Guards the resolved timer results
+    std::vector<GfxTimerResult> m_timerResults = {}; // Results of the latest resolved frame
+    uint64_t m_timerResultsSerial = 0; // Serial number of the frame of m_timerResults
 
     static VkDebugUtilsMessengerEXT s_debugMessenger; // Debug messenger
 
+    mutable std::mutex m_uploadMutex; // Guards the staging ring, upload batches and queue submits
+    mutable VkBuffer m_stagingRing = VK_NULL_HANDLE; // Persistently mapped staging ring buffer
+    mutable GfxVulkanAllocation m_stagingRingAllocation = {}; // Memory of the staging ring
+    mutable VkDeviceSize m_stagingHead = 0; // Next free offset in the staging ring
+    mutable UploadBatch m_pendingUploads = {}; // Upload batch being recorded
+    mutable std::deque<UploadBatch> m_submittedUploads = {}; // Submitted batches, oldest first
+    mutable std::vector<VkCommandBuffer> m_freeUploadCommandBuffers = {}; // Recycled
+    mutable std::vector<VkFence> m_freeUploadFences = {}; // Recycled upload fences
+    mutable std::vector<ReadbackBuffer> m_freeReadbackBuffers = {}; // Released readbacks
+    mutable std::vector<VkFence> m_frameReadbackFences = {}; // Readbacks recorded into the frame
+    mutable uint64_t m_uploadSerial = 0; // Serial number of the latest upload batch
+    mutable uint64_t m_retiredUploadSerial = 0; // Serial number of the latest completed batch
+
     VkRenderPass m_ImGuiRenderPass = VK_NULL_HANDLE; // [ImGui specific] Render pass for ImGui
 };
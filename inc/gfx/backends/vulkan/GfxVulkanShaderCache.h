@@ -0,0 +1,113 @@
+/**
+ * @file GfxVulkanShaderCache.h
+ * @brief On-disk SPIR-V and pipeline cache for the Vulkan backend.
+ * @details Compiled SPIR-V is stored per shader, keyed by a hash of the source, the shader
+            stage, the target environment and the glslang version. Each file also holds the
+            full key, a file whose key differs is treated as a miss. The VkPipelineCache blob is
+            stored once per device and validated against the device before it is reused.
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "gfx/GfxPr.h"
+
+/**
+ * @brief Usage statistics of GfxVulkanShaderCache.
+ */
+struct GfxVulkanShaderCacheStats {
+    int spirvHits = 0; // Shaders loaded from the SPIR-V cache
+    int spirvMisses = 0; // Shaders compiled by glslang
+    double spirvLoadMs = 0.0; // Time spent loading cached SPIR-V in milliseconds
+    double spirvCompileMs = 0.0; // Time spent compiling GLSL in milliseconds
+    bool pipelineCacheLoaded = false; // Whether the pipeline cache was restored from disk
+    size_t pipelineCacheBytes = 0; // Size of the restored pipeline cache in bytes
+};
+
+/**
+ * @brief Persistent cache for compiled shaders and pipelines.
+ * @note An empty cache directory disables the disk side, the pipeline cache then still
+         speeds up pipelines recreated during the session. Corrupt or stale cache files are
+         ignored and overwritten.
+ */
+class GfxVulkanShaderCache {
+public:
+    /**
+     * @brief Construct the cache.
+     * @param cacheDir Directory to store the cache files in, empty to keep everything in memory.
+     */
+    explicit GfxVulkanShaderCache(const std::string& cacheDir);
+    GfxVulkanShaderCache(const GfxVulkanShaderCache&) = delete;
+    GfxVulkanShaderCache& operator=(const GfxVulkanShaderCache&) = delete;
+
+    /**
+     * @brief Load cached SPIR-V.
+     * @param key Key identifying the shader source, stage and compiler.
+     * @param[out] code The cached SPIR-V words.
+     * @return 0 on a cache hit, non-zero on a miss.
+     */
+    int loadSpirv(const std::string& key, std::vector<uint32_t>& code) const;
+    /**
+     * @brief Store compiled SPIR-V.
+     * @param key Key identifying the shader source, stage and compiler.
+     * @param code The SPIR-V words to store.
+     * @return 0 on success, non-zero on failure.
+     */
+    int storeSpirv(const std::string& key, const std::vector<uint32_t>& code) const;
+    /**
+     * @brief Record the time spent to get the SPIR-V of a shader.
+     * @param hit True if the SPIR-V came from the cache, false if it was compiled.
+     * @param ms Time spent in milliseconds.
+     */
+    void recordSpirv(bool hit, double ms);
+
+    /**
+     * @brief Create a pipeline cache, seeded from disk if a matching blob exists.
+     * @param physicalDevice The physical device the cache must match.
+     * @param device The logical device to create the cache on.
+     * @param[out] pipelineCache The created pipeline cache.
+     * @return 0 on success, non-zero on failure.
+     */
+    int createPipelineCache(
+        VkPhysicalDevice physicalDevice,
+        VkDevice device,
+        VkPipelineCache& pipelineCache
+    );
+    /**
+     * @brief Write the content of a pipeline cache to disk.
+     * @param device The logical device owning the cache.
+     * @param pipelineCache The pipeline cache to save.
+     * @return 0 on success, non-zero on failure.
+     */
+    int savePipelineCache(VkDevice device, VkPipelineCache pipelineCache) const;
+
+    /**
+     * @brief Get the usage statistics of the cache.
+     * @return The usage statistics.
+     */
+    GfxVulkanShaderCacheStats getStats() const;
+
+private:
+    /**
+     * @brief Hash a string with 64-bit FNV-1a.
+     * @param data The string to hash.
+     * @return The hash value.
+     */
+    static uint64_t hash(const std::string& data);
+    /**
+     * @brief Write a file through a temporary file, so readers never see partial content.
+     * @param path Path of the file.
+     * @param data Pointer to the content.
+     * @param size Size of the content in bytes.
+     * @return 0 on success, non-zero on failure.
+     */
+    static int writeFile(const std::string& path, const void* data, size_t size);
+
+private:
+    mutable std::mutex m_mutex; // Guards statistics
+
+    std::string m_spirvDir = {}; // Directory of the SPIR-V cache, empty if disabled
+    std::string m_pipelineCachePath = {}; // Path of the pipeline cache blob, empty if disabled
+    GfxVulkanShaderCacheStats m_stats = {}; // Usage statistics
+};
@@ -71,6 +71,15 @@ public:
      * @return 0 on success, non-zero on failure.
      */
     virtual int endFrame() const = 0;
+    /**
+     * @brief Sleeps until events arrive or the timeout expires, then processes the events.
+     * @param timeout Maximum time to wait in seconds.
+     */
+    virtual void waitEvents(double timeout) const = 0;
+    /**
+     * @brief Wakes up a thread waiting in waitEvents(), may be called from any thread.
+     */
+    virtual void postEmptyEvent() const = 0;
 
     /**
      * @brief Sets the window icon using the provided icons.
@@ -62,10 +62,40 @@ public:
     static GfxBackend getGraphicsBackend() {
         return s_backend;
     };
+    /**
+     * @brief Sets the directory for the graphics shader and pipeline caches.
+     * @param cacheDir The cache directory, empty to disable the disk caches.
+     */
+    static void setCacheDir(const std::string& cacheDir) {
+        s_cacheDir = cacheDir;
+    };
+    /**
+     * @brief Gets the directory for the graphics shader and pipeline caches.
+     * @return The cache directory.
+     */
+    static const std::string& getCacheDir() {
+        return s_cacheDir;
+    };
+    /**
+     * @brief Sets whether the graphics backend may use timeline semaphores.
+     * @param enabled False to take the fallback paths of devices without them.
+     */
+    static void setTimelineSemaphores(bool enabled) {
+        s_timelineSemaphores = enabled;
+    };
+    /**
+     * @brief Gets whether the graphics backend may use timeline semaphores.
+     * @return True if they are used when the device supports them.
+     */
+    static bool getTimelineSemaphores() {
+        return s_timelineSemaphores;
+    };
 
 private:
     static std::string s_appName; // Application name
     static GfxBackend s_backend; // Graphics backend
+    static std::string s_cacheDir; // Graphics cache directory
+    static bool s_timelineSemaphores; // Whether timeline semaphores may be used
 };
 
 /**
@@ -549,6 +579,23 @@ public:
      * @return 0 on success, non-zero on failure.
      */
     int drawFrame();
+    /**
+     * @brief Enables or disables on-demand redrawing.
+     *        When enabled, drawFrame() sleeps until input arrives, a redraw is requested or
+     *        the idle interval expires, instead of drawing back to back.
+     * @param enabled True to redraw on demand, false to redraw continuously.
+     */
+    void setRedrawOnDemand(bool enabled);
+    /**
+     * @brief Requests frames to be drawn in on-demand mode, may be called from any thread.
+     * @param nFrames Number of frames to draw, pending requests are not accumulated.
+     */
+    void requestRedraw(int nFrames = 1);
+    /**
+     * @brief Caps the rate at which drawFrame() draws frames.
+     * @param fps Maximum frames per second, 0 for no cap.
+     */
+    void setMaxFrameRate(int fps);
 
     /**
      * @brief Gets the native window handle.
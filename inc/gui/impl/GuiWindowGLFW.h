@@ -73,6 +73,8 @@ public:
 
     int beginFrame() const override;
     int endFrame() const override;
+    void waitEvents(double timeout) const override;
+    void postEmptyEvent() const override;
 
     void setWindowIcon(const std::vector<GuiIcon>& icons) override;
 
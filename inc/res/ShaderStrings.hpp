@@ -25,7 +25,18 @@ inline constexpr const char* PATHTRACER_COMP =
     "#extension GL_EXT_nonuniform_qualifier : require\n"
     "#endif\n"
     "\n"
-    "layout(local_size_x = 32, local_size_y = 32) in;\n"
+    "// Set by the application when it compiles the shader\n"
+    "#ifndef WORKGROUP_SIZE_X\n"
+    "#define WORKGROUP_SIZE_X 16 // Invocations per workgroup in X\n"
+    "#endif\n"
+    "#ifndef WORKGROUP_SIZE_Y\n"
+    "#define WORKGROUP_SIZE_Y 16 // Invocations per workgroup in Y\n"
+    "#endif\n"
+    "#ifndef BVH_STACK_SIZE\n"
+    "#define BVH_STACK_SIZE 32 // Traversal stack entries, at least the number of BVH levels\n"
+    "#endif\n"
+    "\n"
+    "layout(local_size_x = WORKGROUP_SIZE_X, local_size_y = WORKGROUP_SIZE_Y) in;\n"
     "\n"
     "/**\n"
     " * @brief Storage buffer for accumulating radiance values for each pixel and wavelength.\n"
@@ -42,6 +53,7 @@ inline constexpr const char* PATHTRACER_COMP =
     "    int resY; // Resolution in Y\n"
     "    int traceDepth; // Trace depth\n"
     "    int currentSample; // Current sample count\n"
+    "    int collectStats; // Whether the sampled pixels record ray statistics\n"
     "} u_scene; // Scene parameters\n"
     "\n"
     "/**\n"
@@ -153,7 +165,7 @@ inline constexpr const char* PATHTRACER_COMP =
     "struct BvhNode {\n"
     "    uint idx; // Index of this node\n"
     "    uint rChildOffset; // Offset to the right child node\n"
-    "    uint idxTriangle; // Index of the triangle (if leaf node)\n"
+    "    uint idxTriangle; // Index of the intersection triangle (if leaf node)\n"
     "    uint leafFlag; // Flag indicating if this is a leaf node\n"
     "\n"
     "    vec4 aabbMin; // Minimum AABB coordinates\n"
@@ -166,6 +178,43 @@ inline constexpr const char* PATHTRACER_COMP =
     "    BvhNode bvhNodes[]; // Array of BVH nodes\n"
     "} b_BVH; // BVH buffer\n"
     "\n"
+    "/**\n"
+    " * @brief Struct representing a triangle used only for intersection.\n"
+    " */\n"
+    "struct IntersectTriangle {\n"
+    "    vec3 p0; // Position of vertex 0\n"
+    "    uint idxTriangle; // Index of the triangle in the triangle buffer\n"
+    "    vec4 e1; // Edge from vertex 0 to vertex 1\n"
+    "    vec4 e2; // Edge from vertex 0 to vertex 2\n"
+    "};\n"
+    "/**\n"
+    " * @brief Storage buffer containing the intersection triangles in BVH leaf order.\n"
+    " */\n"
+    "layout(binding = 12) readonly buffer IntersectTriangles {\n"
+    "    IntersectTriangle triangles[]; // Array of intersection triangles\n"
+    "} b_intersect; // Intersection triangle buffer\n"
+    "\n"
+    "/**\n"
+    " * @brief Storage buffer accumulating ray statistics over the sampled pixels of a frame.\n"
+    " */\n"
+    "layout(binding = 11) buffer Stats {\n"
+    "    uint paths; // Traced paths\n"
+    "    uint rays; // Rays traced through the BVH\n"
+    "    uint rrTerminations; // Paths ended by Russian roulette\n"
+    "    uint nodesVisited; // BVH nodes visited\n"
+    "    uint triangleTests; // Ray-triangle intersection tests\n"
+    "    uint boxTests; // Ray-AABB intersection tests\n"
+    "    uint padding[2]; // Padding for alignment\n"
+    "} b_stats; // Ray statistics\n"
+    "\n"
+    "const int STATS_PIXEL_STRIDE = 4; // Every 4th pixel on both axes records statistics\n"
+    "\n"
+    "uint g_statRays = 0; // Rays traced by this invocation\n"
+    "uint g_statRrTerminations = 0; // Russian roulette terminations of this invocation\n"
+    "uint g_statNodesVisited = 0; // BVH nodes visited by this invocation\n"
+    "uint g_statTriangleTests = 0; // Ray-triangle tests of this invocation\n"
+    "uint g_statBoxTests = 0; // Ray-AABB tests of this invocation\n"
+    "\n"
     "const float EPS = 0.00001; // Small epsilon value\n"
     "const float INFINITY = 1e20; // Large value representing infinity\n"
     "const float PI = 3.14159265359; // Value of pi\n"
@@ -328,11 +377,20 @@ inline constexpr const char* PATHTRACER_COMP =
     "\n"
     "/**\n"
     " * @brief Struct representing the result of a ray intersection.\n"
+    " * @note Only what traversal needs to pick the closest hit, the shading attributes are\n"
+    " *       reconstructed for the closest hit with getHitAttributes().\n"
     " */\n"
     "struct HitRecord {\n"
     "    bool hit; // Flag indicating if an intersection occurred\n"
     "    float t; // Distance to intersection\n"
-    "    vec3 normal; // Surface normal at intersection\n"
+    "    vec2 barycentric; // Barycentric weights of vertices 1 and 2 at intersection\n"
+    "    uint idxTriangle; // Index of the intersected triangle\n"
+    "};\n"
+    "/**\n"
+    " * @brief Struct representing the surface attributes at a ray intersection.\n"
+    " */\n"
+    "struct HitAttributes {\n"
+    "    vec3 normal; // Surface normal at intersection, facing against the ray\n"
     "    vec3 tangent; // Interpolated tangent at intersection\n"
     "    vec2 texCoord; // Texture coordinates at intersection\n"
     "    uint idxMaterial; // Index of the material at intersection\n"
@@ -341,50 +399,61 @@ inline constexpr const char* PATHTRACER_COMP =
     " * @brief Function to test ray-triangle intersection.\n"
     " * @param ray The ray to test.\n"
     " * @param tri The triangle to test against.\n"
-    " * @return The result of the intersection test.\n"
+    " * @param[out] t Distance to the intersection.\n"
+    " * @param[out] barycentric Barycentric weights of vertices 1 and 2 at the intersection.\n"
+    " * @return True if the ray hits the triangle, false otherwise.\n"
     " */\n"
-    "HitRecord hitTriangle(Ray ray, Triangle tri) {\n"
-    "    HitRecord result;\n"
-    "    result.t = INFINITY;\n"
-    "    result.hit = false;\n"
-    "\n"
-    "    Vertex v0 = b_vertices.vertices[tri.v0];\n"
-    "    Vertex v1 = b_vertices.vertices[tri.v1];\n"
-    "    Vertex v2 = b_vertices.vertices[tri.v2];\n"
-    "\n"
-    "    vec3 p0 = v0.pos.xyz;\n"
-    "    vec3 p1 = v1.pos.xyz;\n"
-    "    vec3 p2 = v2.pos.xyz;\n"
+    "bool hitTriangle(Ray ray, IntersectTriangle tri, out float t, out vec2 barycentric) {\n"
+    "    t = INFINITY;\n"
+    "    barycentric = vec2(0.0);\n"
     "\n"
-    "    vec3 e1 = p1 - p0;\n"
-    "    vec3 e2 = p2 - p0;\n"
+    "    // The vertex buffer is only read for the attributes of the closest hit\n"
+    "    vec3 p0 = tri.p0;\n"
+    "    vec3 e1 = tri.e1.xyz;\n"
+    "    vec3 e2 = tri.e2.xyz;\n"
     "\n"
     "    vec3 p = cross(ray.direction, e2);\n"
     "    float det = dot(e1, p);\n"
     "\n"
     "    if (abs(det) < EPS)\n"
-    "        return result;\n"
+    "        return false;\n"
     "\n"
     "    float invDet = 1.0 / det;\n"
     "    vec3 tvec = ray.origin - p0;\n"
     "\n"
     "    float u = dot(tvec, p) * invDet;\n"
     "    if (u < 0.0 || u > 1.0)\n"
-    "        return result;\n"
+    "        return false;\n"
     "\n"
     "    vec3 q = cross(tvec, e1);\n"
     "    float v = dot(ray.direction, q) * invDet;\n"
     "    if (v < 0.0 || (u + v) > 1.0)\n"
-    "        return result;\n"
+    "        return false;\n"
     "\n"
-    "    float t = dot(e2, q) * invDet;\n"
-    "    if (t < EPS)\n"
-    "        return result;\n"
+    "    float tHit = dot(e2, q) * invDet;\n"
+    "    if (tHit < EPS)\n"
+    "        return false;\n"
     "\n"
-    "    /* ===== Hit confirmed ===== */\n"
-    "    result.hit = true;\n"
-    "    result.t = t;\n"
+    "    t = tHit;\n"
+    "    barycentric = vec2(u, v);\n"
+    "    return true;\n"
+    "}\n"
+    "/**\n"
+    " * @brief Function to reconstruct the surface attributes of a hit.\n"
+    " * @param ray The ray that produced the hit.\n"
+    " * @param hit The hit, must have hit set.\n"
+    " * @return The interpolated surface attributes.\n"
+    " */\n"
+    "HitAttributes getHitAttributes(Ray ray, HitRecord hit) {\n"
+    "    HitAttributes result;\n"
     "\n"
+    "    Triangle tri = b_triangles.triangles[hit.idxTriangle];\n"
+    "    Vertex v0 = b_vertices.vertices[tri.v0];\n"
+    "    Vertex v1 = b_vertices.vertices[tri.v1];\n"
+    "    Vertex v2 = b_vertices.vertices[tri.v2];\n"
+    "\n"
+    "    float u = hit.barycentric.x;\n"
+    "    float v = hit.barycentric.y;\n"
     "    float w = 1.0 - u - v;\n"
     "\n"
     "    vec3 n0 = v0.normal.xyz;\n"
@@ -410,17 +479,43 @@ inline constexpr const char* PATHTRACER_COMP =
     "    return result;\n"
     "}\n"
     "/**\n"
-    " * @brief Function to test ray-AABB intersection.\n"
+    " * @brief Struct holding the per-ray terms of the ray-AABB test.\n"
+    " */\n"
+    "struct RayBoxTerms {\n"
+    "    vec3 invDir; // Reciprocal of the ray direction\n"
+    "    vec3 originInvDir; // Ray origin scaled by the reciprocal direction\n"
+    "};\n"
+    "/**\n"
+    " * @brief Function to compute the ray-AABB test terms once per ray.\n"
     " * @param ray The ray to test.\n"
+    " * @return The terms for hitAABB.\n"
+    " */\n"
+    "RayBoxTerms getRayBoxTerms(Ray ray) {\n"
+    "    // Keep zero components finite so that origin * invDir never becomes 0 * inf\n"
+    "    const float MIN_DIR = 1e-12;\n"
+    "    vec3 dir = mix(\n"
+    "        ray.direction,\n"
+    "        vec3(MIN_DIR),\n"
+    "        lessThan(abs(ray.direction), vec3(MIN_DIR))\n"
+    "    );\n"
+    "    RayBoxTerms terms;\n"
+    "    terms.invDir = 1.0 / dir;\n"
+    "    terms.originInvDir = ray.origin * terms.invDir;\n"
+    "    return terms;\n"
+    "}\n"
+    "/**\n"
+    " * @brief Function to test ray-AABB intersection.\n"
+    " * @param terms The per-ray test terms.\n"
     " * @param aabbMin The minimum coordinates of the AABB.\n"
     " * @param aabbMax The maximum coordinates of the AABB.\n"
+    " * @param tMax The distance beyond which hits are ignored.\n"
     " * @return The distance to the intersection or INFINITY if no intersection occurs.\n"
     " */\n"
-    "float hitAABB(Ray ray, vec3 aabbMin, vec3 aabbMax) {\n"
-    "    vec3 invDir = 1.0 / ray.direction;\n"
+    "float hitAABB(RayBoxTerms terms, vec3 aabbMin, vec3 aabbMax, float tMax) {\n"
+    "    g_statBoxTests++;\n"
     "\n"
-    "    vec3 t0 = (aabbMin - ray.origin) * invDir;\n"
-    "    vec3 t1 = (aabbMax - ray.origin) * invDir;\n"
+    "    vec3 t0 = aabbMin * terms.invDir - terms.originInvDir;\n"
+    "    vec3 t1 = aabbMax * terms.invDir - terms.originInvDir;\n"
     "\n"
     "    vec3 tmin = min(t0, t1);\n"
     "    vec3 tmax = max(t0, t1);\n"
@@ -428,13 +523,15 @@ inline constexpr const char* PATHTRACER_COMP =
     "    float tNear = max(max(tmin.x, tmin.y), tmin.z);\n"
     "    float tFar  = min(min(tmax.x, tmax.y), tmax.z);\n"
     "\n"
-    "    if (tFar < max(tNear, 0.0))\n"
+    "    if (tFar < max(tNear, 0.0) || tNear > tMax)\n"
     "        return INFINITY;\n"
     "\n"
     "    return tNear;\n"
     "}\n"
     "/**\n"
     " * @brief Function to traverse the BVH and find the closest intersection.\n"
+    " * @note Every box is tested once, by its parent, and the entry distance is kept on the stack\n"
+    " *       with the node. Popped nodes that start beyond the closest hit are skipped unread.\n"
     " * @param ray The ray to trace.\n"
     " * @return The closest hit record.\n"
     " */\n"
@@ -442,56 +539,84 @@ inline constexpr const char* PATHTRACER_COMP =
     "    HitRecord closest;\n"
     "    closest.t = INFINITY;\n"
     "    closest.hit = false;\n"
+    "    closest.barycentric = vec2(0.0);\n"
+    "    closest.idxTriangle = 0;\n"
+    "\n"
+    "    RayBoxTerms terms = getRayBoxTerms(ray);\n"
     "\n"
-    "    const int MAX_STACK = 64;\n"
-    "    int stack[MAX_STACK];\n"
+    "    int stackNodes[BVH_STACK_SIZE];\n"
+    "    float stackDists[BVH_STACK_SIZE];\n"
     "    int stackPtr = 0;\n"
     "\n"
-    "    stack[stackPtr++] = 0; // root\n"
+    "    float tRoot = hitAABB(\n"
+    "        terms,\n"
+    "        b_BVH.bvhNodes[0].aabbMin.xyz,\n"
+    "        b_BVH.bvhNodes[0].aabbMax.xyz,\n"
+    "        closest.t\n"
+    "    );\n"
+    "    if (tRoot == INFINITY)\n"
+    "        return closest;\n"
+    "    stackNodes[stackPtr] = 0;\n"
+    "    stackDists[stackPtr] = tRoot;\n"
+    "    stackPtr++;\n"
     "\n"
     "    while (stackPtr > 0) {\n"
-    "        int nodeIdx = stack[--stackPtr];\n"
-    "        BvhNode node = b_BVH.bvhNodes[nodeIdx];\n"
-    "\n"
-    "        float nodeHit = hitAABB(ray, node.aabbMin.xyz, node.aabbMax.xyz);\n"
-    "        if (nodeHit == INFINITY || nodeHit > closest.t)\n"
+    "        stackPtr--;\n"
+    "        if (stackDists[stackPtr] > closest.t)\n"
     "            continue;\n"
-    "\n"
-    "        if (node.leafFlag != 0) {\n"
-    "            Triangle tri = b_triangles.triangles[node.idxTriangle];\n"
-    "            HitRecord hit = hitTriangle(ray, tri);\n"
-    "\n"
-    "            if (hit.hit && hit.t < closest.t)\n"
-    "                closest = hit;\n"
+    "        int nodeIdx = stackNodes[stackPtr];\n"
+    "        g_statNodesVisited++;\n"
+    "\n"
+    "        // The box of the node was tested by its parent, only the links are read\n"
+    "        if (b_BVH.bvhNodes[nodeIdx].leafFlag != 0) {\n"
+    "            IntersectTriangle tri = b_intersect.triangles[b_BVH.bvhNodes[nodeIdx].idxTriangle];\n"
+    "            float t;\n"
+    "            vec2 barycentric;\n"
+    "            bool hit = hitTriangle(ray, tri, t, barycentric);\n"
+    "            g_statTriangleTests++;\n"
+    "\n"
+    "            if (hit && t < closest.t) {\n"
+    "                closest.hit = true;\n"
+    "                closest.t = t;\n"
+    "                closest.barycentric = barycentric;\n"
+    "                closest.idxTriangle = tri.idxTriangle;\n"
+    "            }\n"
     "        } else {\n"
+    "            uint rChildOffset = b_BVH.bvhNodes[nodeIdx].rChildOffset;\n"
     "            int leftChild  = nodeIdx + 1;\n"
-    "            int rightChild = int(nodeIdx + node.rChildOffset);\n"
+    "            int rightChild = nodeIdx + int(rChildOffset);\n"
     "\n"
     "            float tLeft = hitAABB(\n"
-    "                ray,\n"
+    "                terms,\n"
     "                b_BVH.bvhNodes[leftChild].aabbMin.xyz,\n"
-    "                b_BVH.bvhNodes[leftChild].aabbMax.xyz\n"
+    "                b_BVH.bvhNodes[leftChild].aabbMax.xyz,\n"
+    "                closest.t\n"
     "            );\n"
     "\n"
     "            float tRight = INFINITY;\n"
-    "            if (node.rChildOffset != 0) {\n"
+    "            if (rChildOffset != 0) {\n"
     "                tRight = hitAABB(\n"
-    "                    ray,\n"
+    "                    terms,\n"
     "                    b_BVH.bvhNodes[rightChild].aabbMin.xyz,\n"
-    "                    b_BVH.bvhNodes[rightChild].aabbMax.xyz\n"
+    "                    b_BVH.bvhNodes[rightChild].aabbMax.xyz,\n"
+    "                    closest.t\n"
     "                );\n"
     "            }\n"
     "\n"
-    "            if (tLeft < tRight) {\n"
-    "                if (tRight < INFINITY)\n"
-    "                    stack[stackPtr++] = rightChild;\n"
-    "                if (tLeft < INFINITY)\n"
-    "                    stack[stackPtr++] = leftChild;\n"
-    "            } else {\n"
-    "                if (tLeft < INFINITY)\n"
-    "                    stack[stackPtr++] = leftChild;\n"
-    "                if (tRight < INFINITY)\n"
-    "                    stack[stackPtr++] = rightChild;\n"
+    "            // Push the far child first so the near one is popped next, the right one on a tie\n"
+    "            int nearChild = tLeft < tRight ? leftChild : rightChild;\n"
+    "            int farChild = tLeft < tRight ? rightChild : leftChild;\n"
+    "            float tNear = min(tLeft, tRight);\n"
+    "            float tFar = max(tLeft, tRight);\n"
+    "            if (tFar < INFINITY) {\n"
+    "                stackNodes[stackPtr] = farChild;\n"
+    "                stackDists[stackPtr] = tFar;\n"
+    "                stackPtr++;\n"
+    "            }\n"
+    "            if (tNear < INFINITY) {\n"
+    "                stackNodes[stackPtr] = nearChild;\n"
+    "                stackDists[stackPtr] = tNear;\n"
+    "                stackPtr++;\n"
     "            }\n"
     "        }\n"
     "    }\n"
@@ -554,6 +679,7 @@ inline constexpr const char* PATHTRACER_COMP =
     "\n"
     "    while (bounces < u_scene.traceDepth) {\n"
     "        HitRecord hit = traverseBVH(newRay);\n"
+    "        g_statRays++;\n"
     "\n"
     "        // ===== MISS : use sky =====\n"
     "        if (!hit.hit) {\n"
@@ -566,17 +692,18 @@ inline constexpr const char* PATHTRACER_COMP =
     "        }\n"
     "\n"
     "        // ===== HIT =====\n"
+    "        HitAttributes attribs = getHitAttributes(newRay, hit);\n"
     "        vec3 p = newRay.origin + newRay.direction * hit.t;\n"
-    "        vec3 n = normalize(hit.normal);\n"
-    "        Material material = b_materials.materials[hit.idxMaterial];\n"
+    "        vec3 n = normalize(attribs.normal);\n"
+    "        Material material = b_materials.materials[attribs.idxMaterial];\n"
     "\n"
     "        // normal mapping\n"
     "        if ((material.flags & MATERIAL_NORMAL_MAP) != 0) {\n"
-    "            vec3 t = hit.tangent;\n"
+    "            vec3 t = attribs.tangent;\n"
     "            vec3 b = normalize(cross(n, t));\n"
     "            mat3 TBN = mat3(t, b, n);\n"
     "            vec3 nTex =\n"
-    "                sampleTexture(material.idxNormalTex, hit.texCoord).xyz * 2.0 - 1.0;\n"
+    "                sampleTexture(material.idxNormalTex, attribs.texCoord).xyz * 2.0 - 1.0;\n"
     "            n = normalize(TBN * nTex);\n"
     "        }\n"
     "\n"
@@ -588,7 +715,7 @@ inline constexpr const char* PATHTRACER_COMP =
     "\n"
     "        float temperature = material.temperature;\n"
     "        if ((material.flags & MATERIAL_TEMPERATURE_MAP) != 0)\n"
-    "            temperature = sampleTexture(material.idxTemperatureTex, hit.texCoord).r;\n"
+    "            temperature = sampleTexture(material.idxTemperatureTex, attribs.texCoord).r;\n"
     "\n"
     "        float blackbodyRadiance = bbp(temperature, b_waves.waveNumbers[idxWave]);\n"
     "        float emittedRadiance = spectralEmittance * blackbodyRadiance;\n"
@@ -600,7 +727,7 @@ inline constexpr const char* PATHTRACER_COMP =
     "\n"
     "        if (material.type == MATERIAL_TYPE_DIFFUSE) {\n"
     "            float pdf = 0.0;\n"
-    "            vec3 wo = cosineSampleHemisphere(n, pdf);\n"
+    "            wo = cosineSampleHemisphere(n, pdf);\n"
     "            float cosTheta = max(dot(wo, n), 0.0);\n"
     "            float brdf = 1.0 / PI;\n"
     "            throughput *= brdf * cosTheta / pdf;\n"
@@ -608,7 +735,7 @@ inline constexpr const char* PATHTRACER_COMP =
     "        else if (material.type == MATERIAL_TYPE_GLOSSY) {\n"
     "            float roughness = material.roughness;\n"
     "            if ((material.flags & MATERIAL_ROUGHNESS_MAP) != 0)\n"
-    "                roughness = sampleTexture(material.idxRoughnessTex, hit.texCoord).r;\n"
+    "                roughness = sampleTexture(material.idxRoughnessTex, attribs.texCoord).r;\n"
     "            float alpha = roughness * roughness;\n"
     "\n"
     "            vec3 V = -wi;\n"
@@ -639,7 +766,8 @@ inline constexpr const char* PATHTRACER_COMP =
     "        }\n"
     "        else if (material.type == MATERIAL_TYPE_TRANSLUCENT) {\n"
     "            wo = sampleGlass(wi, n, inside, material.ior);\n"
-    "            if (inside)\n"
+    "            // Refracted rays continue below the surface, whether they enter or leave\n"
+    "            if (dot(wo, n) < 0.0)\n"
     "                p -= n * EPS * 2.0;\n"
     "        }\n"
     "        else // specular\n"
@@ -652,8 +780,10 @@ inline constexpr const char* PATHTRACER_COMP =
     "        // Russian roulette\n"
     "        if (bounces > 3) {\n"
     "            float p = clamp(throughput, 0.05, 0.95);\n"
-    "            if (rand() > p)\n"
+    "            if (rand() > p) {\n"
+    "                g_statRrTerminations++;\n"
     "                break;\n"
+    "            }\n"
     "            throughput /= p;\n"
     "        }\n"
     "    }\n"
@@ -710,12 +840,25 @@ inline constexpr const char* PATHTRACER_COMP =
     "        int bufferIndex = i * waveBlockSize + pixelIndex;\n"
     "\n"
     "        float contribution = (i == idxWave) ? radiance : 0.0;\n"
-    "        float oldValue = b_outRadiances.radiances[bufferIndex];\n"
+    "        // The output buffer lives in device-local memory and starts out uninitialized\n"
+    "        float oldValue =\n"
+    "            u_scene.currentSample > 1 ? b_outRadiances.radiances[bufferIndex] : 0.0;\n"
     "        float newValue = oldValue * float(u_scene.currentSample - 1) + contribution;\n"
     "        newValue /= float(u_scene.currentSample);\n"
     "\n"
     "        b_outRadiances.radiances[bufferIndex] = newValue;\n"
     "    }\n"
+    "\n"
+    "    // Sampling a subset of the pixels keeps the counters from overflowing and contending\n"
+    "    bool statsPixel = pixel.x % STATS_PIXEL_STRIDE == 0 && pixel.y % STATS_PIXEL_STRIDE == 0;\n"
+    "    if (u_scene.collectStats != 0 && statsPixel) {\n"
+    "        atomicAdd(b_stats.paths, 1u);\n"
+    "        atomicAdd(b_stats.rays, g_statRays);\n"
+    "        atomicAdd(b_stats.rrTerminations, g_statRrTerminations);\n"
+    "        atomicAdd(b_stats.nodesVisited, g_statNodesVisited);\n"
+    "        atomicAdd(b_stats.triangleTests, g_statTriangleTests);\n"
+    "        atomicAdd(b_stats.boxTests, g_statBoxTests);\n"
+    "    }\n"
     "}\n"
     "";
 
@@ -5,8 +5,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <mutex>
 #include <set>
-#include <regex>
 #include <sstream>
 #include <vector>
 
@@ -14,8 +17,36 @@
 
 namespace ShaderStrings {
 
+/**
+ * @brief Hash a string with 64-bit FNV-1a.
+ * @param data The string to hash.
+ * @return The hash value.
+ */
+inline uint64_t hashSource(const std::string& data) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : data) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Get the source string number used in #line directives for a shader file.
+ * @param name The path of the shader file.
+ * @return The number, derived from the path so it is the same in every run. The root file
+ *         of a shader keeps number 0.
+ */
+inline int getSourceId(const std::string& name) {
+    return 1 + static_cast<int>(hashSource(name) % 99999);
+}
+
 /**
  * @brief Class to resolve #include directives in shader strings.
+ * @note Directives are found with a single pass over the lines of each file. Files are
+ *       expanded once and memoized by the hash of their path and content, shared by all
+ *       resolvers and threads. Every included file is wrapped in #line directives with its
+ *       source string number, see getSourceId() and mapSourceNames().
  */
 class IncludeResolver {
 public:
@@ -26,126 +57,179 @@ public:
      */
     std::string resolve(const std::string& filePath) {
         m_processingFiles.clear();
-        return resolveImpl(filePath);
+        return resolveImpl(filePath, ShaderStrings::get(filePath), true);
     }
 
 private:
+    /**
+     * @brief Expansion of an included file, shared by all resolvers.
+     */
+    struct Cache {
+        std::mutex mutex; // Guards the members
+        std::unordered_map<uint64_t, std::string> expanded = {}; // Expanded files by hash
+        std::unordered_map<int, std::string> names = {}; // File paths by source string number
+    };
+
+    static Cache& getCache() {
+        static Cache cache;
+        return cache;
+    }
+
     /**
      * @brief Internal implementation to resolve includes recursively.
      * @param filePath The path of the shader file to resolve.
-     * @param baseLineNumber The base line number for line directives.
+     * @param content The content of the shader file.
+     * @param root Whether the file is the shader itself rather than an included file.
      * @return The resolved shader string.
      */
-    std::string resolveImpl(const std::string& filePath, int baseLineNumber = 1) {
+    std::string resolveImpl(const std::string& filePath, const std::string& content, bool root) {
+        // Included files expand the same wherever they are included, the root file differs
+        // only in numbering its lines as source string 0
+        uint64_t key = hashSource(content) ^ (hashSource(filePath) * 31 + (root ? 1 : 0));
+        Cache& cache = getCache();
+        {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            auto it = cache.expanded.find(key);
+            if (it != cache.expanded.end())
+                return it->second;
+        }
+
         // Detect circular dependencies
         if (m_processingFiles.find(filePath) != m_processingFiles.end())
             return "// Circular dependency detected for: " + filePath + "\n";
         m_processingFiles.insert(filePath);
 
-        try {
-            std::string content = ShaderStrings::get(filePath);
-            std::regex includePattern("#include\\s*\"([^\"]+)\"");
-            std::smatch match;
-
-            std::ostringstream result;
-            size_t lastPos = 0;
-            auto searchStart = content.cbegin();
-            int currentLine = baseLineNumber;
-
-            // Helper to count lines in a substring
-            auto countLines = [](const std::string& str, size_t start, size_t end) -> int {
-                if (start >= end)
-                    return 0;
-                return std::count(str.begin() + start, str.begin() + end, '\n');
-                };
-
-            // Helper to normalize paths
-            auto normalizePath = [](const std::string& basePath, const std::string& relativePath) {
-                if (relativePath.empty())
-                    return std::string();
-
-                std::string base = basePath;
-                std::string rel = relativePath;
-
-                // Remove filename from base path
-                size_t lastSlash = base.find_last_of('/');
-                if (lastSlash != std::string::npos)
-                    base = base.substr(0, lastSlash + 1);
-                else
-                    base = "";
+        int sourceId = root ? 0 : getSourceId(filePath);
+        std::string result;
+        result.reserve(content.size());
+        size_t lineStart = 0;
+        int lineNumber = 1;
+        while (lineStart < content.size()) {
+            size_t lineEnd = content.find('\n', lineStart);
+            size_t next = lineEnd == std::string::npos ? content.size() : lineEnd + 1;
 
-                // Resolve ../ in relative path
-                while (rel.find("../") == 0) {
-                    // Remove ../ from the beginning
-                    rel = rel.substr(3);
-
-                    // Go up one directory in base path
-                    if (!base.empty()) {
-                        size_t slash = base.find_last_of('/', base.length() - 2);
-                        if (slash != std::string::npos)
-                            base = base.substr(0, slash + 1);
-                        else
-                            base = "";
+            std::string includedFile;
+            if (!parseInclude(content, lineStart, next, includedFile)) {
+                result.append(content, lineStart, next - lineStart);
+            } else {
+                std::string resolvedPath = normalizePath(filePath, includedFile);
+                std::string includedContent =
+                    resolvedPath.empty() ? std::string() : ShaderStrings::get(resolvedPath);
+                if (includedContent.empty()) {
+                    // Keep the directive so the compiler reports the missing file
+                    result.append(content, lineStart, next - lineStart);
+                    if (lineEnd == std::string::npos)
+                        result += '\n';
+                    result += "// Error: Failed to include '" + includedFile + "'\n";
+                } else {
+                    int includedId = getSourceId(resolvedPath);
+                    {
+                        std::lock_guard<std::mutex> lock(cache.mutex);
+                        cache.names[includedId] = resolvedPath;
                     }
+                    result += "#line 1 " + std::to_string(includedId) + "\n";
+                    result += resolveImpl(resolvedPath, includedContent, false);
+                    if (result.back() != '\n')
+                        result += '\n';
                 }
+                // Continue after the directive in the including file
+                result += "#line " + std::to_string(lineNumber + 1) + " " +
+                    std::to_string(sourceId) + "\n";
+            }
 
-                return base + rel;
-                };
+            lineStart = next;
+            lineNumber++;
+        }
 
-            // Process all #include directives
-            while (std::regex_search(searchStart, content.cend(), match, includePattern)) {
-                size_t matchPos = match.position() + (searchStart - content.cbegin());
-                int linesBeforeMatch = countLines(content, lastPos, matchPos);
+        m_processingFiles.erase(filePath);
+        {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            cache.expanded.emplace(key, result);
+        }
+        return result;
+    }
 
-                // Append content before the match
-                result << content.substr(lastPos, matchPos - lastPos);
+    /**
+     * @brief Parse an #include directive.
+     * @param content The content of the file.
+     * @param begin Start of the line.
+     * @param end End of the line.
+     * @param[out] includedFile The path in quotes if the line is an #include directive.
+     * @return True if the line is an #include directive, false otherwise.
+     */
+    static bool parseInclude(
+        const std::string& content,
+        size_t begin,
+        size_t end,
+        std::string& includedFile
+    ) {
+        auto skipSpaces = [&content, end](size_t pos) {
+            while (pos < end && (content[pos] == ' ' || content[pos] == '\t'))
+                pos++;
+            return pos;
+            };
 
-                std::string includedFile = match[1].str();
-                std::string resolvedPath = normalizePath(filePath, includedFile);
-                int includeLineNumber = currentLine + linesBeforeMatch;
-
-                if (!resolvedPath.empty()) {
-                    try {
-                        // Add line directive before including file
-                        result << "#line 1 \"" << includedFile << "\"\n";
-
-                        // Recursively resolve included file
-                        std::string includedContent = resolveImpl(resolvedPath, 1);
-                        result << includedContent;
-
-                        // Add line directive after including file
-                        result << "#line " << (includeLineNumber + 1) << "\n";
-
-                    } catch (const std::exception& e) {
-                        // Inclusion failed, output error comment
-                        result << match.str();
-                        result << "\n// Error: Failed to include '" << includedFile << "': ";
-                        result << e.what() << "\n";
-                        result << "#line " << (includeLineNumber + 1) << "\n";
-                    }
-                } else {
-                    // Could not resolve path
-                    result << match.str();
-                    result << "\n#line " << (includeLineNumber + 1) << "\n";
-                }
+        static constexpr const char* DIRECTIVE = "include";
+        static constexpr size_t DIRECTIVE_LENGTH = 7;
+        size_t pos = skipSpaces(begin);
+        if (pos >= end || content[pos] != '#')
+            return false;
+        pos = skipSpaces(pos + 1);
+        if (end - pos < DIRECTIVE_LENGTH || content.compare(pos, DIRECTIVE_LENGTH, DIRECTIVE))
+            return false;
+        pos = skipSpaces(pos + DIRECTIVE_LENGTH);
+        if (pos >= end || content[pos] != '"')
+            return false;
+        size_t nameEnd = content.find('"', pos + 1);
+        if (nameEnd == std::string::npos || nameEnd >= end)
+            return false;
+        includedFile = content.substr(pos + 1, nameEnd - pos - 1);
+        return true;
+    }
 
-                lastPos = matchPos + match.length();
-                searchStart = content.cbegin() + lastPos;
-                currentLine = includeLineNumber + 1;
-            }
+    /**
+     * @brief Resolve the path of an included file.
+     * @param basePath The path of the including file.
+     * @param relativePath The path in the #include directive.
+     * @return The path of the included file, empty if invalid.
+     */
+    static std::string normalizePath(
+        const std::string& basePath,
+        const std::string& relativePath
+    ) {
+        if (relativePath.empty())
+            return std::string();
+
+        std::string base = basePath;
+        std::string rel = relativePath;
 
-            // Append remaining content
-            result << content.substr(lastPos);
-            m_processingFiles.erase(filePath);
+        // Remove filename from base path
+        size_t lastSlash = base.find_last_of('/');
+        if (lastSlash != std::string::npos)
+            base = base.substr(0, lastSlash + 1);
+        else
+            base = "";
 
-            return result.str();
+        // Resolve ../ in relative path
+        while (rel.find("../") == 0) {
+            // Remove ../ from the beginning
+            rel = rel.substr(3);
 
-        } catch (...) {
-            m_processingFiles.erase(filePath);
+            // Go up one directory in base path
+            if (!base.empty()) {
+                size_t slash = base.find_last_of('/', base.length() - 2);
+                if (slash != std::string::npos)
+                    base = base.substr(0, slash + 1);
+                else
+                    base = "";
+            }
         }
-        return "// Error: Failed to include file: " + filePath + "\n";
+
+        return base + rel;
     }
 
+    friend std::string mapSourceNames(const std::string& log);
+
 private:
     // Set of files currently being processed to detect circular dependencies
     std::set<std::string> m_processingFiles = {};
@@ -161,4 +245,85 @@ inline std::string getResolved(const std::string& name) {
     return resolver.resolve(name);
 }
 
+/**
+ * @brief Add #define directives to a resolved shader string.
+ * @param source The shader string, starting with or containing a #version directive.
+ * @param defines The macro names and values to define.
+ * @return The shader string with the defines after the #version directive, followed by a
+ *         #line directive so the compiler still reports the original line numbers.
+ */
+inline std::string addDefines(
+    const std::string& source,
+    const std::vector<std::pair<std::string, std::string>>& defines
+) {
+    // The #version directive must stay the first one, comments may precede it
+    size_t versionPos = source.find("#version");
+    if (versionPos == std::string::npos || defines.empty())
+        return source;
+    size_t lineEnd = source.find('\n', versionPos);
+    if (lineEnd == std::string::npos)
+        lineEnd = source.size();
+    int versionLine =
+        1 + static_cast<int>(std::count(source.begin(), source.begin() + versionPos, '\n'));
+
+    std::string result = source.substr(0, lineEnd);
+    result += '\n';
+    for (const auto& define : defines)
+        result += "#define " + define.first + " " + define.second + "\n";
+    result += "#line " + std::to_string(versionLine + 1) + " 0\n";
+    if (lineEnd < source.size())
+        result.append(source, lineEnd + 1, std::string::npos);
+    return result;
+}
+
+/**
+ * @brief Replace the source string numbers of included files in a compiler log with their
+ *        paths, e.g. "ERROR: 4242:12:" becomes "ERROR: common.glsl:12:". Only the field
+ *        following an "ERROR: " or "WARNING: " prefix is replaced.
+ * @param log The compiler log.
+ * @return The log with known numbers replaced.
+ */
+inline std::string mapSourceNames(const std::string& log) {
+    IncludeResolver::Cache& cache = IncludeResolver::getCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (cache.names.empty())
+        return log;
+
+    // Only the source string field right after the message prefix is a number to replace, the
+    // line number following it may equal a source string number as well
+    static constexpr const char* PREFIXES[] = { "ERROR: ", "WARNING: " };
+    std::string result;
+    result.reserve(log.size());
+    size_t pos = 0;
+    while (pos < log.size()) {
+        size_t fieldStart = std::string::npos;
+        for (const char* prefix : PREFIXES) {
+            size_t length = std::char_traits<char>::length(prefix);
+            if (!log.compare(pos, length, prefix)) {
+                fieldStart = pos + length;
+                break;
+            }
+        }
+        if (fieldStart == std::string::npos) {
+            result += log[pos++];
+            continue;
+        }
+
+        size_t digitsEnd = fieldStart;
+        while (digitsEnd < log.size() && std::isdigit(static_cast<unsigned char>(log[digitsEnd])))
+            digitsEnd++;
+        result.append(log, pos, fieldStart - pos);
+        pos = fieldStart;
+        if (digitsEnd > fieldStart && digitsEnd - fieldStart < 9 && digitsEnd < log.size() &&
+            log[digitsEnd] == ':') {
+            auto it = cache.names.find(std::stoi(log.substr(fieldStart, digitsEnd - fieldStart)));
+            if (it != cache.names.end()) {
+                result += it->second;
+                pos = digitsEnd;
+            }
+        }
+    }
+    return result;
+}
+
 }
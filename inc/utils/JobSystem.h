@@ -0,0 +1,216 @@
+/**
+ * @file JobSystem.h
+ * @brief Header file for the JobSystem class.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "UtilsCommon.h"
+
+/**
+ * @brief Priority of a job.
+ */
+enum class JobPriority {
+    INTERACTIVE, // Work the user is waiting for, always picked first
+    BACKGROUND, // Work that may lag behind, e.g. caching or prefetching
+};
+
+/**
+ * @brief Token for cancelling jobs.
+ * @note Copies share the cancellation state. Cancelled jobs that have not started are skipped,
+ *       running jobs may poll isCancelled() to stop early.
+ */
+class JobCancelToken {
+public:
+    JobCancelToken() : m_cancelled(std::make_shared<std::atomic<bool>>(false)) {};
+
+    /**
+     * @brief Cancel the jobs holding this token.
+     */
+    void cancel() { m_cancelled->store(true, std::memory_order_release); };
+    /**
+     * @brief Check if the token has been cancelled.
+     * @return True if cancelled, false otherwise.
+     */
+    bool isCancelled() const { return m_cancelled->load(std::memory_order_acquire); };
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled; // Shared cancellation state
+};
+
+/**
+ * @brief A job scheduled on the job system.
+ */
+class Job_T {
+public:
+    /**
+     * @brief Check if the job has finished or has been skipped.
+     * @return True if the job is done, false otherwise.
+     */
+    bool isDone() const { return m_done.load(std::memory_order_acquire); };
+
+private:
+    friend class JobSystem;
+
+    std::function<void()> m_func = nullptr; // Work of the job
+    JobPriority m_priority = JobPriority::INTERACTIVE; // Priority of the job
+    JobCancelToken m_token; // Token checked before the job starts
+    std::atomic<int> m_nPendingDeps{ 0 }; // Unfinished dependencies, queued at 0
+    std::atomic<bool> m_done{ false }; // Whether the job is done
+    std::mutex m_mutex; // Guards m_dependents
+    std::vector<std::shared_ptr<Job_T>> m_dependents = {}; // Jobs waiting for this one
+};
+using Job = std::shared_ptr<Job_T>;
+
+/**
+ * @brief Work-stealing job system shared across the application.
+ * @note Each worker owns a queue per priority. Workers take their newest jobs first and steal
+ *       the oldest jobs of other workers when they run dry. Threads waiting for a job run
+ *       queued jobs meanwhile, so jobs may wait for other jobs without blocking a worker.
+ */
+class JobSystem {
+private:
+    JobSystem() = default;
+    ~JobSystem() { term(); };
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+
+public:
+    static JobSystem& instance() {
+        static JobSystem instance;
+        return instance;
+    };
+
+    /**
+     * @brief Start the worker threads, called implicitly by the first submission.
+     * @param nWorkers Number of workers, 0 for one less than the hardware threads.
+     */
+    void init(int nWorkers = 0);
+    /**
+     * @brief Finish the queued jobs and stop the worker threads.
+     */
+    void term();
+    /**
+     * @brief Get the number of worker threads.
+     * @return Number of workers.
+     */
+    int getWorkerCount() const;
+
+    /**
+     * @brief Submit a job.
+     * @param func Work of the job.
+     * @param priority Priority of the job.
+     * @param dependencies Jobs that must be done before this job starts.
+     * @param token Token for cancelling the job.
+     * @return The submitted job.
+     */
+    Job submit(
+        const std::function<void()>& func,
+        JobPriority priority = JobPriority::INTERACTIVE,
+        const std::vector<Job>& dependencies = {},
+        const JobCancelToken& token = JobCancelToken()
+    );
+    /**
+     * @brief Wait until a job is done, running queued jobs meanwhile.
+     * @param job The job to wait for.
+     */
+    void wait(const Job& job);
+    /**
+     * @brief Wait until all given jobs are done, running queued jobs meanwhile.
+     * @param jobs The jobs to wait for.
+     */
+    void waitAll(const std::vector<Job>& jobs);
+    /**
+     * @brief Run a function over a range split into chunks, returns when all chunks are done.
+     * @param begin First index of the range.
+     * @param end One past the last index of the range.
+     * @param grainSize Minimum number of indices per chunk, 0 to pick one from the range.
+     * @param func Function called with the [begin, end) bounds of each chunk.
+     * @param priority Priority of the chunks.
+     * @param token Token for cancelling the chunks that have not started.
+     */
+    void parallelFor(
+        size_t begin,
+        size_t end,
+        size_t grainSize,
+        const std::function<void(size_t, size_t)>& func,
+        JobPriority priority = JobPriority::INTERACTIVE,
+        const JobCancelToken& token = JobCancelToken()
+    );
+
+    /**
+     * @brief Queue a function to run on the main thread, may be called from any thread.
+     * @param func The function, e.g. a UI or DB update with the result of a job.
+     */
+    void postToMainThread(const std::function<void()>& func);
+    /**
+     * @brief Run the functions queued for the main thread, called by the main thread only.
+     * @return Number of functions run.
+     */
+    int runMainThreadTasks();
+    /**
+     * @brief Set a function called when work is posted to the main thread.
+     * @param func The function, e.g. waking up the main loop to draw a frame.
+     */
+    void setMainThreadWakeup(const std::function<void()>& func);
+
+private:
+    static constexpr int N_PRIORITIES = 2; // Number of job priorities
+
+    /**
+     * @brief Job queues of a worker.
+     */
+    struct Worker {
+        std::mutex mutex; // Guards the queues
+        std::array<std::deque<Job>, N_PRIORITIES> queues = {}; // Queues by priority
+    };
+
+    /**
+     * @brief Queue a job whose dependencies are done.
+     * @param job The job.
+     */
+    void enqueue(const Job& job);
+    /**
+     * @brief Take a queued job, own queues first, then from other workers.
+     * @param workerIndex Index of the calling worker, -1 for other threads.
+     * @return The job, or nullptr if all queues are empty.
+     */
+    Job dequeue(int workerIndex);
+    /**
+     * @brief Run a job and release the jobs depending on it.
+     * @param job The job.
+     */
+    void execute(const Job& job);
+    /**
+     * @brief Main loop of a worker thread.
+     * @param workerIndex Index of the worker.
+     */
+    void workerLoop(int workerIndex);
+
+private:
+    std::mutex m_initMutex; // Guards starting and stopping the workers
+    std::vector<std::unique_ptr<Worker>> m_workers = {}; // Queues of the workers
+    std::vector<std::thread> m_threads = {}; // Worker threads
+    std::atomic<bool> m_running{ false }; // Whether the workers are running
+    std::atomic<uint32_t> m_nextWorker{ 0 }; // Worker receiving the next outside submission
+
+    std::mutex m_sleepMutex; // Guards sleeping and waking up threads
+    std::condition_variable m_workCv; // Notified when a job is queued
+    std::condition_variable m_doneCv; // Notified when a job is done and threads wait for jobs
+    std::atomic<int> m_nQueued{ 0 }; // Number of queued jobs
+    std::atomic<int> m_nSleeping{ 0 }; // Number of workers sleeping for lack of jobs
+    std::atomic<int> m_nWaiters{ 0 }; // Number of threads waiting in wait()
+
+    std::mutex m_mainThreadMutex; // Guards the main thread queue
+    std::vector<std::function<void()>> m_mainThreadTasks = {}; // Functions for the main thread
+    std::function<void()> m_mainThreadWakeup = nullptr; // Called when a function is posted
+};
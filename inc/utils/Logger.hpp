@@ -1,39 +1,219 @@
 /**
  * @file Logger.hpp
- * @brief A simple logger class for accumulating and outputting debug log messages.
+ * @brief Leveled logger writing through a lock-free queue to a background sink thread.
  */
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
 #include "UtilsCommon.h"
 
 /**
- * @brief A simple logger class that accumulates and outputs debug log messages.
+ * @brief Severity levels of log messages.
+ */
+enum class LogLevel {
+    DEBUG = 0, // Details for developers
+    INFO, // Progress of long operations and notable events
+    WARN, // Unexpected states the application recovers from
+    ERR, // Failed operations
+    OFF, // Filter level that drops all messages
+};
+
+/**
+ * @brief Background sink receiving the messages of all threads.
+ * @note Messages are queued in a bounded lock-free ring and written to rotating log files by
+ *       the sink thread, debug builds also echo them to stdout. Messages queued before init()
+ *       are written once the sink starts. When the ring is full messages are dropped and
+ *       counted rather than blocking the caller.
+ */
+class LogSink {
+private:
+    LogSink();
+    ~LogSink() { term(); };
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+    LogSink(LogSink&&) = delete;
+    LogSink& operator=(LogSink&&) = delete;
+
+public:
+    static LogSink& instance() {
+        static LogSink instance;
+        return instance;
+    };
+
+    static constexpr size_t MAX_MESSAGE_SIZE = 256; // Longer messages are truncated
+
+    /**
+     * @brief Start the sink thread.
+     * @param directory Directory of the log files, empty to only echo to stdout.
+     * @param baseName Name of the current log file, rotated files get a .1, .2... suffix.
+     * @param maxFileSize Size in bytes after which the file is rotated.
+     * @param maxFiles Number of rotated files kept besides the current one.
+     * @return 0 on success, non-zero if the log file cannot be opened.
+     */
+    int init(
+        const std::string& directory,
+        const std::string& baseName,
+        size_t maxFileSize = 4 * 1024 * 1024,
+        int maxFiles = 3
+    );
+    /**
+     * @brief Write the queued messages and stop the sink thread.
+     */
+    void term();
+
+    /**
+     * @brief Set the minimum level of messages of modules without their own filter.
+     * @param level The minimum level.
+     */
+    void setLevel(LogLevel level);
+    /**
+     * @brief Set the minimum level of messages of a module.
+     * @param module Name of the module, must outlive the sink.
+     * @param level The minimum level.
+     * @return 0 on success, non-zero if there are too many module filters.
+     */
+    int setModuleLevel(const char* module, LogLevel level);
+    /**
+     * @brief Parse filters from a string and apply them.
+     * @param filters Comma-separated filters, a level alone sets the default level and
+     *                module=level sets the level of a module, e.g. "warn,path_tracer=debug".
+     */
+    void setFilters(const std::string& filters);
+    /**
+     * @brief Check if messages of a level and module pass the filters.
+     * @param level Level of the message.
+     * @param module Name of the module, null for none.
+     * @return True if the message is logged, false otherwise.
+     */
+    bool isEnabled(LogLevel level, const char* module) const;
+
+    /**
+     * @brief Queue a formatted message, called by Logger.
+     * @param level Level of the message.
+     * @param module Name of the module, must outlive the sink, null for none.
+     * @param text Text of the message, truncated to MAX_MESSAGE_SIZE.
+     * @param length Length of the text.
+     */
+    void push(LogLevel level, const char* module, const char* text, size_t length);
+    /**
+     * @brief Get the number of messages dropped because the queue was full.
+     * @return Number of dropped messages.
+     */
+    uint64_t getDroppedCount() const;
+
+private:
+    static constexpr size_t QUEUE_SIZE = 2048; // Slots of the ring, a power of two
+    static constexpr int MAX_MODULE_FILTERS = 16; // Module filters that may be set
+
+    /**
+     * @brief Slot of the ring.
+     * @note A slot is writable when its sequence equals the enqueue position and readable
+     *       when it equals the position plus one.
+     */
+    struct Slot {
+        std::atomic<size_t> sequence{ 0 }; // Sequence number of the slot
+        LogLevel level = LogLevel::INFO; // Level of the message
+        const char* module = nullptr; // Module of the message
+        int64_t time = 0; // System time of the message in milliseconds
+        uint32_t thread = 0; // Index of the thread that logged the message
+        uint32_t length = 0; // Length of the text
+        char text[MAX_MESSAGE_SIZE] = {}; // Text of the message
+    };
+    /**
+     * @brief Filter of a module.
+     */
+    struct ModuleFilter {
+        std::atomic<const char*> module{ nullptr }; // Name of the module, null if unused
+        std::atomic<int> level{ 0 }; // Minimum level
+    };
+
+    /**
+     * @brief Main loop of the sink thread.
+     */
+    void sinkLoop();
+    /**
+     * @brief Wake the sink thread before its flush interval ends.
+     */
+    void wakeSink();
+    /**
+     * @brief Write the queued messages.
+     * @return Number of messages written.
+     */
+    size_t drain();
+    /**
+     * @brief Write a line to the outputs, rotating the log file if needed.
+     * @param line The line, without the trailing newline.
+     */
+    void writeLine(const std::string& line);
+    /**
+     * @brief Rotate the log files and open a new current file.
+     */
+    void rotate();
+
+private:
+    std::unique_ptr<std::array<Slot, QUEUE_SIZE>> m_slots; // Ring of queued messages
+    std::atomic<size_t> m_enqueuePos{ 0 }; // Next position written by the producers
+    size_t m_dequeuePos = 0; // Next position read by the sink thread
+    std::atomic<uint64_t> m_dropped{ 0 }; // Number of messages dropped on a full ring
+
+    std::atomic<int> m_level{ static_cast<int>(LogLevel::INFO) }; // Default minimum level
+    std::array<ModuleFilter, MAX_MODULE_FILTERS> m_moduleFilters = {}; // Module filters
+    std::mutex m_filterMutex; // Serializes adding module filters
+
+    std::thread m_thread; // Sink thread
+    std::atomic<bool> m_running{ false }; // Whether the sink thread runs
+    std::mutex m_wakeMutex; // Guards waking up the sink thread
+    std::condition_variable m_wakeCv; // Wakes the sink thread early for errors and on exit
+    std::atomic<bool> m_wakeRequested{ false }; // Whether the sink thread has been woken up
+
+    std::filesystem::path m_directory = {}; // Directory of the log files
+    std::string m_baseName = {}; // Name of the current log file
+    size_t m_maxFileSize = 0; // Size after which the file is rotated
+    int m_maxFiles = 0; // Number of rotated files kept
+    std::ofstream m_file; // Current log file
+    size_t m_fileSize = 0; // Bytes written to the current log file
+    uint64_t m_reportedDrops = 0; // Dropped messages already reported in the log
+};
+
+/**
+ * @brief A log message, queued to the LogSink when it goes out of scope.
  * @note Usage: Logger() << "Message part 1" << "Message part 2";
+ *       Logger(LogLevel::INFO, "scene") << "Loaded " << n << " models";
+ *       The text is only formatted if the level and module pass the filters, into a buffer
+ *       reused by the calling thread.
  */
 class Logger {
 public:
-    Logger() = default;
-    ~Logger() {
-#ifdef _DEBUG
-        std::cout << m_buffer.str() << std::endl;
-#endif
-    }
+    /**
+     * @param level Level of the message, messages without a level are errors.
+     * @param module Name of the module for filtering, must outlive the sink, null for none.
+     */
+    explicit Logger(LogLevel level = LogLevel::ERR, const char* module = nullptr);
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
 
     template<typename T>
     Logger& operator<<(const T& msg) {
-#ifdef _DEBUG
-        m_buffer << msg;
-#endif
+        if (m_stream)
+            *m_stream << msg;
         return *this;
     }
     Logger& operator<<(std::ostream& (*manip)(std::ostream&)) {
-#ifdef _DEBUG
-        manip(m_buffer);
-#endif
+        if (m_stream)
+            manip(*m_stream);
         return *this;
     }
 
 private:
-    std::stringstream m_buffer; // Buffer to hold log messages
+    LogLevel m_level = LogLevel::ERR; // Level of the message
+    const char* m_module = nullptr; // Module of the message
+    std::ostream* m_stream = nullptr; // Stream of the thread buffer, null if filtered out
+    size_t m_offset = 0; // Start of this message in the thread buffer
 };
@@ -0,0 +1,201 @@
+/**
+ * @file MemoryTracker.h
+ * @brief Header file for the MemoryTracker class and the TrackedMemory handle.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include "UtilsCommon.h"
+
+/**
+ * @brief Subsystems memory is attributed to.
+ */
+enum class MemoryTag {
+    DB_OBJECTS = 0, // Objects of the scene database
+    DB_HISTORY, // Undo and redo stacks of the scene database
+    MESH, // Meshes loaded from model files
+    BVH, // BVH nodes and build state
+    SCENE_BUFFERS, // Path tracer scene data before upload
+    TEXTURES, // Texture pixels before upload
+    GPU_VERTEX_BUFFERS, // Vertex buffers of all renderers
+    GPU_INDEX_BUFFERS, // Index buffers of all renderers
+    GPU_UNIFORM_BUFFERS, // Uniform buffers of all renderers, with their per-frame copies
+    GPU_STORAGE_BUFFERS, // Storage buffers of all renderers
+    GPU_TEXTURES, // Sampled images of all renderers
+    GPU_RENDER_TARGETS, // Attachments of all renderers
+    GPU_STORAGE_IMAGES, // Storage images of all renderers
+    COUNT,
+};
+
+/**
+ * @brief Memory attributed to a tag.
+ */
+struct MemoryTagStats {
+    uint64_t bytes = 0; // Bytes currently held
+    uint64_t peakBytes = 0; // Highest number of bytes held since startup
+    uint64_t count = 0; // Number of live allocations
+};
+
+/**
+ * @brief Accounts memory by subsystem.
+ * @note Allocations are reported where their size is known, tags whose owners keep their own
+ *       counters (the database, the graphics backends) are sampled into the tracker with set().
+ *       All functions are lock-free.
+ */
+class MemoryTracker {
+private:
+    MemoryTracker() = default;
+    ~MemoryTracker() = default;
+    MemoryTracker(const MemoryTracker&) = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+    MemoryTracker(MemoryTracker&&) = delete;
+    MemoryTracker& operator=(MemoryTracker&&) = delete;
+
+public:
+    static MemoryTracker& instance() {
+        static MemoryTracker instance;
+        return instance;
+    };
+
+    static constexpr size_t N_TAGS = static_cast<size_t>(MemoryTag::COUNT); // Number of tags
+
+    /**
+     * @brief Count a new allocation.
+     * @param tag The tag of the allocation.
+     * @param bytes Size of the allocation in bytes.
+     */
+    void add(MemoryTag tag, uint64_t bytes);
+    /**
+     * @brief Remove a freed allocation.
+     * @param tag The tag of the allocation.
+     * @param bytes Size of the allocation in bytes, as added.
+     */
+    void remove(MemoryTag tag, uint64_t bytes);
+    /**
+     * @brief Update the size of a live allocation.
+     * @param tag The tag of the allocation.
+     * @param oldBytes Previous size in bytes.
+     * @param newBytes New size in bytes.
+     */
+    void resize(MemoryTag tag, uint64_t oldBytes, uint64_t newBytes);
+    /**
+     * @brief Replace the stats of a tag sampled from another counter.
+     * @param tag The tag.
+     * @param stats The sampled stats, the peak is kept if it is higher.
+     */
+    void set(MemoryTag tag, const MemoryTagStats& stats);
+
+    /**
+     * @brief Get the stats of a tag.
+     * @param tag The tag.
+     * @return The stats of the tag.
+     */
+    MemoryTagStats getStats(MemoryTag tag) const;
+    /**
+     * @brief Get the name of a tag.
+     * @param tag The tag.
+     * @return The name, e.g. "gpu.textures".
+     */
+    static const char* getTagName(MemoryTag tag);
+    /**
+     * @brief Check if a tag counts device memory.
+     * @param tag The tag.
+     * @return True for GPU tags, false for host memory.
+     */
+    static bool isGpuTag(MemoryTag tag);
+    /**
+     * @brief Format a size for reports.
+     * @param bytes The size in bytes.
+     * @return The size in B, KiB, MiB or GiB.
+     */
+    static std::string formatBytes(uint64_t bytes);
+
+    /**
+     * @brief Write the stats of all tags as a text table.
+     * @param filename Path of the file to write.
+     * @return 0 on success, non-zero on failure.
+     */
+    int writeReport(const std::string& filename) const;
+
+private:
+    /**
+     * @brief Counters of a tag.
+     */
+    struct Counters {
+        std::atomic<uint64_t> bytes{ 0 }; // Bytes currently held
+        std::atomic<uint64_t> peakBytes{ 0 }; // Highest number of bytes held
+        std::atomic<uint64_t> count{ 0 }; // Number of live allocations
+    };
+
+    /**
+     * @brief Get the index of the counters of a tag.
+     * @param tag The tag.
+     * @return Index into m_counters, invalid tags map to the first one.
+     */
+    static size_t getIndex(MemoryTag tag);
+    /**
+     * @brief Raise the peak of a tag to a value if it is higher.
+     * @param counters The counters of the tag.
+     * @param bytes The value.
+     */
+    static void updatePeak(Counters& counters, uint64_t bytes);
+
+private:
+    std::array<Counters, N_TAGS> m_counters = {}; // Counters by tag
+};
+
+/**
+ * @brief Handle of a tracked allocation, removes it from the tracker when destroyed.
+ * @note Usage: TrackedMemory memory(MemoryTag::BVH, nodes.capacity() * sizeof(Node));
+ *       Declare it next to the data it accounts for so both go away together.
+ */
+class TrackedMemory {
+public:
+    /**
+     * @param tag The tag of the allocation.
+     * @param bytes Initial size of the allocation in bytes.
+     */
+    explicit TrackedMemory(MemoryTag tag, uint64_t bytes = 0) :
+        m_tag(tag),
+        m_bytes(bytes) {
+        MemoryTracker::instance().add(m_tag, m_bytes);
+    };
+    ~TrackedMemory() { MemoryTracker::instance().remove(m_tag, m_bytes); };
+    TrackedMemory(const TrackedMemory&) = delete;
+    TrackedMemory& operator=(const TrackedMemory&) = delete;
+
+    /**
+     * @brief Update the size of the allocation.
+     * @param bytes The new size in bytes.
+     */
+    void resize(uint64_t bytes) {
+        MemoryTracker::instance().resize(m_tag, m_bytes, bytes);
+        m_bytes = bytes;
+    };
+    /**
+     * @brief Get the size of the allocation.
+     * @return Size in bytes.
+     */
+    uint64_t getBytes() const { return m_bytes; };
+
+private:
+    MemoryTag m_tag = MemoryTag::COUNT; // Tag of the allocation
+    uint64_t m_bytes = 0; // Size of the allocation in bytes
+};
+
+namespace MemoryUtils {
+
+/**
+ * @brief Get the heap memory held by a vector.
+ * @param vec The vector.
+ * @return Capacity of the vector in bytes.
+ */
+template<typename T>
+uint64_t getVectorSize(const std::vector<T>& vec) {
+    return static_cast<uint64_t>(vec.capacity()) * sizeof(T);
+}
+
+} // namespace MemoryUtils
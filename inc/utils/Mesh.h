@@ -44,6 +44,13 @@ struct Model {
     std::vector<Mesh> meshes; // List of meshes in the model
 };
 
+/**
+ * @brief Get the heap memory held by the data of a model.
+ * @param model The model.
+ * @return Size of the vertex and index data in bytes.
+ */
+size_t getMemorySize(const Model& model);
+
 } // namespace Mesh
 
 namespace MeshLoader {
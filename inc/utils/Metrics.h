@@ -0,0 +1,245 @@
+/**
+ * @file Metrics.h
+ * @brief Header file for the MetricsRegistry class and its metric types.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "UtilsCommon.h"
+
+/**
+ * @brief Type of a metric.
+ */
+enum class MetricType {
+    COUNTER, // Monotonic total, e.g. rendered samples
+    GAUGE, // Latest value, e.g. rays per second
+    HISTOGRAM, // Distribution of recorded values, e.g. frame times
+};
+
+/**
+ * @brief Monotonic counter.
+ */
+class MetricCounter {
+public:
+    /**
+     * @brief Add to the counter.
+     * @param n The amount to add.
+     */
+    void add(uint64_t n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); };
+    /**
+     * @brief Get the total.
+     * @return The total since the last reset.
+     */
+    uint64_t get() const { return m_value.load(std::memory_order_relaxed); };
+    /**
+     * @brief Reset the total to 0.
+     */
+    void reset() { m_value.store(0, std::memory_order_relaxed); };
+
+private:
+    std::atomic<uint64_t> m_value{ 0 }; // Total
+};
+
+/**
+ * @brief Gauge holding the latest value set.
+ */
+class MetricGauge {
+public:
+    /**
+     * @brief Set the value.
+     * @param value The value.
+     */
+    void set(double value) { m_value.store(value, std::memory_order_relaxed); };
+    /**
+     * @brief Get the value.
+     * @return The latest value set.
+     */
+    double get() const { return m_value.load(std::memory_order_relaxed); };
+
+private:
+    std::atomic<double> m_value{ 0.0 }; // Latest value
+};
+
+/**
+ * @brief Histogram over fixed buckets.
+ * @note Percentiles are estimated as the upper bound of the bucket they fall into.
+ */
+class MetricHistogram {
+public:
+    /**
+     * @param bounds Ascending upper bounds of the buckets, values above the last bound are
+     *               counted in an extra bucket.
+     */
+    explicit MetricHistogram(const std::vector<double>& bounds);
+
+    /**
+     * @brief Record a value.
+     * @param value The value.
+     */
+    void record(double value);
+    /**
+     * @brief Clear the recorded values.
+     */
+    void reset();
+
+    /**
+     * @brief Get the number of recorded values.
+     * @return Number of values.
+     */
+    uint64_t getCount() const { return m_count.load(std::memory_order_relaxed); };
+    /**
+     * @brief Get the sum of the recorded values.
+     * @return Sum of the values.
+     */
+    double getSum() const { return m_sum.load(std::memory_order_relaxed); };
+    /**
+     * @brief Get the smallest recorded value.
+     * @return The smallest value, 0 if none.
+     */
+    double getMin() const;
+    /**
+     * @brief Get the largest recorded value.
+     * @return The largest value, 0 if none.
+     */
+    double getMax() const;
+    /**
+     * @brief Estimate a percentile of the recorded values.
+     * @param percentile The percentile in [0, 100].
+     * @return The estimate, 0 if no values were recorded.
+     */
+    double getPercentile(double percentile) const;
+
+private:
+    std::vector<double> m_bounds = {}; // Upper bounds of the buckets
+    std::unique_ptr<std::atomic<uint64_t>[]> m_buckets = nullptr; // Counts per bucket
+    std::atomic<uint64_t> m_count{ 0 }; // Number of values
+    std::atomic<double> m_sum{ 0.0 }; // Sum of the values
+    std::atomic<double> m_min{ std::numeric_limits<double>::max() }; // Smallest value
+    std::atomic<double> m_max{ std::numeric_limits<double>::lowest() }; // Largest value
+};
+
+/**
+ * @brief Values of a metric at a point in time.
+ */
+struct MetricSnapshot {
+    std::string name = {}; // Name of the metric
+    std::string unit = {}; // Unit of the values
+    MetricType type = MetricType::COUNTER; // Type of the metric
+    double value = 0.0; // Total of counters, value of gauges, mean of histograms
+    uint64_t count = 0; // Number of recorded values of histograms
+    double min = 0.0; // Smallest recorded value of histograms
+    double max = 0.0; // Largest recorded value of histograms
+    double p50 = 0.0; // Median estimate of histograms
+    double p95 = 0.0; // 95th percentile estimate of histograms
+};
+
+/**
+ * @brief Registry of the runtime metrics of the application.
+ * @note Metrics are created on first lookup and live as long as the registry, so callers may
+ *       keep the returned references. Updating a metric does not lock. Names are dotted paths
+ *       like "path_tracer.rays_per_sec".
+ */
+class MetricsRegistry {
+private:
+    MetricsRegistry() = default;
+    ~MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+    MetricsRegistry(MetricsRegistry&&) = delete;
+    MetricsRegistry& operator=(MetricsRegistry&&) = delete;
+
+public:
+    static MetricsRegistry& instance() {
+        static MetricsRegistry instance;
+        return instance;
+    };
+
+    /**
+     * @brief Get or create a counter.
+     * @param name Name of the counter.
+     * @param unit Unit of the counter, used when it is created.
+     * @return The counter.
+     */
+    MetricCounter& counter(const std::string& name, const std::string& unit = "");
+    /**
+     * @brief Get or create a gauge.
+     * @param name Name of the gauge.
+     * @param unit Unit of the gauge, used when it is created.
+     * @return The gauge.
+     */
+    MetricGauge& gauge(const std::string& name, const std::string& unit = "");
+    /**
+     * @brief Get or create a histogram.
+     * @param name Name of the histogram.
+     * @param unit Unit of the histogram, used when it is created.
+     * @param bounds Upper bounds of the buckets, used when it is created.
+     * @return The histogram.
+     */
+    MetricHistogram& histogram(
+        const std::string& name,
+        const std::string& unit,
+        const std::vector<double>& bounds
+    );
+
+    /**
+     * @brief Set a label written with exported metrics, e.g. the application version.
+     * @param key Key of the label.
+     * @param value Value of the label.
+     */
+    void setLabel(const std::string& key, const std::string& value);
+    /**
+     * @brief Take a snapshot of all metrics.
+     * @return Snapshots sorted by name.
+     */
+    std::vector<MetricSnapshot> snapshot() const;
+    /**
+     * @brief Reset all counters and histograms, gauges keep their values.
+     */
+    void reset();
+
+    /**
+     * @brief Write a snapshot of all metrics and the labels as JSON.
+     * @param filename Path of the file to write.
+     * @return 0 on success, non-zero on failure.
+     */
+    int exportJson(const std::string& filename) const;
+    /**
+     * @brief Append a snapshot of all metrics to a CSV file, one row per metric.
+     * @param filename Path of the file, the header is written if the file is new.
+     * @return 0 on success, non-zero on failure.
+     * @note Rows of one snapshot share the time and labels, so runs of different builds can
+     *       be compared in one file.
+     */
+    int exportCsv(const std::string& filename) const;
+
+private:
+    /**
+     * @brief A registered metric.
+     */
+    struct Entry {
+        MetricType type = MetricType::COUNTER; // Type of the metric
+        std::string unit = {}; // Unit of the values
+        std::unique_ptr<MetricCounter> counter = nullptr; // Counter, if a counter
+        std::unique_ptr<MetricGauge> gauge = nullptr; // Gauge, if a gauge
+        std::unique_ptr<MetricHistogram> histogram = nullptr; // Histogram, if a histogram
+    };
+
+    /**
+     * @brief Get or create an entry, called with the mutex held.
+     * @param name Name of the metric.
+     * @param type Type of the metric.
+     * @param unit Unit of the metric.
+     * @return The entry, or nullptr if the name is taken by a metric of another type.
+     */
+    Entry* getEntry(const std::string& name, MetricType type, const std::string& unit);
+
+private:
+    mutable std::mutex m_mutex; // Guards the maps, not the metrics
+    std::map<std::string, Entry> m_entries = {}; // Metrics by name
+    std::map<std::string, std::string> m_labels = {}; // Labels of exported metrics
+};
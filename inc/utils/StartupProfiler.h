@@ -0,0 +1,116 @@
+/**
+ * @file StartupProfiler.h
+ * @brief Header file for the StartupProfiler class and the StartupPhase scope.
+ */
+
+#pragma once
+
+#include <mutex>
+
+#include "UtilsCommon.h"
+#include "Tracer.h"
+
+/**
+ * @brief A timed phase of the startup.
+ */
+struct StartupPhaseRecord {
+    std::string name = {}; // Name of the phase
+    double startMs = 0.0; // Start of the phase since startup began
+    double durationMs = 0.0; // Duration of the phase
+    bool mainThread = true; // Whether the phase ran on the main thread
+};
+
+/**
+ * @brief Records how long each startup phase takes until the first frame is shown.
+ * @note Phases may overlap when they run on worker threads, the report lists them by start
+ *       time. Phases are also recorded as trace scopes when tracing is enabled.
+ */
+class StartupProfiler {
+private:
+    StartupProfiler() = default;
+    ~StartupProfiler() = default;
+    StartupProfiler(const StartupProfiler&) = delete;
+    StartupProfiler& operator=(const StartupProfiler&) = delete;
+    StartupProfiler(StartupProfiler&&) = delete;
+    StartupProfiler& operator=(StartupProfiler&&) = delete;
+
+public:
+    static StartupProfiler& instance() {
+        static StartupProfiler instance;
+        return instance;
+    };
+
+    /**
+     * @brief Start the profile, the calling thread is taken as the main thread.
+     */
+    void begin();
+    /**
+     * @brief Record a finished phase, phases after finish() are ignored.
+     * @param name Name of the phase.
+     * @param start Start time of the phase.
+     * @param end End time of the phase.
+     */
+    void record(
+        const std::string& name,
+        std::chrono::steady_clock::time_point start,
+        std::chrono::steady_clock::time_point end
+    );
+    /**
+     * @brief End the profile when the first frame has been shown.
+     * @return Time from begin() to the first frame in milliseconds.
+     */
+    double finish();
+
+    /**
+     * @brief Check if the profile has ended.
+     * @return True after finish(), false otherwise.
+     */
+    bool isFinished() const;
+    /**
+     * @brief Get the recorded phases.
+     * @return The phases sorted by start time.
+     */
+    std::vector<StartupPhaseRecord> getPhases() const;
+    /**
+     * @brief Get a one-line summary of the profile for the log.
+     * @return The summary, e.g. "first frame after 412 ms (window 120 ms, shaders 230 ms)".
+     */
+    std::string getSummary() const;
+    /**
+     * @brief Write the phases as a text table.
+     * @param filename Path of the file to write.
+     * @return 0 on success, non-zero on failure.
+     */
+    int writeReport(const std::string& filename) const;
+
+private:
+    mutable std::mutex m_mutex; // Guards all members
+
+    std::chrono::steady_clock::time_point m_begin = {}; // Time begin() was called
+    std::thread::id m_mainThread = {}; // ID of the thread that called begin()
+    std::vector<StartupPhaseRecord> m_phases = {}; // Recorded phases
+    double m_firstFrameMs = 0.0; // Time to the first frame, 0 until finish()
+    bool m_finished = false; // Whether finish() was called
+};
+
+/**
+ * @brief Records the enclosing scope as a startup phase.
+ * @note Usage: StartupPhase phase("shaders"); names must be string literals.
+ */
+class StartupPhase {
+public:
+    explicit StartupPhase(const char* name) :
+        m_name(name),
+        m_traceScope(name),
+        m_start(std::chrono::steady_clock::now()) {};
+    ~StartupPhase() {
+        StartupProfiler::instance().record(m_name, m_start, std::chrono::steady_clock::now());
+    };
+    StartupPhase(const StartupPhase&) = delete;
+    StartupPhase& operator=(const StartupPhase&) = delete;
+
+private:
+    const char* m_name = nullptr; // Name of the phase
+    TraceScope m_traceScope; // Trace scope of the phase
+    std::chrono::steady_clock::time_point m_start = {}; // Start time of the phase
+};
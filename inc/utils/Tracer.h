@@ -0,0 +1,195 @@
+/**
+ * @file Tracer.h
+ * @brief Header file for the Tracer class and the tracing macros.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "UtilsCommon.h"
+
+/**
+ * @brief Records trace events of all threads and exports them as a Chrome trace.
+ * @note Every thread writes to its own buffer without locking, names must be string literals
+ *       or otherwise outlive the tracer. Recording is off until setEnabled(true), the macros
+ *       below then cost a relaxed atomic load. Open exported files in chrome://tracing or
+ *       ui.perfetto.dev.
+ */
+class Tracer {
+private:
+    Tracer();
+    ~Tracer() = default;
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+    Tracer(Tracer&&) = delete;
+    Tracer& operator=(Tracer&&) = delete;
+
+public:
+    static Tracer& instance() {
+        static Tracer instance;
+        return instance;
+    };
+
+    /**
+     * @brief Check if events are recorded.
+     * @return True if enabled, false otherwise.
+     */
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); };
+    /**
+     * @brief Enable or disable recording events.
+     * @param enabled True to record events, false to ignore them.
+     */
+    static void setEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); };
+
+    /**
+     * @brief Get the time since the tracer was created.
+     * @return Time in nanoseconds.
+     */
+    int64_t now() const;
+
+    /**
+     * @brief Record a completed scope of the calling thread.
+     * @param name Name of the scope.
+     * @param begin Time the scope began in nanoseconds, see now().
+     * @param end Time the scope ended in nanoseconds, see now().
+     */
+    void scope(const char* name, int64_t begin, int64_t end);
+    /**
+     * @brief Record the value of a counter.
+     * @param name Name of the counter.
+     * @param value Value of the counter.
+     */
+    void counter(const char* name, double value);
+    /**
+     * @brief Record the start of a flow, links the enclosing scope to the scope ending it.
+     * @param name Name of the flow.
+     * @param id ID of the flow, unique among the flows with the same name.
+     */
+    void flowBegin(const char* name, uint64_t id);
+    /**
+     * @brief Record the end of a flow, see flowBegin().
+     * @param name Name of the flow.
+     * @param id ID of the flow.
+     */
+    void flowEnd(const char* name, uint64_t id);
+    /**
+     * @brief Name the calling thread in exported traces.
+     * @param name Name of the thread.
+     */
+    void setThreadName(const char* name);
+
+    /**
+     * @brief Write the recorded events as Chrome trace event JSON.
+     * @param filename Path of the file to write.
+     * @return 0 on success, non-zero on failure.
+     * @note Events recorded while exporting may be left out.
+     */
+    int exportChromeTrace(const std::string& filename) const;
+    /**
+     * @brief Get the number of events dropped because a thread buffer was full.
+     * @return Number of dropped events.
+     */
+    uint64_t getDroppedEventCount() const;
+
+private:
+    /**
+     * @brief A recorded event.
+     */
+    struct Event {
+        const char* name = nullptr; // Name of the event
+        int64_t time = 0; // Time of the event in nanoseconds
+        int64_t duration = 0; // Duration of scopes in nanoseconds
+        double value = 0.0; // Value of counters
+        uint64_t id = 0; // ID of flows
+        char phase = 0; // Chrome trace event phase
+    };
+
+    static constexpr size_t CHUNK_SIZE = 4096; // Events per chunk of a thread buffer
+    static constexpr size_t MAX_CHUNKS = 256; // Chunks per thread buffer
+    /**
+     * @brief Event buffer written by a single thread.
+     * @note Chunks are never moved or freed, so the exporter reads them while the thread
+     *       keeps writing. m_count is published after the event is written.
+     */
+    struct ThreadBuffer {
+        using Chunk = std::array<Event, CHUNK_SIZE>;
+
+        uint32_t tid = 0; // Thread ID in exported traces
+        std::atomic<const char*> threadName{ nullptr }; // Name of the thread
+        std::array<std::atomic<Chunk*>, MAX_CHUNKS> chunks = {}; // Allocated chunks
+        std::vector<std::unique_ptr<Chunk>> ownedChunks = {}; // Owner of the chunks
+        std::atomic<size_t> count{ 0 }; // Number of written events
+        std::atomic<uint64_t> dropped{ 0 }; // Number of events not written
+    };
+
+    /**
+     * @brief Get the buffer of the calling thread, registering it on first use.
+     * @return The buffer.
+     */
+    ThreadBuffer& getThreadBuffer();
+    /**
+     * @brief Append an event to the buffer of the calling thread.
+     * @param event The event.
+     */
+    void record(const Event& event);
+
+private:
+    static std::atomic<bool> s_enabled; // Whether events are recorded
+
+    std::chrono::steady_clock::time_point m_epoch; // Time the tracer was created
+    mutable std::mutex m_buffersMutex; // Guards registering and listing thread buffers
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers = {}; // Buffers of all threads
+};
+
+/**
+ * @brief Records the lifetime of a scope to the tracer.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) {
+        if (Tracer::isEnabled()) {
+            m_name = name;
+            m_begin = Tracer::instance().now();
+        }
+    };
+    ~TraceScope() {
+        if (m_name)
+            Tracer::instance().scope(m_name, m_begin, Tracer::instance().now());
+    };
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name = nullptr; // Name of the scope, null if not recorded
+    int64_t m_begin = 0; // Time the scope began in nanoseconds
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+// Trace the enclosing scope under the given name
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+// Trace the enclosing function
+#define TRACE_FUNCTION() TRACE_SCOPE(__func__)
+// Record the value of a counter
+#define TRACE_COUNTER(name, value) \
+    do { \
+        if (Tracer::isEnabled()) \
+            Tracer::instance().counter(name, static_cast<double>(value)); \
+    } while (0)
+// Start a flow from the enclosing scope
+#define TRACE_FLOW_BEGIN(name, id) \
+    do { \
+        if (Tracer::isEnabled()) \
+            Tracer::instance().flowBegin(name, static_cast<uint64_t>(id)); \
+    } while (0)
+// End a flow in the enclosing scope
+#define TRACE_FLOW_END(name, id) \
+    do { \
+        if (Tracer::isEnabled()) \
+            Tracer::instance().flowEnd(name, static_cast<uint64_t>(id)); \
+    } while (0)
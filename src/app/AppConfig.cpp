@@ -31,6 +31,9 @@ public:
     void init(const std::string& appName, const std::string& configFilename) {
         std::filesystem::path configDir = getAppConfigPath(appName);
         m_configPath = (configDir / (configFilename + ".json")).string();
+        m_cachePath = (configDir / "cache").string();
+        m_tracePath = (configDir / "trace").string();
+        m_logPath = (configDir / "logs").string();
 
         // Load existing configuration if the file exists
         std::ifstream configFile(m_configPath);
@@ -68,6 +71,27 @@ public:
         m_configData[key] = value;
         return saveConfigFile();
     }
+    /**
+     * @brief Get the directory for cache files.
+     * @return The path to the cache directory.
+     */
+    const std::string& getCachePath() const {
+        return m_cachePath;
+    }
+    /**
+     * @brief Get the directory for trace files.
+     * @return The path to the trace directory.
+     */
+    const std::string& getTracePath() const {
+        return m_tracePath;
+    }
+    /**
+     * @brief Get the directory for log files.
+     * @return The path to the log directory.
+     */
+    const std::string& getLogPath() const {
+        return m_logPath;
+    }
 
 private:
     /**
@@ -136,6 +160,9 @@ private:
 
 private:
     std::string m_configPath; // Path to the configuration file
+    std::string m_cachePath; // Path to the cache directory
+    std::string m_tracePath; // Path to the trace directory
+    std::string m_logPath; // Path to the log directory
     nlohmann::json m_configData; // JSON object to hold configuration data
     mutable std::mutex m_mutex; // Mutex for thread-safe access
 };
@@ -162,6 +189,24 @@ int AppConfig::setConfig(const std::string& key, const std::string& value) {
     return 1;
 }
 
+std::string AppConfig::getCachePath() const {
+    if (m_impl)
+        return m_impl->getCachePath();
+    return "";
+}
+
+std::string AppConfig::getTracePath() const {
+    if (m_impl)
+        return m_impl->getTracePath();
+    return "";
+}
+
+std::string AppConfig::getLogPath() const {
+    if (m_impl)
+        return m_impl->getLogPath();
+    return "";
+}
+
 std::string AppConfigUitls::Vec3ToString(const Math::Vec3& vec) {
     return std::to_string(vec.x) + "," + std::to_string(vec.y) + "," + std::to_string(vec.z);
 }
@@ -6,6 +6,7 @@
 #include "app/AppDataManager.h"
 
 #include "app/Application.h"
+#include "utils/Tracer.h"
 
 AppDataManager::AppDataManager() {}
 
@@ -35,6 +36,7 @@ std::string AppDataManager::getCurrentDbPath() const {
 }
 
 int AppDataManager::loadDbFromFile(const std::string& filepath) {
+    TRACE_FUNCTION();
     resetDB();
     if (m_db->loadFromFile(filepath) != DB::Result::SUCCESS)
         return 1;
@@ -43,6 +45,7 @@ int AppDataManager::loadDbFromFile(const std::string& filepath) {
 }
 
 int AppDataManager::saveDbToFile(const std::string& filepath) {
+    TRACE_FUNCTION();
     if (m_db->saveToFile(filepath) != DB::Result::SUCCESS)
         return 1;
     m_currentDbPath = filepath;
@@ -6,6 +6,7 @@
 #include "app/AppTextureManager.h"
 
 #include "utils/Logger.hpp"
+#include "utils/MemoryTracker.h"
 #include "utils/Image.h"
 
 void AppTextureManager::init(GfxRenderer renderer) {
@@ -18,8 +19,10 @@ void AppTextureManager::init(GfxRenderer renderer) {
     info.format = GfxFormat::R8G8B8A8_UNORM;
     info.usages.set(GfxImageUsage::SAMPLED_TEXTURE);
     m_defaultTexture = m_renderer->createImage(info);
-    if (m_defaultTexture)
+    if (m_defaultTexture) {
         m_renderer->setImageData(m_defaultTexture, data.data());
+        m_renderer->flushUploads();
+    }
 }
 
 void AppTextureManager::term() {
@@ -50,6 +53,7 @@ GfxImage AppTextureManager::getTexture(const std::string& filename) {
         Logger() << "Failed to load texture: " << filename;
         return nullptr;
     }
+    TrackedMemory pixelMemory(MemoryTag::TEXTURES, MemoryUtils::getVectorSize(pixels));
 
     // Create GfxImage from pixel data
     GfxImageInfo info = {};
@@ -68,6 +72,7 @@ GfxImage AppTextureManager::getTexture(const std::string& filename) {
         Logger() << "Failed to upload texture data for: " << filename;
         return nullptr;
     }
+    m_renderer->flushUploads(); // Textures are also sampled by other renderers
 
     m_textures[filename] = image;
 
@@ -111,6 +116,7 @@ GfxImage AppTextureManager::getIntensityTexture(const std::string& filename) {
     }
     if (width == 0 || height == 0)
         return nullptr;
+    TrackedMemory dataMemory(MemoryTag::TEXTURES, MemoryUtils::getVectorSize(data));
 
     // Create GfxImage
     GfxImageInfo info = {};
@@ -129,6 +135,7 @@ GfxImage AppTextureManager::getIntensityTexture(const std::string& filename) {
         Logger() << "Failed to upload texture data for: " << filename;
         return nullptr;
     }
+    m_renderer->flushUploads(); // Textures are also sampled by other renderers
 
     m_textures[filename] = image;
 
@@ -207,6 +214,10 @@ GfxImage AppTextureManager::getIntensityPreviewTexture(const std::string& filena
         return lerp(c4, c5, (t - 0.8f) / 0.2f);
         };
     std::vector<uint8_t> rgba(width * height * 4);
+    TrackedMemory pixelMemory(
+        MemoryTag::TEXTURES,
+        MemoryUtils::getVectorSize(data) + MemoryUtils::getVectorSize(rgba)
+    );
     const float range = maxValue - minValue;
     const bool validRange = range > std::numeric_limits<float>::epsilon();
     for (size_t i = 0; i < data.size(); ++i) {
@@ -240,6 +251,7 @@ GfxImage AppTextureManager::getIntensityPreviewTexture(const std::string& filena
         Logger() << "Failed to upload texture data for: " << filename;
         return nullptr;
     }
+    m_renderer->flushUploads(); // Textures are also sampled by other renderers
 
     m_textures[filename] = image;
 
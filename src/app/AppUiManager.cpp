@@ -96,7 +96,7 @@ void AppUiManager::initUI(float dpiScale) {
 
     ImGui::GetIO().Fonts->Clear();
 
-    ImGui::GetIO().Fonts->AddFontFromMemoryCompressedTTF(
+    ImFont* textFont = ImGui::GetIO().Fonts->AddFontFromMemoryCompressedTTF(
         SourceHanSansSC_compressed_data,
         SourceHanSansSC_compressed_size,
         17.0f * dpiScale
@@ -115,10 +115,16 @@ void AppUiManager::initUI(float dpiScale) {
         icons_ranges
     );
 
-    ImGui::GetIO().Fonts->AddFontFromMemoryCompressedTTF(
-        SourceHanSansSC_compressed_data,
-        SourceHanSansSC_compressed_size,
-        17.0f * dpiScale
+    // Glyphs are baked on demand, the costly part is decompressing the CJK font, so the second
+    // text font shares the data decompressed for the first one
+    ImFontConfig textConfig;
+    textConfig.FontDataOwnedByAtlas = false;
+    const ImFontConfig* textSource = textFont->Sources[0];
+    ImGui::GetIO().Fonts->AddFontFromMemoryTTF(
+        textSource->FontData,
+        textSource->FontDataSize,
+        17.0f * dpiScale,
+        &textConfig
     );
     icons_config.GlyphOffset.y += (22.0f - 17.0f) * 0.5f;
     m_boldIconFont = ImGui::GetIO().Fonts->AddFontFromMemoryCompressedTTF(
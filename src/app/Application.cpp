@@ -6,6 +6,8 @@
 #include "app/Application.h"
 
 #include "app/PathTracerApp.h"
+#include "utils/Logger.hpp"
+#include "utils/StartupProfiler.h"
 
 using App = PathTracerApp;
 
@@ -16,6 +18,7 @@ const int AppVersion::MINOR = 0;
 const int AppVersion::PATCH = 0;
 
 constexpr const char* CONFIG_FILE = "config";
+constexpr const char* LOG_FILE = "spectrumizer.log";
 
 const std::string AppVersion::getVersionString() {
     return std::to_string(MAJOR) + "." + std::to_string(MINOR) + "." + std::to_string(PATCH);
@@ -36,8 +39,23 @@ Application::Application(int argc, char** argv) :
 }
 
 int Application::init() {
-    AppConfig::instance().init(APP_NAME, CONFIG_FILE);
-    AppDataManager::instance().init();
+    // Phases are reported once the first frame is shown
+    StartupProfiler::instance().begin();
+    {
+        StartupPhase phase("config");
+        AppConfig::instance().init(APP_NAME, CONFIG_FILE);
+    }
+    {
+        StartupPhase phase("log");
+        // e.g. "warn,path_tracer=debug", see LogSink::setFilters()
+        LogSink::instance().setFilters(AppConfig::instance().getConfig("log_level"));
+        if (LogSink::instance().init(AppConfig::instance().getLogPath(), LOG_FILE) != 0)
+            Logger(LogLevel::WARN) << "Failed to open the log file, logging to the console only";
+    }
+    {
+        StartupPhase phase("db");
+        AppDataManager::instance().init();
+    }
     return m_pApp->init();
 }
 
@@ -47,4 +65,5 @@ int Application::run() {
 
 void Application::term() {
     m_pApp->term();
+    LogSink::instance().term();
 }
@@ -14,35 +14,116 @@
 #include "utils/Mesh.h"
 #include "utils/Image.h"
 #include "utils/ScopeGuard.hpp"
+#include "utils/JobSystem.h"
+#include "utils/Metrics.h"
+#include "utils/MemoryTracker.h"
+#include "utils/StartupProfiler.h"
+#include "utils/Tracer.h"
 
 PathTracerApp::PathTracerApp(int argc, char** argv) :
     BaseApp(argc, argv) {}
 
 int PathTracerApp::init() {
+    // Record trace events from the start, they are exported on exit
+    if (AppConfig::instance().getConfig("debug_trace") == "true") {
+        Tracer::setEnabled(true);
+        Tracer::instance().setThreadName("Main");
+    }
+
     // Init global config
     GuiConfig::setAppName(Application::APP_NAME);
     GuiConfig::setGraphicsBackend(GfxBackend::Vulkan);
+    GuiConfig::setCacheDir(AppConfig::instance().getCachePath());
+    // Lets the fallback paths of devices without timeline semaphores run on any device
+    GuiConfig::setTimelineSemaphores(
+        AppConfig::instance().getConfig("debug_vk_timeline_semaphores") != "false"
+    );
     std::string langCfgStr = AppConfig::instance().getConfig("general_lang");
     LangStrings::Lang language = LangStrings::Lang::EN_US;
     if (!langCfgStr.empty())
         language = static_cast<LangStrings::Lang>(std::stoi(langCfgStr));
     GuiText::load(LangStrings::get(language));
 
-    if (initWindow())
-        return 1;
+    // The shaders compile on a cold start and load from the cache of a previous run on a warm
+    // one, check before the renderer creates the cache directories
+    bool shaderCacheWarm = false;
+    {
+        std::error_code ec;
+        std::filesystem::recursive_directory_iterator it(
+            AppConfig::instance().getCachePath(),
+            ec
+        );
+        for (; !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+            if (it->is_regular_file(ec)) {
+                shaderCacheWarm = true;
+                break;
+            }
+        }
+    }
 
+    {
+        StartupPhase phase("window");
+        if (initWindow())
+            return 1;
+    }
     GfxRenderer renderer = m_window->getRenderer();
+
+    // Compile the shaders on worker threads while the UI is set up
+    {
+        StartupPhase phase("path_tracer_context");
+        m_pathTracerCtx = std::make_unique<GuiWindow>("PathTracerContext", 0, 0);
+        m_pathTracerCtx->setOnDrawCb([this] { onPathTracerRender(); });
+        // Keep long dispatches off the graphics queue of the UI when the device allows it
+        m_pathTracerCtx->getRenderer()->useComputeQueue();
+    }
+    m_previewer = std::make_unique<Previewer>(renderer);
+    m_pathTracer = std::make_unique<PathTracer>(m_pathTracerCtx->getRenderer());
+    m_postProcesser = std::make_unique<PostProcesser>(renderer);
+    initWorkgroupSize();
+    auto shaderStart = std::chrono::steady_clock::now();
+    std::vector<Job> shaderJobs = loadShaders();
+    if (!shaderJobs.empty()) {
+        // Spans all shader jobs, named so cold and warm startup profiles can be compared
+        const char* name = shaderCacheWarm ? "shaders.warm_cache" : "shaders.cold_cache";
+        shaderJobs.push_back(JobSystem::instance().submit(
+            [name, shaderStart] {
+                StartupProfiler::instance().record(
+                    name,
+                    shaderStart,
+                    std::chrono::steady_clock::now()
+                );
+            },
+            JobPriority::INTERACTIVE,
+            shaderJobs
+        ));
+    }
+    // The jobs use the renderers, do not leave before they are done
+    ScopeGuard shaderJobsGuard([&shaderJobs]() { JobSystem::instance().waitAll(shaderJobs); });
+
+    {
+        StartupPhase phase("ui");
+        if (initUI())
+            return 1;
+    }
+
     // Init texture manager
     AppTextureManager::instance().init(renderer);
 
+    {
+        StartupPhase phase("shader_wait");
+        JobSystem::instance().waitAll(shaderJobs);
+    }
+
     // Init previewer
-    m_previewer = std::make_unique<Previewer>(renderer);
     DbObjHandle hScene = AppDataManager::instance().getDB()->getRootObject();
     int resX = 0, resY = 0;
     PtScene::getResolution(hScene, resX, resY);
     std::string samplesStr = AppConfig::instance().getConfig("previewer_samples");
     int samples = samplesStr.empty() ? 1 : std::stoi(samplesStr);
-    m_previewer->init(resX, resY, samples);
+    {
+        StartupPhase phase("previewer");
+        m_previewer->init(resX, resY, samples);
+    }
     std::string bgColorStr = AppConfig::instance().getConfig("previewer_bg_color");
     Math::Vec3 bgColor =
         bgColorStr.empty() ? Math::Vec3(0.0f) : AppConfigUitls::StringToVec3(bgColorStr);
@@ -66,15 +147,35 @@ int PathTracerApp::init() {
     m_mainViewport->frameTexture =
         AppUiManager::instance().getImGuiTexture(renderer, previewFrame);
 
-    // Init path tracer
-    m_pathTracerCtx = std::make_unique<GuiWindow>("PathTracerContext", 0, 0);
-    m_pathTracerCtx->setOnDrawCb([this] { onPathTracerRender(); });
-    m_pathTracer = std::make_unique<PathTracer>(m_pathTracerCtx->getRenderer());
-    m_pathTracer->init();
-
-    // Init post processer
-    m_postProcesser = std::make_unique<PostProcesser>(renderer);
-    m_postProcesser->init();
+    // Init path tracer and post processer
+    {
+        StartupPhase phase("path_tracer");
+        m_pathTracer->init();
+        m_postProcesser->init();
+    }
+
+    // Record GPU ray statistics and export the metrics on exit
+    m_metricsExport = AppConfig::instance().getConfig("debug_metrics") == "true";
+    m_pathTracer->setStatsEnabled(m_metricsExport);
+    MetricsRegistry::instance().setLabel("version", AppVersion::getVersionString());
+#ifdef _DEBUG
+    MetricsRegistry::instance().setLabel("build", "debug");
+#else
+    MetricsRegistry::instance().setLabel("build", "release");
+#endif
+    m_metricsLastTime = std::chrono::steady_clock::now();
+
+    // Open GPU timing trace
+    if (AppConfig::instance().getConfig("debug_gpu_trace") == "true") {
+        std::filesystem::path traceDir = AppConfig::instance().getTracePath();
+        std::error_code ec;
+        std::filesystem::create_directories(traceDir, ec);
+        m_gpuTraceFile.open(traceDir / "gpu_timings.csv", std::ios::trunc);
+        if (m_gpuTraceFile.is_open())
+            m_gpuTraceFile << "renderer,frame,pass,depth,ms" << std::endl;
+        else
+            Logger() << "Failed to open GPU timing trace in " << traceDir.string();
+    }
 
     // Init settings window with saved config
     auto langConfig = UiSettingsWindow::Language::EN_US;
@@ -128,13 +229,9 @@ int PathTracerApp::init() {
         AppUiUtils::vec3ToArray(hiliteColorPicked)
     );
 
-    // Load scene from command line argument
-    if (m_argc > 1) {
-        std::string filename = m_argc > 1 ? m_argv[1] : "";
-        if (filename.empty())
-            return 0;
-        loadNewScene(filename);
-    }
+    // Load the scene from the command line after the first frame, the window shows up sooner
+    if (m_argc > 1)
+        m_startupScenePath = m_argv[1];
 
     return 0;
 }
@@ -144,16 +241,44 @@ int PathTracerApp::run() {
 
     std::thread pathTracerThread(
         [this] {
-            while (!m_pathTracerCtx->shouldClose()) {
-                if (m_pathTracer->isRendering()) {
-                    m_pathTracerCtx->drawFrame();
-                    if (m_targetSample > 0) {
-                        if (m_pathTracer->getCurrentSample() >= m_targetSample)
-                            stopRendering();
-                    }
+            Tracer::instance().setThreadName("Path Tracer");
+            MetricHistogram& frameMetric = MetricsRegistry::instance().histogram(
+                "path_tracer.frame_ms",
+                "ms",
+                { 1.0, 2.0, 4.0, 8.0, 16.0, 33.0, 66.0, 125.0, 250.0, 500.0, 1000.0 }
+            );
+            // The thread sleeps in waitForWork until a render request arrives
+            while (true) {
+                PathTracer::Work work = m_pathTracer->waitForWork();
+                if (work == PathTracer::Work::CLOSE)
+                    break;
+                TRACE_SCOPE("Path Tracer Frame");
+                if (work == PathTracer::Work::FINISHED) {
+                    // A display image held back for its frame must show up before idling
+                    m_pathTracer->markDisplayImageReady(0, true);
                     m_renderFinished.store(true, std::memory_order_release);
-                    m_pathTracer->markDisplayImageReady();
+                    m_window->requestRedraw();
+                    continue;
                 }
+                // FRAME traces a sample, PRESENT only copies the last samples to the display
+                auto frameStart = std::chrono::steady_clock::now();
+                m_pathTracerCtx->drawFrame();
+                // The display copy is part of the frame, the main renderer waits for it on
+                // the device if it can, otherwise it is published once the frame completed
+                GfxRenderer renderer = m_pathTracerCtx->getRenderer();
+                uint64_t syncValue = renderer->getFrameSyncValue();
+                if (work == PathTracer::Work::FRAME) {
+                    std::chrono::duration<double, std::milli> frameTime =
+                        std::chrono::steady_clock::now() - frameStart;
+                    frameMetric.record(frameTime.count());
+                }
+                if (work == PathTracer::Work::FRAME && m_targetSample > 0) {
+                    if (m_pathTracer->getCurrentSample() >= m_targetSample)
+                        stopRendering();
+                }
+                m_renderFinished.store(true, std::memory_order_release);
+                m_pathTracer->markDisplayImageReady(syncValue, false);
+                m_window->requestRedraw();
             }
         }
     );
@@ -164,12 +289,18 @@ int PathTracerApp::run() {
     }
 
     m_pathTracerCtx->term();
+    m_pathTracer->close();
     pathTracerThread.join();
 
     return 0;
 }
 
 void PathTracerApp::term() {
+    // Jobs may still hold GPU resources or post UI updates
+    JobSystem::instance().term();
+    JobSystem::instance().setMainThreadWakeup(nullptr);
+    JobSystem::instance().runMainThreadTasks();
+
     GfxRenderer renderer = m_window->getRenderer();
 
     renderer->waitDeviceIdle();
@@ -197,9 +328,32 @@ void PathTracerApp::term() {
     m_pathTracerCtx.reset();
 
     m_window.reset();
+
+    if (Tracer::isEnabled()) {
+        std::filesystem::path traceDir = AppConfig::instance().getTracePath();
+        std::error_code ec;
+        std::filesystem::create_directories(traceDir, ec);
+        if (Tracer::instance().exportChromeTrace((traceDir / "trace.json").string()))
+            Logger() << "Failed to export trace to " << traceDir.string();
+    }
+
+    if (m_metricsExport) {
+        std::filesystem::path traceDir = AppConfig::instance().getTracePath();
+        std::error_code ec;
+        std::filesystem::create_directories(traceDir, ec);
+        MetricsRegistry& metrics = MetricsRegistry::instance();
+        // The CSV collects the runs of all builds, the JSON holds the latest run
+        if (metrics.exportJson((traceDir / "metrics.json").string()) ||
+            metrics.exportCsv((traceDir / "metrics.csv").string()))
+            Logger() << "Failed to export metrics to " << traceDir.string();
+    }
 }
 
 void PathTracerApp::onGuiEvent(const GuiEvent& event) {
+    // Handled events may change the scene or the UI, redraw to show it. Hover updates of the
+    // viewport come every frame and are driven by mouse input already.
+    if (event.viewLabel != UiMainViewport::LABEL)
+        m_window->requestRedraw(2);
     if (event.viewLabel == UiMenuBar::LABEL)
         handleMenuBarEvent(event);
     else if (event.viewLabel == UiToolBar::LABEL)
@@ -226,6 +380,10 @@ void PathTracerApp::onGuiEvent(const GuiEvent& event) {
         handleLeftPanelEvent(event);
     else if (event.viewLabel == UiSettingsWindow::LABEL)
         handleSettingsWindowEvent(event);
+    else if (event.viewLabel == UiMemoryWindow::LABEL) {
+        if (event.widgetID == static_cast<int>(UiMemoryWindow::ID::SAVE_REPORT))
+            saveMemoryReport();
+    }
 }
 
 void PathTracerApp::onResizeWindow(int width, int height) {
@@ -234,9 +392,15 @@ void PathTracerApp::onResizeWindow(int width, int height) {
 }
 
 void PathTracerApp::onDrawWindow() {
+    TRACE_SCOPE("UI Frame");
     m_frameTimer.beginFrame();
 
-    m_pathTracer->syncDisplayImage();
+    JobSystem::instance().runMainThreadTasks();
+
+    m_pathTracer->syncDisplayImage(m_window->getRenderer());
+
+    // Leave the GPU to the path tracer while rendering, the UI only shows progress
+    m_window->setMaxFrameRate(m_currentRenderState == RenderState::RENDERING ? m_renderFpsCap : 0);
 
     // Render main viewport
     m_viewportHovered = false;
@@ -245,6 +409,8 @@ void PathTracerApp::onDrawWindow() {
     m_mainViewport->frameHeight = m_previewer->getFrameImage()->getHeight();
     if (m_displayMode == DisplayMode::PREVIEW_MODE) {
         if (m_previewerCamInControl) {
+            // Camera movement is animated, keep drawing until the camera is released
+            m_window->requestRedraw();
             float frameDuration = static_cast<float>(m_frameTimer.getFrameInterval());
             m_previewer->getCameraController().processMovement(frameDuration);
             m_rightPanel->setWidgetValue(
@@ -291,6 +457,10 @@ void PathTracerApp::onDrawWindow() {
         AppClipboard::instance().hasData() && m_currentRenderState == RenderState::IDLE
     );
     updateUiStatusBar();
+    updateGpuTimings();
+    updateMetrics();
+    if (m_memoryWindow->isOpen())
+        updateMemoryStats();
 
     if (m_renderFinished.exchange(false, std::memory_order_acquire))
         m_pathTracer->renderFinishCallback();
@@ -301,6 +471,31 @@ void PathTracerApp::onDrawWindow() {
 void PathTracerApp::onDrawWindowFinished() {
     AppUiUtils::renderForImGui(m_window->getRenderer());
     m_frameTimer.endFrame();
+
+    if (!StartupProfiler::instance().isFinished())
+        onFirstFrameShown();
+}
+
+void PathTracerApp::onFirstFrameShown() {
+    StartupProfiler& profiler = StartupProfiler::instance();
+    double firstFrameMs = profiler.finish();
+    Logger(LogLevel::INFO, "startup") << "Startup: " << profiler.getSummary();
+    MetricsRegistry::instance().gauge("startup.first_frame_ms", "ms").set(firstFrameMs);
+    if (m_metricsExport) {
+        std::filesystem::path traceDir = AppConfig::instance().getTracePath();
+        std::error_code ec;
+        std::filesystem::create_directories(traceDir, ec);
+        if (profiler.writeReport((traceDir / "startup_profile.txt").string()))
+            Logger() << "Failed to write startup profile to " << traceDir.string();
+    }
+
+    // The scene loads on the main thread in the next frame
+    if (!m_startupScenePath.empty()) {
+        JobSystem::instance().postToMainThread(
+            [this, filename = m_startupScenePath] { loadNewScene(filename); }
+        );
+        m_startupScenePath.clear();
+    }
 }
 
 void PathTracerApp::onMouseButton(GuiMouseButton button, bool pressed, GuiFlags<GuiModKey> mod) {
@@ -549,9 +744,36 @@ int PathTracerApp::initWindow() {
         }
     );
     m_window->setOnCloseCb([this] { return onCloseWindow(); });
+    // Only redraw on input or when something changed, unless configured otherwise
+    if (AppConfig::instance().getConfig("ui_continuous_redraw") != "true")
+        m_window->setRedrawOnDemand(true);
+    std::string fpsCapStr = AppConfig::instance().getConfig("ui_render_fps_cap");
+    m_renderFpsCap = fpsCapStr.empty() ? 30 : std::stoi(fpsCapStr);
+    // Results of background jobs are applied on the main thread in the next frame
+    JobSystem::instance().setMainThreadWakeup([this] { m_window->requestRedraw(); });
 
     GfxRenderer renderer = m_window->getRenderer();
 
+    // Create app icon image
+    GuiIcon& icon = appIcons.back();
+    GfxImageInfo iconImageInfo{};
+    iconImageInfo.width = icon.width;
+    iconImageInfo.height = icon.height;
+    iconImageInfo.format = GfxFormat::R8G8B8A8_UNORM;
+    iconImageInfo.usages.set(GfxImageUsage::SAMPLED_TEXTURE);
+    m_appIcon = renderer->createImage(iconImageInfo);
+    if (m_appIcon == nullptr) {
+        Logger() << "Failed to create app icon image";
+        return 1;
+    }
+    renderer->setImageData(m_appIcon, icon.data.data());
+
+    return 0;
+}
+
+int PathTracerApp::initUI() {
+    GfxRenderer renderer = m_window->getRenderer();
+
     // Init UI
     if (AppUiUtils::initForImGui(renderer, m_window)) {
         Logger() << "Failed to init ImGui";
@@ -584,28 +806,41 @@ int PathTracerApp::initWindow() {
     m_aboutWindow = std::make_shared<UiAboutWindow>();
     m_aboutWindow->addListener(this);
     m_window->addView(m_aboutWindow);
+    m_memoryWindow = std::make_shared<UiMemoryWindow>();
+    m_memoryWindow->addListener(this);
+    m_window->addView(m_memoryWindow);
     m_leftPanel = std::make_shared<UiLeftPanel>();
     m_leftPanel->addListener(this);
     m_window->addView(m_leftPanel);
 
-    // Create app icon image
-    GuiIcon& icon = appIcons.back();
-    GfxImageInfo iconImageInfo{};
-    iconImageInfo.width = icon.width;
-    iconImageInfo.height = icon.height;
-    iconImageInfo.format = GfxFormat::R8G8B8A8_UNORM;
-    iconImageInfo.usages.set(GfxImageUsage::SAMPLED_TEXTURE);
-    m_appIcon = renderer->createImage(iconImageInfo);
-    if (m_appIcon == nullptr) {
-        Logger() << "Failed to create app icon image";
-        return 1;
-    }
-    renderer->setImageData(m_appIcon, icon.data.data());
-
     return 0;
 }
 
+std::vector<Job> PathTracerApp::loadShaders() {
+    // GL objects belong to the thread of the context, init() then compiles on the main thread
+    if (GuiConfig::getGraphicsBackend() != GfxBackend::Vulkan)
+        return {};
+
+    // Failures are logged and reported again by init(), which retries on the main thread
+    JobSystem& jobSystem = JobSystem::instance();
+    std::vector<Job> jobs;
+    jobs.push_back(jobSystem.submit([this] {
+        StartupPhase phase("shaders.path_tracer");
+        m_pathTracer->loadShaders();
+    }));
+    jobs.push_back(jobSystem.submit([this] {
+        StartupPhase phase("shaders.previewer");
+        m_previewer->loadShaders();
+    }));
+    jobs.push_back(jobSystem.submit([this] {
+        StartupPhase phase("shaders.post_processer");
+        m_postProcesser->loadShaders();
+    }));
+    return jobs;
+}
+
 void PathTracerApp::syncDirtyObjects(const std::unordered_set<DbObjHandle>& hObjects) {
+    TRACE_FUNCTION();
     std::vector<DbObjHandle> dirtyObjects(hObjects.begin(), hObjects.end());
     // sort by type priority: Scene > Model > Mesh > Material
     std::sort(
@@ -1028,6 +1263,174 @@ void PathTracerApp::updateUiStatusBar() {
     );
 }
 
+void PathTracerApp::updateGpuTimings() {
+    const std::array<std::pair<const char*, GfxRenderer>, 2> renderers = {
+        std::make_pair("main", m_window->getRenderer()),
+        std::make_pair("path_tracer", m_pathTracerCtx->getRenderer())
+    };
+
+    double totalMs = 0.0;
+    std::stringstream details;
+    details << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < renderers.size(); i++) {
+        std::vector<GfxTimerResult> results;
+        uint64_t serial = renderers[i].second->getTimerResults(results);
+        if (serial == 0)
+            continue;
+
+        // The path tracer timings stay on display while it is idle
+        for (const auto& result : results) {
+            if (result.depth == 0)
+                totalMs += result.ms;
+            details << std::string(result.depth * 2, ' ') << result.name << ": ";
+            details << result.ms << " ms\n";
+        }
+
+        if (serial != m_gpuTimerSerials[i]) {
+            MetricsRegistry& metrics = MetricsRegistry::instance();
+            std::string prefix = std::string("gpu.") + renderers[i].first + ".";
+            for (const auto& result : results)
+                metrics.gauge(prefix + result.name, "ms").set(result.ms);
+        }
+        if (m_gpuTraceFile.is_open() && serial != m_gpuTimerSerials[i]) {
+            for (const auto& result : results) {
+                m_gpuTraceFile << renderers[i].first << ',' << serial << ',';
+                m_gpuTraceFile << result.name << ',' << result.depth << ',' << result.ms << '\n';
+            }
+        }
+        m_gpuTimerSerials[i] = serial;
+    }
+
+    // Display image handoff of the path tracer
+    PathTracer::DisplayStats dspStats = m_pathTracer->getDisplayStats();
+    if (dspStats.published > 0) {
+        details << "Display latency: " << dspStats.lastLatencyMs << " ms (avg ";
+        details << dspStats.avgLatencyMs << " ms)\n";
+        details << "Display copies skipped: " << dspStats.skippedCopies << ", dropped: ";
+        details << dspStats.dropped << '\n';
+    }
+
+    m_statusBar->setWidgetValue(
+        static_cast<int>(UiStatusBar::ID::GPU_TIME),
+        static_cast<float>(totalMs)
+    );
+    m_statusBar->setWidgetValue(
+        static_cast<int>(UiStatusBar::ID::GPU_TIME_DETAILS),
+        details.str()
+    );
+}
+
+void PathTracerApp::updateMetrics() {
+    static constexpr double UPDATE_INTERVAL = 0.5; // Seconds between rate updates
+
+    MetricsRegistry& metrics = MetricsRegistry::instance();
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - m_metricsLastTime).count();
+    if (elapsed < UPDATE_INTERVAL)
+        return;
+    uint64_t samples = metrics.counter("path_tracer.samples", "samples").get();
+    uint64_t newSamples = samples >= m_metricsLastSamples ? samples - m_metricsLastSamples : 0;
+    double samplesPerSec = static_cast<double>(newSamples) / elapsed;
+    m_metricsLastSamples = samples;
+    m_metricsLastTime = now;
+
+    // Paths and rays per second are estimated from the sampled GPU statistics
+    double pathsPerSample = metrics.gauge("path_tracer.paths_per_sample", "paths").get();
+    double avgPathLength = metrics.gauge("path_tracer.avg_path_length", "rays").get();
+    double pathsPerSec = samplesPerSec * pathsPerSample;
+    double raysPerSec = pathsPerSec * avgPathLength;
+    metrics.gauge("path_tracer.samples_per_sec", "samples/s").set(samplesPerSec);
+    metrics.gauge("path_tracer.paths_per_sec", "paths/s").set(pathsPerSec);
+    metrics.gauge("path_tracer.rays_per_sec", "rays/s").set(raysPerSec);
+
+    std::stringstream details;
+    details << std::fixed << std::setprecision(2);
+    details << "Samples/s: " << samplesPerSec << '\n';
+    details << "Paths/s: " << pathsPerSec * 1e-6 << " M\n";
+    if (avgPathLength > 0.0) {
+        details << "Rays/s: " << raysPerSec * 1e-6 << " M\n";
+        details << "Avg path length: " << avgPathLength << '\n';
+        details << "Russian roulette terminations: ";
+        details << metrics.gauge("path_tracer.rr_termination_rate").get() * 100.0 << "%\n";
+        details << "BVH nodes per ray: ";
+        details << metrics.gauge("path_tracer.bvh_nodes_per_ray", "nodes").get() << '\n';
+        details << "Triangle tests per ray: ";
+        details << metrics.gauge("path_tracer.triangle_tests_per_ray", "tests").get() << '\n';
+        details << "Box tests per ray: ";
+        details << metrics.gauge("path_tracer.bvh_box_tests_per_ray", "tests").get() << '\n';
+    }
+    for (const auto& snapshot : metrics.snapshot()) {
+        if (snapshot.name != "path_tracer.frame_ms" || snapshot.count == 0)
+            continue;
+        details << "Frame time p50/p95: " << snapshot.p50 << " / " << snapshot.p95 << " ms\n";
+    }
+
+    m_statusBar->setWidgetValue(
+        static_cast<int>(UiStatusBar::ID::METRICS_DETAILS),
+        details.str()
+    );
+}
+
+void PathTracerApp::updateMemoryStats() {
+    static constexpr double UPDATE_INTERVAL = 1.0; // Seconds between updates
+
+    // Sizing the database walks all objects, only do it now and then
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<double>(now - m_memoryLastTime).count() < UPDATE_INTERVAL)
+        return;
+    m_memoryLastTime = now;
+
+    MemoryTracker& tracker = MemoryTracker::instance();
+    DB::MemoryUsage dbUsage = AppDataManager::instance().getDB()->getMemoryUsage();
+    tracker.set(MemoryTag::DB_OBJECTS, { dbUsage.objectBytes, 0, dbUsage.objectCount });
+    tracker.set(MemoryTag::DB_HISTORY, { dbUsage.historyBytes, 0, dbUsage.historyCount });
+
+    // All backends count into the same categories, the device totals are per renderer
+    GfxMemoryUsage gfxUsage = m_window->getRenderer()->getMemoryUsage();
+    GfxMemoryUsage ptUsage = m_pathTracerCtx->getRenderer()->getMemoryUsage();
+    uint64_t deviceReserved = gfxUsage.deviceReservedBytes + ptUsage.deviceReservedBytes;
+    uint64_t deviceUsed = gfxUsage.deviceUsedBytes + ptUsage.deviceUsedBytes;
+    // The GPU tags follow the order of the graphics memory categories
+    size_t firstGpuTag = static_cast<size_t>(MemoryTag::GPU_VERTEX_BUFFERS);
+    for (size_t i = 0; i < gfxUsage.categories.size(); i++) {
+        const GfxMemoryCategoryUsage& category = gfxUsage.categories[i];
+        MemoryTag tag = static_cast<MemoryTag>(firstGpuTag + i);
+        tracker.set(tag, { category.bytes, category.peakBytes, category.count });
+    }
+
+    m_memoryWindow->rows.clear();
+    for (size_t i = 0; i < MemoryTracker::N_TAGS; i++) {
+        MemoryTag tag = static_cast<MemoryTag>(i);
+        MemoryTagStats stats = tracker.getStats(tag);
+        m_memoryWindow->rows.push_back({
+            MemoryTracker::getTagName(tag),
+            MemoryTracker::formatBytes(stats.bytes),
+            MemoryTracker::formatBytes(stats.peakBytes),
+            std::to_string(stats.count)
+        });
+    }
+    m_memoryWindow->deviceText.clear();
+    if (deviceReserved > 0) {
+        m_memoryWindow->deviceText = MemoryTracker::formatBytes(deviceUsed) + " / " +
+            MemoryTracker::formatBytes(deviceReserved);
+    }
+}
+
+void PathTracerApp::saveMemoryReport() {
+    m_memoryLastTime = {};
+    updateMemoryStats();
+
+    std::filesystem::path traceDir = AppConfig::instance().getTracePath();
+    std::error_code ec;
+    std::filesystem::create_directories(traceDir, ec);
+    std::filesystem::path reportPath = traceDir / "memory_report.txt";
+    if (MemoryTracker::instance().writeReport(reportPath.string())) {
+        Logger() << "Failed to write memory report to " << reportPath.string();
+        return;
+    }
+    Logger(LogLevel::INFO, "app") << "Memory report written to " << reportPath.string();
+}
+
 void PathTracerApp::selectModel(const DbObjHandle& hModel) {
     if (m_modelUiListItemLookUp.count(hModel) == 0)
         return;
@@ -1297,7 +1700,7 @@ void PathTracerApp::exportImage() const {
     int nWaves = PtScene::getWaves(hScene).size();
     std::vector<float> data = {};
     if (m_pathTracer->getImageData(data, width, height, nWaves))
-        data.resize(static_cast<size_t>(width * height * nWaves), 0);
+        data.assign(static_cast<size_t>(width) * height * nWaves, 0.0f);
 
     // Write data to file
     std::ofstream file(filename);
@@ -1306,7 +1709,8 @@ void PathTracerApp::exportImage() const {
     for (int wave = 0; wave < nWaves; ++wave) {
         for (int row = height - 1; row >= 0; --row) {
             for (int col = 0; col < width; ++col) {
-                size_t idx = static_cast<size_t>(wave * height * width + row * width + col);
+                size_t idx =
+                    (static_cast<size_t>(wave) * height + row) * width + static_cast<size_t>(col);
                 file << data[idx];
                 if (col < width - 1)
                     file << " ";
@@ -1413,13 +1817,47 @@ void PathTracerApp::selectAllModels() {
     m_rightPanel->modelListView.selectAll();
 }
 
+void PathTracerApp::initWorkgroupSize() {
+    // "<x>x<y>" selects a size, "auto" or no value uses the size tuned for the device
+    std::string sizeStr = AppConfig::instance().getConfig("path_tracer_workgroup_size");
+    PathTracer::WorkgroupSize size = {};
+    if (!sizeStr.empty() && sizeStr != "auto") {
+        if (PathTracer::parseWorkgroupSize(sizeStr, size) || m_pathTracer->setWorkgroupSize(size))
+            Logger() << "Unsupported workgroup size " << sizeStr << " in PathTracerApp::init";
+        return;
+    }
+
+    // The tuned size is stored as "<device name>:<size>"
+    std::string deviceName = m_pathTracerCtx->getRenderer()->getDeviceInfo().name;
+    std::string tunedStr = AppConfig::instance().getConfig("path_tracer_workgroup_tuned");
+    size_t separator = tunedStr.rfind(':');
+    bool tuned =
+        separator != std::string::npos &&
+        tunedStr.substr(0, separator) == deviceName &&
+        PathTracer::parseWorkgroupSize(tunedStr.substr(separator + 1), size) == 0 &&
+        m_pathTracer->setWorkgroupSize(size) == 0;
+    if (tuned)
+        return;
+    m_pathTracer->startWorkgroupAutotune(
+        [deviceName](const PathTracer::WorkgroupSize& tunedSize) {
+            JobSystem::instance().postToMainThread([deviceName, tunedSize]() {
+                AppConfig::instance().setConfig(
+                    "path_tracer_workgroup_tuned",
+                    deviceName + ":" + tunedSize.getName()
+                );
+            });
+        }
+    );
+}
+
 void PathTracerApp::startRendering() {
     bool condition =
         m_currentRenderState == RenderState::IDLE ||
         m_currentRenderState == RenderState::PAUSED;
     if (!condition)
         return;
-    if (m_pathTracer->getCurrentSample() == 0) {
+    // Requests are applied by the render thread, the sample count may not be reset yet
+    if (m_currentRenderState == RenderState::IDLE) {
         GfxRenderer renderer = m_window->getRenderer();
         auto outputImage = m_postProcesser->getOutputImage();
         AppUiManager::instance().destroyImGuiTexture(renderer, outputImage);
@@ -1661,6 +2099,14 @@ void PathTracerApp::handleMenuBarEvent(const GuiEvent& event) {
         setDisplayMode(DisplayMode::PATH_TRACER_OUTPUT);
         break;
     }
+    case UiMenuBar::ID::VIEW_MEMORY_USAGE:
+    {
+        // Fill the table right away instead of waiting for the next periodic update
+        m_memoryLastTime = {};
+        updateMemoryStats();
+        m_memoryWindow->open();
+        break;
+    }
     case UiMenuBar::ID::HELP_ABOUT:
     {
         m_aboutWindow->appIconTexture = AppUiManager::instance().getImGuiTexture(
@@ -8,25 +8,87 @@
 #include "app/AppTextureManager.h"
 #include "utils/Logger.hpp"
 #include "utils/Flags.hpp"
+#include "utils/MemoryTracker.h"
+#include "utils/Metrics.h"
+#include "utils/Tracer.h"
 #include "res/ShaderStringsUtils.hpp"
 
-int PathTracer::init() {
+/**
+ * @brief Check if a device supports a workgroup size of the path tracing kernel.
+ * @param info The device information.
+ * @param x Invocations per workgroup in X.
+ * @param y Invocations per workgroup in Y.
+ * @return True if the size is within the compute limits of the device, false otherwise.
+ */
+static bool isWorkgroupSizeSupported(const GfxDeviceInfo& info, int x, int y) {
+    if (x <= 0 || y <= 0)
+        return false;
+    return static_cast<uint32_t>(x) <= info.maxComputeWorkGroupSize[0] &&
+        static_cast<uint32_t>(y) <= info.maxComputeWorkGroupSize[1] &&
+        static_cast<uint32_t>(x * y) <= info.maxComputeWorkGroupInvocations;
+}
+
+int PathTracer::loadShaders() {
     if (!m_renderer) {
-        Logger() << "Invalid renderer in PathTracer::init";
+        Logger() << "Invalid renderer in PathTracer::loadShaders";
         return 1;
     }
+    if (m_computeShader)
+        return 0;
+
+    // setWorkgroupSize() checks the sizes it selects, the default may exceed tight limits
+    GfxDeviceInfo info = m_renderer->getDeviceInfo();
+    if (!isWorkgroupSizeSupported(info, m_workgroupSize.x, m_workgroupSize.y)) {
+        std::vector<WorkgroupSize> candidates = getWorkgroupSizeCandidates();
+        if (!candidates.empty())
+            m_workgroupSize = candidates.front();
+    }
 
-    // Load shader
+    return compileShader(m_workgroupSize, m_stackSize);
+}
+
+int PathTracer::compileShader(const WorkgroupSize& size, int stackSize) {
+    TRACE_FUNCTION();
+    GfxShader shader = nullptr;
     try {
-        m_computeShader = m_renderer->createShader(
+        shader = m_renderer->createShader(
             GfxShaderStage::COMPUTE,
-            ShaderStrings::get("pathTracer.comp")
+            ShaderStrings::addDefines(
+                ShaderStrings::getResolved("pathTracer.comp"),
+                {
+                    { "WORKGROUP_SIZE_X", std::to_string(size.x) },
+                    { "WORKGROUP_SIZE_Y", std::to_string(size.y) },
+                    { "BVH_STACK_SIZE", std::to_string(stackSize) },
+                }
+            )
         );
     } catch (GfxShaderException& e) {
-        Logger() << "Shader compilation error in PathTracer::init: " << e.what();
+        Logger() << "Shader compilation error in PathTracer::compileShader: " <<
+            ShaderStrings::mapSourceNames(e.what());
+        return 1;
+    }
+    if (!shader) {
+        Logger() << "Failed to create compute shader in PathTracer::compileShader";
+        return 1;
+    }
+
+    if (m_computeShader)
+        m_renderer->destroyShader(m_computeShader);
+    m_computeShader = shader;
+    m_shaderWorkgroupSize = size;
+    m_stackSize = stackSize;
+    return 0;
+}
+
+int PathTracer::init() {
+    if (!m_renderer) {
+        Logger() << "Invalid renderer in PathTracer::init";
         return 1;
     }
 
+    if (loadShaders())
+        return 1;
+
     /* Initialize descriptors and UBOs */
     m_descriptors.b_outRadiances.binding = 0;
     m_descriptors.b_outRadiances.type = GfxDescriptorType::STORAGE_BUFFER;
@@ -99,6 +161,25 @@ int PathTracer::init() {
     m_descriptors.b_spMaterials.type = GfxDescriptorType::STORAGE_BUFFER;
     m_descriptors.b_spMaterials.stages.set(GfxShaderStage::COMPUTE);
 
+    m_descriptors.b_stats.binding = 11;
+    m_descriptors.b_stats.type = GfxDescriptorType::STORAGE_BUFFER;
+    m_descriptors.b_stats.stages.set(GfxShaderStage::COMPUTE);
+    m_descriptors.b_intersect.binding = 12;
+    m_descriptors.b_intersect.type = GfxDescriptorType::STORAGE_BUFFER;
+    m_descriptors.b_intersect.stages.set(GfxShaderStage::COMPUTE);
+
+    m_ssboStats = m_renderer->createBuffer(
+        sizeof(GpuStats),
+        GfxBufferUsage::STORAGE_BUFFER,
+        GfxBufferProp::DYNAMIC
+    );
+    if (!m_ssboStats) {
+        Logger() << "Failed to create stats buffer in PathTracer::init";
+        return 1;
+    }
+    GpuStats stats = {};
+    m_renderer->setBufferData(m_ssboStats, sizeof(stats), &stats);
+
     return 0;
 }
 
@@ -111,12 +192,14 @@ void PathTracer::term() {
     m_renderer->destroyBuffer(m_uboScene);
     m_renderer->destroyBuffer(m_uboCamera);
     m_renderer->destroyBuffer(m_uboSpScene);
+    m_renderer->destroyBuffer(m_ssboStats);
     m_renderer->destroyShader(m_computeShader);
 
     m_descriptors = {};
 }
 
 int PathTracer::buildScene(const DbObjHandle& hScene) {
+    TRACE_FUNCTION();
     if (!hScene.isValid() || hScene.getType() != PtScene::TYPE_NAME) {
         Logger() << "Invalid scene handle in PathTracer::buildScene";
         return 1;
@@ -138,35 +221,24 @@ int PathTracer::buildScene(const DbObjHandle& hScene) {
 
     /* Load models */
     loadModels(hScene, hSpMaterialIdxMap, bufferData);
+    TrackedMemory bufferMemory(MemoryTag::SCENE_BUFFERS, bufferData.getMemorySize());
 
     m_renderer->waitDeviceIdle();
 
-    /* Create pipeline */
-    m_descriptors.u_textures.size = static_cast<int>(bufferData.textures.size());
-    if (m_pipeline)
-        m_renderer->destroyPipeline(m_pipeline);
-    m_pipeline = m_renderer->createPipeline(
-        { m_computeShader },
-        {
-            {
-                m_descriptors.b_outRadiances,
-                m_descriptors.u_scene,
-                m_descriptors.u_camera,
-                m_descriptors.u_textures,
-                m_descriptors.b_vertices,
-                m_descriptors.b_triangles,
-                m_descriptors.b_materials,
-                m_descriptors.b_BVH,
-                m_descriptors.u_spScene,
-                m_descriptors.b_waves,
-                m_descriptors.b_spMaterials,
-            }
-        }
-    );
-    if (!m_pipeline) {
-        Logger() << "Failed to create pipeline in PathTracer::buildScene";
+    /* Compile the shader for the selected workgroup size and the depth of the BVH */
+    // Every level of the BVH holds at most one pending node on the traversal stack
+    int stackSize = MIN_STACK_SIZE;
+    while (stackSize < bufferData.bvhDepth)
+        stackSize *= 2;
+    bool shaderChanged =
+        !m_computeShader ||
+        m_shaderWorkgroupSize != m_workgroupSize ||
+        m_stackSize != stackSize;
+    if (shaderChanged && compileShader(m_workgroupSize, stackSize)) {
+        Logger() << "Failed to compile shader in PathTracer::buildScene";
         return 1;
     }
+    m_descriptors.u_textures.size = static_cast<int>(bufferData.textures.size());
 
     /* Create GPU buffers */
     if (createBuffers(bufferData)) {
@@ -175,6 +247,7 @@ int PathTracer::buildScene(const DbObjHandle& hScene) {
     }
 
     /* Create output and display image */
+    size_t outImageSize = sizeof(float) * m_resolutionX * m_resolutionY * m_nWaves;
     if (m_outImage)
         m_renderer->destroyBuffer(m_outImage);
     GfxImageInfo outImgInfo = {};
@@ -183,56 +256,61 @@ int PathTracer::buildScene(const DbObjHandle& hScene) {
     outImgInfo.format = GfxFormat::R32G32B32A32_SFLOAT;
     outImgInfo.usages = GfxImageUsage::STORAGE_IMAGE;
     m_outImage = m_renderer->createBuffer(
-        static_cast<int>(sizeof(float) * m_resolutionX * m_resolutionY * m_nWaves),
+        outImageSize,
         GfxBufferUsage::STORAGE_BUFFER,
-        GfxBufferProp::DYNAMIC
+        GfxBufferProp::STATIC
     );
     if (!m_outImage) {
         Logger() << "Failed to create output image in PathTracer::buildScene";
         return 1;
     }
-    if (m_dspImageFront)
-        m_renderer->destroyBuffer(m_dspImageFront);
-    if (m_dspImageBack)
-        m_renderer->destroyBuffer(m_dspImageBack);
-    GfxImageInfo dspImgInfo = {};
-    dspImgInfo.width = m_resolutionX;
-    dspImgInfo.height = m_resolutionY;
-    dspImgInfo.format = GfxFormat::R32G32B32A32_SFLOAT;
-    dspImgInfo.usages.set(GfxImageUsage::COLOR_ATTACHMENT);
-    dspImgInfo.usages.set(GfxImageUsage::SAMPLED_TEXTURE);
-    m_dspImageFront = m_renderer->createBuffer(
-        static_cast<int>(sizeof(float) * m_resolutionX * m_resolutionY * m_nWaves),
-        GfxBufferUsage::STORAGE_BUFFER,
-        GfxBufferProp::DYNAMIC
-    );
-    m_dspImageBack = m_renderer->createBuffer(
-        static_cast<int>(sizeof(float) * m_resolutionX * m_resolutionY * m_nWaves),
-        GfxBufferUsage::STORAGE_BUFFER,
-        GfxBufferProp::DYNAMIC
-    );
-    if (!m_dspImageFront || !m_dspImageBack) {
-        Logger() << "Failed to create display image in PathTracer::buildScene";
+    for (GfxBuffer& dspImage : m_dspImages) {
+        if (dspImage)
+            m_renderer->destroyBuffer(dspImage);
+        dspImage = m_renderer->createBuffer(
+            outImageSize,
+            GfxBufferUsage::STORAGE_BUFFER,
+            GfxBufferProp::DYNAMIC
+        );
+        if (!dspImage) {
+            Logger() << "Failed to create display image in PathTracer::buildScene";
+            return 1;
+        }
+    }
+    resetDisplayImages();
+
+    /* Create pipeline and descriptor set binding */
+    m_bindings.clear();
+    m_bindings.reserve(13);
+    m_bindings.push_back({ m_descriptors.b_outRadiances, m_outImage });
+    m_bindings.push_back({ m_descriptors.u_scene, m_uboScene });
+    m_bindings.push_back({ m_descriptors.u_camera, m_uboCamera });
+    m_bindings.push_back({ m_descriptors.u_textures, bufferData.textures });
+    m_bindings.push_back({ m_descriptors.b_vertices, m_ssboVertex });
+    m_bindings.push_back({ m_descriptors.b_triangles, m_ssboTriangle });
+    m_bindings.push_back({ m_descriptors.b_materials, m_ssboMaterial });
+    m_bindings.push_back({ m_descriptors.b_BVH, m_ssboBVH });
+    m_bindings.push_back({ m_descriptors.u_spScene, m_uboSpScene });
+    m_bindings.push_back({ m_descriptors.b_waves, m_ssboWaves });
+    m_bindings.push_back({ m_descriptors.b_spMaterials, m_ssboSpMaterials });
+    m_bindings.push_back({ m_descriptors.b_stats, m_ssboStats });
+    m_bindings.push_back({ m_descriptors.b_intersect, m_ssboIntersect });
+    if (createKernel()) {
+        Logger() << "Failed to create pipeline in PathTracer::buildScene";
         return 1;
     }
 
-    /* Create descriptor set binding */
-    if (m_descriptorSetBinding)
-        m_renderer->destroyDescriptorSetBinding(m_descriptorSetBinding);
-    std::vector<GfxDescriptorBinding> bindings = {};
-    bindings.reserve(11);
-    bindings.push_back({ m_descriptors.b_outRadiances, m_outImage });
-    bindings.push_back({ m_descriptors.u_scene, m_uboScene });
-    bindings.push_back({ m_descriptors.u_camera, m_uboCamera });
-    bindings.push_back({ m_descriptors.u_textures, bufferData.textures });
-    bindings.push_back({ m_descriptors.b_vertices, m_ssboVertex });
-    bindings.push_back({ m_descriptors.b_triangles, m_ssboTriangle });
-    bindings.push_back({ m_descriptors.b_materials, m_ssboMaterial });
-    bindings.push_back({ m_descriptors.b_BVH, m_ssboBVH });
-    bindings.push_back({ m_descriptors.u_spScene, m_uboSpScene });
-    bindings.push_back({ m_descriptors.b_waves, m_ssboWaves });
-    bindings.push_back({ m_descriptors.b_spMaterials, m_ssboSpMaterials });
-    m_descriptorSetBinding = m_renderer->createDescriptorSetBinding(m_pipeline, 0, bindings);
+    /* Start workgroup size autotuning */
+    m_autotune.active = false;
+    if (m_autotune.requested) {
+        m_autotune.requested = false;
+        m_autotune.candidates = getWorkgroupSizeCandidates();
+        m_autotune.times.assign(m_autotune.candidates.size(), {});
+        m_autotune.current = 0;
+        m_autotune.frames = 0;
+        m_autotune.lastSerial = 0;
+        m_autotune.active = !m_autotune.candidates.empty();
+    }
 
     /* Load scene settings and update UBOs */
     UScene u_scene = {};
@@ -240,6 +318,9 @@ int PathTracer::buildScene(const DbObjHandle& hScene) {
     u_scene.resY = m_resolutionY;
     u_scene.traceDepth = PtScene::getTraceDepth(hScene);
     m_currentSample = 0;
+    MetricsRegistry::instance().gauge("path_tracer.paths_per_sample", "paths").set(
+        static_cast<double>(m_resolutionX) * static_cast<double>(m_resolutionY)
+    );
     if (m_renderer->updateBufferData(m_uboScene, 0, sizeof(u_scene), &u_scene)) {
         Logger() << "Failed to update scene UBO in PathTracer::buildScene";
         return 1;
@@ -270,6 +351,11 @@ void PathTracer::clearScene() {
         return;
     m_renderer->waitDeviceIdle();
 
+    if (m_statsReadback) {
+        m_renderer->releaseReadback(m_statsReadback);
+        m_statsReadback = nullptr;
+    }
+    destroyFrameCommands();
     if (m_descriptorSetBinding) {
         m_renderer->destroyDescriptorSetBinding(m_descriptorSetBinding);
         m_descriptorSetBinding = nullptr;
@@ -278,14 +364,13 @@ void PathTracer::clearScene() {
         m_renderer->destroyBuffer(m_outImage);
         m_outImage = nullptr;
     }
-    if (m_dspImageFront) {
-        m_renderer->destroyBuffer(m_dspImageFront);
-        m_dspImageFront = nullptr;
-    }
-    if (m_dspImageBack) {
-        m_renderer->destroyBuffer(m_dspImageBack);
-        m_dspImageBack = nullptr;
+    for (GfxBuffer& dspImage : m_dspImages) {
+        if (dspImage) {
+            m_renderer->destroyBuffer(dspImage);
+            dspImage = nullptr;
+        }
     }
+    resetDisplayImages();
 
     if (m_ssboVertex) {
         m_renderer->destroyBuffer(m_ssboVertex);
@@ -303,6 +388,10 @@ void PathTracer::clearScene() {
         m_renderer->destroyBuffer(m_ssboBVH);
         m_ssboBVH = nullptr;
     }
+    if (m_ssboIntersect) {
+        m_renderer->destroyBuffer(m_ssboIntersect);
+        m_ssboIntersect = nullptr;
+    }
     if (m_ssboWaves) {
         m_renderer->destroyBuffer(m_ssboWaves);
         m_ssboWaves = nullptr;
@@ -316,41 +405,100 @@ void PathTracer::clearScene() {
         m_renderer->destroyPipeline(m_pipeline);
         m_pipeline = nullptr;
     }
+    m_bindings.clear();
+    m_autotune.active = false;
 
     m_currentSample = 0;
 }
 
 int PathTracer::renderFrame() {
-    m_renderer->bindPipeline(m_pipeline);
-
-    // Update current sample in UBO
-    m_currentSample++;
-    int err = m_renderer->updateBufferData(
-        m_uboScene,
-        static_cast<int>(offsetof(UScene, currentSample)),
-        static_cast<int>(sizeof(uint32_t)),
-        &m_currentSample
-    );
-    if (err)
+    TRACE_FUNCTION();
+    if (!m_traceCommands)
         return 1;
-    m_renderer->bindDescriptorSetBinding(m_descriptorSetBinding);
 
-    // Dispatch compute shader
-    m_renderer->dispatchCompute(
-        static_cast<int>(std::ceil(static_cast<float>(m_resolutionX) / 32.0f)),
-        static_cast<int>(std::ceil(static_cast<float>(m_resolutionY) / 32.0f)),
-        1
-    );
-    m_renderer->memoryBarrier();
-
-    // Copy output image to display image
-    m_renderer->copyBuffer(
-        m_outImage,
-        m_dspImageBack,
-        0,
-        0,
-        static_cast<int>(sizeof(float) * m_resolutionX * m_resolutionY * m_nWaves)
-    );
+    static MetricCounter& samplesMetric =
+        MetricsRegistry::instance().counter("path_tracer.samples", "samples");
+
+    collectStats();
+
+    bool presentOnly = m_presentOnly;
+    m_presentOnly = false;
+    if (!presentOnly) {
+        uint32_t currentSample = ++m_currentSample;
+        // Record stats only once the previous ones were read, they share the buffer
+        bool recordStats =
+            m_statsEnabled.load(std::memory_order_relaxed) &&
+            !m_statsReadback &&
+            currentSample % STATS_INTERVAL == 1 % STATS_INTERVAL;
+        if (recordStats) {
+            GpuStats stats = {};
+            if (m_renderer->updateBufferData(m_ssboStats, 0, sizeof(stats), &stats))
+                recordStats = false;
+        }
+
+        // Update current sample in UBO, the recorded commands read it from there
+        int sceneData[2] = { static_cast<int>(currentSample), recordStats ? 1 : 0 };
+        static_assert(
+            offsetof(UScene, collectStats) == offsetof(UScene, currentSample) + sizeof(int),
+            "The sample and stats flag are updated together"
+        );
+        int err = m_renderer->updateBufferData(
+            m_uboScene,
+            offsetof(UScene, currentSample),
+            sizeof(sceneData),
+            sceneData
+        );
+        if (err)
+            return 1;
+        TRACE_COUNTER("Samples", currentSample);
+        samplesMetric.add();
+
+        if (m_autotune.active) {
+            updateAutotune();
+            if (!m_traceCommands)
+                return 1;
+        }
+
+        // Dispatch compute shader
+        {
+            GfxTimerScope timer(m_renderer, "Path Trace");
+            // Candidates are timed in a nested scope named after them
+            std::optional<GfxTimerScope> autotuneTimer;
+            if (m_autotune.active) {
+                autotuneTimer.emplace(m_renderer, "Workgroup " + m_shaderWorkgroupSize.getName());
+                m_autotune.frames++;
+            }
+            m_renderer->executeCommandList(m_traceCommands);
+        }
+        // Recorded into the frame after the dispatch, collected by a later frame once it arrived
+        if (recordStats)
+            m_statsReadback = m_renderer->readBufferDataAsync(m_ssboStats, 0, sizeof(GpuStats));
+    }
+
+    // Copy output image to display image only once the display took the previous one and the
+    // back image is not held back for its frame, the samples rendered meanwhile are shown by
+    // the next copy
+    m_dspBackWritten = false;
+    bool displayReady = !(m_dspMailbox.load(std::memory_order_acquire) & DSP_MAILBOX_FULL) &&
+        !m_dspPendingFrame;
+    if (!displayReady && !presentOnly) {
+        m_dspStale = true;
+        m_dspSkippedCopies.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    {
+        GfxTimerScope timer(m_renderer, "Display Copy");
+        // The display renderer may still read the image in a frame in flight
+        if (m_dspReaders[m_dspBack] && m_dspReadValues[m_dspBack])
+            m_renderer->waitForRenderer(m_dspReaders[m_dspBack], m_dspReadValues[m_dspBack]);
+        m_dspReaders[m_dspBack] = nullptr;
+        m_dspReadValues[m_dspBack] = 0;
+        m_renderer->executeCommandList(m_copyCommands[m_dspBack]);
+        // The display renderer may run on another queue family
+        m_renderer->releaseBuffer(m_dspImages[m_dspBack]);
+    }
+    m_dspBackWritten = true;
+    m_dspStale = false;
 
     return 0;
 }
@@ -360,22 +508,153 @@ uint32_t PathTracer::getCurrentSample() const {
 }
 
 GfxBuffer PathTracer::getCurrentDisplayImage() const {
-    return m_dspImageFront;
+    return m_dspImages[m_dspFront];
+}
+
+std::vector<GfxBuffer> PathTracer::getDisplayImages() const {
+    return std::vector<GfxBuffer>(m_dspImages.begin(), m_dspImages.end());
+}
+
+bool PathTracer::markDisplayImageReady(uint64_t syncValue, bool wait) {
+    if (m_dspBackWritten) {
+        m_dspBackWritten = false;
+        m_dspPendingFrame = syncValue ? 0 : m_renderer->getFrameSerial();
+    } else if (!m_dspPendingFrame)
+        return false;
+    if (m_dspPendingFrame) {
+        // The display renderer cannot wait on the device, poll the fence of the frame
+        if (wait)
+            m_renderer->waitFrames();
+        else if (!m_renderer->isFrameComplete(m_dspPendingFrame))
+            return false;
+        m_dspPendingFrame = 0;
+    }
+
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    m_dspSyncValues[m_dspBack] = syncValue;
+    m_dspPublishTimes[m_dspBack] =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+    // The publish time identifies the image until it is taken
+    TRACE_FLOW_BEGIN("Display Image", m_dspPublishTimes[m_dspBack]);
+    uint32_t previous =
+        m_dspMailbox.exchange(m_dspBack | DSP_MAILBOX_FULL, std::memory_order_acq_rel);
+    m_dspBack = static_cast<int>(previous & ~DSP_MAILBOX_FULL);
+    if (previous & DSP_MAILBOX_FULL)
+        m_dspDropped.fetch_add(1, std::memory_order_relaxed);
+    m_dspPublished.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void PathTracer::syncDisplayImage(const GfxRenderer& renderer) {
+    // Only this thread empties the mailbox, it stays full until the exchange below
+    if (!(m_dspMailbox.load(std::memory_order_acquire) & DSP_MAILBOX_FULL))
+        return;
+
+    // The render thread waits for the frames reading the image before it writes it again
+    m_dspReaders[m_dspFront] = renderer;
+    m_dspReadValues[m_dspFront] = renderer->getFrameSyncValue();
+    uint32_t taken = m_dspMailbox.exchange(m_dspFront, std::memory_order_acq_rel);
+    m_dspFront = static_cast<int>(taken & ~DSP_MAILBOX_FULL);
+    TRACE_FLOW_END("Display Image", m_dspPublishTimes[m_dspFront]);
+
+    uint64_t syncValue = m_dspSyncValues[m_dspFront];
+    if (syncValue)
+        renderer->waitForRenderer(m_renderer, syncValue);
+
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    int64_t latencyNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() -
+        m_dspPublishTimes[m_dspFront];
+    m_dspLastLatencyMs = static_cast<double>(latencyNs) * 1e-6;
+    m_dspTotalLatencyMs += m_dspLastLatencyMs;
+    m_dspPresented++;
+}
+
+PathTracer::DisplayStats PathTracer::getDisplayStats() const {
+    DisplayStats stats = {};
+    stats.published = m_dspPublished.load(std::memory_order_relaxed);
+    stats.presented = m_dspPresented;
+    stats.skippedCopies = m_dspSkippedCopies.load(std::memory_order_relaxed);
+    stats.dropped = m_dspDropped.load(std::memory_order_relaxed);
+    stats.lastLatencyMs = m_dspLastLatencyMs;
+    if (m_dspPresented > 0)
+        stats.avgLatencyMs = m_dspTotalLatencyMs / static_cast<double>(m_dspPresented);
+    return stats;
+}
+
+void PathTracer::setStatsEnabled(bool enabled) {
+    m_statsEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+int PathTracer::parseWorkgroupSize(const std::string& str, WorkgroupSize& size) {
+    int x = 0;
+    int y = 0;
+    char extra = 0;
+    if (std::sscanf(str.c_str(), "%dx%d%c", &x, &y, &extra) != 2 || x <= 0 || y <= 0)
+        return 1;
+    size.x = x;
+    size.y = y;
+    return 0;
+}
+
+std::vector<PathTracer::WorkgroupSize> PathTracer::getWorkgroupSizeCandidates() const {
+    static const WorkgroupSize CANDIDATES[] = {
+        { 8, 8 }, { 16, 8 }, { 8, 16 }, { 16, 16 }, { 32, 8 }, { 32, 16 }, { 32, 32 },
+    };
+    std::vector<WorkgroupSize> candidates;
+    if (!m_renderer)
+        return candidates;
+    GfxDeviceInfo info = m_renderer->getDeviceInfo();
+    for (const auto& candidate : CANDIDATES) {
+        if (isWorkgroupSizeSupported(info, candidate.x, candidate.y))
+            candidates.push_back(candidate);
+    }
+    return candidates;
+}
+
+int PathTracer::setWorkgroupSize(const WorkgroupSize& size) {
+    if (!m_renderer || !isWorkgroupSizeSupported(m_renderer->getDeviceInfo(), size.x, size.y))
+        return 1;
+    m_workgroupSize = size;
+    return 0;
 }
 
-std::array<GfxBuffer, 2> PathTracer::getDisplayImages() const {
-    return { m_dspImageFront, m_dspImageBack };
+PathTracer::WorkgroupSize PathTracer::getWorkgroupSize() const {
+    return m_workgroupSize;
 }
 
-void PathTracer::markDisplayImageReady() {
-    m_dspImgSwapPending.store(true, std::memory_order_release);
+void PathTracer::startWorkgroupAutotune(const std::function<void(const WorkgroupSize&)>& cb) {
+    m_autotune.requested = true;
+    m_autotune.callback = cb;
 }
 
-void PathTracer::syncDisplayImage() {
-    if (m_dspImgSwapPending.load(std::memory_order_acquire)) {
-        std::swap(m_dspImageFront, m_dspImageBack);
-        m_dspImgSwapPending.store(false, std::memory_order_release);
+void PathTracer::collectStats() {
+    if (!m_statsReadback || !m_renderer->isReadbackReady(m_statsReadback))
+        return;
+
+    const void* data = m_renderer->mapReadback(m_statsReadback, false);
+    const auto* stats = static_cast<const GpuStats*>(data);
+    if (stats && stats->paths > 0) {
+        MetricsRegistry& metrics = MetricsRegistry::instance();
+        metrics.counter("path_tracer.sampled_paths", "paths").add(stats->paths);
+        metrics.counter("path_tracer.sampled_rays", "rays").add(stats->rays);
+        metrics.counter("path_tracer.rr_terminations", "paths").add(stats->rrTerminations);
+        metrics.counter("path_tracer.bvh_nodes_visited", "nodes").add(stats->nodesVisited);
+        metrics.counter("path_tracer.triangle_tests", "tests").add(stats->triangleTests);
+        metrics.counter("path_tracer.bvh_box_tests", "tests").add(stats->boxTests);
+
+        double paths = static_cast<double>(stats->paths);
+        double rays = std::max(1.0, static_cast<double>(stats->rays));
+        metrics.gauge("path_tracer.avg_path_length", "rays").set(stats->rays / paths);
+        metrics.gauge("path_tracer.rr_termination_rate").set(stats->rrTerminations / paths);
+        metrics.gauge("path_tracer.bvh_nodes_per_ray", "nodes").set(stats->nodesVisited / rays);
+        metrics.gauge("path_tracer.triangle_tests_per_ray", "tests").set(
+            stats->triangleTests / rays
+        );
+        metrics.gauge("path_tracer.bvh_box_tests_per_ray", "tests").set(stats->boxTests / rays);
     }
+    m_renderer->releaseReadback(m_statsReadback);
+    m_statsReadback = nullptr;
 }
 
 int PathTracer::getImageData(
@@ -386,10 +665,18 @@ int PathTracer::getImageData(
 ) const {
     if (!m_renderer || !m_outImage)
         return 1;
-    int size = m_resolutionX * m_resolutionY * m_nWaves;
-    std::vector<float> data(size);
-    pixels.resize(size);
-    if (m_renderer->readBufferData(m_outImage, 0, size * sizeof(float), data.data()))
+    size_t size = static_cast<size_t>(m_resolutionX) * m_resolutionY * m_nWaves;
+
+    // Submit the copy on its own, mapReadback() then waits only for its fence while the render
+    // thread keeps submitting frames
+    GfxReadback readback = m_renderer->readBufferDataAsync(m_outImage, 0, size * sizeof(float));
+    if (!readback)
+        return 1;
+    const float* data = static_cast<const float*>(m_renderer->mapReadback(readback, true));
+    if (data)
+        pixels.assign(data, data + size);
+    m_renderer->releaseReadback(readback);
+    if (!data)
         return 1;
     width = m_resolutionX;
     height = m_resolutionY;
@@ -398,21 +685,78 @@ int PathTracer::getImageData(
 }
 
 void PathTracer::render() {
-    m_rendering = true;
+    pushRequest(Request::RENDER);
 }
 
 void PathTracer::pause() {
-    m_rendering = false;
+    pushRequest(Request::PAUSE);
 }
 
 void PathTracer::stop() {
-    m_rendering = false;
-    m_currentSample = 0;
+    pushRequest(Request::STOP);
 }
 
 void PathTracer::restart() {
-    m_currentSample = 0;
-    m_rendering = true;
+    pushRequest(Request::RESTART);
+}
+
+void PathTracer::close() {
+    pushRequest(Request::CLOSE);
+}
+
+PathTracer::Work PathTracer::waitForWork() {
+    std::unique_lock<std::mutex> lock(m_requestMutex);
+    bool finished = m_finishPending;
+    m_finishPending = false;
+    while (true) {
+        while (!m_requests.empty()) {
+            Request request = m_requests.front();
+            m_requests.pop_front();
+            switch (request) {
+            case Request::RENDER:
+                m_rendering = true;
+                break;
+            case Request::PAUSE:
+                m_rendering = false;
+                finished = true;
+                break;
+            case Request::STOP:
+                m_rendering = false;
+                m_currentSample = 0;
+                finished = true;
+                break;
+            case Request::RESTART:
+                m_currentSample = 0;
+                m_rendering = true;
+                break;
+            case Request::CLOSE:
+                m_closed = true;
+                break;
+            }
+        }
+        if (m_closed)
+            return Work::CLOSE;
+        if (finished) {
+            // Show the last samples first, their display copy may have been skipped
+            if (m_dspStale && m_currentSample > 0) {
+                m_presentOnly = true;
+                m_finishPending = true;
+                return Work::PRESENT;
+            }
+            return Work::FINISHED;
+        }
+        if (m_rendering)
+            return Work::FRAME;
+        m_requestCv.wait(lock, [this] { return !m_requests.empty(); });
+    }
+}
+
+void PathTracer::pushRequest(Request request) {
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_requests.push_back(request);
+    }
+    m_requestCv.notify_one();
 }
 
 bool PathTracer::isRendering() const {
@@ -434,11 +778,194 @@ void PathTracer::setRenderFinishCallback(const std::function<void()>& cb) {
     m_renderFinishCb = cb;
 }
 
+int PathTracer::createKernel() {
+    if (m_descriptorSetBinding) {
+        m_renderer->destroyDescriptorSetBinding(m_descriptorSetBinding);
+        m_descriptorSetBinding = nullptr;
+    }
+    if (m_pipeline)
+        m_renderer->destroyPipeline(m_pipeline);
+    m_pipeline = m_renderer->createPipeline(
+        { m_computeShader },
+        {
+            {
+                m_descriptors.b_outRadiances,
+                m_descriptors.u_scene,
+                m_descriptors.u_camera,
+                m_descriptors.u_textures,
+                m_descriptors.b_vertices,
+                m_descriptors.b_triangles,
+                m_descriptors.b_materials,
+                m_descriptors.b_BVH,
+                m_descriptors.u_spScene,
+                m_descriptors.b_waves,
+                m_descriptors.b_spMaterials,
+                m_descriptors.b_stats,
+                m_descriptors.b_intersect,
+            }
+        }
+    );
+    if (!m_pipeline)
+        return 1;
+    m_descriptorSetBinding = m_renderer->createDescriptorSetBinding(m_pipeline, 0, m_bindings);
+    if (!m_descriptorSetBinding)
+        return 1;
+
+    return recordFrameCommands();
+}
+
+void PathTracer::updateAutotune() {
+    TRACE_FUNCTION();
+    // Timings arrive a few frames late, the name of their scope tells the candidate
+    std::vector<GfxTimerResult> results;
+    uint64_t serial = m_renderer->getTimerResults(results);
+    if (serial != 0 && serial != m_autotune.lastSerial) {
+        m_autotune.lastSerial = serial;
+        for (const auto& result : results) {
+            for (size_t i = 0; i < m_autotune.candidates.size(); i++) {
+                if (result.name == "Workgroup " + m_autotune.candidates[i].getName())
+                    m_autotune.times[i].push_back(result.ms);
+            }
+        }
+    }
+
+    if (m_autotune.current > 0 && m_autotune.frames < AUTOTUNE_FRAMES)
+        return;
+    m_autotune.frames = 0;
+
+    // Switch to the next candidate, the last one keeps rendering while its timings arrive
+    size_t nCandidates = m_autotune.candidates.size();
+    WorkgroupSize size = m_shaderWorkgroupSize;
+    bool finished = m_autotune.current > nCandidates;
+    if (!finished) {
+        if (m_autotune.current < nCandidates)
+            size = m_autotune.candidates[m_autotune.current];
+        m_autotune.current++;
+    } else {
+        // Keep the candidate with the lowest median time
+        size = m_workgroupSize;
+        double bestMs = std::numeric_limits<double>::max();
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(3);
+        for (size_t i = 0; i < nCandidates; i++) {
+            std::vector<double>& times = m_autotune.times[i];
+            if (times.empty())
+                continue;
+            std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+            double medianMs = times[times.size() / 2];
+            ss << ' ' << m_autotune.candidates[i].getName() << ' ' << medianMs << " ms";
+            if (medianMs < bestMs) {
+                bestMs = medianMs;
+                size = m_autotune.candidates[i];
+            }
+        }
+        m_autotune.active = false;
+        m_workgroupSize = size;
+        if (bestMs == std::numeric_limits<double>::max()) {
+            Logger(LogLevel::INFO, "path_tracer") <<
+                "No GPU timings for workgroup autotuning, keeping " << size.getName();
+        } else {
+            Logger(LogLevel::INFO, "path_tracer") << "Workgroup autotuning:" << ss.str() <<
+                ", using " << size.getName();
+        }
+    }
+
+    if (size != m_shaderWorkgroupSize) {
+        // The frames in flight may still use the pipeline and the recorded commands
+        m_renderer->waitFrames();
+        WorkgroupSize previous = m_shaderWorkgroupSize;
+        if (compileShader(size, m_stackSize) || createKernel()) {
+            Logger() << "Failed to switch to workgroup size " << size.getName() <<
+                " in PathTracer::updateAutotune";
+            m_autotune.active = false;
+            m_workgroupSize = previous;
+            if (m_shaderWorkgroupSize != previous)
+                compileShader(previous, m_stackSize);
+            createKernel();
+            return;
+        }
+    }
+
+    if (finished && m_autotune.callback) {
+        m_autotune.callback(m_workgroupSize);
+        m_autotune.callback = nullptr;
+    }
+}
+
+int PathTracer::recordFrameCommands() {
+    destroyFrameCommands();
+
+    m_traceCommands = m_renderer->createCommandList();
+    if (!m_traceCommands)
+        return 1;
+    int err = m_renderer->recordCommandList(m_traceCommands, [this]() {
+        m_renderer->bindPipeline(m_pipeline);
+        m_renderer->bindDescriptorSetBinding(m_descriptorSetBinding);
+        m_renderer->dispatchCompute(
+            (m_resolutionX + m_shaderWorkgroupSize.x - 1) / m_shaderWorkgroupSize.x,
+            (m_resolutionY + m_shaderWorkgroupSize.y - 1) / m_shaderWorkgroupSize.y,
+            1
+        );
+        m_renderer->memoryBarrier();
+    });
+    if (err)
+        return 1;
+
+    // The display images cycle between the threads, record a copy into each of them
+    for (size_t i = 0; i < m_copyCommands.size(); i++) {
+        m_copyCommands[i] = m_renderer->createCommandList();
+        if (!m_copyCommands[i])
+            return 1;
+        GfxBuffer target = m_dspImages[i];
+        err = m_renderer->recordCommandList(m_copyCommands[i], [this, target]() {
+            m_renderer->copyBuffer(m_outImage, target, 0, 0, m_outImage->getSize());
+        });
+        if (err)
+            return 1;
+    }
+
+    return 0;
+}
+
+void PathTracer::destroyFrameCommands() {
+    if (m_traceCommands) {
+        m_renderer->destroyCommandList(m_traceCommands);
+        m_traceCommands = nullptr;
+    }
+    for (GfxCommandList& copyCommands : m_copyCommands) {
+        if (copyCommands) {
+            m_renderer->destroyCommandList(copyCommands);
+            copyCommands = nullptr;
+        }
+    }
+}
+
+void PathTracer::resetDisplayImages() {
+    m_dspFront = 0;
+    m_dspBack = 1;
+    m_dspMailbox.store(2, std::memory_order_release);
+    m_dspSyncValues = {};
+    m_dspPublishTimes = {};
+    m_dspReaders = {};
+    m_dspReadValues = {};
+    m_dspBackWritten = false;
+    m_dspPendingFrame = 0;
+    m_dspStale = false;
+    m_presentOnly = false;
+    m_dspPublished.store(0, std::memory_order_relaxed);
+    m_dspSkippedCopies.store(0, std::memory_order_relaxed);
+    m_dspDropped.store(0, std::memory_order_relaxed);
+    m_dspPresented = 0;
+    m_dspLastLatencyMs = 0.0;
+    m_dspTotalLatencyMs = 0.0;
+}
+
 void PathTracer::loadModels(
     const DbObjHandle& hScene,
     const std::unordered_map<DbObjHandle, uint32_t>& hSpMaterialIdxMap,
     BufferData& data
 ) {
+    TRACE_FUNCTION();
     std::unordered_map<std::string, uint32_t> textureIndexMap;
     std::vector<GfxImage> textures = {};
     textures.push_back(AppTextureManager::instance().getDefaultTexture());
@@ -455,6 +982,7 @@ void PathTracer::loadModels(
             Logger() << "Failed to load model file: " << filename;
             continue;
         }
+        TrackedMemory meshMemory(MemoryTag::MESH, Mesh::getMemorySize(modelData));
 
         std::vector<DbObjHandle> meshHandles = PtModel::getMeshes(hModel);
 
@@ -593,27 +1121,50 @@ void PathTracer::loadModels(
 
     /* Build scene BVH */
     BvhBuilder bvhBuilder;
-    std::shared_ptr<BvhNode> bvh = bvhBuilder.build(data.vertices, data.triangles);
+    std::shared_ptr<BvhNode> bvh = nullptr;
+    {
+        TRACE_SCOPE("BvhBuilder::build");
+        bvh = bvhBuilder.build(data.vertices, data.triangles);
+    }
     BvhBufferizer bvhBufferizer;
-    data.bvhBufferData = bvhBufferizer.bufferize(bvh.get());
+    {
+        TRACE_SCOPE("BvhBufferizer::bufferize");
+        data.bvhBufferData = bvhBufferizer.bufferize(
+            bvh.get(),
+            data.vertices,
+            data.triangles,
+            data.intersectData
+        );
+        data.bvhDepth = bvhBufferizer.getDepth();
+    }
+    // The nodes, the build lists and the copy kept by the bufferizer live until this returns
+    size_t nNodes = data.bvhBufferData.size();
+    TrackedMemory bvhMemory(
+        MemoryTag::BVH,
+        nNodes * (sizeof(BvhNode) + sizeof(BufferBvhNode)) +
+        data.triangles.size() * (sizeof(uint32_t) + sizeof(AABB))
+    );
+    Logger(LogLevel::INFO, "path_tracer") << "Built scene of " << data.triangles.size() <<
+        " triangles and " << data.textures.size() << " textures";
 }
 
 int PathTracer::createBuffers(const BufferData& data) {
+    TRACE_FUNCTION();
     int err = 0;
 
     // Vertex buffer
     if (m_ssboVertex)
         m_renderer->destroyBuffer(m_ssboVertex);
     m_ssboVertex = m_renderer->createBuffer(
-        static_cast<int>(sizeof(Vertex) * data.vertices.size()),
+        sizeof(Vertex) * data.vertices.size(),
         GfxBufferUsage::STORAGE_BUFFER,
-        GfxBufferProp::DYNAMIC
+        GfxBufferProp::STATIC
     );
     if (!m_ssboVertex)
         return 1;
     err = m_renderer->setBufferData(
         m_ssboVertex,
-        static_cast<int>(sizeof(Vertex) * data.vertices.size()),
+        sizeof(Vertex) * data.vertices.size(),
         data.vertices.data()
     );
     if (err)
@@ -623,15 +1174,15 @@ int PathTracer::createBuffers(const BufferData& data) {
     if (m_ssboTriangle)
         m_renderer->destroyBuffer(m_ssboTriangle);
     m_ssboTriangle = m_renderer->createBuffer(
-        static_cast<int>(sizeof(Triangle) * data.triangles.size()),
+        sizeof(Triangle) * data.triangles.size(),
         GfxBufferUsage::STORAGE_BUFFER,
-        GfxBufferProp::DYNAMIC
+        GfxBufferProp::STATIC
     );
     if (!m_ssboTriangle)
         return 1;
     err = m_renderer->setBufferData(
         m_ssboTriangle,
-        static_cast<int>(sizeof(Triangle) * data.triangles.size()),
+        sizeof(Triangle) * data.triangles.size(),
         data.triangles.data()
     );
     if (err)
@@ -641,15 +1192,15 @@ int PathTracer::createBuffers(const BufferData& data) {
     if (m_ssboMaterial)
         m_renderer->destroyBuffer(m_ssboMaterial);
     m_ssboMaterial = m_renderer->createBuffer(
-        static_cast<int>(sizeof(Material) * data.materials.size()),
+        sizeof(Material) * data.materials.size(),
         GfxBufferUsage::STORAGE_BUFFER,
-        GfxBufferProp::DYNAMIC
+        GfxBufferProp::STATIC
     );
     if (!m_ssboMaterial)
         return 1;
     err = m_renderer->setBufferData(
         m_ssboMaterial,
-        static_cast<int>(sizeof(Material) * data.materials.size()),
+        sizeof(Material) * data.materials.size(),
         data.materials.data()
     );
     if (err)
@@ -659,20 +1210,38 @@ int PathTracer::createBuffers(const BufferData& data) {
     if (m_ssboBVH)
         m_renderer->destroyBuffer(m_ssboBVH);
     m_ssboBVH = m_renderer->createBuffer(
-        static_cast<int>(sizeof(BufferBvhNode) * data.bvhBufferData.size()),
+        sizeof(BufferBvhNode) * data.bvhBufferData.size(),
         GfxBufferUsage::STORAGE_BUFFER,
-        GfxBufferProp::DYNAMIC
+        GfxBufferProp::STATIC
     );
     if (!m_ssboBVH)
         return 1;
     err = m_renderer->setBufferData(
         m_ssboBVH,
-        static_cast<int>(sizeof(BufferBvhNode) * data.bvhBufferData.size()),
+        sizeof(BufferBvhNode) * data.bvhBufferData.size(),
         data.bvhBufferData.data()
     );
     if (err)
         return 1;
 
+    // Intersection triangle buffer
+    if (m_ssboIntersect)
+        m_renderer->destroyBuffer(m_ssboIntersect);
+    m_ssboIntersect = m_renderer->createBuffer(
+        sizeof(IntersectTriangle) * data.intersectData.size(),
+        GfxBufferUsage::STORAGE_BUFFER,
+        GfxBufferProp::STATIC
+    );
+    if (!m_ssboIntersect)
+        return 1;
+    err = m_renderer->setBufferData(
+        m_ssboIntersect,
+        sizeof(IntersectTriangle) * data.intersectData.size(),
+        data.intersectData.data()
+    );
+    if (err)
+        return 1;
+
     return 0;
 }
 
@@ -680,6 +1249,7 @@ int PathTracer::buildSpectralScene(
     const DbObjHandle& hScene,
     std::unordered_map<DbObjHandle, uint32_t>& hSpMaterialIdxMap
 ) {
+    TRACE_FUNCTION();
     int err = 0;
 
     // Waves
@@ -696,9 +1266,9 @@ int PathTracer::buildSpectralScene(
     if (m_ssboWaves)
         m_renderer->destroyBuffer(m_ssboWaves);
     m_ssboWaves = m_renderer->createBuffer(
-        static_cast<int>(sizeof(float) * waveNumbers.size()),
+        sizeof(float) * waveNumbers.size(),
         GfxBufferUsage::STORAGE_BUFFER,
-        GfxBufferProp::DYNAMIC
+        GfxBufferProp::STATIC
     );
     if (!m_ssboWaves) {
         Logger() << "Failed to create waves buffer in PathTracer::buildSpectralScene";
@@ -706,7 +1276,7 @@ int PathTracer::buildSpectralScene(
     }
     err = m_renderer->setBufferData(
         m_ssboWaves,
-        static_cast<int>(sizeof(float) * waveNumbers.size()),
+        sizeof(float) * waveNumbers.size(),
         waveNumbers.data()
     );
     if (err) {
@@ -733,9 +1303,9 @@ int PathTracer::buildSpectralScene(
     if (m_ssboSpMaterials)
         m_renderer->destroyBuffer(m_ssboSpMaterials);
     m_ssboSpMaterials = m_renderer->createBuffer(
-        static_cast<int>(sizeof(float) * emissivities.size()),
+        sizeof(float) * emissivities.size(),
         GfxBufferUsage::STORAGE_BUFFER,
-        GfxBufferProp::DYNAMIC
+        GfxBufferProp::STATIC
     );
     if (!m_ssboSpMaterials) {
         Logger() << "Failed to create spectral materials buffer in PathTracer::buildSpectralScene";
@@ -743,7 +1313,7 @@ int PathTracer::buildSpectralScene(
     }
     err = m_renderer->setBufferData(
         m_ssboSpMaterials,
-        static_cast<int>(sizeof(float) * emissivities.size()),
+        sizeof(float) * emissivities.size(),
         emissivities.data()
     );
     if (err) {
@@ -771,150 +1341,3 @@ int PathTracer::buildSpectralScene(
 
     return 0;
 }
-
-std::unique_ptr<PathTracer::BvhNode> PathTracer::BvhBuilder::build
-(
-    const std::vector<Vertex>& vertices,
-    const std::vector<Triangle>& triangles
-) {
-    m_triList.resize(triangles.size());
-    m_triAABBs.resize(triangles.size());
-    for (int i = 0; i < triangles.size(); i++) {
-        m_triList[i] = i;
-        m_triAABBs[i].merge(Math::Vec3(vertices[triangles[i].v0].pos));
-        m_triAABBs[i].merge(Math::Vec3(vertices[triangles[i].v1].pos));
-        m_triAABBs[i].merge(Math::Vec3(vertices[triangles[i].v2].pos));
-        m_triAABBs[i].validate();
-    }
-    std::unique_ptr<BvhNode> root = std::make_unique<BvhNode>();
-    buildRecursive(root.get(), 0, triangles.size());
-    return root;
-}
-
-void PathTracer::BvhBuilder::buildRecursive(BvhNode* node, size_t triListOffset, size_t triCount) {
-    for (int i = triListOffset; i < triListOffset + triCount; i++)
-        node->aabb.merge(m_triAABBs[m_triList[i]]);
-
-    /* Build leaves */
-    if (triCount == 0)
-        return;
-    else if (triCount == 1) {
-        node->left = std::make_unique<BvhNode>();
-        node->left->aabb = m_triAABBs[m_triList[triListOffset]];
-        node->left->idxTriangle = m_triList[triListOffset];
-        return;
-    } else if (triCount == 2) {
-        node->left = std::make_unique<BvhNode>();
-        node->left->aabb = m_triAABBs[m_triList[triListOffset + 0]];
-        node->left->idxTriangle = m_triList[triListOffset + 0];
-        node->right = std::make_unique<BvhNode>();
-        node->right->aabb = m_triAABBs[m_triList[triListOffset + 1]];
-        node->right->idxTriangle = m_triList[triListOffset + 1];
-        return;
-    }
-
-    /* SAH splitting */
-
-    enum class Axis { X, Y, Z };
-
-    // Comparator for sorting triangles along an axis.
-    auto triAxisGreater = [&](uint32_t t1, uint32_t t2, Axis axis) {
-        if (axis == Axis::X && m_triAABBs[t1].min().x > m_triAABBs[t2].min().x)
-            return true;
-        else if (axis == Axis::Y && m_triAABBs[t1].min().y > m_triAABBs[t2].min().y)
-            return true;
-        else if (axis == Axis::Z && m_triAABBs[t1].min().z > m_triAABBs[t2].min().z)
-            return true;
-        return false;
-        };
-
-    float sahCost = std::numeric_limits<float>::max();
-    Axis splitAxis = Axis::X;
-    size_t splitPos = triListOffset + triCount / 2;
-
-    // SAH: evaluate all split positions (between primitives) for each axis.
-    // Cost: SA(L) * NL + SA(R) * NR
-    for (const auto& axis : { Axis::X, Axis::Y, Axis::Z }) {
-        std::sort(
-            m_triList.begin() + triListOffset,
-            m_triList.begin() + triListOffset + triCount,
-            std::bind(triAxisGreater, std::placeholders::_1, std::placeholders::_2, axis)
-        );
-
-        // Prefix/suffix bounds to evaluate splits in O(n).
-        std::vector<AABB> leftBounds(triCount);
-        std::vector<AABB> rightBounds(triCount);
-
-        leftBounds[0] = m_triAABBs[m_triList[triListOffset + 0]];
-        for (size_t i = 1; i < triCount; i++) {
-            leftBounds[i] = leftBounds[i - 1];
-            leftBounds[i].merge(m_triAABBs[m_triList[triListOffset + i]]);
-        }
-
-        rightBounds[triCount - 1] = m_triAABBs[m_triList[triListOffset + triCount - 1]];
-        for (size_t i = triCount - 1; i-- > 0;) {
-            rightBounds[i] = rightBounds[i + 1];
-            rightBounds[i].merge(m_triAABBs[m_triList[triListOffset + i]]);
-        }
-
-        // Split position is an index into m_triList.
-        // Left: [offset, splitPos), Right: [splitPos, offset+count)
-        for (size_t i = 1; i < triCount; i++) {
-            float cost = leftBounds[i - 1].surfaceArea() * static_cast<float>(i);
-            cost += rightBounds[i].surfaceArea() * static_cast<float>(triCount - i);
-            if (cost < sahCost) {
-                sahCost = cost;
-                splitAxis = axis;
-                splitPos = triListOffset + i;
-            }
-        }
-    }
-
-    if (splitPos <= triListOffset)
-        splitPos = triListOffset + 1;
-    else if (splitPos >= triListOffset + triCount)
-        splitPos = triListOffset + triCount - 1;
-
-    // Re-sort along the selected best axis so that splitPos corresponds to the final order.
-    std::sort(
-        m_triList.begin() + triListOffset,
-        m_triList.begin() + triListOffset + triCount,
-        std::bind(triAxisGreater, std::placeholders::_1, std::placeholders::_2, splitAxis)
-    );
-
-    /* Build children */
-    node->left = std::make_unique<BvhNode>();
-    buildRecursive(node->left.get(), triListOffset, splitPos - triListOffset);
-    node->right = std::make_unique<BvhNode>();
-    buildRecursive(node->right.get(), splitPos, triListOffset + triCount - splitPos);
-}
-
-std::vector<PathTracer::BufferBvhNode> PathTracer::BvhBufferizer::bufferize(BvhNode* root) {
-    m_bufferData.clear();
-    bufferizeRecursive(root);
-    return m_bufferData;
-}
-
-void PathTracer::BvhBufferizer::bufferizeRecursive(BvhNode* node) {
-    if (node == nullptr)
-        return;
-    BufferBvhNode bufferNode = {};
-    bufferNode.idx = static_cast<uint32_t>(m_bufferData.size());
-    bufferNode.aabbMin = Math::Vec4(node->aabb.min(), 0.0f);
-    bufferNode.aabbMax = Math::Vec4(node->aabb.max(), 0.0f);
-    if (node->left == nullptr && node->right == nullptr) {
-        // Leaf node
-        bufferNode.leafFlag = 1;
-        bufferNode.idxTriangle = node->idxTriangle;
-        m_bufferData.push_back(bufferNode);
-    } else {
-        // Internal node
-        m_bufferData.push_back(bufferNode);
-        bufferizeRecursive(node->left.get());
-        m_bufferData[bufferNode.idx].rChildOffset =
-            node->right != nullptr ?
-            static_cast<uint32_t>(m_bufferData.size() - bufferNode.idx) :
-            0; // 0 if no right child
-        bufferizeRecursive(node->right.get());
-    }
-}
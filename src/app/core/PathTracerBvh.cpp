@@ -0,0 +1,195 @@
+/**
+ * @file PathTracerBvh.cpp
+ * @brief Implementation of the BVH builder and bufferizer of the PathTracer class.
+ * @note Kept apart from PathTracer.cpp so the tests can build the GPU buffers of a scene
+ *       without a renderer.
+ */
+
+#include "app/core/PathTracer.h"
+
+#include <algorithm>
+#include <functional>
+
+std::unique_ptr<PathTracer::BvhNode> PathTracer::BvhBuilder::build
+(
+    const std::vector<Vertex>& vertices,
+    const std::vector<Triangle>& triangles
+) {
+    m_triList.resize(triangles.size());
+    m_triAABBs.resize(triangles.size());
+    for (int i = 0; i < triangles.size(); i++) {
+        m_triList[i] = i;
+        m_triAABBs[i].merge(Math::Vec3(vertices[triangles[i].v0].pos));
+        m_triAABBs[i].merge(Math::Vec3(vertices[triangles[i].v1].pos));
+        m_triAABBs[i].merge(Math::Vec3(vertices[triangles[i].v2].pos));
+        m_triAABBs[i].validate();
+    }
+    std::unique_ptr<BvhNode> root = std::make_unique<BvhNode>();
+    buildRecursive(root.get(), 0, triangles.size());
+    return root;
+}
+
+void PathTracer::BvhBuilder::buildRecursive(BvhNode* node, size_t triListOffset, size_t triCount) {
+    for (int i = triListOffset; i < triListOffset + triCount; i++)
+        node->aabb.merge(m_triAABBs[m_triList[i]]);
+
+    /* Build leaves */
+    if (triCount == 0)
+        return;
+    else if (triCount == 1) {
+        node->left = std::make_unique<BvhNode>();
+        node->left->aabb = m_triAABBs[m_triList[triListOffset]];
+        node->left->idxTriangle = m_triList[triListOffset];
+        return;
+    } else if (triCount == 2) {
+        node->left = std::make_unique<BvhNode>();
+        node->left->aabb = m_triAABBs[m_triList[triListOffset + 0]];
+        node->left->idxTriangle = m_triList[triListOffset + 0];
+        node->right = std::make_unique<BvhNode>();
+        node->right->aabb = m_triAABBs[m_triList[triListOffset + 1]];
+        node->right->idxTriangle = m_triList[triListOffset + 1];
+        return;
+    }
+
+    /* SAH splitting */
+
+    enum class Axis { X, Y, Z };
+
+    // Comparator for sorting triangles along an axis.
+    auto triAxisGreater = [&](uint32_t t1, uint32_t t2, Axis axis) {
+        if (axis == Axis::X && m_triAABBs[t1].min().x > m_triAABBs[t2].min().x)
+            return true;
+        else if (axis == Axis::Y && m_triAABBs[t1].min().y > m_triAABBs[t2].min().y)
+            return true;
+        else if (axis == Axis::Z && m_triAABBs[t1].min().z > m_triAABBs[t2].min().z)
+            return true;
+        return false;
+        };
+
+    float sahCost = std::numeric_limits<float>::max();
+    Axis splitAxis = Axis::X;
+    size_t splitPos = triListOffset + triCount / 2;
+
+    // SAH: evaluate all split positions (between primitives) for each axis.
+    // Cost: SA(L) * NL + SA(R) * NR
+    for (const auto& axis : { Axis::X, Axis::Y, Axis::Z }) {
+        std::sort(
+            m_triList.begin() + triListOffset,
+            m_triList.begin() + triListOffset + triCount,
+            std::bind(triAxisGreater, std::placeholders::_1, std::placeholders::_2, axis)
+        );
+
+        // Prefix/suffix bounds to evaluate splits in O(n).
+        std::vector<AABB> leftBounds(triCount);
+        std::vector<AABB> rightBounds(triCount);
+
+        leftBounds[0] = m_triAABBs[m_triList[triListOffset + 0]];
+        for (size_t i = 1; i < triCount; i++) {
+            leftBounds[i] = leftBounds[i - 1];
+            leftBounds[i].merge(m_triAABBs[m_triList[triListOffset + i]]);
+        }
+
+        rightBounds[triCount - 1] = m_triAABBs[m_triList[triListOffset + triCount - 1]];
+        for (size_t i = triCount - 1; i-- > 0;) {
+            rightBounds[i] = rightBounds[i + 1];
+            rightBounds[i].merge(m_triAABBs[m_triList[triListOffset + i]]);
+        }
+
+        // Split position is an index into m_triList.
+        // Left: [offset, splitPos), Right: [splitPos, offset+count)
+        for (size_t i = 1; i < triCount; i++) {
+            float cost = leftBounds[i - 1].surfaceArea() * static_cast<float>(i);
+            cost += rightBounds[i].surfaceArea() * static_cast<float>(triCount - i);
+            if (cost < sahCost) {
+                sahCost = cost;
+                splitAxis = axis;
+                splitPos = triListOffset + i;
+            }
+        }
+    }
+
+    if (splitPos <= triListOffset)
+        splitPos = triListOffset + 1;
+    else if (splitPos >= triListOffset + triCount)
+        splitPos = triListOffset + triCount - 1;
+
+    // Re-sort along the selected best axis so that splitPos corresponds to the final order.
+    std::sort(
+        m_triList.begin() + triListOffset,
+        m_triList.begin() + triListOffset + triCount,
+        std::bind(triAxisGreater, std::placeholders::_1, std::placeholders::_2, splitAxis)
+    );
+
+    /* Build children */
+    node->left = std::make_unique<BvhNode>();
+    buildRecursive(node->left.get(), triListOffset, splitPos - triListOffset);
+    node->right = std::make_unique<BvhNode>();
+    buildRecursive(node->right.get(), splitPos, triListOffset + triCount - splitPos);
+}
+
+std::vector<PathTracer::BufferBvhNode> PathTracer::BvhBufferizer::bufferize(
+    BvhNode* root,
+    const std::vector<Vertex>& vertices,
+    const std::vector<Triangle>& triangles,
+    std::vector<IntersectTriangle>& intersectData
+) {
+    m_bufferData.clear();
+    m_intersectData.clear();
+    m_intersectData.reserve(triangles.size());
+    m_vertices = &vertices;
+    m_triangles = &triangles;
+    m_depth = 0;
+    if (triangles.empty()) {
+        // The root of an empty scene is a leaf without a triangle, but traversal reads the
+        // triangle of every leaf it reaches. Point it to a degenerate one that no ray hits.
+        BufferBvhNode bufferNode = {};
+        bufferNode.leafFlag = 1;
+        m_bufferData.push_back(bufferNode);
+        m_intersectData.push_back(IntersectTriangle());
+        m_depth = 1;
+    } else {
+        bufferizeRecursive(root, 1);
+    }
+    m_vertices = nullptr;
+    m_triangles = nullptr;
+    intersectData = std::move(m_intersectData);
+    m_intersectData = {};
+    return m_bufferData;
+}
+
+void PathTracer::BvhBufferizer::bufferizeRecursive(BvhNode* node, int depth) {
+    if (node == nullptr)
+        return;
+    m_depth = std::max(m_depth, depth);
+    BufferBvhNode bufferNode = {};
+    bufferNode.idx = static_cast<uint32_t>(m_bufferData.size());
+    bufferNode.aabbMin = Math::Vec4(node->aabb.min(), 0.0f);
+    bufferNode.aabbMax = Math::Vec4(node->aabb.max(), 0.0f);
+    if (node->left == nullptr && node->right == nullptr) {
+        // Leaf node
+        bufferNode.leafFlag = 1;
+        bufferNode.idxTriangle = static_cast<uint32_t>(m_intersectData.size());
+        m_bufferData.push_back(bufferNode);
+
+        // Precompute the edges so a triangle test is one contiguous load
+        const Triangle& tri = (*m_triangles)[node->idxTriangle];
+        Math::Vec3 p0 = (*m_vertices)[tri.v0].pos;
+        Math::Vec3 p1 = (*m_vertices)[tri.v1].pos;
+        Math::Vec3 p2 = (*m_vertices)[tri.v2].pos;
+        IntersectTriangle intersectTri = {};
+        intersectTri.p0 = p0;
+        intersectTri.idxTriangle = node->idxTriangle;
+        intersectTri.e1 = Math::Vec4(p1 - p0, 0.0f);
+        intersectTri.e2 = Math::Vec4(p2 - p0, 0.0f);
+        m_intersectData.push_back(intersectTri);
+    } else {
+        // Internal node
+        m_bufferData.push_back(bufferNode);
+        bufferizeRecursive(node->left.get(), depth + 1);
+        m_bufferData[bufferNode.idx].rChildOffset =
+            node->right != nullptr ?
+            static_cast<uint32_t>(m_bufferData.size() - bufferNode.idx) :
+            0; // 0 if no right child
+        bufferizeRecursive(node->right.get(), depth + 1);
+    }
+}
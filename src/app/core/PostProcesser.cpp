@@ -7,34 +7,49 @@
 
 #include "app/AppTextureManager.h"
 #include "utils/Logger.hpp"
-#include "res/ShaderStrings.hpp"
+#include "res/ShaderStringsUtils.hpp"
 
-int PostProcesser::init() {
+int PostProcesser::loadShaders() {
     if (!m_renderer) {
-        Logger() << "Renderer is null in Previewer::init";
+        Logger() << "Renderer is null in PostProcesser::loadShaders";
         return 1;
     }
+    if (m_vertexShader && m_fragmentShader)
+        return 0;
 
-    // Load shaders
     try {
         m_vertexShader = m_renderer->createShader(
             GfxShaderStage::VERTEX,
-            ShaderStrings::QUAD_VERT
+            ShaderStrings::getResolved("quad.vert")
         );
     } catch (GfxShaderException& e) {
-        Logger() << "Failed to create vertex shader in PostProcesser::init: " << e.what();
+        Logger() << "Failed to create vertex shader in PostProcesser::loadShaders: " <<
+            ShaderStrings::mapSourceNames(e.what());
         return 1;
     }
     try {
         m_fragmentShader = m_renderer->createShader(
             GfxShaderStage::FRAGMENT,
-            ShaderStrings::QUAD_FRAG
+            ShaderStrings::getResolved("quad.frag")
         );
     } catch (GfxShaderException& e) {
-        Logger() << "Failed to create fragment shader in PostProcesser::init: " << e.what();
+        Logger() << "Failed to create fragment shader in PostProcesser::loadShaders: " <<
+            ShaderStrings::mapSourceNames(e.what());
+        return 1;
+    }
+
+    return 0;
+}
+
+int PostProcesser::init() {
+    if (!m_renderer) {
+        Logger() << "Renderer is null in Previewer::init";
         return 1;
     }
 
+    if (loadShaders())
+        return 1;
+
     // Initialize descriptors and UBOs
     b_radiances.binding = 0;
     b_radiances.type = GfxDescriptorType::STORAGE_BUFFER;
@@ -80,9 +95,9 @@ void PostProcesser::term() {
         m_renderer->destroyPipeline(m_pipeline);
         m_pipeline = nullptr;
 
-        m_renderer->destroyDescriptorSetBinding(m_descriptorSetBindings[0]);
-        m_renderer->destroyDescriptorSetBinding(m_descriptorSetBindings[1]);
-        m_descriptorSetBindings = {};
+        for (GfxDescriptorSetBinding& binding : m_descriptorSetBindings)
+            m_renderer->destroyDescriptorSetBinding(binding);
+        m_descriptorSetBindings.clear();
 
         frameInitiated = false;
     }
@@ -94,7 +109,7 @@ void PostProcesser::term() {
 int PostProcesser::initFrame(
     int width,
     int height,
-    const std::array<GfxBuffer, 2>& inputImages
+    const std::vector<GfxBuffer>& inputImages
 ) {
     m_resolutionX = width;
     m_resolutionY = height;
@@ -137,26 +152,21 @@ int PostProcesser::initFrame(
     }
 
     // Create descriptor set bindings
-    if (m_descriptorSetBindings[0])
-        m_renderer->destroyDescriptorSetBinding(m_descriptorSetBindings[0]);
-    m_descriptorSetBindings[0] = m_renderer->createDescriptorSetBinding(
-        m_pipeline,
-        0,
-        {
-            { b_radiances, m_inputImages[0] },
-            { u_params, m_uboParams }
-        }
-    );
-    if (m_descriptorSetBindings[1])
-        m_renderer->destroyDescriptorSetBinding(m_descriptorSetBindings[1]);
-    m_descriptorSetBindings[1] = m_renderer->createDescriptorSetBinding(
-        m_pipeline,
-        0,
-        {
-            { b_radiances, m_inputImages[1] },
-            { u_params, m_uboParams }
-        }
-    );
+    for (GfxDescriptorSetBinding& binding : m_descriptorSetBindings) {
+        if (binding)
+            m_renderer->destroyDescriptorSetBinding(binding);
+    }
+    m_descriptorSetBindings.assign(m_inputImages.size(), nullptr);
+    for (size_t i = 0; i < m_inputImages.size(); i++) {
+        m_descriptorSetBindings[i] = m_renderer->createDescriptorSetBinding(
+            m_pipeline,
+            0,
+            {
+                { b_radiances, m_inputImages[i] },
+                { u_params, m_uboParams }
+            }
+        );
+    }
 
     // Create output image
     if (m_outputImage)
@@ -186,7 +196,7 @@ int PostProcesser::initFrame(
     return 0;
 }
 
-void PostProcesser::setInputImage(GfxBuffer& image) {
+void PostProcesser::setInputImage(const GfxBuffer& image) {
     m_currentInputImage = image;
 }
 
@@ -205,6 +215,9 @@ int PostProcesser::renderFrame() {
     if (!frameInitiated)
         return 1;
 
+    GfxTimerScope timer(m_renderer, "Post-Process");
+    // The input image is written by the path tracer renderer, possibly on another queue
+    m_renderer->acquireBuffer(m_currentInputImage);
     m_renderer->beginRenderPass(m_framebuffer);
     m_renderer->bindPipeline(m_pipeline);
 
@@ -222,10 +235,12 @@ int PostProcesser::renderFrame() {
     if (m_renderer->updateBufferData(m_uboParams, 0, sizeof(UParams), &u_params))
         return 1;
 
-    if (m_currentInputImage == m_inputImages[0])
-        m_renderer->bindDescriptorSetBinding(m_descriptorSetBindings[0]);
-    else
-        m_renderer->bindDescriptorSetBinding(m_descriptorSetBindings[1]);
+    for (size_t i = 0; i < m_inputImages.size(); i++) {
+        if (m_currentInputImage == m_inputImages[i]) {
+            m_renderer->bindDescriptorSetBinding(m_descriptorSetBindings[i]);
+            break;
+        }
+    }
 
     m_renderer->draw(4);
 
@@ -7,7 +7,8 @@
 
 #include "app/AppTextureManager.h"
 #include "utils/Logger.hpp"
-#include "res/ShaderStrings.hpp"
+#include "utils/MemoryTracker.h"
+#include "res/ShaderStringsUtils.hpp"
 
 constexpr float DRAW_DIST = 100.0f; // Far clipping plane distance
 
@@ -17,36 +18,51 @@ Previewer::Previewer(GfxRenderer& renderer) :
     m_camera.up = Math::Vec3(0.0f, 1.0f, 0.0f);
 }
 
-int Previewer::init(int resX, int resY, int samples) {
-    m_resolutionX = resX;
-    m_resolutionY = resY;
-    m_MSAAsampleCount = samples;
-
+int Previewer::loadShaders() {
     if (!m_renderer) {
-        Logger() << "Renderer is null in Previewer::init";
+        Logger() << "Renderer is null in Previewer::loadShaders";
         return 1;
     }
+    if (m_vertexShader && m_fragmentShader)
+        return 0;
 
-    // Load shaders
     try {
         m_vertexShader = m_renderer->createShader(
             GfxShaderStage::VERTEX,
-            ShaderStrings::PREVIEW_VERT
+            ShaderStrings::getResolved("preview.vert")
         );
     } catch (GfxShaderException& e) {
-        Logger() << "Failed to create vertex shader in Previewer::init: " << e.what();
+        Logger() << "Failed to create vertex shader in Previewer::loadShaders: " <<
+            ShaderStrings::mapSourceNames(e.what());
         return 1;
     }
     try {
         m_fragmentShader = m_renderer->createShader(
             GfxShaderStage::FRAGMENT,
-            ShaderStrings::PREVIEW_FRAG
+            ShaderStrings::getResolved("preview.frag")
         );
     } catch (GfxShaderException& e) {
-        Logger() << "Failed to create fragment shader in Previewer::init: " << e.what();
+        Logger() << "Failed to create fragment shader in Previewer::loadShaders: " <<
+            ShaderStrings::mapSourceNames(e.what());
+        return 1;
+    }
+
+    return 0;
+}
+
+int Previewer::init(int resX, int resY, int samples) {
+    m_resolutionX = resX;
+    m_resolutionY = resY;
+    m_MSAAsampleCount = samples;
+
+    if (!m_renderer) {
+        Logger() << "Renderer is null in Previewer::init";
         return 1;
     }
 
+    if (loadShaders())
+        return 1;
+
     // Initialize descriptors and UBOs
     m_descriptors.u_xform.binding = 0;
     m_descriptors.u_xform.type = GfxDescriptorType::UNIFORM_BUFFER;
@@ -348,6 +364,7 @@ int Previewer::renderFrame() {
     UMaterial u_material = {};
     UPickInfo u_pickInfo = {};
 
+    GfxTimerScope timer(m_renderer, "Preview");
     m_renderer->beginRenderPass(m_framebuffer);
     m_renderer->bindPipeline(m_pipeline);
 
@@ -517,6 +534,7 @@ int Previewer::updateModel(const DbObjHandle& hModel) {
         Logger() << "Failed to load model file: " << filename;
         return 1;
     }
+    TrackedMemory meshMemory(MemoryTag::MESH, ::Mesh::getMemorySize(modelData));
 
     // Prepare mesh data info
     std::vector<MeshDataInfo> meshDataInfos;
@@ -553,7 +571,7 @@ int Previewer::updateModel(const DbObjHandle& hModel) {
 }
 
 int Previewer::updateMesh(const DbObjHandle& hMesh, Mesh& mesh, const MeshDataInfo& meshDataInfo) {
-    int vtxBufferSize = meshDataInfo.vertices.size() * m_vertexDesc.stride;
+    size_t vtxBufferSize = meshDataInfo.vertices.size() * m_vertexDesc.stride;
 
     // Create and fill vertex buffer
     mesh.vertexBuffer = m_renderer->createBuffer(
@@ -589,7 +607,7 @@ int Previewer::updateMesh(const DbObjHandle& hMesh, Mesh& mesh, const MeshDataIn
     }
 
     // Create and fill index buffer
-    int idxBufferSize = meshDataInfo.indices.size() * sizeof(uint32_t);
+    size_t idxBufferSize = meshDataInfo.indices.size() * sizeof(uint32_t);
     mesh.indexBuffer = m_renderer->createBuffer(
         idxBufferSize,
         GfxBufferUsage::INDEX_BUFFER,
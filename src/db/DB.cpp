@@ -374,6 +374,44 @@ bool DB::isModified() const {
     return m_modifyCount > 0;
 }
 
+DB::MemoryUsage DB::getMemoryUsage() const {
+    std::shared_lock lock(m_mutex);
+
+    // Serialized size of the object data, registered types only
+    auto getDataSize = [](const std::string& typeName, const std::any& data) -> uint64_t {
+        if (!data.has_value())
+            return 0;
+        const DbTypeRegistry::TypeInfo* typeInfo =
+            DbTypeRegistry::instance().getTypeInfo(typeName);
+        if (!typeInfo)
+            return 0;
+        std::stringstream dataStream(std::ios::binary | std::ios::out);
+        DbSerializer serializer(DbSerializer::SerializationMode::WRITE, dataStream, "");
+        typeInfo->serialize(serializer, data);
+        return static_cast<uint64_t>(dataStream.tellp());
+    };
+
+    MemoryUsage usage{};
+    usage.objectBytes = sizeof(ObjectEntry) * m_objects.capacity();
+    for (const auto& entry : m_objects) {
+        if (!entry.alive)
+            continue;
+        usage.objectBytes += getDataSize(entry.typeName, entry.data);
+        usage.objectCount++;
+    }
+    for (const auto* stack : { &m_undoStack, &m_redoStack }) {
+        for (const auto& txn : *stack) {
+            usage.historyBytes += sizeof(TxnRecord) + sizeof(Op) * txn.capacity();
+            for (const auto& op : txn) {
+                usage.historyBytes += getDataSize(op.typeName, op.oldData);
+                usage.historyBytes += getDataSize(op.typeName, op.newData);
+            }
+            usage.historyCount++;
+        }
+    }
+    return usage;
+}
+
 DB::Result DB::undoOp(const Op& op) {
     uint32_t index = op.objId & 0xFFFF;
     uint32_t gen = op.objId >> 16;
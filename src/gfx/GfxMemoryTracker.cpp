@@ -0,0 +1,87 @@
+/**
+ * @file GfxMemoryTracker.cpp
+ * @brief Implementation of the GfxMemoryTracker class.
+ */
+
+#include "gfx/GfxPr.h"
+
+#include <atomic>
+
+static constexpr size_t N_CATEGORIES = static_cast<size_t>(GfxMemoryCategory::COUNT);
+
+/**
+ * @brief Counters of one memory category.
+ */
+struct GfxMemoryCounters {
+    std::atomic<uint64_t> bytes{ 0 }; // Bytes held by live resources
+    std::atomic<uint64_t> peakBytes{ 0 }; // Highest number of bytes held
+    std::atomic<uint64_t> count{ 0 }; // Number of live resources
+};
+
+static std::array<GfxMemoryCounters, N_CATEGORIES> s_counters = {}; // Counters by category
+
+static GfxMemoryCounters& getCounters(GfxMemoryCategory category) {
+    size_t index = static_cast<size_t>(category);
+    return s_counters[index < N_CATEGORIES ? index : 0];
+}
+
+static void addBytes(GfxMemoryCounters& counters, uint64_t bytes) {
+    uint64_t current = counters.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    uint64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (current > peak &&
+        !counters.peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed));
+}
+
+void GfxMemoryTracker::track(GfxMemoryCategory category, uint64_t bytes) {
+    GfxMemoryCounters& counters = getCounters(category);
+    counters.count.fetch_add(1, std::memory_order_relaxed);
+    addBytes(counters, bytes);
+}
+
+void GfxMemoryTracker::untrack(GfxMemoryCategory category, uint64_t bytes) {
+    GfxMemoryCounters& counters = getCounters(category);
+    counters.count.fetch_sub(1, std::memory_order_relaxed);
+    counters.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void GfxMemoryTracker::resize(GfxMemoryCategory category, uint64_t oldBytes, uint64_t newBytes) {
+    GfxMemoryCounters& counters = getCounters(category);
+    if (newBytes >= oldBytes)
+        addBytes(counters, newBytes - oldBytes);
+    else
+        counters.bytes.fetch_sub(oldBytes - newBytes, std::memory_order_relaxed);
+}
+
+GfxMemoryUsage GfxMemoryTracker::getUsage() {
+    GfxMemoryUsage usage{};
+    for (size_t i = 0; i < N_CATEGORIES; i++) {
+        usage.categories[i].bytes = s_counters[i].bytes.load(std::memory_order_relaxed);
+        usage.categories[i].peakBytes = s_counters[i].peakBytes.load(std::memory_order_relaxed);
+        usage.categories[i].count = s_counters[i].count.load(std::memory_order_relaxed);
+    }
+    return usage;
+}
+
+GfxMemoryCategory GfxMemoryTracker::getCategory(GfxBufferUsage usage) {
+    switch (usage) {
+    case GfxBufferUsage::VERTEX_BUFFER:
+        return GfxMemoryCategory::VERTEX_BUFFER;
+    case GfxBufferUsage::INDEX_BUFFER:
+        return GfxMemoryCategory::INDEX_BUFFER;
+    case GfxBufferUsage::UNIFORM_BUFFER:
+        return GfxMemoryCategory::UNIFORM_BUFFER;
+    case GfxBufferUsage::STORAGE_BUFFER:
+    default:
+        return GfxMemoryCategory::STORAGE_BUFFER;
+    }
+}
+
+GfxMemoryCategory GfxMemoryTracker::getCategory(GfxFlags<GfxImageUsage> usages) {
+    if (usages.check(GfxImageUsage::COLOR_ATTACHMENT) ||
+        usages.check(GfxImageUsage::DEPTH_ATTACHMENT)) {
+        return GfxMemoryCategory::RENDER_TARGET;
+    }
+    if (usages.check(GfxImageUsage::SAMPLED_TEXTURE))
+        return GfxMemoryCategory::TEXTURE;
+    return GfxMemoryCategory::STORAGE_IMAGE;
+}
@@ -6,6 +6,7 @@
 #include "gfx/GfxPr.h"
 
 #include "gfx/backends/gl/GfxGLRenderer.h"
+#include "gfx/backends/null/GfxNullRenderer.h"
 #include "gfx/backends/vulkan/GfxVulkanRenderer.h"
 
 GfxBackend GfxRendererInterface::getBackend() const {
@@ -16,6 +17,10 @@ GfxPipelineStateMachine GfxRendererInterface::getPipelineStateMachine() const {
     return m_pipelineStateMachine;
 }
 
+GfxMemoryUsage GfxRendererInterface::getMemoryUsage() const {
+    return GfxMemoryTracker::getUsage();
+}
+
 GfxRendererFactory::~GfxRendererFactory() {
     if (m_initialized[GfxBackend::OpenGL]) {
         GfxGLRenderer::termGlobal();
@@ -25,6 +30,10 @@ GfxRendererFactory::~GfxRendererFactory() {
         GfxVulkanRenderer::termGlobal();
         m_initialized[GfxBackend::Vulkan] = false;
     }
+    if (m_initialized[GfxBackend::Null]) {
+        GfxNullRenderer::termGlobal();
+        m_initialized[GfxBackend::Null] = false;
+    }
 }
 
 int GfxRendererFactory::initGlobal(GfxBackend backend, const GfxRendererConfig& config) {
@@ -43,6 +52,13 @@ int GfxRendererFactory::initGlobal(GfxBackend backend, const GfxRendererConfig&
         m_initialized[GfxBackend::Vulkan] = !GfxVulkanRenderer::initGlobal(config);
         return m_initialized[GfxBackend::Vulkan] ? 0 : 1;
     }
+    case GfxBackend::Null:
+    {
+        if (m_initialized[GfxBackend::Null])
+            return 0; // Null backend already initialized
+        m_initialized[GfxBackend::Null] = !GfxNullRenderer::initGlobal(config);
+        return m_initialized[GfxBackend::Null] ? 0 : 1;
+    }
     default:
         return 1; // Unsupported backend
     }
@@ -66,6 +82,14 @@ void GfxRendererFactory::termGlobal(GfxBackend backend) {
         }
         break;
     }
+    case GfxBackend::Null:
+    {
+        if (m_initialized[GfxBackend::Null]) {
+            GfxNullRenderer::termGlobal();
+            m_initialized[GfxBackend::Null] = false;
+        }
+        break;
+    }
     default:
         break; // Unsupported backend
     }
@@ -85,6 +109,12 @@ GfxRenderer GfxRendererFactory::create(GfxBackend backend) {
             return nullptr; // Vulkan backend not initialized
         return std::shared_ptr<GfxVulkanRenderer>(new GfxVulkanRenderer());
     }
+    case GfxBackend::Null:
+    {
+        if (!m_initialized[GfxBackend::Null])
+            return nullptr; // Null backend not initialized
+        return std::shared_ptr<GfxNullRenderer>(new GfxNullRenderer());
+    }
     default:
         return nullptr; // Unsupported backend
     }
@@ -13,7 +13,23 @@
 #define ENABLE_DEBUG_OUTPUT
 #endif // _DEBUG
 
+constexpr int TIMER_FRAMES = 4; // Frames a timestamp query may take before it is dropped
+constexpr GLuint MAX_TIMER_QUERIES = 128; // Timestamp queries per frame
+
 std::mutex GfxGLRenderer::s_mutex; // Mutex for global OpenGL renderer
+GfxDeviceInfo GfxGLRenderer::s_deviceInfo = {}; // Device information
+
+/**
+ * @brief Estimate the memory of an image from its size and format.
+ * @param image The image.
+ * @return Size of the base level in bytes, drivers may pad it.
+ */
+static uint64_t getImageMemorySize(const GfxImage& image) {
+    uint64_t size = static_cast<uint64_t>(std::max(image->getWidth(), 0)) *
+        static_cast<uint64_t>(std::max(image->getHeight(), 0)) *
+        static_cast<uint64_t>(GfxGLTypeConverter::formatSize(image->getFormat()));
+    return size * static_cast<uint64_t>(std::max(image->getSamples(), 1));
+}
 
 GfxGLRenderer::GfxGLRenderer() {
     m_backend = GfxBackend::OpenGL;
@@ -119,6 +135,21 @@ int GfxGLRenderer::initGlobal(const GfxRendererConfig& config) {
     glDebugMessageCallback(debugCallback, nullptr);
     glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
 #endif // ENABLE_DEBUG_OUTPUT
+
+    // The queries need a current context, renderers on other threads read the copy
+    const GLubyte* deviceName = glGetString(GL_RENDERER);
+    if (deviceName)
+        s_deviceInfo.name = reinterpret_cast<const char*>(deviceName);
+    GLint value = 0;
+    glGetIntegerv(GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS, &value);
+    if (value > 0)
+        s_deviceInfo.maxComputeWorkGroupInvocations = static_cast<uint32_t>(value);
+    for (GLuint i = 0; i < static_cast<GLuint>(s_deviceInfo.maxComputeWorkGroupSize.size()); i++) {
+        value = 0;
+        glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_SIZE, i, &value);
+        if (value > 0)
+            s_deviceInfo.maxComputeWorkGroupSize[i] = static_cast<uint32_t>(value);
+    }
     return 0;
 }
 
@@ -205,6 +236,7 @@ GfxImage GfxGLRenderer::createImage(const GfxImageInfo& info) const {
         glTexParameterf(target, GL_TEXTURE_LOD_BIAS, info.lodBias);
     }
     glBindTexture(target, 0);
+    GfxMemoryTracker::track(GfxMemoryTracker::getCategory(info.usages), getImageMemorySize(image));
 
     return image;
 }
@@ -301,6 +333,10 @@ void GfxGLRenderer::copyImage(const GfxImage& src, const GfxImage& dst, int widt
 void GfxGLRenderer::destroyImage(const GfxImage& image) const {
     std::shared_ptr<GfxGLImage> glImage = std::static_pointer_cast<GfxGLImage>(image);
     if (glImage->m_texture != 0) {
+        GfxMemoryTracker::untrack(
+            GfxMemoryTracker::getCategory(image->getUsages()),
+            getImageMemorySize(image)
+        );
         glDeleteTextures(1, &glImage->m_texture);
         glImage->m_texture = 0;
     }
@@ -441,17 +477,19 @@ int GfxGLRenderer::readFramebufferColorAttachmentPixels(
 }
 
 GfxBuffer GfxGLRenderer::createBuffer(
-    int size,
+    size_t size,
     GfxBufferUsage usage,
     GfxBufferProp prop
 ) const {
     GfxBuffer buffer = std::make_shared<GfxGLBuffer>(size, usage, prop);
     std::shared_ptr<GfxGLBuffer> glBuffer = std::static_pointer_cast<GfxGLBuffer>(buffer);
     glGenBuffers(1, &glBuffer->m_buffer);
+    // The data store is allocated by setBufferData
+    GfxMemoryTracker::track(GfxMemoryTracker::getCategory(usage), 0);
     return buffer;
 }
 
-int GfxGLRenderer::setBufferData(const GfxBuffer& buffer, int size, const void* data) const {
+int GfxGLRenderer::setBufferData(const GfxBuffer& buffer, size_t size, const void* data) const {
     std::shared_ptr<GfxGLBuffer> glBuffer = std::static_pointer_cast<GfxGLBuffer>(buffer);
 
     GLenum usage =
@@ -464,18 +502,27 @@ int GfxGLRenderer::setBufferData(const GfxBuffer& buffer, int size, const void*
         target = GL_SHADER_STORAGE_BUFFER;
 
     glBindBuffer(target, glBuffer->m_buffer);
-    glBufferData(target, size, data, usage);
+    glBufferData(target, static_cast<GLsizeiptr>(size), data, usage);
+    glBuffer->setSize(size);
+    GfxMemoryTracker::resize(
+        GfxMemoryTracker::getCategory(buffer->getUsage()),
+        glBuffer->m_storageSize,
+        size
+    );
+    glBuffer->m_storageSize = size;
 
     return 0;
 }
 
 int GfxGLRenderer::updateBufferData(
     const GfxBuffer& buffer,
-    int offset,
-    int size,
+    size_t offset,
+    size_t size,
     const void* data
 ) const {
     std::shared_ptr<GfxGLBuffer> glBuffer = std::static_pointer_cast<GfxGLBuffer>(buffer);
+    if (offset > buffer->getSize() || size > buffer->getSize() - offset)
+        return 1; // Error: Update out of bounds
 
     GLenum usage =
         buffer->getProp() == GfxBufferProp::STATIC ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW;
@@ -487,8 +534,13 @@ int GfxGLRenderer::updateBufferData(
         target = GL_SHADER_STORAGE_BUFFER;
 
     glBindBuffer(target, glBuffer->m_buffer);
-    glBufferData(target, buffer->getSize(), nullptr, usage);
-    glBufferSubData(target, offset, size, data);
+    glBufferData(target, static_cast<GLsizeiptr>(buffer->getSize()), nullptr, usage);
+    glBufferSubData(
+        target,
+        static_cast<GLintptr>(offset),
+        static_cast<GLsizeiptr>(size),
+        data
+    );
 
     return 0;
 }
@@ -496,37 +548,53 @@ int GfxGLRenderer::updateBufferData(
 void GfxGLRenderer::destroyBuffer(const GfxBuffer& buffer) const {
     std::shared_ptr<GfxGLBuffer> glBuffer = std::static_pointer_cast<GfxGLBuffer>(buffer);
     if (glBuffer->m_buffer != 0) {
+        GfxMemoryTracker::untrack(
+            GfxMemoryTracker::getCategory(buffer->getUsage()),
+            glBuffer->m_storageSize
+        );
         glDeleteBuffers(1, &glBuffer->m_buffer);
         glBuffer->m_buffer = 0;
+        glBuffer->m_storageSize = 0;
     }
 }
 
 int GfxGLRenderer::readBufferData(
     const GfxBuffer& buffer,
-    int offset,
-    int size,
+    size_t offset,
+    size_t size,
     void* data
 ) const {
     std::shared_ptr<GfxGLBuffer> glBuffer = std::static_pointer_cast<GfxGLBuffer>(buffer);
+    if (offset > buffer->getSize() || size > buffer->getSize() - offset)
+        return 1; // Error: Read out of bounds
     GLenum target = GL_ARRAY_BUFFER;
     if (buffer->getUsage() == GfxBufferUsage::UNIFORM_BUFFER)
         target = GL_UNIFORM_BUFFER;
     else if (buffer->getUsage() == GfxBufferUsage::STORAGE_BUFFER)
         target = GL_SHADER_STORAGE_BUFFER;
     glBindBuffer(target, glBuffer->m_buffer);
-    glGetBufferSubData(target, offset, size, data);
+    glGetBufferSubData(
+        target,
+        static_cast<GLintptr>(offset),
+        static_cast<GLsizeiptr>(size),
+        data
+    );
     return 0;
 }
 
 int GfxGLRenderer::copyBuffer(
     const GfxBuffer& src,
     const GfxBuffer& dst,
-    int srcOffset,
-    int dstOffset,
-    int size
+    size_t srcOffset,
+    size_t dstOffset,
+    size_t size
 ) const {
     std::shared_ptr<GfxGLBuffer> glBufferSrc = std::static_pointer_cast<GfxGLBuffer>(src);
     std::shared_ptr<GfxGLBuffer> glBufferDst = std::static_pointer_cast<GfxGLBuffer>(dst);
+    if (srcOffset > src->getSize() || size > src->getSize() - srcOffset)
+        return 1; // Error: Source range out of bounds
+    if (dstOffset > dst->getSize() || size > dst->getSize() - dstOffset)
+        return 1; // Error: Destination range out of bounds
     GLenum targetSrc = GL_ARRAY_BUFFER;
     if (src->getUsage() == GfxBufferUsage::UNIFORM_BUFFER)
         targetSrc = GL_UNIFORM_BUFFER;
@@ -539,10 +607,91 @@ int GfxGLRenderer::copyBuffer(
         targetDst = GL_SHADER_STORAGE_BUFFER;
     glBindBuffer(GL_COPY_READ_BUFFER, glBufferSrc->m_buffer);
     glBindBuffer(GL_COPY_WRITE_BUFFER, glBufferDst->m_buffer);
-    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset, dstOffset, size);
+    glCopyBufferSubData(
+        GL_COPY_READ_BUFFER,
+        GL_COPY_WRITE_BUFFER,
+        static_cast<GLintptr>(srcOffset),
+        static_cast<GLintptr>(dstOffset),
+        static_cast<GLsizeiptr>(size)
+    );
     return 0;
 }
 
+GfxReadback GfxGLRenderer::readBufferDataAsync(
+    const GfxBuffer& buffer,
+    size_t offset,
+    size_t size
+) const {
+    if (!buffer || size == 0 || offset > buffer->getSize() || size > buffer->getSize() - offset)
+        return nullptr; // Error: Read out of bounds
+
+    std::shared_ptr<GfxGLBuffer> glBuffer = std::static_pointer_cast<GfxGLBuffer>(buffer);
+    GfxReadback readback = std::make_shared<GfxGLReadback>(size);
+    std::shared_ptr<GfxGLReadback> glReadback = std::static_pointer_cast<GfxGLReadback>(readback);
+
+    // Persistent coherent mapping, the data can be read in place once the fence signals
+    GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &glReadback->m_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, glReadback->m_buffer);
+    glBufferStorage(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(size), nullptr, flags);
+    glReadback->m_mappedData =
+        glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, static_cast<GLsizeiptr>(size), flags);
+    if (glReadback->m_mappedData == nullptr) {
+        glDeleteBuffers(1, &glReadback->m_buffer);
+        return nullptr; // Error: Failed to map readback buffer
+    }
+
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_COPY_READ_BUFFER, glBuffer->m_buffer);
+    glCopyBufferSubData(
+        GL_COPY_READ_BUFFER,
+        GL_COPY_WRITE_BUFFER,
+        static_cast<GLintptr>(offset),
+        0,
+        static_cast<GLsizeiptr>(size)
+    );
+    glMemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+    glReadback->m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush(); // Make sure the fence gets signaled without further GL calls
+
+    return readback;
+}
+
+bool GfxGLRenderer::isReadbackReady(const GfxReadback& readback) const {
+    std::shared_ptr<GfxGLReadback> glReadback = std::static_pointer_cast<GfxGLReadback>(readback);
+    if (!glReadback || glReadback->m_fence == nullptr)
+        return false;
+    GLenum result = glClientWaitSync(glReadback->m_fence, 0, 0);
+    return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
+const void* GfxGLRenderer::mapReadback(const GfxReadback& readback, bool wait) const {
+    std::shared_ptr<GfxGLReadback> glReadback = std::static_pointer_cast<GfxGLReadback>(readback);
+    if (!glReadback || glReadback->m_fence == nullptr)
+        return nullptr; // Error: Invalid or released readback
+
+    GLenum result = glClientWaitSync(glReadback->m_fence, 0, 0);
+    while (wait && result == GL_TIMEOUT_EXPIRED)
+        result = glClientWaitSync(glReadback->m_fence, 0, 1000000000); // 1 second
+    if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+        return nullptr; // Data has not arrived yet or the wait failed
+
+    return glReadback->m_mappedData;
+}
+
+void GfxGLRenderer::releaseReadback(const GfxReadback& readback) const {
+    std::shared_ptr<GfxGLReadback> glReadback = std::static_pointer_cast<GfxGLReadback>(readback);
+    if (!glReadback || glReadback->m_fence == nullptr)
+        return;
+    glDeleteSync(glReadback->m_fence);
+    glReadback->m_fence = nullptr;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, glReadback->m_buffer);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    glDeleteBuffers(1, &glReadback->m_buffer);
+    glReadback->m_buffer = 0;
+    glReadback->m_mappedData = nullptr;
+}
+
 GfxVAO GfxGLRenderer::createVAO(
     const GfxVertexDesc& vertexDesc,
     const GfxBuffer& vertexBuffer,
@@ -919,7 +1068,12 @@ void GfxGLRenderer::drawIndexed(
     );
 }
 
-void GfxGLRenderer::drawIndirect(const GfxBuffer& buffer, int offset, int drawCount, int stride) {
+void GfxGLRenderer::drawIndirect(
+    const GfxBuffer& buffer,
+    size_t offset,
+    int drawCount,
+    int stride
+) {
     std::shared_ptr<GfxGLBuffer> glBuffer = std::static_pointer_cast<GfxGLBuffer>(buffer);
     glBindBuffer(GL_DRAW_INDIRECT_BUFFER, glBuffer->m_buffer);
     GfxPrimitiveTopo topo =
@@ -936,7 +1090,7 @@ void GfxGLRenderer::drawIndirect(const GfxBuffer& buffer, int offset, int drawCo
 
 void GfxGLRenderer::drawIndexedIndirect(
     const GfxBuffer& buffer,
-    int offset,
+    size_t offset,
     int drawCount,
     int stride
 ) {
@@ -959,13 +1113,136 @@ void GfxGLRenderer::dispatchCompute(int nGroupsX, int nGroupsY, int nGroupsZ) {
     glDispatchCompute(nGroupsX, nGroupsY, nGroupsZ);
 }
 
-void GfxGLRenderer::dispatchComputeIndirect(const GfxBuffer& buffer, int offset) {
+void GfxGLRenderer::dispatchComputeIndirect(const GfxBuffer& buffer, size_t offset) {
     std::shared_ptr<GfxGLBuffer> glBuffer = std::static_pointer_cast<GfxGLBuffer>(buffer);
     glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, glBuffer->m_buffer);
-    glDispatchComputeIndirect(offset);
+    glDispatchComputeIndirect(static_cast<GLintptr>(offset));
     glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
 }
 
 void GfxGLRenderer::memoryBarrier() {
     glMemoryBarrier(GL_ALL_BARRIER_BITS);
 }
+
+GfxCommandList GfxGLRenderer::createCommandList() const {
+    return std::make_shared<GfxGLCommandList>();
+}
+
+int GfxGLRenderer::recordCommandList(
+    const GfxCommandList& list,
+    const std::function<void()>& recordFunc
+) {
+    std::shared_ptr<GfxGLCommandList> glList = std::static_pointer_cast<GfxGLCommandList>(list);
+    if (!glList)
+        return 1; // Error: Invalid command list
+    glList->m_recordFunc = recordFunc;
+    return 0;
+}
+
+void GfxGLRenderer::executeCommandList(const GfxCommandList& list) {
+    std::shared_ptr<GfxGLCommandList> glList = std::static_pointer_cast<GfxGLCommandList>(list);
+    if (!glList || !glList->m_recordFunc)
+        return; // Error: Invalid or empty command list
+    glList->m_recordFunc();
+}
+
+void GfxGLRenderer::destroyCommandList(const GfxCommandList& list) const {
+    std::shared_ptr<GfxGLCommandList> glList = std::static_pointer_cast<GfxGLCommandList>(list);
+    if (glList)
+        glList->m_recordFunc = nullptr;
+}
+
+int GfxGLRenderer::beginFrame() {
+    // Queries belong to the context, create them once it is current
+    if (m_timerFrames.empty()) {
+        m_timerFrames.resize(TIMER_FRAMES);
+        for (auto& frame : m_timerFrames) {
+            frame.queries.resize(MAX_TIMER_QUERIES, 0);
+            glGenQueries(static_cast<GLsizei>(MAX_TIMER_QUERIES), frame.queries.data());
+        }
+    }
+
+    // The oldest frame of the ring is reused for this one
+    m_currentTimerFrame = (m_currentTimerFrame + 1) % TIMER_FRAMES;
+    TimerFrame& frame = m_timerFrames[m_currentTimerFrame];
+    resolveTimers(frame);
+    frame.serial = ++m_frameSerial;
+
+    return 0;
+}
+
+int GfxGLRenderer::beginTimer(const std::string& name) {
+    if (m_timerFrames.empty())
+        return 1; // Error: No frame begun yet
+    TimerFrame& frame = m_timerFrames[m_currentTimerFrame];
+    // Keep a query for the end of every open scope
+    if (frame.nQueries + frame.openScopes.size() + 2 > MAX_TIMER_QUERIES)
+        return 1; // Error: Out of timestamp queries for this frame
+
+    TimerScope scope{};
+    scope.name = name;
+    scope.depth = static_cast<int>(frame.openScopes.size());
+    scope.beginQuery = frame.nQueries++;
+    glQueryCounter(frame.queries[scope.beginQuery], GL_TIMESTAMP);
+    frame.openScopes.push_back(static_cast<int>(frame.scopes.size()));
+    frame.scopes.push_back(std::move(scope));
+    return 0;
+}
+
+void GfxGLRenderer::endTimer() {
+    if (m_timerFrames.empty())
+        return;
+    TimerFrame& frame = m_timerFrames[m_currentTimerFrame];
+    if (frame.openScopes.empty())
+        return;
+
+    TimerScope& scope = frame.scopes[frame.openScopes.back()];
+    frame.openScopes.pop_back();
+    scope.endQuery = frame.nQueries++;
+    glQueryCounter(frame.queries[scope.endQuery], GL_TIMESTAMP);
+}
+
+GfxDeviceInfo GfxGLRenderer::getDeviceInfo() const {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_deviceInfo;
+}
+
+uint64_t GfxGLRenderer::getTimerResults(std::vector<GfxTimerResult>& results) const {
+    std::lock_guard<std::mutex> lock(m_timerMutex);
+    results = m_timerResults;
+    return m_timerResultsSerial;
+}
+
+void GfxGLRenderer::resolveTimers(TimerFrame& frame) {
+    if (frame.nQueries > 0) {
+        // Queries complete in order, the last one being available means all of them are
+        GLint available = GL_FALSE;
+        GLuint lastQuery = frame.queries[frame.nQueries - 1];
+        glGetQueryObjectiv(lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        // Results still pending after a full ring are dropped instead of stalling
+        if (available == GL_TRUE) {
+            std::vector<GfxTimerResult> results;
+            results.reserve(frame.scopes.size());
+            for (const auto& scope : frame.scopes) {
+                if (scope.endQuery == UINT32_MAX)
+                    continue; // Scope was never ended
+                GLuint64 begin = 0;
+                GLuint64 end = 0;
+                glGetQueryObjectui64v(frame.queries[scope.beginQuery], GL_QUERY_RESULT, &begin);
+                glGetQueryObjectui64v(frame.queries[scope.endQuery], GL_QUERY_RESULT, &end);
+                GfxTimerResult timerResult{};
+                timerResult.name = scope.name;
+                timerResult.depth = scope.depth;
+                timerResult.ms = end > begin ? static_cast<double>(end - begin) * 1e-6 : 0.0;
+                results.push_back(std::move(timerResult));
+            }
+            std::lock_guard<std::mutex> lock(m_timerMutex);
+            m_timerResults = std::move(results);
+            m_timerResultsSerial = frame.serial;
+        }
+    }
+
+    frame.scopes.clear();
+    frame.openScopes.clear();
+    frame.nQueries = 0;
+}
@@ -122,6 +122,32 @@ int GfxGLTypeConverter::toGLTypeSize(GfxFormat format) {
     }
 }
 
+int GfxGLTypeConverter::formatSize(GfxFormat format) {
+    switch (format) {
+    case GfxFormat::R8_UNORM:
+    case GfxFormat::R8_SNORM:
+        return 1;
+    case GfxFormat::R32_SFLOAT:
+    case GfxFormat::R32_UINT:
+    case GfxFormat::R32_SINT:
+    case GfxFormat::R8G8B8A8_UNORM:
+    case GfxFormat::R8G8B8A8_SNORM:
+    case GfxFormat::D32_SFLOAT:
+    case GfxFormat::D24_UNORM_S8_UINT:
+        return 4;
+    case GfxFormat::R32G32_SFLOAT:
+    case GfxFormat::R32G32_UINT:
+    case GfxFormat::R32G32_SINT:
+        return 8;
+    case GfxFormat::R32G32B32_SFLOAT:
+        return 12;
+    case GfxFormat::R32G32B32A32_SFLOAT:
+        return 16;
+    default:
+        return 0; // Unsupported format
+    }
+}
+
 GLenum GfxGLTypeConverter::toGLFilterMode(GfxImageFilterMode filterMode) {
     switch (filterMode) {
     case GfxImageFilterMode::NEAREST:
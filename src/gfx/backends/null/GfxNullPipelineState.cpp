@@ -0,0 +1,129 @@
+/**
+ * @file GfxNullPipelineState.cpp
+ * @brief Null implementation of the GfxPipelineStateMachine interface.
+ */
+
+#include "gfx/backends/null/GfxNullPipelineState.h"
+
+void GfxNullPipelineStateMachine::setViewport(const GfxViewport& viewport) {
+    m_stateCache.viewport = viewport;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setScissor(const GfxRect& scissor) {
+    m_stateCache.scissor = scissor;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setLineWidth(float lineWidth) {
+    m_stateCache.lineWidth = lineWidth;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setLineSmoothEnabled(bool enabled) {
+    m_stateCache.lineSmoothEnabled = enabled;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setBlendConstants(const float blendConstants[4]) {
+    m_stateCache.blendConstants[0] = blendConstants[0];
+    m_stateCache.blendConstants[1] = blendConstants[1];
+    m_stateCache.blendConstants[2] = blendConstants[2];
+    m_stateCache.blendConstants[3] = blendConstants[3];
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setColorBlendEnabled(bool enabled) {
+    m_stateCache.colorBlendEnabled = enabled;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setColorBlendEquation(const GfxBlendEquation& equation) {
+    m_stateCache.colorBlendEquation = equation;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setColorWriteMask(unsigned int mask) {
+    m_stateCache.colorWriteMask = mask;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setDepthBiasEnabled(bool enabled) {
+    m_stateCache.depthBiasEnabled = enabled;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setDepthBiasParams(const GfxDepthBiasParams& params) {
+    m_stateCache.depthBiasParams = params;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setDepthTestEnabled(bool enabled) {
+    m_stateCache.depthTestEnabled = enabled;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setDepthWriteEnabled(bool enabled) {
+    m_stateCache.depthWriteEnabled = enabled;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setDepthCompareOp(GfxCompareOp op) {
+    m_stateCache.depthCompareOp = op;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setStencilTestEnabled(bool enabled) {
+    m_stateCache.stencilTestEnabled = enabled;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setStencilOpParams(
+    GfxFaceSide face,
+    const GfxStencilOpParams& params
+) {
+    if (face == GfxFaceSide::FRONT)
+        m_stateCache.frontFaceStencilOpParams = params;
+    else if (face == GfxFaceSide::BACK)
+        m_stateCache.backFaceStencilOpParams = params;
+    else {
+        m_stateCache.frontFaceStencilOpParams = params;
+        m_stateCache.backFaceStencilOpParams = params;
+    }
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setCullMode(GfxFaceSide mode) {
+    m_stateCache.cullMode = mode;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setFrontFace(GfxFrontFace frontFace) {
+    m_stateCache.frontFace = frontFace;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setPrimitiveTopo(GfxPrimitiveTopo topo) {
+    m_stateCache.primitiveTopo = topo;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setPrimitiveRestartEnabled(bool enabled) {
+    m_stateCache.primitiveRestartEnabled = enabled;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setLogicOpEnabled(bool enabled) {
+    m_stateCache.logicOpEnabled = enabled;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setLogicOp(GfxLogicOp op) {
+    m_stateCache.logicOp = op;
+    m_nStateChanges++;
+}
+
+void GfxNullPipelineStateMachine::setPolygonMode(GfxPolygonMode mode) {
+    m_stateCache.polygonMode = mode;
+    m_nStateChanges++;
+}
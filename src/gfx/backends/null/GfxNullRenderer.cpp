@@ -0,0 +1,666 @@
+/**
+ * @file GfxNullRenderer.cpp
+ * @brief Implementation of the GfxNullRenderer class.
+ */
+
+#include "gfx/backends/null/GfxNullRenderer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "gfx/backends/null/GfxNullPipelineState.h"
+
+std::mutex GfxNullRenderer::s_mutex;
+GfxNullRendererConfig GfxNullRenderer::s_config;
+
+GfxNullRenderer::GfxNullRenderer() {
+    m_backend = GfxBackend::Null;
+    m_pipelineStateMachine = std::make_shared<GfxNullPipelineStateMachine>();
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    m_dispatchFunc = s_config.dispatchFunc;
+}
+
+int GfxNullRenderer::initGlobal(const GfxRendererConfig& config) {
+    const GfxNullRendererConfig* nullConfig = std::get_if<GfxNullRendererConfig>(&config);
+    if (nullConfig == nullptr)
+        return 1; // Invalid configuration
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_config = *nullConfig;
+    return 0;
+}
+
+void GfxNullRenderer::termGlobal() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_config = {};
+}
+
+GfxNullRendererStats GfxNullRenderer::getStats() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return m_stats;
+}
+
+void GfxNullRenderer::resetStats() {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    GfxNullRendererStats stats{};
+    stats.buffers = m_stats.buffers;
+    stats.bufferBytes = m_stats.bufferBytes;
+    stats.images = m_stats.images;
+    stats.imageBytes = m_stats.imageBytes;
+    stats.shaders = m_stats.shaders;
+    stats.pipelines = m_stats.pipelines;
+    stats.descriptorSetBindings = m_stats.descriptorSetBindings;
+    m_stats = stats;
+}
+
+GfxImage GfxNullRenderer::createImage(const GfxImageInfo& info) const {
+    size_t pixelSize = formatSize(info.format);
+    if (info.width <= 0 || info.height <= 0 || pixelSize == 0)
+        return nullptr; // Error: Invalid image size or format
+
+    GfxImage image = std::make_shared<GfxNullImage>(info);
+    std::shared_ptr<GfxNullImage> nullImage = std::static_pointer_cast<GfxNullImage>(image);
+    nullImage->m_pixelSize = pixelSize;
+    nullImage->m_data.resize(static_cast<size_t>(info.width) * info.height * pixelSize);
+
+    GfxMemoryTracker::track(GfxMemoryTracker::getCategory(info.usages), nullImage->m_data.size());
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.images++;
+    m_stats.imageBytes += nullImage->m_data.size();
+    return image;
+}
+
+int GfxNullRenderer::setImageData(const GfxImage& image, void* data) const {
+    std::shared_ptr<GfxNullImage> nullImage = std::static_pointer_cast<GfxNullImage>(image);
+    if (!nullImage || data == nullptr)
+        return 1; // Error: Invalid image or data
+    memcpy(nullImage->m_data.data(), data, nullImage->m_data.size());
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.bytesUploaded += nullImage->m_data.size();
+    return 0;
+}
+
+int GfxNullRenderer::getImageData(const GfxImage& image, void* data) const {
+    std::shared_ptr<GfxNullImage> nullImage = std::static_pointer_cast<GfxNullImage>(image);
+    if (!nullImage || data == nullptr)
+        return 1; // Error: Invalid image or data
+    memcpy(data, nullImage->m_data.data(), nullImage->m_data.size());
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.readbacks++;
+    m_stats.bytesRead += nullImage->m_data.size();
+    return 0;
+}
+
+void GfxNullRenderer::copyImage(
+    const GfxImage& src,
+    const GfxImage& dst,
+    int width,
+    int height
+) {
+    std::shared_ptr<GfxNullImage> nullImageSrc = std::static_pointer_cast<GfxNullImage>(src);
+    std::shared_ptr<GfxNullImage> nullImageDst = std::static_pointer_cast<GfxNullImage>(dst);
+    if (!nullImageSrc || !nullImageDst || nullImageSrc->m_pixelSize != nullImageDst->m_pixelSize)
+        return; // Error: Invalid images or mismatching formats
+
+    width = std::min({ width, src->getWidth(), dst->getWidth() });
+    height = std::min({ height, src->getHeight(), dst->getHeight() });
+    size_t rowSize = static_cast<size_t>(std::max(width, 0)) * nullImageSrc->m_pixelSize;
+    for (int y = 0; y < height; y++) {
+        memcpy(
+            nullImageDst->m_data.data() + y * dst->getWidth() * nullImageDst->m_pixelSize,
+            nullImageSrc->m_data.data() + y * src->getWidth() * nullImageSrc->m_pixelSize,
+            rowSize
+        );
+    }
+}
+
+void GfxNullRenderer::destroyImage(const GfxImage& image) const {
+    std::shared_ptr<GfxNullImage> nullImage = std::static_pointer_cast<GfxNullImage>(image);
+    if (!nullImage)
+        return;
+
+    GfxMemoryTracker::untrack(
+        GfxMemoryTracker::getCategory(image->getUsages()),
+        nullImage->m_data.size()
+    );
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.images--;
+    m_stats.imageBytes -= nullImage->m_data.size();
+    nullImage->m_data = {};
+}
+
+GfxRenderPass GfxNullRenderer::createRenderPass(
+    const std::vector<GfxAttachment>& colorAttachments,
+    const GfxAttachment& depthAttachment
+) const {
+    return std::make_shared<GfxRenderPass_T>(colorAttachments, depthAttachment);
+}
+
+GfxFramebuffer GfxNullRenderer::createFramebuffer(
+    const GfxRenderPass& renderPass,
+    const std::vector<GfxImage>& colorImages,
+    const GfxImage& depthImage,
+    const std::vector<GfxImage>& colorResolveImages
+) const {
+    return std::make_shared<GfxFramebuffer_T>(
+        renderPass,
+        colorImages,
+        depthImage,
+        colorResolveImages
+    );
+}
+
+int GfxNullRenderer::readFramebufferColorAttachmentPixels(
+    const GfxFramebuffer& framebuffer,
+    int index,
+    const GfxRect& rect,
+    void* pixels
+) const {
+    if (index < 0 || index >= static_cast<int>(framebuffer->getColorImages().size()))
+        return 1; // Error: Invalid color attachment index
+
+    std::shared_ptr<GfxNullImage> nullImage =
+        std::static_pointer_cast<GfxNullImage>(framebuffer->getColorImages()[index]);
+    if (nullImage->getSamples() > 1) {
+        nullImage =
+            std::static_pointer_cast<GfxNullImage>(framebuffer->getColorResolveImages()[index]);
+    }
+    if (rect.x < 0 || rect.y < 0 || rect.width <= 0 || rect.height <= 0 ||
+        rect.x + rect.width > nullImage->getWidth() ||
+        rect.y + rect.height > nullImage->getHeight()) {
+        return 1; // Error: Rectangle out of bounds
+    }
+
+    size_t rowSize = static_cast<size_t>(rect.width) * nullImage->m_pixelSize;
+    for (int y = 0; y < rect.height; y++) {
+        size_t srcOffset =
+            (static_cast<size_t>(rect.y + y) * nullImage->getWidth() + rect.x) *
+            nullImage->m_pixelSize;
+        memcpy(
+            static_cast<char*>(pixels) + y * rowSize,
+            nullImage->m_data.data() + srcOffset,
+            rowSize
+        );
+    }
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.readbacks++;
+    m_stats.bytesRead += rowSize * rect.height;
+    return 0;
+}
+
+GfxBuffer GfxNullRenderer::createBuffer(
+    size_t size,
+    GfxBufferUsage usage,
+    GfxBufferProp prop
+) const {
+    GfxBuffer buffer = std::make_shared<GfxNullBuffer>(size, usage, prop);
+    std::shared_ptr<GfxNullBuffer> nullBuffer = std::static_pointer_cast<GfxNullBuffer>(buffer);
+    nullBuffer->m_data.resize(size);
+
+    GfxMemoryTracker::track(GfxMemoryTracker::getCategory(usage), size);
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.buffers++;
+    m_stats.bufferBytes += size;
+    return buffer;
+}
+
+int GfxNullRenderer::setBufferData(const GfxBuffer& buffer, size_t size, const void* data) const {
+    std::shared_ptr<GfxNullBuffer> nullBuffer = std::static_pointer_cast<GfxNullBuffer>(buffer);
+    size_t oldSize = nullBuffer->m_data.size();
+    nullBuffer->m_data.resize(size);
+    if (data != nullptr)
+        memcpy(nullBuffer->m_data.data(), data, size);
+    nullBuffer->setSize(size);
+
+    GfxMemoryTracker::resize(GfxMemoryTracker::getCategory(buffer->getUsage()), oldSize, size);
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.bufferBytes = m_stats.bufferBytes - oldSize + size;
+    m_stats.bufferUploads++;
+    m_stats.bytesUploaded += data != nullptr ? size : 0;
+    return 0;
+}
+
+int GfxNullRenderer::updateBufferData(
+    const GfxBuffer& buffer,
+    size_t offset,
+    size_t size,
+    const void* data
+) const {
+    std::shared_ptr<GfxNullBuffer> nullBuffer = std::static_pointer_cast<GfxNullBuffer>(buffer);
+    if (offset > buffer->getSize() || size > buffer->getSize() - offset)
+        return 1; // Error: Update out of bounds
+    memcpy(nullBuffer->m_data.data() + offset, data, size);
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.bufferUploads++;
+    m_stats.bytesUploaded += size;
+    return 0;
+}
+
+void GfxNullRenderer::destroyBuffer(const GfxBuffer& buffer) const {
+    std::shared_ptr<GfxNullBuffer> nullBuffer = std::static_pointer_cast<GfxNullBuffer>(buffer);
+    if (!nullBuffer)
+        return;
+
+    GfxMemoryTracker::untrack(
+        GfxMemoryTracker::getCategory(buffer->getUsage()),
+        nullBuffer->m_data.size()
+    );
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.buffers--;
+    m_stats.bufferBytes -= nullBuffer->m_data.size();
+    nullBuffer->m_data = {};
+}
+
+int GfxNullRenderer::readBufferData(
+    const GfxBuffer& buffer,
+    size_t offset,
+    size_t size,
+    void* data
+) const {
+    std::shared_ptr<GfxNullBuffer> nullBuffer = std::static_pointer_cast<GfxNullBuffer>(buffer);
+    if (offset > buffer->getSize() || size > buffer->getSize() - offset)
+        return 1; // Error: Read out of bounds
+    memcpy(data, nullBuffer->m_data.data() + offset, size);
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.readbacks++;
+    m_stats.bytesRead += size;
+    return 0;
+}
+
+int GfxNullRenderer::copyBuffer(
+    const GfxBuffer& src,
+    const GfxBuffer& dst,
+    size_t srcOffset,
+    size_t dstOffset,
+    size_t size
+) const {
+    std::shared_ptr<GfxNullBuffer> nullBufferSrc = std::static_pointer_cast<GfxNullBuffer>(src);
+    std::shared_ptr<GfxNullBuffer> nullBufferDst = std::static_pointer_cast<GfxNullBuffer>(dst);
+    if (srcOffset > src->getSize() || size > src->getSize() - srcOffset)
+        return 1; // Error: Source range out of bounds
+    if (dstOffset > dst->getSize() || size > dst->getSize() - dstOffset)
+        return 1; // Error: Destination range out of bounds
+    memmove(
+        nullBufferDst->m_data.data() + dstOffset,
+        nullBufferSrc->m_data.data() + srcOffset,
+        size
+    );
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.bufferCopies++;
+    m_stats.bytesCopied += size;
+    return 0;
+}
+
+GfxReadback GfxNullRenderer::readBufferDataAsync(
+    const GfxBuffer& buffer,
+    size_t offset,
+    size_t size
+) const {
+    if (!buffer || size == 0 || offset > buffer->getSize() || size > buffer->getSize() - offset)
+        return nullptr; // Error: Read out of bounds
+
+    // There is no device to wait for, the data arrives immediately
+    std::shared_ptr<GfxNullBuffer> nullBuffer = std::static_pointer_cast<GfxNullBuffer>(buffer);
+    std::shared_ptr<GfxNullReadback> nullReadback = std::make_shared<GfxNullReadback>(size);
+    nullReadback->m_data.assign(
+        nullBuffer->m_data.begin() + offset,
+        nullBuffer->m_data.begin() + offset + size
+    );
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.readbacks++;
+    m_stats.bytesRead += size;
+    return nullReadback;
+}
+
+bool GfxNullRenderer::isReadbackReady(const GfxReadback& readback) const {
+    std::shared_ptr<GfxNullReadback> nullReadback =
+        std::static_pointer_cast<GfxNullReadback>(readback);
+    return nullReadback && !nullReadback->m_data.empty();
+}
+
+const void* GfxNullRenderer::mapReadback(const GfxReadback& readback, bool wait) const {
+    std::shared_ptr<GfxNullReadback> nullReadback =
+        std::static_pointer_cast<GfxNullReadback>(readback);
+    if (!nullReadback || nullReadback->m_data.empty())
+        return nullptr; // Error: Invalid or released readback
+    return nullReadback->m_data.data();
+}
+
+void GfxNullRenderer::releaseReadback(const GfxReadback& readback) const {
+    std::shared_ptr<GfxNullReadback> nullReadback =
+        std::static_pointer_cast<GfxNullReadback>(readback);
+    if (nullReadback)
+        nullReadback->m_data = {};
+}
+
+GfxVAO GfxNullRenderer::createVAO(
+    const GfxVertexDesc& vertexDesc,
+    const GfxBuffer& vertexBuffer,
+    const GfxBuffer& indexBuffer
+) const {
+    return std::make_shared<GfxVAO_T>(vertexDesc, vertexBuffer, indexBuffer);
+}
+
+GfxShader GfxNullRenderer::createShader(
+    GfxShaderStage stage,
+    const std::string& source
+) const {
+    GfxShader shader = std::make_shared<GfxNullShader>(stage, source);
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.shaders++;
+    return shader;
+}
+
+void GfxNullRenderer::destroyShader(const GfxShader& shader) const {
+    if (!shader)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.shaders--;
+}
+
+GfxPipeline GfxNullRenderer::createPipeline(
+    const std::vector<GfxShader>& shaders,
+    const std::vector<GfxDescriptorSet>& descriptorSets,
+    const GfxVertexDesc& vertexDesc,
+    const std::vector<GfxPipelineState>& dynamicStates,
+    const GfxRenderPass& renderPass
+) const {
+    std::shared_ptr<GfxNullPipeline> nullPipeline =
+        std::make_shared<GfxNullPipeline>(renderPass, descriptorSets, dynamicStates);
+    for (const auto& shader : shaders) {
+        if (shader)
+            nullPipeline->setStage(shader->getStage());
+    }
+    nullPipeline->m_shaders = shaders;
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.pipelines++;
+    return nullPipeline;
+}
+
+void GfxNullRenderer::destroyPipeline(const GfxPipeline& pipeline) const {
+    if (!pipeline)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.pipelines--;
+}
+
+GfxDescriptorSetBinding GfxNullRenderer::createDescriptorSetBinding(
+    const GfxPipeline& pipeline,
+    int descriptorSetIndex,
+    const std::vector<GfxDescriptorBinding>& bindings
+) const {
+    GfxDescriptorSetBinding binding =
+        std::make_shared<GfxDescriptorSetBinding_T>(pipeline, descriptorSetIndex, bindings);
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.descriptorSetBindings++;
+    return binding;
+}
+
+void GfxNullRenderer::destroyDescriptorSetBinding(GfxDescriptorSetBinding& binding) const {
+    if (!binding)
+        return;
+    binding = nullptr;
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.descriptorSetBindings--;
+}
+
+int GfxNullRenderer::beginRenderPass(const GfxFramebuffer& framebuffer) {
+    m_currentFramebuffer = framebuffer;
+
+    m_recordedStats.renderPasses++;
+    return 0;
+}
+
+void GfxNullRenderer::endRenderPass() {
+    m_currentFramebuffer = nullptr;
+}
+
+void GfxNullRenderer::bindPipeline(const GfxPipeline& pipeline) {
+    m_currentPipeline = pipeline;
+    m_boundDescriptorSets.clear();
+
+    m_recordedStats.pipelineBinds++;
+}
+
+void GfxNullRenderer::bindVAO(const GfxVAO& vao) {
+    m_recordedStats.vaoBinds++;
+}
+
+void GfxNullRenderer::clearColorAttachment(int index, const std::array<float, 4>& value) {
+    m_recordedStats.clears++;
+}
+
+void GfxNullRenderer::clearDepthAttachment(float value) {
+    m_recordedStats.clears++;
+}
+
+void GfxNullRenderer::clearStencilAttachment(int value) {
+    m_recordedStats.clears++;
+}
+
+void GfxNullRenderer::bindDescriptorSetBinding(const GfxDescriptorSetBinding& binding) {
+    int index = binding->getDescriptorSetIndex();
+    if (index >= static_cast<int>(m_boundDescriptorSets.size()))
+        m_boundDescriptorSets.resize(index + 1);
+    m_boundDescriptorSets[index] = binding;
+
+    m_recordedStats.descriptorSetBinds++;
+}
+
+int GfxNullRenderer::beginFrame() {
+    m_frameSerial++;
+    m_timerScopes.clear();
+    m_openTimerScopes.clear();
+
+    m_recordedStats.frames++;
+    return 0;
+}
+
+int GfxNullRenderer::endFrame() {
+    // Commands are counted without locking while recording and merged on submission, the
+    // state machine counts its changes on the render thread as well
+    std::shared_ptr<GfxNullPipelineStateMachine> stateMachine =
+        std::static_pointer_cast<GfxNullPipelineStateMachine>(m_pipelineStateMachine);
+    m_recordedStats.stateChanges = stateMachine->m_nStateChanges;
+    stateMachine->m_nStateChanges = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.frames += m_recordedStats.frames;
+        m_stats.renderPasses += m_recordedStats.renderPasses;
+        m_stats.pipelineBinds += m_recordedStats.pipelineBinds;
+        m_stats.vaoBinds += m_recordedStats.vaoBinds;
+        m_stats.descriptorSetBinds += m_recordedStats.descriptorSetBinds;
+        m_stats.clears += m_recordedStats.clears;
+        m_stats.draws += m_recordedStats.draws;
+        m_stats.dispatches += m_recordedStats.dispatches;
+        m_stats.workGroups += m_recordedStats.workGroups;
+        m_stats.barriers += m_recordedStats.barriers;
+        m_stats.commandLists += m_recordedStats.commandLists;
+        m_stats.timerScopes += m_recordedStats.timerScopes;
+        m_stats.stateChanges += m_recordedStats.stateChanges;
+    }
+    m_recordedStats = {};
+
+    // Scopes still open at the end of the frame are dropped
+    std::vector<GfxTimerResult> results;
+    for (const auto& scope : m_timerScopes) {
+        if (scope.ms >= 0.0)
+            results.push_back({ scope.name, scope.depth, scope.ms });
+    }
+
+    std::lock_guard<std::mutex> lock(m_timerMutex);
+    m_timerResults = std::move(results);
+    m_timerResultsSerial = m_frameSerial;
+    return 0;
+}
+
+void GfxNullRenderer::draw(int nVertices, int nInstances, int firstVertex, int firstInstance) {
+    m_recordedStats.draws++;
+}
+
+void GfxNullRenderer::drawIndexed(
+    int nIndices,
+    int nInstances,
+    int firstIndex,
+    int vertexOffset,
+    int firstInstance
+) {
+    m_recordedStats.draws++;
+}
+
+void GfxNullRenderer::drawIndirect(
+    const GfxBuffer& buffer,
+    size_t offset,
+    int drawCount,
+    int stride
+) {
+    m_recordedStats.draws += std::max(drawCount, 0);
+}
+
+void GfxNullRenderer::drawIndexedIndirect(
+    const GfxBuffer& buffer,
+    size_t offset,
+    int drawCount,
+    int stride
+) {
+    m_recordedStats.draws += std::max(drawCount, 0);
+}
+
+void GfxNullRenderer::dispatchCompute(int nGroupsX, int nGroupsY, int nGroupsZ) {
+    m_recordedStats.dispatches++;
+    m_recordedStats.workGroups += static_cast<uint64_t>(nGroupsX) * nGroupsY * nGroupsZ;
+    runDispatch(nGroupsX, nGroupsY, nGroupsZ);
+}
+
+void GfxNullRenderer::dispatchComputeIndirect(const GfxBuffer& buffer, size_t offset) {
+    m_recordedStats.dispatches++;
+
+    // The group counts are already in host memory
+    std::shared_ptr<GfxNullBuffer> nullBuffer = std::static_pointer_cast<GfxNullBuffer>(buffer);
+    uint32_t groups[3] = { 0, 0, 0 };
+    if (offset > buffer->getSize() || sizeof(groups) > buffer->getSize() - offset)
+        return; // Error: Indirect arguments out of bounds
+    memcpy(groups, nullBuffer->m_data.data() + offset, sizeof(groups));
+    runDispatch(
+        static_cast<int>(groups[0]),
+        static_cast<int>(groups[1]),
+        static_cast<int>(groups[2])
+    );
+}
+
+void GfxNullRenderer::memoryBarrier() {
+    m_recordedStats.barriers++;
+}
+
+GfxCommandList GfxNullRenderer::createCommandList() const {
+    return std::make_shared<GfxNullCommandList>();
+}
+
+int GfxNullRenderer::recordCommandList(
+    const GfxCommandList& list,
+    const std::function<void()>& recordFunc
+) {
+    std::shared_ptr<GfxNullCommandList> nullList =
+        std::static_pointer_cast<GfxNullCommandList>(list);
+    if (!nullList)
+        return 1; // Error: Invalid command list
+    nullList->m_recordFunc = recordFunc;
+    return 0;
+}
+
+void GfxNullRenderer::executeCommandList(const GfxCommandList& list) {
+    std::shared_ptr<GfxNullCommandList> nullList =
+        std::static_pointer_cast<GfxNullCommandList>(list);
+    if (!nullList || !nullList->m_recordFunc)
+        return; // Error: Invalid or empty command list
+    m_recordedStats.commandLists++;
+    nullList->m_recordFunc();
+}
+
+void GfxNullRenderer::destroyCommandList(const GfxCommandList& list) const {
+    std::shared_ptr<GfxNullCommandList> nullList =
+        std::static_pointer_cast<GfxNullCommandList>(list);
+    if (nullList)
+        nullList->m_recordFunc = nullptr;
+}
+
+int GfxNullRenderer::beginTimer(const std::string& name) {
+    TimerScope scope{};
+    scope.name = name;
+    scope.depth = static_cast<int>(m_openTimerScopes.size());
+    scope.begin = std::chrono::steady_clock::now();
+    scope.ms = -1.0;
+    m_openTimerScopes.push_back(static_cast<int>(m_timerScopes.size()));
+    m_timerScopes.push_back(std::move(scope));
+
+    m_recordedStats.timerScopes++;
+    return 0;
+}
+
+void GfxNullRenderer::endTimer() {
+    if (m_openTimerScopes.empty())
+        return; // Error: No open timer scope
+    TimerScope& scope = m_timerScopes[m_openTimerScopes.back()];
+    m_openTimerScopes.pop_back();
+    scope.ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - scope.begin
+    ).count();
+}
+
+uint64_t GfxNullRenderer::getTimerResults(std::vector<GfxTimerResult>& results) const {
+    std::lock_guard<std::mutex> lock(m_timerMutex);
+    results = m_timerResults;
+    return m_timerResultsSerial;
+}
+
+size_t GfxNullRenderer::formatSize(GfxFormat format) {
+    switch (format) {
+    case GfxFormat::R8_UNORM:
+    case GfxFormat::R8_SNORM:
+        return 1;
+    case GfxFormat::R32_SFLOAT:
+    case GfxFormat::R8G8B8A8_UNORM:
+    case GfxFormat::R8G8B8A8_SNORM:
+    case GfxFormat::D32_SFLOAT:
+    case GfxFormat::D24_UNORM_S8_UINT:
+    case GfxFormat::R32_UINT:
+    case GfxFormat::R32_SINT:
+        return 4;
+    case GfxFormat::R32G32_SFLOAT:
+    case GfxFormat::R32G32_UINT:
+    case GfxFormat::R32G32_SINT:
+        return 8;
+    case GfxFormat::R32G32B32_SFLOAT:
+        return 12;
+    case GfxFormat::R32G32B32A32_SFLOAT:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+void GfxNullRenderer::runDispatch(int nGroupsX, int nGroupsY, int nGroupsZ) {
+    if (!m_dispatchFunc)
+        return;
+
+    GfxNullDispatch dispatch{};
+    dispatch.pipeline = m_currentPipeline;
+    dispatch.descriptorSetBindings = m_boundDescriptorSets;
+    dispatch.nGroupsX = nGroupsX;
+    dispatch.nGroupsY = nGroupsY;
+    dispatch.nGroupsZ = nGroupsZ;
+    m_dispatchFunc(dispatch);
+}
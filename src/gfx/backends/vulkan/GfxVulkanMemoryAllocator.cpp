@@ -0,0 +1,295 @@
+/**
+ * @file GfxVulkanMemoryAllocator.cpp
+ * @brief Implementation of GfxVulkanMemoryAllocator class.
+ */
+
+#include "gfx/backends/vulkan/GfxVulkanMemoryAllocator.h"
+
+GfxVulkanMemoryAllocator::GfxVulkanMemoryAllocator(
+    VkPhysicalDevice physicalDevice,
+    VkDevice device,
+    VkDeviceSize blockSize
+) :
+    m_device(device),
+    m_blockSize(blockSize)
+{
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_memProperties);
+    m_pools.resize(static_cast<size_t>(m_memProperties.memoryTypeCount) * 2);
+}
+
+GfxVulkanMemoryAllocator::~GfxVulkanMemoryAllocator() {
+    for (auto& pool : m_pools) {
+        for (auto& block : pool.blocks)
+            destroyBlock(block);
+    }
+    m_pools.clear();
+}
+
+int GfxVulkanMemoryAllocator::allocate(
+    const VkMemoryRequirements& requirements,
+    uint32_t memoryTypeIndex,
+    bool linear,
+    GfxVulkanAllocation& allocation
+) {
+    if (memoryTypeIndex >= m_memProperties.memoryTypeCount)
+        return 1; // Error: Invalid memory type
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    VkDeviceSize size = requirements.size;
+    VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+
+    // Large resources get their own device memory, they would waste most of a block
+    VkMemoryHeap heap = m_memProperties.memoryHeaps[
+        m_memProperties.memoryTypes[memoryTypeIndex].heapIndex
+    ];
+    VkDeviceSize blockSize = std::min(m_blockSize, heap.size / 8);
+    if (size > blockSize / 2) {
+        Block dedicated{};
+        if (createBlock(memoryTypeIndex, size, dedicated))
+            return 1; // Error: Failed to allocate device memory
+        allocation = {};
+        allocation.memory = dedicated.memory;
+        allocation.offset = 0;
+        allocation.size = size;
+        allocation.mappedData = dedicated.mappedData;
+        allocation.memoryTypeIndex = memoryTypeIndex;
+        m_dedicatedCount++;
+        m_dedicatedBytes += size;
+        m_allocationCount++;
+        m_usedBytes += size;
+        return 0;
+    }
+
+    int poolIndex = static_cast<int>(memoryTypeIndex) * 2 + (linear ? 0 : 1);
+    Pool& pool = m_pools[poolIndex];
+
+    VkDeviceSize offset = 0;
+    int blockIndex = -1;
+    int emptySlot = -1;
+    for (int i = 0; i < static_cast<int>(pool.blocks.size()); i++) {
+        Block& block = pool.blocks[i];
+        if (block.memory == VK_NULL_HANDLE) {
+            if (emptySlot < 0)
+                emptySlot = i;
+            continue;
+        }
+        if (allocateFromBlock(block, size, alignment, offset)) {
+            blockIndex = i;
+            break;
+        }
+    }
+
+    // No block has room, grow the pool
+    if (blockIndex < 0) {
+        Block block{};
+        if (createBlock(memoryTypeIndex, blockSize, block))
+            return 1; // Error: Failed to allocate device memory
+        insertFreeRange(block, 0, block.size);
+        if (emptySlot >= 0) {
+            pool.blocks[emptySlot] = std::move(block);
+            blockIndex = emptySlot;
+        } else {
+            pool.blocks.push_back(std::move(block));
+            blockIndex = static_cast<int>(pool.blocks.size()) - 1;
+        }
+        if (!allocateFromBlock(pool.blocks[blockIndex], size, alignment, offset))
+            return 1; // Error: Allocation does not fit into a fresh block
+    }
+
+    Block& block = pool.blocks[blockIndex];
+    block.nAllocations++;
+
+    allocation = {};
+    allocation.memory = block.memory;
+    allocation.offset = offset;
+    allocation.size = size;
+    if (block.mappedData != nullptr)
+        allocation.mappedData = static_cast<char*>(block.mappedData) + offset;
+    allocation.memoryTypeIndex = memoryTypeIndex;
+    allocation.poolIndex = poolIndex;
+    allocation.blockIndex = blockIndex;
+
+    m_allocationCount++;
+    m_usedBytes += size;
+
+    return 0;
+}
+
+void GfxVulkanMemoryAllocator::free(GfxVulkanAllocation& allocation) {
+    if (allocation.memory == VK_NULL_HANDLE)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (allocation.poolIndex < 0) {
+        Block dedicated{};
+        dedicated.memory = allocation.memory;
+        dedicated.mappedData = allocation.mappedData;
+        destroyBlock(dedicated);
+        m_dedicatedCount--;
+        m_dedicatedBytes -= allocation.size;
+    } else {
+        Block& block = m_pools[allocation.poolIndex].blocks[allocation.blockIndex];
+        insertFreeRange(block, allocation.offset, allocation.size);
+        block.nAllocations--;
+    }
+
+    m_allocationCount--;
+    m_usedBytes -= allocation.size;
+
+    allocation = {};
+}
+
+int GfxVulkanMemoryAllocator::releaseEmptyBlocks() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    int nReleased = 0;
+    for (auto& pool : m_pools) {
+        for (auto& block : pool.blocks) {
+            if (block.memory != VK_NULL_HANDLE && block.nAllocations == 0) {
+                destroyBlock(block);
+                nReleased++;
+            }
+        }
+        // Trailing empty slots can go, the others keep block indices of live allocations stable
+        while (!pool.blocks.empty() && pool.blocks.back().memory == VK_NULL_HANDLE)
+            pool.blocks.pop_back();
+    }
+    return nReleased;
+}
+
+GfxVulkanMemoryStats GfxVulkanMemoryAllocator::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    GfxVulkanMemoryStats stats{};
+    for (const auto& pool : m_pools) {
+        for (const auto& block : pool.blocks) {
+            if (block.memory == VK_NULL_HANDLE)
+                continue;
+            stats.blockCount++;
+            stats.reservedBytes += block.size;
+            stats.freeRangeCount += static_cast<int>(block.freeByOffset.size());
+            if (!block.freeBySize.empty()) {
+                stats.largestFreeRange =
+                    std::max(stats.largestFreeRange, block.freeBySize.rbegin()->first);
+            }
+        }
+    }
+    stats.dedicatedCount = m_dedicatedCount;
+    stats.allocationCount = m_allocationCount;
+    stats.reservedBytes += m_dedicatedBytes;
+    stats.usedBytes = m_usedBytes;
+    return stats;
+}
+
+int GfxVulkanMemoryAllocator::createBlock(
+    uint32_t memoryTypeIndex,
+    VkDeviceSize size,
+    Block& block
+) const {
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &block.memory))
+        return 1; // Error: Failed to allocate device memory
+
+    VkMemoryPropertyFlags flags = m_memProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+    if (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        if (vkMapMemory(m_device, block.memory, 0, VK_WHOLE_SIZE, 0, &block.mappedData)) {
+            vkFreeMemory(m_device, block.memory, nullptr);
+            block.memory = VK_NULL_HANDLE;
+            return 1; // Error: Failed to map device memory
+        }
+    }
+
+    block.size = size;
+    return 0;
+}
+
+void GfxVulkanMemoryAllocator::destroyBlock(Block& block) const {
+    if (block.memory == VK_NULL_HANDLE)
+        return;
+    if (block.mappedData != nullptr)
+        vkUnmapMemory(m_device, block.memory);
+    vkFreeMemory(m_device, block.memory, nullptr);
+    block = {};
+}
+
+bool GfxVulkanMemoryAllocator::allocateFromBlock(
+    Block& block,
+    VkDeviceSize size,
+    VkDeviceSize alignment,
+    VkDeviceSize& offset
+) {
+    // Smallest free ranges first, the first one that still fits after alignment wins
+    for (auto it = block.freeBySize.lower_bound(size); it != block.freeBySize.end(); ++it) {
+        VkDeviceSize rangeSize = it->first;
+        VkDeviceSize rangeOffset = it->second;
+        VkDeviceSize alignedOffset = (rangeOffset + alignment - 1) / alignment * alignment;
+        VkDeviceSize padding = alignedOffset - rangeOffset;
+        if (padding + size > rangeSize)
+            continue;
+
+        block.freeBySize.erase(it);
+        block.freeByOffset.erase(rangeOffset);
+
+        // Return the alignment padding and the tail to the free lists
+        if (padding > 0) {
+            block.freeByOffset[rangeOffset] = padding;
+            block.freeBySize.emplace(padding, rangeOffset);
+        }
+        VkDeviceSize tail = rangeSize - padding - size;
+        if (tail > 0) {
+            block.freeByOffset[alignedOffset + size] = tail;
+            block.freeBySize.emplace(tail, alignedOffset + size);
+        }
+
+        offset = alignedOffset;
+        return true;
+    }
+    return false;
+}
+
+void GfxVulkanMemoryAllocator::insertFreeRange(
+    Block& block,
+    VkDeviceSize offset,
+    VkDeviceSize size
+) {
+    auto next = block.freeByOffset.lower_bound(offset);
+
+    // Merge with the following range
+    if (next != block.freeByOffset.end() && offset + size == next->first) {
+        size += next->second;
+        eraseFreeSize(block, next->first, next->second);
+        next = block.freeByOffset.erase(next);
+    }
+    // Merge with the preceding range
+    if (next != block.freeByOffset.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            eraseFreeSize(block, prev->first, prev->second);
+            block.freeByOffset.erase(prev);
+        }
+    }
+
+    block.freeByOffset[offset] = size;
+    block.freeBySize.emplace(size, offset);
+}
+
+void GfxVulkanMemoryAllocator::eraseFreeSize(
+    Block& block,
+    VkDeviceSize offset,
+    VkDeviceSize size
+) {
+    auto range = block.freeBySize.equal_range(size);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == offset) {
+            block.freeBySize.erase(it);
+            return;
+        }
+    }
+}
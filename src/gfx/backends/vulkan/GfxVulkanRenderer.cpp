@@ -5,6 +5,8 @@
 
 #include "gfx/backends/vulkan/GfxVulkanRenderer.h"
 
+#include <chrono>
+
 #include <glslang/Public/ShaderLang.h>
 #include <glslang/Public/ResourceLimits.h>
 #include <glslang/SPIRV/GlslangToSpv.h>
@@ -18,6 +20,10 @@
 #endif // _DEBUG
 
 constexpr int MAX_FRAMES_IN_FLIGHT = 2; // Maximum number of frames in flight
+constexpr VkDeviceSize STAGING_RING_SIZE = 32ull * 1024 * 1024; // Size of the staging ring
+constexpr VkDeviceSize STAGING_ALIGNMENT = 16; // Alignment of regions in the staging ring
+constexpr VkDeviceSize STAGING_CHUNK_SIZE = 8ull * 1024 * 1024; // Largest buffer transfer chunk
+constexpr uint32_t MAX_TIMER_QUERIES = 128; // Timestamp queries per frame in flight
 
 std::mutex GfxVulkanRenderer::s_mutex; // Mutex for global Vulkan renderer
 
@@ -25,6 +31,13 @@ VkInstance GfxVulkanRenderer::s_vkInstance = VK_NULL_HANDLE; // Vulkan instance
 VkPhysicalDevice GfxVulkanRenderer::s_vkPhysicalDevice = VK_NULL_HANDLE; // Vulkan physical device
 VkDevice GfxVulkanRenderer::s_vkDevice = VK_NULL_HANDLE; // Vulkan logical device
 int GfxVulkanRenderer::s_nInstances = 0; // Number of Vulkan renderer instances
+std::unique_ptr<GfxVulkanMemoryAllocator> GfxVulkanRenderer::s_allocator = nullptr; // Allocator
+std::unique_ptr<GfxVulkanShaderCache> GfxVulkanRenderer::s_shaderCache = nullptr; // Shader cache
+VkPipelineCache GfxVulkanRenderer::s_vkPipelineCache = VK_NULL_HANDLE; // Pipeline cache
+uint32_t GfxVulkanRenderer::s_graphicsFamily = 0; // Graphics queue family
+uint32_t GfxVulkanRenderer::s_computeFamily = UINT32_MAX; // Compute-only queue family
+int GfxVulkanRenderer::s_nComputeInstances = 0; // Number of renderers on the compute family
+bool GfxVulkanRenderer::s_timelineSemaphores = false; // Whether timeline semaphores are enabled
 
 GfxVulkanRenderer::GfxVulkanRenderer() {
     m_backend = GfxBackend::Vulkan;
@@ -39,10 +52,14 @@ GfxVulkanRenderer::GfxVulkanRenderer() {
                     vkDestroySemaphore(s_vkDevice, m_renderFinishedSemaphores[i], nullptr);
                     vkDestroyFence(s_vkDevice, m_inFlightFences[i], nullptr);
                 }
+                vkDestroySemaphore(s_vkDevice, m_frameTimeline, nullptr);
+                m_frameTimeline = VK_NULL_HANDLE;
             }
             if (err) {
                 vkDestroyCommandPool(s_vkDevice, m_vkCommandPool, nullptr);
                 m_vkCommandPool = VK_NULL_HANDLE;
+                vkDestroyCommandPool(s_vkDevice, m_vkTransferCommandPool, nullptr);
+                m_vkTransferCommandPool = VK_NULL_HANDLE;
             }
         }
     );
@@ -74,11 +91,16 @@ GfxVulkanRenderer::GfxVulkanRenderer() {
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
     QueueFamily family = findQueueFamily(s_vkPhysicalDevice);
+    m_queueFamily = family.index;
     poolInfo.queueFamilyIndex = family.index;
     if (vkCreateCommandPool(s_vkDevice, &poolInfo, nullptr, &m_vkCommandPool)) {
         err = 1;
         return; // Error: Failed to create command pool
     }
+    if (vkCreateCommandPool(s_vkDevice, &poolInfo, nullptr, &m_vkTransferCommandPool)) {
+        err = 1;
+        return; // Error: Failed to create transfer command pool
+    }
 
     // Create command buffers
     if (createCommandBuffers()) {
@@ -96,6 +118,7 @@ GfxVulkanRenderer::GfxVulkanRenderer() {
     m_imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
     m_renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
     m_inFlightFences.resize(MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+    m_inFlightSerials.resize(MAX_FRAMES_IN_FLIGHT, 0);
 
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -132,6 +155,43 @@ GfxVulkanRenderer::GfxVulkanRenderer() {
             return; // Error: Failed to create in-flight fence
         }
     }
+    if (s_timelineSemaphores) {
+        VkSemaphoreTypeCreateInfo typeInfo{};
+        typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue = 0;
+        VkSemaphoreCreateInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        timelineInfo.pNext = &typeInfo;
+        result = vkCreateSemaphore(s_vkDevice, &timelineInfo, nullptr, &m_frameTimeline);
+        if (result != VK_SUCCESS) {
+            err = 2;
+            return; // Error: Failed to create frame timeline semaphore
+        }
+    }
+
+    // Create timestamp query pools, GPU timers stay disabled if the queue cannot write them
+    if (family.timestampValidBits > 0 && physicalDeviceProperties.limits.timestampPeriod > 0.0f) {
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolInfo.queryCount = MAX_TIMER_QUERIES;
+        m_timerFrames.resize(MAX_FRAMES_IN_FLIGHT);
+        for (auto& timerFrame : m_timerFrames) {
+            result = vkCreateQueryPool(s_vkDevice, &queryPoolInfo, nullptr, &timerFrame.queryPool);
+            if (result != VK_SUCCESS) {
+                for (auto& createdFrame : m_timerFrames)
+                    vkDestroyQueryPool(s_vkDevice, createdFrame.queryPool, nullptr);
+                m_timerFrames.clear();
+                break;
+            }
+        }
+        if (!m_timerFrames.empty()) {
+            m_timestampMask = family.timestampValidBits >= 64 ?
+                ~0ull : (1ull << family.timestampValidBits) - 1;
+            m_timestampPeriod = physicalDeviceProperties.limits.timestampPeriod;
+        }
+    }
 
     vkGetDeviceQueue(s_vkDevice, family.index, s_nInstances, &m_vkGraphicsQueue);
     vkGetDeviceQueue(s_vkDevice, family.index, s_nInstances, &m_vkPresentQueue);
@@ -155,10 +215,30 @@ GfxVulkanRenderer::~GfxVulkanRenderer() {
         vkDestroySemaphore(s_vkDevice, m_renderFinishedSemaphores[i], nullptr);
         vkDestroyFence(s_vkDevice, m_inFlightFences[i], nullptr);
     }
+    vkDestroySemaphore(s_vkDevice, m_frameTimeline, nullptr);
+    m_frameTimeline = VK_NULL_HANDLE;
+    for (auto& timerFrame : m_timerFrames)
+        vkDestroyQueryPool(s_vkDevice, timerFrame.queryPool, nullptr);
+    m_timerFrames.clear();
+
+    // Upload resources
+    submitUploads();
+    retireUploads(true);
+    for (auto fence : m_freeUploadFences)
+        vkDestroyFence(s_vkDevice, fence, nullptr);
+    m_freeUploadFences.clear();
+    destroyVkBuffer(m_stagingRing, m_stagingRingAllocation);
+    for (auto& readbackBuffer : m_freeReadbackBuffers) {
+        destroyVkBuffer(readbackBuffer.buffer, readbackBuffer.allocation);
+        vkDestroyFence(s_vkDevice, readbackBuffer.fence, nullptr);
+    }
+    m_freeReadbackBuffers.clear();
 
     // Other staff
     vkDestroyCommandPool(s_vkDevice, m_vkCommandPool, nullptr);
     m_vkCommandPool = VK_NULL_HANDLE;
+    vkDestroyCommandPool(s_vkDevice, m_vkTransferCommandPool, nullptr);
+    m_vkTransferCommandPool = VK_NULL_HANDLE;
 
     vkDestroySurfaceKHR(s_vkInstance, m_vkSurface, nullptr);
     m_vkSurface = VK_NULL_HANDLE;
@@ -166,6 +246,8 @@ GfxVulkanRenderer::~GfxVulkanRenderer() {
     m_vkGraphicsQueue = VK_NULL_HANDLE;
     m_vkPresentQueue = VK_NULL_HANDLE;
 
+    if (m_computeQueue)
+        s_nComputeInstances--;
     s_nInstances--;
 }
 
@@ -266,16 +348,32 @@ int GfxVulkanRenderer::initGlobal(const GfxRendererConfig& config) {
 
     // Create logical device
     QueueFamily family = findQueueFamily(s_vkPhysicalDevice);
-    std::vector<float> queuePriorities(family.queueCount, 1.0f);
-    VkDeviceQueueCreateInfo queueCreateInfo{};
-    queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    queueCreateInfo.queueFamilyIndex = family.index;
-    queueCreateInfo.queueCount = family.queueCount;
-    queueCreateInfo.pQueuePriorities = queuePriorities.data();
+    QueueFamily computeFamily = findComputeQueueFamily(s_vkPhysicalDevice);
+    std::vector<float> queuePriorities(
+        std::max(family.queueCount, computeFamily.queueCount),
+        1.0f
+    );
+    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos(1);
+    queueCreateInfos[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queueCreateInfos[0].queueFamilyIndex = family.index;
+    queueCreateInfos[0].queueCount = family.queueCount;
+    queueCreateInfos[0].pQueuePriorities = queuePriorities.data();
+    s_graphicsFamily = family.index;
+    s_computeFamily = UINT32_MAX;
+    if (computeFamily.queueCount > 0) {
+        // Compute-only queues let long dispatches run beside the graphics queues
+        VkDeviceQueueCreateInfo computeQueueCreateInfo{};
+        computeQueueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        computeQueueCreateInfo.queueFamilyIndex = computeFamily.index;
+        computeQueueCreateInfo.queueCount = computeFamily.queueCount;
+        computeQueueCreateInfo.pQueuePriorities = queuePriorities.data();
+        queueCreateInfos.push_back(computeQueueCreateInfo);
+        s_computeFamily = computeFamily.index;
+    }
     VkDeviceCreateInfo deviceCreateInfo{};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    deviceCreateInfo.queueCreateInfoCount = 1;
-    deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
+    deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
+    deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
 
     VkPhysicalDeviceFeatures deviceFeatures;
     vkGetPhysicalDeviceFeatures(s_vkPhysicalDevice, &deviceFeatures);
@@ -314,6 +412,19 @@ int GfxVulkanRenderer::initGlobal(const GfxRendererConfig& config) {
     indexingFeatures.runtimeDescriptorArray = VK_TRUE;
     extendedDynamicState3Features.pNext = &indexingFeatures;
 
+    // Timeline semaphores let renderers wait for each other on the device
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+    timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    VkPhysicalDeviceFeatures2 supportedFeatures{};
+    supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supportedFeatures.pNext = &timelineFeatures;
+    vkGetPhysicalDeviceFeatures2(s_vkPhysicalDevice, &supportedFeatures);
+    s_timelineSemaphores =
+        vulkanConfig->timelineSemaphores && timelineFeatures.timelineSemaphore == VK_TRUE;
+    timelineFeatures.pNext = nullptr;
+    if (s_timelineSemaphores)
+        indexingFeatures.pNext = &timelineFeatures;
+
     const char* deviceExtensions[] = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
         VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME,
@@ -329,6 +440,14 @@ int GfxVulkanRenderer::initGlobal(const GfxRendererConfig& config) {
         return 1; // Error: Failed to create Vulkan device
     }
 
+    // Create device memory sub-allocator
+    s_allocator = std::make_unique<GfxVulkanMemoryAllocator>(s_vkPhysicalDevice, s_vkDevice);
+
+    // Restore compiled shaders and pipelines of previous runs
+    s_shaderCache = std::make_unique<GfxVulkanShaderCache>(vulkanConfig->cacheDir);
+    if (s_shaderCache->createPipelineCache(s_vkPhysicalDevice, s_vkDevice, s_vkPipelineCache))
+        s_vkPipelineCache = VK_NULL_HANDLE; // Pipelines are still created, just uncached
+
     return 0;
 }
 
@@ -347,6 +466,13 @@ void GfxVulkanRenderer::termGlobal() {
     s_debugMessenger = VK_NULL_HANDLE;
 #endif // ENABLE_DEBUG_OUTPUT
 
+    if (s_vkPipelineCache != VK_NULL_HANDLE) {
+        s_shaderCache->savePipelineCache(s_vkDevice, s_vkPipelineCache);
+        vkDestroyPipelineCache(s_vkDevice, s_vkPipelineCache, nullptr);
+        s_vkPipelineCache = VK_NULL_HANDLE;
+    }
+    s_shaderCache.reset();
+    s_allocator.reset();
     vkDestroyDevice(s_vkDevice, nullptr);
     s_vkDevice = VK_NULL_HANDLE;
     vkDestroyInstance(s_vkInstance, nullptr);
@@ -356,6 +482,18 @@ void GfxVulkanRenderer::termGlobal() {
     glslang::FinalizeProcess();
 }
 
+GfxVulkanMemoryStats GfxVulkanRenderer::getMemoryStats() {
+    if (!s_allocator)
+        return {};
+    return s_allocator->getStats();
+}
+
+GfxVulkanShaderCacheStats GfxVulkanRenderer::getShaderCacheStats() {
+    if (!s_shaderCache)
+        return {};
+    return s_shaderCache->getStats();
+}
+
 void GfxVulkanRenderer::setVSyncMode(GfxVSyncMode mode) {
     if (m_vkSurface == VK_NULL_HANDLE)
         return; // Error: No surface set
@@ -401,13 +539,197 @@ void GfxVulkanRenderer::waitDeviceIdle() const {
     vkDeviceWaitIdle(s_vkDevice);
 }
 
+void GfxVulkanRenderer::waitFrames() const {
+    // The fence of a frame being recorded is reset and would never signal
+    bool recording = m_frameThread.load() != std::thread::id();
+    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        if (recording && i == static_cast<int>(m_currentFrame))
+            continue;
+        vkWaitForFences(s_vkDevice, 1, &m_inFlightFences[i], VK_TRUE, UINT64_MAX);
+    }
+}
+
+int GfxVulkanRenderer::useComputeQueue() {
+    if (m_computeQueue)
+        return 0; // Already on the compute queue family
+    if (m_vkSurface != VK_NULL_HANDLE || m_frameSerial > 0)
+        return 1; // Error: Presenting renderers and renderers in use stay on their queue
+    {
+        std::lock_guard<std::mutex> lock(m_uploadMutex);
+        if (m_pendingUploads.commandBuffer != VK_NULL_HANDLE || !m_submittedUploads.empty())
+            return 1; // Error: Uploads were recorded on the graphics queue family
+        if (!m_freeReadbackBuffers.empty())
+            return 1; // Error: Readbacks were recorded on the graphics queue family
+    }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    QueueFamily family = findComputeQueueFamily(s_vkPhysicalDevice);
+    if (family.queueCount == 0)
+        return 1; // Error: No compute-only queue family
+    if (static_cast<uint32_t>(s_nComputeInstances) >= family.queueCount)
+        return 1; // Error: All compute queues are taken, queues are not shared by renderers
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = family.index;
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    if (vkCreateCommandPool(s_vkDevice, &poolInfo, nullptr, &commandPool))
+        return 1; // Error: Failed to create command pool
+    VkCommandPool transferCommandPool = VK_NULL_HANDLE;
+    if (vkCreateCommandPool(s_vkDevice, &poolInfo, nullptr, &transferCommandPool)) {
+        vkDestroyCommandPool(s_vkDevice, commandPool, nullptr);
+        return 1; // Error: Failed to create transfer command pool
+    }
+
+    // Destroying the pools frees the command buffers allocated from them
+    vkDestroyCommandPool(s_vkDevice, m_vkCommandPool, nullptr);
+    m_vkCommandPool = commandPool;
+    {
+        std::lock_guard<std::mutex> uploadLock(m_uploadMutex);
+        vkDestroyCommandPool(s_vkDevice, m_vkTransferCommandPool, nullptr);
+        m_vkTransferCommandPool = transferCommandPool;
+        m_freeUploadCommandBuffers.clear();
+    }
+    if (createCommandBuffers())
+        return 1; // Error: Failed to create command buffers
+
+    vkGetDeviceQueue(s_vkDevice, family.index, s_nComputeInstances, &m_vkGraphicsQueue);
+    m_queueFamily = family.index;
+    m_computeQueue = true;
+    s_nComputeInstances++;
+
+    // Timestamps of the compute family may have fewer valid bits, or none
+    if (family.timestampValidBits == 0) {
+        for (auto& timerFrame : m_timerFrames)
+            vkDestroyQueryPool(s_vkDevice, timerFrame.queryPool, nullptr);
+        m_timerFrames.clear();
+        m_timestampMask = 0;
+    } else if (!m_timerFrames.empty()) {
+        m_timestampMask = family.timestampValidBits >= 64 ?
+            ~0ull : (1ull << family.timestampValidBits) - 1;
+    }
+
+    return 0;
+}
+
+uint64_t GfxVulkanRenderer::getFrameSyncValue() const {
+    if (m_frameTimeline == VK_NULL_HANDLE)
+        return 0;
+    return m_frameSyncValue;
+}
+
+uint64_t GfxVulkanRenderer::getFrameSerial() const {
+    return m_frameSyncValue;
+}
+
+bool GfxVulkanRenderer::isFrameComplete(uint64_t serial) const {
+    // A fence is only reused once its frame completed, so earlier frames are done as well
+    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        if (m_inFlightSerials[i] == 0 || m_inFlightSerials[i] > serial)
+            continue;
+        if (vkGetFenceStatus(s_vkDevice, m_inFlightFences[i]) != VK_SUCCESS)
+            return false;
+    }
+    return true;
+}
+
+int GfxVulkanRenderer::waitForRenderer(
+    const std::shared_ptr<GfxRendererInterface>& renderer,
+    uint64_t value
+) {
+    if (!renderer || renderer->getBackend() != GfxBackend::Vulkan || value == 0)
+        return 1; // Error: Invalid renderer or sync value
+    std::shared_ptr<GfxVulkanRenderer> vulkanRenderer =
+        std::static_pointer_cast<GfxVulkanRenderer>(renderer);
+    if (vulkanRenderer.get() == this)
+        return 0; // Frames of the same queue complete in order
+    if (m_frameTimeline == VK_NULL_HANDLE || vulkanRenderer->m_frameTimeline == VK_NULL_HANDLE)
+        return 1; // Error: Timeline semaphores not supported
+
+    VkSemaphore semaphore = vulkanRenderer->m_frameTimeline;
+    for (auto& frameWait : m_frameWaits) {
+        if (frameWait.first == semaphore) {
+            frameWait.second = std::max(frameWait.second, value);
+            return 0;
+        }
+    }
+    m_frameWaits.emplace_back(semaphore, value);
+    return 0;
+}
+
+void GfxVulkanRenderer::releaseBuffer(const GfxBuffer& buffer) {
+    if (!buffer || m_queueFamily == s_graphicsFamily)
+        return; // Buffers stay owned by the graphics queue family
+    std::shared_ptr<GfxVulkanBuffer> vulkanBuffer =
+        std::static_pointer_cast<GfxVulkanBuffer>(buffer);
+
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    barrier.srcQueueFamilyIndex = m_queueFamily;
+    barrier.dstQueueFamilyIndex = s_graphicsFamily;
+    barrier.buffer = vulkanBuffer->m_vkBuffers[vulkanBuffer->getInstanceIndex(m_recordFrame)];
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(
+        m_recordCommandBuffer,
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0,
+        0,
+        nullptr,
+        1,
+        &barrier,
+        0,
+        nullptr
+    );
+    vulkanBuffer->m_releasedFamily.store(m_queueFamily, std::memory_order_release);
+}
+
+void GfxVulkanRenderer::acquireBuffer(const GfxBuffer& buffer) {
+    if (!buffer || m_queueFamily != s_graphicsFamily)
+        return; // Only the graphics queue family acquires released buffers
+    std::shared_ptr<GfxVulkanBuffer> vulkanBuffer =
+        std::static_pointer_cast<GfxVulkanBuffer>(buffer);
+    uint32_t srcFamily = vulkanBuffer->m_releasedFamily.exchange(
+        VK_QUEUE_FAMILY_IGNORED,
+        std::memory_order_acq_rel
+    );
+    if (srcFamily == VK_QUEUE_FAMILY_IGNORED || srcFamily == m_queueFamily)
+        return; // Not released since the last acquire
+
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.srcQueueFamilyIndex = srcFamily;
+    barrier.dstQueueFamilyIndex = m_queueFamily;
+    barrier.buffer = vulkanBuffer->m_vkBuffers[vulkanBuffer->getInstanceIndex(m_recordFrame)];
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(
+        m_recordCommandBuffer,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        0,
+        0,
+        nullptr,
+        1,
+        &barrier,
+        0,
+        nullptr
+    );
+}
+
 int GfxVulkanRenderer::initForImGui(const std::function<void(void*)>& initFunc) {
     ImGuiVulkanInitInfo info{};
     info.instance = s_vkInstance;
     info.physicalDevice = s_vkPhysicalDevice;
     info.device = s_vkDevice;
     info.queue = m_vkGraphicsQueue;
-    info.queueFamily = findQueueFamily(s_vkPhysicalDevice).index;
+    info.queueFamily = m_queueFamily;
     info.imageCount = static_cast<uint32_t>(m_swapchainImageViews.size());
     info.samples = static_cast<uint32_t>(m_samples);
     info.swapchainFormat = static_cast<uint32_t>(m_swapchainImageFormat);
@@ -536,10 +858,14 @@ GfxImage GfxVulkanRenderer::createImage(const GfxImageInfo& info) const {
     err = createVkImage(
         createImageInfo,
         vulkanImage->m_image,
-        vulkanImage->m_imageMemory
+        vulkanImage->m_imageAllocation
     );
     if (err)
         return nullptr;
+    GfxMemoryTracker::track(
+        GfxMemoryTracker::getCategory(info.usages),
+        vulkanImage->m_imageAllocation.size
+    );
 
     // Transition image layout for sampled textures and storage images
     if (info.usages.check(GfxImageUsage::SAMPLED_TEXTURE)) {
@@ -637,98 +963,72 @@ int GfxVulkanRenderer::setImageData(const GfxImage& image, void* data) const {
     int width = image->getWidth();
     int height = image->getHeight();
 
-    VkBuffer stagingBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory stagingBufferMemory = VK_NULL_HANDLE;
+    std::lock_guard<std::mutex> lock(m_uploadMutex);
 
-    GfxScopeGuard cleaner(
-        [&]() {
-            vkDestroyBuffer(s_vkDevice, stagingBuffer, nullptr);
-            vkFreeMemory(s_vkDevice, stagingBufferMemory, nullptr);
-        }
-    );
-
-    // Create buffer
+    // Stage the pixels
     VkDeviceSize imageSize =
         static_cast<VkDeviceSize>(width) *
         static_cast<VkDeviceSize>(height) * 4;
-    int err = createVkBuffer(
-        imageSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        stagingBuffer,
-        stagingBufferMemory
-    );
-    if (err)
-        return err; // Error: Failed to create staging buffer
-
-    void* dstData;
-    VkResult result = vkMapMemory(
-        s_vkDevice,
-        stagingBufferMemory,
-        0,
-        imageSize,
-        0,
-        &dstData
-    );
-    if (result != VK_SUCCESS)
-        return 1; // Error: Failed to map memory for staging buffer
-    memcpy(dstData, data, static_cast<int>(imageSize));
-    vkUnmapMemory(s_vkDevice, stagingBufferMemory);
+    StagingRegion staging{};
+    if (acquireStagingRegion(imageSize, staging))
+        return 1; // Error: Failed to acquire staging memory
+    memcpy(staging.mappedData, data, static_cast<size_t>(imageSize));
 
-    // Copy buffer to image
-    {
-        VkFormat format = GfxVkTypeConverter::toVkFormat(vulkanImage->getFormat());
-
-        err = transitionImageLayout(
-            vulkanImage->m_image,
-            format,
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            image->getLevels()
-        );
-        if (err)
-            return 1; // Error: Failed to transition image layout
+    VkCommandBuffer commandBuffer = getUploadCommandBuffer();
+    if (commandBuffer == VK_NULL_HANDLE)
+        return 1; // Error: Failed to begin upload command buffer
+    vulkanImage->m_uploadSerial = m_pendingUploads.serial;
 
-        VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    // Record the copy into the pending upload batch
+    VkFormat format = GfxVkTypeConverter::toVkFormat(vulkanImage->getFormat());
 
-        VkBufferImageCopy region{};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
+    int err = transitionImageLayout(
+        vulkanImage->m_image,
+        format,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        image->getLevels(),
+        commandBuffer
+    );
+    if (err)
+        return 1; // Error: Failed to transition image layout
 
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
+    VkBufferImageCopy region{};
+    region.bufferOffset = staging.offset;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
 
-        region.imageOffset = { 0, 0, 0 };
-        region.imageExtent = {
-            static_cast<uint32_t>(width),
-            static_cast<uint32_t>(height),
-            1
-        };
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
 
-        vkCmdCopyBufferToImage(
-            commandBuffer,
-            stagingBuffer,
-            vulkanImage->m_image,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            1,
-            &region
-        );
+    region.imageOffset = { 0, 0, 0 };
+    region.imageExtent = {
+        static_cast<uint32_t>(width),
+        static_cast<uint32_t>(height),
+        1
+    };
 
-        endSingleTimeCommands(commandBuffer);
+    vkCmdCopyBufferToImage(
+        commandBuffer,
+        staging.buffer,
+        vulkanImage->m_image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1,
+        &region
+    );
 
-        err = transitionImageLayout(
-            vulkanImage->m_image,
-            format,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-            image->getLevels()
-        );
-        if (err)
-            return 1; // Error: Failed to transition image layout
-    }
+    err = transitionImageLayout(
+        vulkanImage->m_image,
+        format,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        image->getLevels(),
+        commandBuffer
+    );
+    if (err)
+        return 1; // Error: Failed to transition image layout
 
     return 0;
 }
@@ -947,18 +1247,35 @@ void GfxVulkanRenderer::copyImage(
 void GfxVulkanRenderer::destroyImage(const GfxImage& image) const {
     std::shared_ptr<GfxVulkanImage> vulkanImage =
         std::static_pointer_cast<GfxVulkanImage>(image);
-    vkDestroySampler(s_vkDevice, vulkanImage->m_sampler, nullptr);
+    if (vulkanImage->m_image != VK_NULL_HANDLE) {
+        GfxMemoryTracker::untrack(
+            GfxMemoryTracker::getCategory(vulkanImage->getUsages()),
+            vulkanImage->m_imageAllocation.size
+        );
+    }
+
+    // Pending uploads may still reference the image, hand its objects over to the batch
+    VkSampler sampler = vulkanImage->m_sampler;
+    VkImageView imageView = vulkanImage->m_imageView;
+    std::vector<VkImageView> mipmapViews = std::move(vulkanImage->m_mipmapViews);
+    VkImage vkImage = vulkanImage->m_image;
+    GfxVulkanAllocation allocation = vulkanImage->m_imageAllocation;
     vulkanImage->m_sampler = VK_NULL_HANDLE;
-    vkDestroyImageView(s_vkDevice, vulkanImage->m_imageView, nullptr);
     vulkanImage->m_imageView = VK_NULL_HANDLE;
-    for (auto& view : vulkanImage->m_mipmapViews) {
-        vkDestroyImageView(s_vkDevice, view, nullptr);
-        view = VK_NULL_HANDLE;
-    }
-    vkDestroyImage(s_vkDevice, vulkanImage->m_image, nullptr);
+    vulkanImage->m_mipmapViews.assign(mipmapViews.size(), VK_NULL_HANDLE);
     vulkanImage->m_image = VK_NULL_HANDLE;
-    vkFreeMemory(s_vkDevice, vulkanImage->m_imageMemory, nullptr);
-    vulkanImage->m_imageMemory = VK_NULL_HANDLE;
+    vulkanImage->m_imageAllocation = {};
+    releaseAfterUploads(
+        vulkanImage->m_uploadSerial,
+        [sampler, imageView, mipmapViews, vkImage, allocation]() mutable {
+            vkDestroySampler(s_vkDevice, sampler, nullptr);
+            vkDestroyImageView(s_vkDevice, imageView, nullptr);
+            for (auto view : mipmapViews)
+                vkDestroyImageView(s_vkDevice, view, nullptr);
+            vkDestroyImage(s_vkDevice, vkImage, nullptr);
+            s_allocator->free(allocation);
+        }
+    );
 }
 
 GfxRenderPass GfxVulkanRenderer::createRenderPass(
@@ -1197,11 +1514,11 @@ int GfxVulkanRenderer::readFramebufferColorAttachmentPixels(
 }
 
 GfxBuffer GfxVulkanRenderer::createBuffer(
-    int size,
+    size_t size,
     GfxBufferUsage usage,
     GfxBufferProp prop
 ) const {
-    if (size <= 0)
+    if (size == 0)
         return nullptr; // Error: Invalid buffer size
 
     GfxBuffer buffer = std::make_shared<GfxVulkanBuffer>(size, usage, prop);
@@ -1214,7 +1531,11 @@ GfxBuffer GfxVulkanRenderer::createBuffer(
     return vulkanBuffer;
 }
 
-int GfxVulkanRenderer::setBufferData(const GfxBuffer& buffer, int size, const void* data) const {
+int GfxVulkanRenderer::setBufferData(
+    const GfxBuffer& buffer,
+    size_t size,
+    const void* data
+) const {
     std::shared_ptr<GfxVulkanBuffer> vulkanBuffer =
         std::static_pointer_cast<GfxVulkanBuffer>(buffer);
 
@@ -1233,8 +1554,8 @@ int GfxVulkanRenderer::setBufferData(const GfxBuffer& buffer, int size, const vo
 
 int GfxVulkanRenderer::updateBufferData(
     const GfxBuffer& buffer,
-    int offset,
-    int size,
+    size_t offset,
+    size_t size,
     const void* data
 ) const {
     std::shared_ptr<GfxVulkanBuffer> vulkanBuffer =
@@ -1244,65 +1565,46 @@ int GfxVulkanRenderer::updateBufferData(
     VkDeviceSize updateSize = static_cast<VkDeviceSize>(size);
     VkDeviceSize offsetSize = static_cast<VkDeviceSize>(offset);
 
-    if (updateSize > bufferSize - offsetSize)
+    if (offsetSize > bufferSize || updateSize > bufferSize - offsetSize)
         return 1; // Error: Update size exceeds buffer size
 
     GfxBufferUsage usage = vulkanBuffer->getUsage();
     GfxBufferProp prop = vulkanBuffer->getProp();
 
-    VkBuffer vkBuffer = vulkanBuffer->m_vkBuffers[0];
-    VkDeviceMemory vkBufferMemory = vulkanBuffer->m_vkBufferMemories[0];
-    if (usage == GfxBufferUsage::UNIFORM_BUFFER || usage == GfxBufferUsage::STORAGE_BUFFER) {
-        vkBuffer = vulkanBuffer->m_vkBuffers[m_currentFrame];
-        vkBufferMemory = vulkanBuffer->m_vkBufferMemories[m_currentFrame];
-    }
+    int instance = vulkanBuffer->getInstanceIndex(m_currentFrame);
+    VkBuffer vkBuffer = vulkanBuffer->m_vkBuffers[instance];
+    GfxVulkanAllocation& vkBufferAllocation = vulkanBuffer->m_vkBufferAllocations[instance];
 
     if (prop == GfxBufferProp::STATIC) {
-        VkBuffer stagingBuffer = VK_NULL_HANDLE;
-        VkDeviceMemory stagingBufferMemory = VK_NULL_HANDLE;
-
-        GfxScopeGuard cleaner(
-            [&]() {
-                vkDestroyBuffer(s_vkDevice, stagingBuffer, nullptr);
-                vkFreeMemory(s_vkDevice, stagingBufferMemory, nullptr);
-            }
-        );
-
-        int err = createVkBuffer(
-            bufferSize,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            stagingBuffer,
-            stagingBufferMemory
-        );
-        if (err)
-            return err; // Error: Failed to create staging buffer
-
-        void* dstData;
-        VkResult result = vkMapMemory(
-            s_vkDevice,
-            stagingBufferMemory,
-            0,
-            bufferSize,
-            0,
-            &dstData
-        );
-        if (result != VK_SUCCESS)
-            return 1; // Error: Failed to map memory for staging buffer
-        memcpy(static_cast<char*>(dstData) + offsetSize, data, static_cast<int>(updateSize));
-        vkUnmapMemory(s_vkDevice, stagingBufferMemory);
+        std::lock_guard<std::mutex> lock(m_uploadMutex);
+
+        // Large updates go through the staging ring in chunks, each one carries its own
+        // barrier because the ring may submit the batch between two chunks
+        for (VkDeviceSize done = 0; done < updateSize; done += STAGING_CHUNK_SIZE) {
+            VkDeviceSize chunkSize = std::min(STAGING_CHUNK_SIZE, updateSize - done);
+
+            StagingRegion staging{};
+            if (acquireStagingRegion(chunkSize, staging))
+                return 1; // Error: Failed to acquire staging memory
+            memcpy(
+                staging.mappedData,
+                static_cast<const char*>(data) + done,
+                static_cast<size_t>(chunkSize)
+            );
 
-        // Copy staging buffer to the Vulkan buffer
-        {
-            VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+            // Record the copy into the pending upload batch
+            VkCommandBuffer commandBuffer = getUploadCommandBuffer();
+            if (commandBuffer == VK_NULL_HANDLE)
+                return 1; // Error: Failed to begin upload command buffer
+            vulkanBuffer->m_uploadSerial = m_pendingUploads.serial;
 
             VkBufferCopy copyRegion{};
-            copyRegion.srcOffset = offsetSize;
-            copyRegion.dstOffset = offsetSize;
-            copyRegion.size = size;
+            copyRegion.srcOffset = staging.offset;
+            copyRegion.dstOffset = offsetSize + done;
+            copyRegion.size = chunkSize;
             vkCmdCopyBuffer(
                 commandBuffer,
-                stagingBuffer,
+                staging.buffer,
                 vkBuffer,
                 1,
                 &copyRegion
@@ -1336,8 +1638,8 @@ int GfxVulkanRenderer::updateBufferData(
             bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             bufferBarrier.buffer = vkBuffer;
-            bufferBarrier.offset = offsetSize;
-            bufferBarrier.size = updateSize;
+            bufferBarrier.offset = offsetSize + done;
+            bufferBarrier.size = chunkSize;
 
             vkCmdPipelineBarrier(
                 commandBuffer,
@@ -1351,23 +1653,15 @@ int GfxVulkanRenderer::updateBufferData(
                 0,
                 nullptr
             );
-
-            endSingleTimeCommands(commandBuffer);
         }
     } else if (prop == GfxBufferProp::DYNAMIC) {
-        void* dstData;
-        VkResult result = vkMapMemory(
-            s_vkDevice,
-            vkBufferMemory,
-            offsetSize,
-            updateSize,
-            0,
-            &dstData
+        if (vkBufferAllocation.mappedData == nullptr)
+            return 1; // Error: Vulkan buffer memory is not host visible
+        memcpy(
+            static_cast<char*>(vkBufferAllocation.mappedData) + offsetSize,
+            data,
+            static_cast<size_t>(updateSize)
         );
-        if (result != VK_SUCCESS)
-            return 1; // Error: Failed to map memory for Vulkan buffer
-        memcpy(dstData, data, static_cast<int>(updateSize));
-        vkUnmapMemory(s_vkDevice, vkBufferMemory);
     }
 
     return 0;
@@ -1376,16 +1670,27 @@ int GfxVulkanRenderer::updateBufferData(
 void GfxVulkanRenderer::destroyBuffer(const GfxBuffer& buffer) const {
     std::shared_ptr<GfxVulkanBuffer> vulkanBuffer =
         std::static_pointer_cast<GfxVulkanBuffer>(buffer);
-    for (auto& vkBuffer : vulkanBuffer->m_vkBuffers)
-        vkDestroyBuffer(s_vkDevice, vkBuffer, nullptr);
-    for (auto& vkBufferMemory : vulkanBuffer->m_vkBufferMemories)
-        vkFreeMemory(s_vkDevice, vkBufferMemory, nullptr);
+    GfxMemoryCategory category = GfxMemoryTracker::getCategory(vulkanBuffer->getUsage());
+    for (size_t i = 0; i < vulkanBuffer->m_vkBuffers.size(); i++) {
+        if (vulkanBuffer->m_vkBuffers[i] == VK_NULL_HANDLE)
+            continue; // Not created yet
+        GfxMemoryTracker::untrack(category, vulkanBuffer->m_vkBufferAllocations[i].size);
+
+        // Pending uploads may still reference the buffer, hand it over to the batch
+        VkBuffer vkBuffer = vulkanBuffer->m_vkBuffers[i];
+        GfxVulkanAllocation allocation = vulkanBuffer->m_vkBufferAllocations[i];
+        vulkanBuffer->m_vkBuffers[i] = VK_NULL_HANDLE;
+        vulkanBuffer->m_vkBufferAllocations[i] = {};
+        releaseAfterUploads(vulkanBuffer->m_uploadSerial, [this, vkBuffer, allocation]() mutable {
+            destroyVkBuffer(vkBuffer, allocation);
+        });
+    }
 }
 
 int GfxVulkanRenderer::readBufferData(
     const GfxBuffer& buffer,
-    int offset,
-    int size,
+    size_t offset,
+    size_t size,
     void* data
 ) const {
     std::shared_ptr<GfxVulkanBuffer> vulkanBuffer =
@@ -1395,106 +1700,361 @@ int GfxVulkanRenderer::readBufferData(
     VkDeviceSize readSize = static_cast<VkDeviceSize>(size);
     VkDeviceSize offsetSize = static_cast<VkDeviceSize>(offset);
 
-    GfxBufferUsage usage = vulkanBuffer->getUsage();
+    if (offsetSize > bufferSize || readSize > bufferSize - offsetSize)
+        return 1; // Error: Read size exceeds buffer size
+
     GfxBufferProp prop = vulkanBuffer->getProp();
 
-    VkBuffer vkBuffer = vulkanBuffer->m_vkBuffers[0];
-    VkDeviceMemory vkBufferMemory = vulkanBuffer->m_vkBufferMemories[0];
-    if (usage == GfxBufferUsage::UNIFORM_BUFFER || usage == GfxBufferUsage::STORAGE_BUFFER) {
-        vkBuffer = vulkanBuffer->m_vkBuffers[m_currentFrame];
-        vkBufferMemory = vulkanBuffer->m_vkBufferMemories[m_currentFrame];
-    }
+    int instance = vulkanBuffer->getInstanceIndex(m_currentFrame);
+    VkBuffer vkBuffer = vulkanBuffer->m_vkBuffers[instance];
+    GfxVulkanAllocation& vkBufferAllocation = vulkanBuffer->m_vkBufferAllocations[instance];
 
     if (prop == GfxBufferProp::STATIC) {
-        VkBuffer stagingBuffer = VK_NULL_HANDLE;
-        VkDeviceMemory stagingBufferMemory = VK_NULL_HANDLE;
+        std::lock_guard<std::mutex> lock(m_uploadMutex);
 
-        GfxScopeGuard cleaner(
-            [&]() {
-                vkDestroyBuffer(s_vkDevice, stagingBuffer, nullptr);
-                vkFreeMemory(s_vkDevice, stagingBufferMemory, nullptr);
-            }
-        );
+        // Read back through the staging ring one chunk at a time
+        for (VkDeviceSize done = 0; done < readSize; done += STAGING_CHUNK_SIZE) {
+            VkDeviceSize chunkSize = std::min(STAGING_CHUNK_SIZE, readSize - done);
 
-        int err = createVkBuffer(
-            bufferSize,
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            stagingBuffer,
-            stagingBufferMemory
-        );
-        if (err)
-            return 1; // Error: Failed to create staging buffer
+            StagingRegion staging{};
+            if (acquireStagingRegion(chunkSize, staging))
+                return 1; // Error: Failed to acquire staging memory
+
+            VkCommandBuffer commandBuffer = getUploadCommandBuffer();
+            if (commandBuffer == VK_NULL_HANDLE)
+                return 1; // Error: Failed to begin upload command buffer
 
-        VkBufferCopy copyRegion = {};
-        copyRegion.size = bufferSize;
-        {
-            VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+            VkBufferCopy copyRegion = {};
+            copyRegion.srcOffset = offsetSize + done;
+            copyRegion.dstOffset = staging.offset;
+            copyRegion.size = chunkSize;
             vkCmdCopyBuffer(
                 commandBuffer,
                 vkBuffer,
-                stagingBuffer,
+                staging.buffer,
                 1,
                 &copyRegion
             );
-            endSingleTimeCommands(commandBuffer);
+
+            VkMemoryBarrier hostBarrier{};
+            hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+            vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_HOST_BIT,
+                0,
+                1,
+                &hostBarrier,
+                0,
+                nullptr,
+                0,
+                nullptr
+            );
+
+            // The data is needed right away, submit the batch and wait for it
+            if (submitUploads())
+                return 1; // Error: Failed to submit readback
+            VkFence fence = m_submittedUploads.back().fence;
+            vkWaitForFences(s_vkDevice, 1, &fence, VK_TRUE, UINT64_MAX);
+
+            memcpy(
+                static_cast<char*>(data) + done,
+                staging.mappedData,
+                static_cast<size_t>(chunkSize)
+            );
+            retireUploads(false);
         }
+    } else if (prop == GfxBufferProp::DYNAMIC) {
+        if (vkBufferAllocation.mappedData == nullptr)
+            return 1; // Error: Vulkan buffer memory is not host visible
+        memcpy(
+            data,
+            static_cast<char*>(vkBufferAllocation.mappedData) + offsetSize,
+            static_cast<size_t>(readSize)
+        );
+    }
 
-        void* srcData;
-        VkResult result = vkMapMemory(
-            s_vkDevice,
-            stagingBufferMemory,
-            offsetSize,
-            readSize,
-            0,
-            &srcData
+    return 0;
+}
+
+GfxReadback GfxVulkanRenderer::readBufferDataAsync(
+    const GfxBuffer& buffer,
+    size_t offset,
+    size_t size
+) const {
+    if (!buffer || size == 0 || offset > buffer->getSize() || size > buffer->getSize() - offset)
+        return nullptr; // Error: Read size exceeds buffer size
+
+    std::shared_ptr<GfxVulkanBuffer> vulkanBuffer =
+        std::static_pointer_cast<GfxVulkanBuffer>(buffer);
+    GfxReadback readback = std::make_shared<GfxVulkanReadback>(size);
+    std::shared_ptr<GfxVulkanReadback> vulkanReadback =
+        std::static_pointer_cast<GfxVulkanReadback>(readback);
+
+    std::lock_guard<std::mutex> lock(m_uploadMutex);
+
+    // Pending uploads must land before the copy
+    if (submitUploads())
+        return nullptr; // Error: Failed to submit uploads
+
+    // Reuse the smallest released readback buffer that fits
+    int bestIndex = -1;
+    for (int i = 0; i < static_cast<int>(m_freeReadbackBuffers.size()); i++) {
+        if (m_freeReadbackBuffers[i].capacity < size)
+            continue;
+        if (bestIndex < 0 ||
+            m_freeReadbackBuffers[i].capacity < m_freeReadbackBuffers[bestIndex].capacity) {
+            bestIndex = i;
+        }
+    }
+    ReadbackBuffer readbackBuffer{};
+    if (bestIndex >= 0) {
+        readbackBuffer = m_freeReadbackBuffers[bestIndex];
+        m_freeReadbackBuffers[bestIndex] = m_freeReadbackBuffers.back();
+        m_freeReadbackBuffers.pop_back();
+        vkResetFences(s_vkDevice, 1, &readbackBuffer.fence);
+        vkResetCommandBuffer(readbackBuffer.commandBuffer, 0);
+    } else {
+        readbackBuffer.capacity = static_cast<VkDeviceSize>(size);
+        int err = createVkBuffer(
+            readbackBuffer.capacity,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            readbackBuffer.buffer,
+            readbackBuffer.allocation
         );
-        if (result != VK_SUCCESS)
-            return 1; // Error: Failed to map memory for staging buffer
-        memcpy(data, static_cast<char*>(srcData), static_cast<int>(readSize));
-    } else if (prop == GfxBufferProp::DYNAMIC) {
-        void* srcData;
-        VkResult result = vkMapMemory(
+        if (err)
+            return nullptr; // Error: Failed to create readback buffer
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = m_vkTransferCommandPool;
+        allocInfo.commandBufferCount = 1;
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vkAllocateCommandBuffers(s_vkDevice, &allocInfo, &readbackBuffer.commandBuffer) ||
+            vkCreateFence(s_vkDevice, &fenceInfo, nullptr, &readbackBuffer.fence)) {
+            destroyVkBuffer(readbackBuffer.buffer, readbackBuffer.allocation);
+            if (readbackBuffer.commandBuffer != VK_NULL_HANDLE)
+                vkFreeCommandBuffers(
+                    s_vkDevice,
+                    m_vkTransferCommandPool,
+                    1,
+                    &readbackBuffer.commandBuffer
+                );
+            return nullptr; // Error: Failed to create readback command buffer or fence
+        }
+    }
+    vulkanReadback->m_buffer = readbackBuffer.buffer;
+    vulkanReadback->m_allocation = readbackBuffer.allocation;
+    vulkanReadback->m_capacity = readbackBuffer.capacity;
+    vulkanReadback->m_commandBuffer = readbackBuffer.commandBuffer;
+    vulkanReadback->m_fence = readbackBuffer.fence;
+
+    // While recording a frame, the copy goes into the frame after the commands recorded so far
+    // and the fence is signaled once the frame completes. Otherwise it is submitted on its own,
+    // ordered after everything submitted so far.
+    bool inFrame = m_frameThread.load() == std::this_thread::get_id() &&
+        m_recordCommandBuffer == m_vkCommandBuffers[m_currentFrame];
+    VkCommandBuffer commandBuffer =
+        inFrame ? m_recordCommandBuffer : readbackBuffer.commandBuffer;
+    if (!inFrame) {
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo)) {
+            m_freeReadbackBuffers.push_back(readbackBuffer);
+            return nullptr; // Error: Failed to begin readback command buffer
+        }
+    }
+
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        1,
+        &barrier,
+        0,
+        nullptr,
+        0,
+        nullptr
+    );
+
+    VkBufferCopy copyRegion{};
+    copyRegion.srcOffset = static_cast<VkDeviceSize>(offset);
+    copyRegion.dstOffset = 0;
+    copyRegion.size = static_cast<VkDeviceSize>(size);
+    vkCmdCopyBuffer(
+        commandBuffer,
+        vulkanBuffer->m_vkBuffers[vulkanBuffer->getInstanceIndex(m_currentFrame)],
+        readbackBuffer.buffer,
+        1,
+        &copyRegion
+    );
+
+    VkMemoryBarrier hostBarrier{};
+    hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        0,
+        1,
+        &hostBarrier,
+        0,
+        nullptr,
+        0,
+        nullptr
+    );
+
+    if (inFrame) {
+        m_frameReadbackFences.push_back(readbackBuffer.fence);
+        return readback;
+    }
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    if (vkEndCommandBuffer(commandBuffer) ||
+        vkQueueSubmit(m_vkGraphicsQueue, 1, &submitInfo, readbackBuffer.fence)) {
+        m_freeReadbackBuffers.push_back(readbackBuffer);
+        return nullptr; // Error: Failed to submit readback
+    }
+
+    return readback;
+}
+
+bool GfxVulkanRenderer::isReadbackReady(const GfxReadback& readback) const {
+    std::shared_ptr<GfxVulkanReadback> vulkanReadback =
+        std::static_pointer_cast<GfxVulkanReadback>(readback);
+    if (!vulkanReadback || vulkanReadback->m_fence == VK_NULL_HANDLE)
+        return false;
+    return vkGetFenceStatus(s_vkDevice, vulkanReadback->m_fence) == VK_SUCCESS;
+}
+
+const void* GfxVulkanRenderer::mapReadback(const GfxReadback& readback, bool wait) const {
+    std::shared_ptr<GfxVulkanReadback> vulkanReadback =
+        std::static_pointer_cast<GfxVulkanReadback>(readback);
+    if (!vulkanReadback || vulkanReadback->m_fence == VK_NULL_HANDLE)
+        return nullptr; // Error: Invalid or released readback
+
+    // The fence belongs to the readback alone, waiting on it does not block other threads
+    if (wait) {
+        VkResult result = vkWaitForFences(
             s_vkDevice,
-            vkBufferMemory,
-            offsetSize,
-            readSize,
-            0,
-            &srcData
+            1,
+            &vulkanReadback->m_fence,
+            VK_TRUE,
+            UINT64_MAX
         );
         if (result != VK_SUCCESS)
-            return 1; // Error: Failed to map memory for Vulkan buffer
-        memcpy(data, static_cast<char*>(srcData), static_cast<int>(readSize));
-    }
+            return nullptr; // Error: Failed to wait for readback
+    } else if (vkGetFenceStatus(s_vkDevice, vulkanReadback->m_fence) != VK_SUCCESS)
+        return nullptr; // Data has not arrived yet
 
-    return 0;
+    return vulkanReadback->m_allocation.mappedData;
+}
+
+void GfxVulkanRenderer::releaseReadback(const GfxReadback& readback) const {
+    std::shared_ptr<GfxVulkanReadback> vulkanReadback =
+        std::static_pointer_cast<GfxVulkanReadback>(readback);
+    if (!vulkanReadback || vulkanReadback->m_fence == VK_NULL_HANDLE)
+        return;
+
+    // The buffer may only be reused once the copy into it has finished
+    vkWaitForFences(s_vkDevice, 1, &vulkanReadback->m_fence, VK_TRUE, UINT64_MAX);
+
+    ReadbackBuffer readbackBuffer{};
+    readbackBuffer.buffer = vulkanReadback->m_buffer;
+    readbackBuffer.allocation = vulkanReadback->m_allocation;
+    readbackBuffer.capacity = vulkanReadback->m_capacity;
+    readbackBuffer.commandBuffer = vulkanReadback->m_commandBuffer;
+    readbackBuffer.fence = vulkanReadback->m_fence;
+    vulkanReadback->m_buffer = VK_NULL_HANDLE;
+    vulkanReadback->m_allocation = {};
+    vulkanReadback->m_commandBuffer = VK_NULL_HANDLE;
+    vulkanReadback->m_fence = VK_NULL_HANDLE;
+
+    std::lock_guard<std::mutex> lock(m_uploadMutex);
+    m_freeReadbackBuffers.push_back(readbackBuffer);
 }
 
 int GfxVulkanRenderer::copyBuffer(
     const GfxBuffer& src,
     const GfxBuffer& dst,
-    int srcOffset,
-    int dstOffset,
-    int size
+    size_t srcOffset,
+    size_t dstOffset,
+    size_t size
 ) const {
     std::shared_ptr<GfxVulkanBuffer> vulkanBufferSrc =
         std::static_pointer_cast<GfxVulkanBuffer>(src);
     std::shared_ptr<GfxVulkanBuffer> vulkanBufferDst =
         std::static_pointer_cast<GfxVulkanBuffer>(dst);
+    if (srcOffset > src->getSize() || size > src->getSize() - srcOffset)
+        return 1; // Error: Source range exceeds buffer size
+    if (dstOffset > dst->getSize() || size > dst->getSize() - dstOffset)
+        return 1; // Error: Destination range exceeds buffer size
     VkBufferCopy copyRegion{};
     copyRegion.srcOffset = static_cast<VkDeviceSize>(srcOffset);
     copyRegion.dstOffset = static_cast<VkDeviceSize>(dstOffset);
     copyRegion.size = static_cast<VkDeviceSize>(size);
-    VkBuffer vkBufferSrc = vulkanBufferSrc->m_vkBuffers[0];
-    VkBuffer vkBufferDst = vulkanBufferDst->m_vkBuffers[0];
-    if (vulkanBufferSrc->getUsage() == GfxBufferUsage::UNIFORM_BUFFER ||
-        vulkanBufferSrc->getUsage() == GfxBufferUsage::STORAGE_BUFFER) {
-        vkBufferSrc = vulkanBufferSrc->m_vkBuffers[m_currentFrame];
-    }
-    if (vulkanBufferDst->getUsage() == GfxBufferUsage::UNIFORM_BUFFER ||
-        vulkanBufferDst->getUsage() == GfxBufferUsage::STORAGE_BUFFER) {
-        vkBufferDst = vulkanBufferDst->m_vkBuffers[m_currentFrame];
+    // Inside a frame or a command list the copy is recorded in order with the other commands
+    std::thread::id thisThread = std::this_thread::get_id();
+    bool recorded = m_listThread.load() == thisThread;
+    if (m_frameThread.load() == thisThread && !m_inRenderPass)
+        recorded = true;
+    uint32_t frame = recorded ? m_recordFrame : m_currentFrame;
+    VkBuffer vkBufferSrc = vulkanBufferSrc->m_vkBuffers[vulkanBufferSrc->getInstanceIndex(frame)];
+    VkBuffer vkBufferDst = vulkanBufferDst->m_vkBuffers[vulkanBufferDst->getInstanceIndex(frame)];
+
+    if (recorded) {
+        VkCommandBuffer commandBuffer = m_recordCommandBuffer;
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            1,
+            &barrier,
+            0,
+            nullptr,
+            0,
+            nullptr
+        );
+        vkCmdCopyBuffer(commandBuffer, vkBufferSrc, vkBufferDst, 1, &copyRegion);
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask =
+            VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT | VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+            0,
+            1,
+            &barrier,
+            0,
+            nullptr,
+            0,
+            nullptr
+        );
+        return 0;
     }
+
     {
         VkCommandBuffer commandBuffer = beginSingleTimeCommands();
         vkCmdCopyBuffer(
@@ -1549,25 +2109,46 @@ GfxShader GfxVulkanRenderer::createShader(
         return nullptr; // Error: Invalid shader stage
     }
 
-    glslang::TShader tShader(shaderStage);
-    const char* string = source.c_str();
-    const char* const* strings = &string;
-    tShader.setStrings(strings, 1);
-    tShader.setEnvInput(glslang::EShSourceGlsl, shaderStage, glslang::EShClientVulkan, 100);
-    tShader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_2);
-    tShader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_3);
-
-    if (!tShader.parse(GetDefaultResources(), 100, ENoProfile, false, false, EShMsgDefault))
-        throw GfxShaderException(tShader.getInfoLog()); // Error: Failed to parse shader
-
-    glslang::TProgram program;
-    program.addShader(&tShader);
-    if (!program.link(EShMsgDefault))
-        return nullptr; // Error: Failed to link shader program
-    const auto intermediate = program.getIntermediate(shaderStage);
+    // The cache key covers everything that changes the generated SPIR-V, defines are part of
+    // the source text
+    glslang::Version version = glslang::GetVersion();
+    std::string cacheKey =
+        "glslang " + std::to_string(version.major) + "." + std::to_string(version.minor) + "." +
+        std::to_string(version.patch) + version.flavor +
+        " stage " + std::to_string(static_cast<int>(shaderStage)) +
+        " vulkan1.2 spv1.3\n" + source;
 
+    auto startTime = std::chrono::steady_clock::now();
     std::vector<uint32_t> spvCode;
-    glslang::GlslangToSpv(*intermediate, spvCode);
+    bool cacheHit = s_shaderCache->loadSpirv(cacheKey, spvCode) == 0;
+    if (!cacheHit) {
+        glslang::TShader tShader(shaderStage);
+        const char* string = source.c_str();
+        const char* const* strings = &string;
+        tShader.setStrings(strings, 1);
+        tShader.setEnvInput(glslang::EShSourceGlsl, shaderStage, glslang::EShClientVulkan, 100);
+        tShader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_2);
+        tShader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_3);
+
+        if (!tShader.parse(GetDefaultResources(), 100, ENoProfile, false, false, EShMsgDefault))
+            throw GfxShaderException(tShader.getInfoLog()); // Error: Failed to parse shader
+
+        glslang::TProgram program;
+        program.addShader(&tShader);
+        if (!program.link(EShMsgDefault))
+            return nullptr; // Error: Failed to link shader program
+        const auto intermediate = program.getIntermediate(shaderStage);
+
+        glslang::GlslangToSpv(*intermediate, spvCode);
+        s_shaderCache->storeSpirv(cacheKey, spvCode);
+    }
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - startTime;
+    s_shaderCache->recordSpirv(cacheHit, elapsed.count());
+#ifdef ENABLE_DEBUG_OUTPUT
+    std::cout << "Shader " << (cacheHit ? "loaded from cache" : "compiled") << " in " <<
+        elapsed.count() << " ms" << std::endl;
+#endif // ENABLE_DEBUG_OUTPUT
 
     VkShaderModuleCreateInfo shaderModuleCreateInfo = {};
     shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -1833,7 +2414,7 @@ GfxPipeline GfxVulkanRenderer::createPipeline(
         result = vkCreateGraphicsPipelines
         (
             s_vkDevice,
-            VK_NULL_HANDLE,
+            s_vkPipelineCache,
             1,
             &pipelineInfo,
             nullptr,
@@ -1847,7 +2428,7 @@ GfxPipeline GfxVulkanRenderer::createPipeline(
         result = vkCreateComputePipelines
         (
             s_vkDevice,
-            VK_NULL_HANDLE,
+            s_vkPipelineCache,
             1,
             &pipelineInfo,
             nullptr,
@@ -2016,7 +2597,7 @@ int GfxVulkanRenderer::beginRenderPass(const GfxFramebuffer& framebuffer) {
                     vulkanImage->m_currentLayout,
                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
                     1,
-                    m_vkCommandBuffers[m_currentFrame]
+                    m_recordCommandBuffer
                 );
                 if (err)
                     return err; // Error: Failed to transition image layout
@@ -2035,7 +2616,7 @@ int GfxVulkanRenderer::beginRenderPass(const GfxFramebuffer& framebuffer) {
                     vulkanImage->m_currentLayout,
                     VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
                     1,
-                    m_vkCommandBuffers[m_currentFrame]
+                    m_recordCommandBuffer
                 );
                 if (err)
                     return err; // Error: Failed to transition depth image layout
@@ -2054,7 +2635,7 @@ int GfxVulkanRenderer::beginRenderPass(const GfxFramebuffer& framebuffer) {
                     vulkanImage->m_currentLayout,
                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
                     1,
-                    m_vkCommandBuffers[m_currentFrame]
+                    m_recordCommandBuffer
                 );
                 if (err)
                     return err; // Error: Failed to transition resolve image layout
@@ -2079,7 +2660,7 @@ int GfxVulkanRenderer::beginRenderPass(const GfxFramebuffer& framebuffer) {
     barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
     barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
     vkCmdPipelineBarrier(
-        m_vkCommandBuffers[m_currentFrame],
+        m_recordCommandBuffer,
         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
         0,
@@ -2092,16 +2673,18 @@ int GfxVulkanRenderer::beginRenderPass(const GfxFramebuffer& framebuffer) {
     );
 
     vkCmdBeginRenderPass(
-        m_vkCommandBuffers[m_currentFrame],
+        m_recordCommandBuffer,
         &renderPassInfo,
         VK_SUBPASS_CONTENTS_INLINE
     );
+    m_inRenderPass = true;
 
     return 0;
 }
 
 void GfxVulkanRenderer::endRenderPass() {
-    vkCmdEndRenderPass(m_vkCommandBuffers[m_currentFrame]);
+    vkCmdEndRenderPass(m_recordCommandBuffer);
+    m_inRenderPass = false;
 
     if (m_currentFramebuffer) {
         for (const auto& colorImage : m_currentFramebuffer->getColorImages()) {
@@ -2134,7 +2717,7 @@ void GfxVulkanRenderer::bindPipeline(const GfxPipeline& pipeline) {
     if (pipeline->getStages().check(GfxShaderStage::COMPUTE))
         bindPoint = VK_PIPELINE_BIND_POINT_COMPUTE;
 
-    vkCmdBindPipeline(m_vkCommandBuffers[m_currentFrame], bindPoint, vkPipeline);
+    vkCmdBindPipeline(m_recordCommandBuffer, bindPoint, vkPipeline);
 
     GfxPipelineStateController::bindPipeline(m_pipelineStateMachine, pipeline);
 }
@@ -2150,7 +2733,7 @@ void GfxVulkanRenderer::bindVAO(const GfxVAO& vao) {
         VkBuffer vertexBuffers[] = { vertexBuffer };
         VkDeviceSize offsets[] = { 0 };
         vkCmdBindVertexBuffers(
-            m_vkCommandBuffers[m_currentFrame],
+            m_recordCommandBuffer,
             0,
             1,
             vertexBuffers,
@@ -2163,7 +2746,7 @@ void GfxVulkanRenderer::bindVAO(const GfxVAO& vao) {
             std::static_pointer_cast<GfxVulkanBuffer>(vao->getIndexBuffer());
         VkBuffer indexBuffer = vulkanIndexBuffer->m_vkBuffers[0];
         vkCmdBindIndexBuffer(
-            m_vkCommandBuffers[m_currentFrame],
+            m_recordCommandBuffer,
             indexBuffer,
             0,
             VK_INDEX_TYPE_UINT32
@@ -2203,10 +2786,10 @@ void GfxVulkanRenderer::bindDescriptorSetBinding(const GfxDescriptorSetBinding&
     VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
     if (pipeline->getStages().check(GfxShaderStage::COMPUTE))
         bindPoint = VK_PIPELINE_BIND_POINT_COMPUTE;
-    VkDescriptorSet descriptorSet = vulkanDescriptorSetBinding->m_vkDescriptorSets[m_currentFrame];
+    VkDescriptorSet descriptorSet = vulkanDescriptorSetBinding->m_vkDescriptorSets[m_recordFrame];
 
     vkCmdBindDescriptorSets(
-        m_vkCommandBuffers[m_currentFrame],
+        m_recordCommandBuffer,
         bindPoint,
         vulkanPipeline->m_vkPipelineLayout,
         binding->getDescriptorSetIndex(),
@@ -2250,55 +2833,110 @@ int GfxVulkanRenderer::beginFrame() {
     if (vkBeginCommandBuffer(m_vkCommandBuffers[m_currentFrame], &beginInfo) != VK_SUCCESS)
         return 1; // Error: Failed to begin command buffer
 
+    // The fence of this frame in flight was waited for at the end of the previous frame
+    resolveTimers();
+    m_frameSerial++;
+    m_inFlightSerials[m_currentFrame] = m_frameSerial;
+    if (!m_timerFrames.empty())
+        m_timerFrames[m_currentFrame].serial = m_frameSerial;
+    m_frameThread.store(std::this_thread::get_id());
+
     std::shared_ptr<GfxVulkanPipelineStateMachine> vulkanPipelineStateMachine
         = std::static_pointer_cast<GfxVulkanPipelineStateMachine>(m_pipelineStateMachine);
     vulkanPipelineStateMachine->m_commandBuffer = m_vkCommandBuffers[m_currentFrame];
+    m_recordCommandBuffer = m_vkCommandBuffers[m_currentFrame];
+    m_recordFrame = m_currentFrame;
 
     return 0;
 }
 
 int GfxVulkanRenderer::endFrame() {
+    m_frameThread.store(std::thread::id());
+
     VkResult result = vkEndCommandBuffer(m_vkCommandBuffers[m_currentFrame]);
     if (result != VK_SUCCESS)
         return 1; // Error: Failed to end command buffer
 
+    // Uploads and readbacks from other threads submit to the same queue
+    std::unique_lock<std::mutex> uploadLock(m_uploadMutex);
+
+    // Uploads recorded since the last submission must land before the frame
+    retireUploads(false);
+    if (submitUploads())
+        return 1; // Error: Failed to submit uploads
+
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &m_vkCommandBuffers[m_currentFrame];
 
-    VkSemaphore waitSemaphores[] = { m_imageAvailableSemaphores[m_currentFrame] };
-    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-    VkSemaphore signalSemaphores[] = { m_renderFinishedSemaphores[m_imageIndex] };
+    // Binary semaphores come first, their values in the timeline submit info are ignored
+    std::vector<VkSemaphore> waitSemaphores = {};
+    std::vector<VkPipelineStageFlags> waitStages = {};
+    std::vector<uint64_t> waitValues = {};
+    std::vector<VkSemaphore> signalSemaphores = {};
+    std::vector<uint64_t> signalValues = {};
     if (m_vkSwapchain != VK_NULL_HANDLE) {
-        submitInfo.waitSemaphoreCount = 1;
-        submitInfo.pWaitSemaphores = waitSemaphores;
-        submitInfo.pWaitDstStageMask = waitStages;
-        submitInfo.signalSemaphoreCount = 1;
-        submitInfo.pSignalSemaphores = signalSemaphores;
+        waitSemaphores.push_back(m_imageAvailableSemaphores[m_currentFrame]);
+        waitStages.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+        waitValues.push_back(0);
+        signalSemaphores.push_back(m_renderFinishedSemaphores[m_imageIndex]);
+        signalValues.push_back(0);
+    }
+    for (const auto& frameWait : m_frameWaits) {
+        waitSemaphores.push_back(frameWait.first);
+        waitStages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+        waitValues.push_back(frameWait.second);
     }
+    m_frameWaits.clear();
+    if (m_frameTimeline != VK_NULL_HANDLE) {
+        signalSemaphores.push_back(m_frameTimeline);
+        signalValues.push_back(m_frameSerial);
+    }
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+    submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+    submitInfo.pSignalSemaphores = signalSemaphores.data();
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+    timelineInfo.pSignalSemaphoreValues = signalValues.data();
+    if (m_frameTimeline != VK_NULL_HANDLE)
+        submitInfo.pNext = &timelineInfo;
 
     result = vkQueueSubmit(m_vkGraphicsQueue, 1, &submitInfo, m_inFlightFences[m_currentFrame]);
     if (result != VK_SUCCESS)
         return 1; // Error: Failed to submit command buffer
+    m_frameSyncValue = m_frameSerial;
+
+    // Readbacks recorded into the frame arrive with it, a fence of an empty submission is
+    // signaled once all work submitted before it has completed
+    for (VkFence fence : m_frameReadbackFences)
+        vkQueueSubmit(m_vkGraphicsQueue, 0, nullptr, fence);
+    m_frameReadbackFences.clear();
 
     if (m_vkSwapchain != VK_NULL_HANDLE) {
         VkPresentInfoKHR presentInfo{};
         presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
         presentInfo.waitSemaphoreCount = 1;
-        presentInfo.pWaitSemaphores = signalSemaphores;
+        presentInfo.pWaitSemaphores = &m_renderFinishedSemaphores[m_imageIndex];
         VkSwapchainKHR swapChains[] = { m_vkSwapchain };
         presentInfo.swapchainCount = 1;
         presentInfo.pSwapchains = swapChains;
         presentInfo.pImageIndices = &m_imageIndex;
 
         result = vkQueuePresentKHR(m_vkPresentQueue, &presentInfo);
+        uploadLock.unlock(); // Recreating the swapchain waits for uploads
         if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
             if (recreateSwapchain())
                 return 1; // Error: Failed to recreate swapchain
         } else if (result != VK_SUCCESS)
             return 1; // Error: Failed to present swapchain image
-    }
+    } else
+        uploadLock.unlock();
 
     m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 
@@ -2309,7 +2947,7 @@ int GfxVulkanRenderer::endFrame() {
 
 void GfxVulkanRenderer::draw(int nVertices, int nInstances, int firstVertex, int firstInstance) {
     vkCmdDraw(
-        m_vkCommandBuffers[m_currentFrame],
+        m_recordCommandBuffer,
         static_cast<uint32_t>(nVertices),
         static_cast<uint32_t>(nInstances),
         static_cast<uint32_t>(firstVertex),
@@ -2325,7 +2963,7 @@ void GfxVulkanRenderer::drawIndexed(
     int firstInstance
 ) {
     vkCmdDrawIndexed(
-        m_vkCommandBuffers[m_currentFrame],
+        m_recordCommandBuffer,
         static_cast<uint32_t>(nIndices),
         static_cast<uint32_t>(nInstances),
         static_cast<uint32_t>(firstIndex),
@@ -2336,15 +2974,15 @@ void GfxVulkanRenderer::drawIndexed(
 
 void GfxVulkanRenderer::drawIndirect(
     const GfxBuffer& buffer,
-    int offset,
+    size_t offset,
     int drawCount,
     int stride
 ) {
     std::shared_ptr<GfxVulkanBuffer> vulkanBuffer =
         std::static_pointer_cast<GfxVulkanBuffer>(buffer);
-    VkBuffer vkBuffer = vulkanBuffer->m_vkBuffers[m_currentFrame];
+    VkBuffer vkBuffer = vulkanBuffer->m_vkBuffers[vulkanBuffer->getInstanceIndex(m_recordFrame)];
     vkCmdDrawIndirect(
-        m_vkCommandBuffers[m_currentFrame],
+        m_recordCommandBuffer,
         vkBuffer,
         static_cast<VkDeviceSize>(offset),
         static_cast<uint32_t>(drawCount),
@@ -2354,15 +2992,15 @@ void GfxVulkanRenderer::drawIndirect(
 
 void GfxVulkanRenderer::drawIndexedIndirect(
     const GfxBuffer& buffer,
-    int offset,
+    size_t offset,
     int drawCount,
     int stride
 ) {
     std::shared_ptr<GfxVulkanBuffer> vulkanBuffer =
         std::static_pointer_cast<GfxVulkanBuffer>(buffer);
-    VkBuffer vkBuffer = vulkanBuffer->m_vkBuffers[m_currentFrame];
+    VkBuffer vkBuffer = vulkanBuffer->m_vkBuffers[vulkanBuffer->getInstanceIndex(m_recordFrame)];
     vkCmdDrawIndexedIndirect(
-        m_vkCommandBuffers[m_currentFrame],
+        m_recordCommandBuffer,
         vkBuffer,
         static_cast<VkDeviceSize>(offset),
         static_cast<uint32_t>(drawCount),
@@ -2372,31 +3010,101 @@ void GfxVulkanRenderer::drawIndexedIndirect(
 
 void GfxVulkanRenderer::dispatchCompute(int nGroupsX, int nGroupsY, int nGroupsZ) {
     vkCmdDispatch(
-        m_vkCommandBuffers[m_currentFrame],
+        m_recordCommandBuffer,
         static_cast<uint32_t>(nGroupsX),
         static_cast<uint32_t>(nGroupsY),
         static_cast<uint32_t>(nGroupsZ)
     );
 }
 
-void GfxVulkanRenderer::dispatchComputeIndirect(const GfxBuffer& buffer, int offset) {
+void GfxVulkanRenderer::dispatchComputeIndirect(const GfxBuffer& buffer, size_t offset) {
     std::shared_ptr<GfxVulkanBuffer> vulkanBuffer =
         std::static_pointer_cast<GfxVulkanBuffer>(buffer);
-    VkBuffer vkBuffer = vulkanBuffer->m_vkBuffers[m_currentFrame];
+    VkBuffer vkBuffer = vulkanBuffer->m_vkBuffers[vulkanBuffer->getInstanceIndex(m_recordFrame)];
     vkCmdDispatchIndirect(
-        m_vkCommandBuffers[m_currentFrame],
+        m_recordCommandBuffer,
         vkBuffer,
         static_cast<VkDeviceSize>(offset)
     );
 }
 
+int GfxVulkanRenderer::beginTimer(const std::string& name) {
+    if (m_timerFrames.empty() || m_frameThread.load() != std::this_thread::get_id())
+        return 1; // Error: Timers disabled or no frame being recorded on this thread
+    if (m_listThread.load() == std::this_thread::get_id())
+        return 1; // Error: Command lists do not record timer scopes
+    TimerFrame& frame = m_timerFrames[m_currentFrame];
+    // Keep a query for the end of every open scope
+    if (frame.nQueries + frame.openScopes.size() + 2 > MAX_TIMER_QUERIES)
+        return 1; // Error: Out of timestamp queries for this frame
+
+    TimerScope scope{};
+    scope.name = name;
+    scope.depth = static_cast<int>(frame.openScopes.size());
+    scope.beginQuery = frame.nQueries++;
+    vkCmdWriteTimestamp(
+        m_vkCommandBuffers[m_currentFrame],
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        frame.queryPool,
+        scope.beginQuery
+    );
+    frame.openScopes.push_back(static_cast<int>(frame.scopes.size()));
+    frame.scopes.push_back(std::move(scope));
+    return 0;
+}
+
+void GfxVulkanRenderer::endTimer() {
+    if (m_timerFrames.empty() || m_frameThread.load() != std::this_thread::get_id())
+        return;
+    if (m_listThread.load() == std::this_thread::get_id())
+        return;
+    TimerFrame& frame = m_timerFrames[m_currentFrame];
+    if (frame.openScopes.empty())
+        return;
+
+    TimerScope& scope = frame.scopes[frame.openScopes.back()];
+    frame.openScopes.pop_back();
+    scope.endQuery = frame.nQueries++;
+    vkCmdWriteTimestamp(
+        m_vkCommandBuffers[m_currentFrame],
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        frame.queryPool,
+        scope.endQuery
+    );
+}
+
+uint64_t GfxVulkanRenderer::getTimerResults(std::vector<GfxTimerResult>& results) const {
+    std::lock_guard<std::mutex> lock(m_timerMutex);
+    results = m_timerResults;
+    return m_timerResultsSerial;
+}
+
+GfxDeviceInfo GfxVulkanRenderer::getDeviceInfo() const {
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(s_vkPhysicalDevice, &properties);
+    GfxDeviceInfo info = {};
+    info.name = properties.deviceName;
+    info.maxComputeWorkGroupInvocations = properties.limits.maxComputeWorkGroupInvocations;
+    for (size_t i = 0; i < info.maxComputeWorkGroupSize.size(); i++)
+        info.maxComputeWorkGroupSize[i] = properties.limits.maxComputeWorkGroupSize[i];
+    return info;
+}
+
+GfxMemoryUsage GfxVulkanRenderer::getMemoryUsage() const {
+    GfxMemoryUsage usage = GfxMemoryTracker::getUsage();
+    GfxVulkanMemoryStats stats = getMemoryStats();
+    usage.deviceReservedBytes = static_cast<uint64_t>(stats.reservedBytes);
+    usage.deviceUsedBytes = static_cast<uint64_t>(stats.usedBytes);
+    return usage;
+}
+
 void GfxVulkanRenderer::memoryBarrier() {
     VkMemoryBarrier memoryBarrier{};
     memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
     memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
     memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
     vkCmdPipelineBarrier(
-        m_vkCommandBuffers[m_currentFrame],
+        m_recordCommandBuffer,
         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
         0,
@@ -2409,6 +3117,126 @@ void GfxVulkanRenderer::memoryBarrier() {
     );
 }
 
+GfxCommandList GfxVulkanRenderer::createCommandList() const {
+    std::shared_ptr<GfxVulkanCommandList> vulkanList = std::make_shared<GfxVulkanCommandList>();
+    vulkanList->m_vkCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = m_vkCommandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    allocInfo.commandBufferCount = static_cast<uint32_t>(vulkanList->m_vkCommandBuffers.size());
+    if (vkAllocateCommandBuffers(s_vkDevice, &allocInfo, vulkanList->m_vkCommandBuffers.data()))
+        return nullptr; // Error: Failed to allocate command buffers
+
+    return vulkanList;
+}
+
+int GfxVulkanRenderer::recordCommandList(
+    const GfxCommandList& list,
+    const std::function<void()>& recordFunc
+) {
+    std::shared_ptr<GfxVulkanCommandList> vulkanList =
+        std::static_pointer_cast<GfxVulkanCommandList>(list);
+    if (!vulkanList || vulkanList->m_vkCommandBuffers.empty())
+        return 1; // Error: Invalid command list
+    if (m_inRenderPass || m_listThread.load() != std::thread::id())
+        return 1; // Error: Inside a render pass or already recording a command list
+
+    std::shared_ptr<GfxVulkanPipelineStateMachine> vulkanPipelineStateMachine
+        = std::static_pointer_cast<GfxVulkanPipelineStateMachine>(m_pipelineStateMachine);
+    VkCommandBuffer frameCommandBuffer = m_recordCommandBuffer;
+    uint32_t frame = m_recordFrame;
+    VkCommandBuffer stateCommandBuffer = vulkanPipelineStateMachine->m_commandBuffer;
+    m_listThread.store(std::this_thread::get_id());
+
+    // Descriptor sets and uniform buffers exist per frame in flight, record one copy for each
+    int err = 0;
+    for (uint32_t i = 0; i < vulkanList->m_vkCommandBuffers.size(); i++) {
+        VkCommandBuffer commandBuffer = vulkanList->m_vkCommandBuffers[i];
+        vkResetCommandBuffer(commandBuffer, 0);
+        VkCommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+            err = 1; // Error: Failed to begin command buffer
+            break;
+        }
+
+        m_recordCommandBuffer = commandBuffer;
+        m_recordFrame = i;
+        vulkanPipelineStateMachine->m_commandBuffer = commandBuffer;
+        recordFunc();
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+            err = 1; // Error: Failed to end command buffer
+            break;
+        }
+    }
+
+    m_recordCommandBuffer = frameCommandBuffer;
+    m_recordFrame = frame;
+    vulkanPipelineStateMachine->m_commandBuffer = stateCommandBuffer;
+    m_listThread.store(std::thread::id());
+
+    return err;
+}
+
+void GfxVulkanRenderer::executeCommandList(const GfxCommandList& list) {
+    std::shared_ptr<GfxVulkanCommandList> vulkanList =
+        std::static_pointer_cast<GfxVulkanCommandList>(list);
+    if (!vulkanList || vulkanList->m_vkCommandBuffers.empty())
+        return; // Error: Invalid command list
+    if (m_inRenderPass || m_listThread.load() == std::this_thread::get_id())
+        return; // Error: Command lists run outside render passes and cannot nest
+
+    vkCmdExecuteCommands(
+        m_recordCommandBuffer,
+        1,
+        &vulkanList->m_vkCommandBuffers[m_recordFrame]
+    );
+}
+
+void GfxVulkanRenderer::destroyCommandList(const GfxCommandList& list) const {
+    std::shared_ptr<GfxVulkanCommandList> vulkanList =
+        std::static_pointer_cast<GfxVulkanCommandList>(list);
+    if (!vulkanList || vulkanList->m_vkCommandBuffers.empty())
+        return;
+    vkFreeCommandBuffers(
+        s_vkDevice,
+        m_vkCommandPool,
+        static_cast<uint32_t>(vulkanList->m_vkCommandBuffers.size()),
+        vulkanList->m_vkCommandBuffers.data()
+    );
+    vulkanList->m_vkCommandBuffers.clear();
+}
+
+GfxVulkanRenderer::QueueFamily GfxVulkanRenderer::findComputeQueueFamily(
+    const VkPhysicalDevice& device
+) {
+    QueueFamily family{};
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
+
+    for (uint32_t i = 0; i < queueFamilyCount; i++) {
+        const VkQueueFamilyProperties& queueFamily = queueFamilies[i];
+        if ((queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) &&
+            !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+            family.index = i;
+            family.queueCount = queueFamily.queueCount;
+            family.timestampValidBits = queueFamily.timestampValidBits;
+            break;
+        }
+    }
+
+    return family;
+}
+
 GfxVulkanRenderer::QueueFamily GfxVulkanRenderer::findQueueFamily(
     const VkPhysicalDevice& device
 ) {
@@ -2425,6 +3253,7 @@ GfxVulkanRenderer::QueueFamily GfxVulkanRenderer::findQueueFamily(
         if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
             family.index = i;
             family.queueCount = queueFamily.queueCount;
+            family.timestampValidBits = queueFamily.timestampValidBits;
             break;
         }
         i++;
@@ -2573,7 +3402,7 @@ int GfxVulkanRenderer::createSwapchain() {
     err = createVkImage(
         colorImageInfo,
         m_swapchainColorImage,
-        m_swapchainColorImageMemory
+        m_swapchainColorImageAllocation
     );
     if (err)
         return err; // Error: Failed to create swapchain color image
@@ -2605,7 +3434,7 @@ int GfxVulkanRenderer::createSwapchain() {
     err = createVkImage(
         depthImageInfo,
         m_swapchainDepthImage,
-        m_swapchainDepthImageMemory
+        m_swapchainDepthImageAllocation
     );
     if (err)
         return err; // Error: Failed to create swapchain depth image
@@ -2793,10 +3622,7 @@ void GfxVulkanRenderer::cleanupSwapchain() {
         vkDestroyImage(s_vkDevice, m_swapchainColorImage, nullptr);
         m_swapchainColorImage = VK_NULL_HANDLE;
     }
-    if (m_swapchainColorImageMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(s_vkDevice, m_swapchainColorImageMemory, nullptr);
-        m_swapchainColorImageMemory = VK_NULL_HANDLE;
-    }
+    s_allocator->free(m_swapchainColorImageAllocation);
     if (m_swapchainDepthImageView != VK_NULL_HANDLE) {
         vkDestroyImageView(s_vkDevice, m_swapchainDepthImageView, nullptr);
         m_swapchainDepthImageView = VK_NULL_HANDLE;
@@ -2805,10 +3631,7 @@ void GfxVulkanRenderer::cleanupSwapchain() {
         vkDestroyImage(s_vkDevice, m_swapchainDepthImage, nullptr);
         m_swapchainDepthImage = VK_NULL_HANDLE;
     }
-    if (m_swapchainDepthImageMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(s_vkDevice, m_swapchainDepthImageMemory, nullptr);
-        m_swapchainDepthImageMemory = VK_NULL_HANDLE;
-    }
+    s_allocator->free(m_swapchainDepthImageAllocation);
     for (auto framebuffer : m_swapchainFramebuffers) {
         if (framebuffer != VK_NULL_HANDLE) {
             vkDestroyFramebuffer(s_vkDevice, framebuffer, nullptr);
@@ -2851,7 +3674,7 @@ VkSampleCountFlagBits GfxVulkanRenderer::getSampleCount(int samples) const {
 int GfxVulkanRenderer::createVkImage(
     const CreateVkImageInfo& info,
     VkImage& image,
-    VkDeviceMemory& imageMemory
+    GfxVulkanAllocation& allocation
 ) const {
     VkImageCreateInfo imageInfo{};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -2868,6 +3691,15 @@ int GfxVulkanRenderer::createVkImage(
 
     imageInfo.usage = info.usage;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    // Sampled images may be read by renderers on the compute queue family
+    const uint32_t queueFamilies[] = { s_graphicsFamily, s_computeFamily };
+    VkImageUsageFlags attachmentUsages =
+        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    if (s_computeFamily != UINT32_MAX && !(info.usage & attachmentUsages)) {
+        imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        imageInfo.queueFamilyIndexCount = 2;
+        imageInfo.pQueueFamilyIndices = queueFamilies;
+    }
 
     imageInfo.samples = info.numSamples;
     imageInfo.flags = 0;
@@ -2878,18 +3710,15 @@ int GfxVulkanRenderer::createVkImage(
     VkMemoryRequirements memRequirements;
     vkGetImageMemoryRequirements(s_vkDevice, image, &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
     uint32_t typeIndex = 0;
     if (findMemoryType(memRequirements.memoryTypeBits, info.properties, typeIndex))
         return 1; // Error: Failed to find suitable memory type
-    allocInfo.memoryTypeIndex = typeIndex;
 
-    if (vkAllocateMemory(s_vkDevice, &allocInfo, nullptr, &imageMemory))
-        return 1;
+    bool linear = info.tiling == VK_IMAGE_TILING_LINEAR;
+    if (s_allocator->allocate(memRequirements, typeIndex, linear, allocation))
+        return 1; // Error: Failed to allocate device memory
 
-    vkBindImageMemory(s_vkDevice, image, imageMemory, 0);
+    vkBindImageMemory(s_vkDevice, image, allocation.memory, allocation.offset);
 
     return 0;
 }
@@ -3102,18 +3931,25 @@ int GfxVulkanRenderer::readImageData(
 
     // Create staging buffer
     VkBuffer stagingBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory stagingBufferMemory = VK_NULL_HANDLE;
+    GfxVulkanAllocation stagingAllocation = {};
     int err = createVkBuffer(
         imageSize,
         VK_BUFFER_USAGE_TRANSFER_DST_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
         stagingBuffer,
-        stagingBufferMemory
+        stagingAllocation
     );
     if (err)
         return 1; // Error: Failed to create staging buffer
 
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    // Callers may be on any thread, record into the upload batch since the frame command pool
+    // belongs to the render thread
+    std::lock_guard<std::mutex> lock(m_uploadMutex);
+    VkCommandBuffer commandBuffer = getUploadCommandBuffer();
+    if (commandBuffer == VK_NULL_HANDLE) {
+        destroyVkBuffer(stagingBuffer, stagingAllocation);
+        return 1; // Error: Failed to begin upload command buffer
+    }
 
     // Transition image to transfer src
     err = transitionImageLayout(
@@ -3124,8 +3960,10 @@ int GfxVulkanRenderer::readImageData(
         1,
         commandBuffer
     );
-    if (err)
+    if (err) {
+        destroyVkBuffer(stagingBuffer, stagingAllocation);
         return 1; // Error: Failed to transition image layout
+    }
 
     // Copy image region to buffer
     VkBufferImageCopy region{};
@@ -3161,22 +3999,38 @@ int GfxVulkanRenderer::readImageData(
         commandBuffer
     );
 
-    endSingleTimeCommands(commandBuffer);
+    VkMemoryBarrier hostBarrier{};
+    hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        0,
+        1,
+        &hostBarrier,
+        0,
+        nullptr,
+        0,
+        nullptr
+    );
 
-    // Map buffer and copy to output
-    void* mappedData = nullptr;
-    VkResult result = vkMapMemory(s_vkDevice, stagingBufferMemory, 0, imageSize, 0, &mappedData);
-    if (result != VK_SUCCESS) {
-        vkDestroyBuffer(s_vkDevice, stagingBuffer, nullptr);
-        vkFreeMemory(s_vkDevice, stagingBufferMemory, nullptr);
-        return 1; // Error: Failed to map memory for staging buffer
+    // The data is needed right away, submit the batch and wait for it
+    err = submitUploads();
+    if (!err) {
+        VkFence fence = m_submittedUploads.back().fence;
+        vkWaitForFences(s_vkDevice, 1, &fence, VK_TRUE, UINT64_MAX);
+
+        // Copy to output
+        memcpy(data, stagingAllocation.mappedData, static_cast<size_t>(imageSize));
+        retireUploads(false);
     }
-    memcpy(data, mappedData, static_cast<size_t>(imageSize));
-    vkUnmapMemory(s_vkDevice, stagingBufferMemory);
 
     // Cleanup
-    vkDestroyBuffer(s_vkDevice, stagingBuffer, nullptr);
-    vkFreeMemory(s_vkDevice, stagingBufferMemory, nullptr);
+    destroyVkBuffer(stagingBuffer, stagingAllocation);
+    if (err)
+        return 1; // Error: Failed to submit readback
 
     return 0;
 }
@@ -3198,7 +4052,7 @@ void GfxVulkanRenderer::clearAttachment(const VkClearAttachment& attachment) con
     clearRect.layerCount = 1;
 
     vkCmdClearAttachments(
-        m_vkCommandBuffers[m_currentFrame],
+        m_recordCommandBuffer,
         1,
         &attachment,
         1,
@@ -3254,7 +4108,7 @@ int GfxVulkanRenderer::createVkBuffer(
     VkBufferUsageFlags usage,
     VkMemoryPropertyFlags properties,
     VkBuffer& buffer,
-    VkDeviceMemory& bufferMemory
+    GfxVulkanAllocation& allocation
 ) const {
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -3268,23 +4122,29 @@ int GfxVulkanRenderer::createVkBuffer(
     VkMemoryRequirements memRequirements;
     vkGetBufferMemoryRequirements(s_vkDevice, buffer, &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
     uint32_t typeIndex = 0;
-    if (findMemoryType(memRequirements.memoryTypeBits, properties, typeIndex))
+    if (findMemoryType(memRequirements.memoryTypeBits, properties, typeIndex)) {
+        destroyVkBuffer(buffer, allocation);
         return 1; // Error: Failed to find suitable memory type
-    allocInfo.memoryTypeIndex = typeIndex;
+    }
 
-    if (vkAllocateMemory(s_vkDevice, &allocInfo, nullptr, &bufferMemory))
-        return 1;
+    if (s_allocator->allocate(memRequirements, typeIndex, true, allocation)) {
+        destroyVkBuffer(buffer, allocation);
+        return 1; // Error: Failed to allocate device memory
+    }
 
-    vkBindBufferMemory(s_vkDevice, buffer, bufferMemory, 0);
+    vkBindBufferMemory(s_vkDevice, buffer, allocation.memory, allocation.offset);
 
     return 0;
 }
 
-int GfxVulkanRenderer::resizeVkBuffer(const GfxBuffer& buffer, int size) const {
+void GfxVulkanRenderer::destroyVkBuffer(VkBuffer& buffer, GfxVulkanAllocation& allocation) const {
+    vkDestroyBuffer(s_vkDevice, buffer, nullptr);
+    buffer = VK_NULL_HANDLE;
+    s_allocator->free(allocation);
+}
+
+int GfxVulkanRenderer::resizeVkBuffer(const GfxBuffer& buffer, size_t size) const {
     std::shared_ptr<GfxVulkanBuffer> vulkanBuffer =
         std::static_pointer_cast<GfxVulkanBuffer>(buffer);
 
@@ -3302,13 +4162,12 @@ int GfxVulkanRenderer::resizeVkBuffer(const GfxBuffer& buffer, int size) const {
         vkUsage |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
     else if (usage == GfxBufferUsage::INDEX_BUFFER)
         vkUsage |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-    else {
+    else if (usage == GfxBufferUsage::UNIFORM_BUFFER) {
+        // Uniform buffers are small and rewritten every frame, keep one per frame in flight
         nBuffers = MAX_FRAMES_IN_FLIGHT;
-        if (usage == GfxBufferUsage::UNIFORM_BUFFER)
-            vkUsage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-        else if (usage == GfxBufferUsage::STORAGE_BUFFER)
-            vkUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-    }
+        vkUsage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    } else if (usage == GfxBufferUsage::STORAGE_BUFFER)
+        vkUsage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
     if (prop == GfxBufferProp::STATIC)
         vkProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
     else if (prop == GfxBufferProp::DYNAMIC) {
@@ -3317,25 +4176,38 @@ int GfxVulkanRenderer::resizeVkBuffer(const GfxBuffer& buffer, int size) const {
             VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
     }
 
+    // Uniform and storage buffers are bound as a whole, so they must fit into one descriptor
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(s_vkPhysicalDevice, &properties);
+    if (usage == GfxBufferUsage::UNIFORM_BUFFER &&
+        bufferSize > properties.limits.maxUniformBufferRange) {
+        return 1; // Error: Buffer size exceeds maxUniformBufferRange
+    }
+    if (usage == GfxBufferUsage::STORAGE_BUFFER &&
+        bufferSize > properties.limits.maxStorageBufferRange) {
+        return 1; // Error: Buffer size exceeds maxStorageBufferRange
+    }
+
     destroyBuffer(buffer);
     vulkanBuffer->m_vkBuffers.resize(nBuffers, VK_NULL_HANDLE);
-    vulkanBuffer->m_vkBufferMemories.resize(nBuffers, VK_NULL_HANDLE);
+    vulkanBuffer->m_vkBufferAllocations.resize(nBuffers);
 
     for (int i = 0; i < nBuffers; i++) {
         VkBuffer& vkBuffer = vulkanBuffer->m_vkBuffers[i];
-        VkDeviceMemory& vkBufferMemory = vulkanBuffer->m_vkBufferMemories[i];
+        GfxVulkanAllocation& vkBufferAllocation = vulkanBuffer->m_vkBufferAllocations[i];
 
         int err = createVkBuffer(
             bufferSize,
             vkUsage,
             vkProperties,
             vkBuffer,
-            vkBufferMemory
+            vkBufferAllocation
         );
         if (err) {
             destroyBuffer(buffer);
             return err; // Error: Failed to recreate Vulkan buffer
         }
+        GfxMemoryTracker::track(GfxMemoryTracker::getCategory(usage), vkBufferAllocation.size);
     }
 
     vulkanBuffer->setSize(size);
@@ -3496,7 +4368,7 @@ void GfxVulkanRenderer::updateVkDescriptorSets(
                     std::static_pointer_cast<GfxVulkanBuffer>(*buffer);
                 bufferInfos.emplace_back();
                 VkDescriptorBufferInfo& bufferInfo = bufferInfos.back();
-                bufferInfo.buffer = vulkanBuffer->m_vkBuffers[i];
+                bufferInfo.buffer = vulkanBuffer->m_vkBuffers[vulkanBuffer->getInstanceIndex(i)];
                 bufferInfo.offset = 0;
                 bufferInfo.range = static_cast<VkDeviceSize>((*buffer)->getSize());
                 if (binding.descriptor.type == GfxDescriptorType::UNIFORM_BUFFER)
@@ -3518,7 +4390,278 @@ void GfxVulkanRenderer::updateVkDescriptorSets(
     }
 }
 
+void GfxVulkanRenderer::resolveTimers() {
+    if (m_timerFrames.empty())
+        return;
+    TimerFrame& frame = m_timerFrames[m_currentFrame];
+
+    if (frame.nQueries > 0) {
+        std::vector<uint64_t> timestamps(frame.nQueries, 0);
+        VkResult result = vkGetQueryPoolResults(
+            s_vkDevice,
+            frame.queryPool,
+            0,
+            frame.nQueries,
+            timestamps.size() * sizeof(uint64_t),
+            timestamps.data(),
+            sizeof(uint64_t),
+            VK_QUERY_RESULT_64_BIT
+        );
+        // Not ready only if the frame never reached the GPU, its results are dropped then
+        if (result == VK_SUCCESS) {
+            std::vector<GfxTimerResult> results;
+            results.reserve(frame.scopes.size());
+            for (const auto& scope : frame.scopes) {
+                if (scope.endQuery == UINT32_MAX)
+                    continue; // Scope was never ended
+                uint64_t ticks =
+                    (timestamps[scope.endQuery] - timestamps[scope.beginQuery]) & m_timestampMask;
+                GfxTimerResult timerResult{};
+                timerResult.name = scope.name;
+                timerResult.depth = scope.depth;
+                timerResult.ms = static_cast<double>(ticks) * m_timestampPeriod * 1e-6;
+                results.push_back(std::move(timerResult));
+            }
+            std::lock_guard<std::mutex> lock(m_timerMutex);
+            m_timerResults = std::move(results);
+            m_timerResultsSerial = frame.serial;
+        }
+    }
+
+    vkCmdResetQueryPool(m_vkCommandBuffers[m_currentFrame], frame.queryPool, 0, MAX_TIMER_QUERIES);
+    frame.scopes.clear();
+    frame.openScopes.clear();
+    frame.nQueries = 0;
+}
+
+VkCommandBuffer GfxVulkanRenderer::getUploadCommandBuffer() const {
+    if (m_pendingUploads.commandBuffer != VK_NULL_HANDLE)
+        return m_pendingUploads.commandBuffer;
+
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    if (!m_freeUploadCommandBuffers.empty()) {
+        commandBuffer = m_freeUploadCommandBuffers.back();
+        m_freeUploadCommandBuffers.pop_back();
+        vkResetCommandBuffer(commandBuffer, 0);
+    } else {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = m_vkTransferCommandPool;
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(s_vkDevice, &allocInfo, &commandBuffer))
+            return VK_NULL_HANDLE; // Error: Failed to allocate command buffer
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo)) {
+        m_freeUploadCommandBuffers.push_back(commandBuffer);
+        return VK_NULL_HANDLE; // Error: Failed to begin command buffer
+    }
+
+    // Transfers of this batch must see the writes of everything submitted before it
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        1,
+        &barrier,
+        0,
+        nullptr,
+        0,
+        nullptr
+    );
+
+    m_pendingUploads.commandBuffer = commandBuffer;
+    m_pendingUploads.serial = ++m_uploadSerial;
+    return commandBuffer;
+}
+
+int GfxVulkanRenderer::acquireStagingRegion(VkDeviceSize size, StagingRegion& region) const {
+    // Transfers that do not fit into the ring get their own staging buffer
+    if (size > STAGING_RING_SIZE) {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        GfxVulkanAllocation allocation = {};
+        int err = createVkBuffer(
+            size,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            buffer,
+            allocation
+        );
+        if (err)
+            return err; // Error: Failed to create staging buffer
+        m_pendingUploads.oversizedBuffers.push_back(buffer);
+        m_pendingUploads.oversizedAllocations.push_back(allocation);
+        region.buffer = buffer;
+        region.offset = 0;
+        region.mappedData = allocation.mappedData;
+        return getUploadCommandBuffer() == VK_NULL_HANDLE ? 1 : 0;
+    }
+
+    if (m_stagingRing == VK_NULL_HANDLE) {
+        int err = createVkBuffer(
+            STAGING_RING_SIZE,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_stagingRing,
+            m_stagingRingAllocation
+        );
+        if (err)
+            return err; // Error: Failed to create staging ring
+        m_stagingHead = 0;
+    }
+
+    retireUploads(false);
+
+    VkDeviceSize begin =
+        (m_stagingHead + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+    if (begin + size > STAGING_RING_SIZE)
+        begin = 0; // Wrap around
+    while (!isStagingRangeFree(begin, size)) {
+        // The ring wrapped onto memory still in flight, wait for the oldest batch
+        if (m_submittedUploads.empty() && submitUploads())
+            return 1; // Error: Failed to submit uploads
+        if (m_submittedUploads.empty())
+            return 1; // Error: Staging ring is exhausted
+        VkFence fence = m_submittedUploads.front().fence;
+        vkWaitForFences(s_vkDevice, 1, &fence, VK_TRUE, UINT64_MAX);
+        retireUploads(false);
+    }
+
+    if (getUploadCommandBuffer() == VK_NULL_HANDLE)
+        return 1; // Error: Failed to begin upload command buffer
+
+    if (!m_pendingUploads.usesRing) {
+        m_pendingUploads.usesRing = true;
+        m_pendingUploads.ringBegin = begin;
+    }
+    m_pendingUploads.ringEnd = begin + size;
+    m_stagingHead = begin + size;
+
+    region.buffer = m_stagingRing;
+    region.offset = begin;
+    region.mappedData = static_cast<char*>(m_stagingRingAllocation.mappedData) + begin;
+
+    return 0;
+}
+
+bool GfxVulkanRenderer::isStagingRangeFree(VkDeviceSize begin, VkDeviceSize size) const {
+    // Find the oldest batch still holding ring memory, its start is the tail of the ring
+    const UploadBatch* oldest = nullptr;
+    for (const auto& batch : m_submittedUploads) {
+        if (batch.usesRing) {
+            oldest = &batch;
+            break;
+        }
+    }
+    if (oldest == nullptr && m_pendingUploads.usesRing)
+        oldest = &m_pendingUploads;
+    if (oldest == nullptr)
+        return true; // Nothing in use
+
+    VkDeviceSize tail = oldest->ringBegin;
+    VkDeviceSize head = m_stagingHead;
+    VkDeviceSize end = begin + size;
+    if (tail < head)
+        return end <= tail || begin >= head; // In use: [tail, head)
+    return begin >= head && end <= tail; // In use: [tail, size) and [0, head)
+}
+
+int GfxVulkanRenderer::submitUploads() const {
+    if (m_pendingUploads.commandBuffer == VK_NULL_HANDLE)
+        return 0; // Nothing to submit
+
+    UploadBatch batch = std::move(m_pendingUploads);
+    m_pendingUploads = {};
+
+    if (vkEndCommandBuffer(batch.commandBuffer))
+        return 1; // Error: Failed to end upload command buffer
+
+    if (!m_freeUploadFences.empty()) {
+        batch.fence = m_freeUploadFences.back();
+        m_freeUploadFences.pop_back();
+    } else {
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vkCreateFence(s_vkDevice, &fenceInfo, nullptr, &batch.fence))
+            return 1; // Error: Failed to create upload fence
+    }
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch.commandBuffer;
+    if (vkQueueSubmit(m_vkGraphicsQueue, 1, &submitInfo, batch.fence)) {
+        m_freeUploadFences.push_back(batch.fence);
+        return 1; // Error: Failed to submit upload command buffer
+    }
+
+    m_submittedUploads.push_back(std::move(batch));
+
+    return 0;
+}
+
+void GfxVulkanRenderer::retireUploads(bool wait) const {
+    while (!m_submittedUploads.empty()) {
+        UploadBatch& batch = m_submittedUploads.front();
+        if (wait)
+            vkWaitForFences(s_vkDevice, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+        else if (vkGetFenceStatus(s_vkDevice, batch.fence) != VK_SUCCESS)
+            break; // Batches complete in order, the rest are still in flight
+
+        for (size_t i = 0; i < batch.oversizedBuffers.size(); i++)
+            destroyVkBuffer(batch.oversizedBuffers[i], batch.oversizedAllocations[i]);
+        for (auto& release : batch.releases)
+            release();
+        m_retiredUploadSerial = batch.serial;
+        m_freeUploadCommandBuffers.push_back(batch.commandBuffer);
+        vkResetFences(s_vkDevice, 1, &batch.fence);
+        m_freeUploadFences.push_back(batch.fence);
+        m_submittedUploads.pop_front();
+    }
+}
+
+int GfxVulkanRenderer::flushUploads() const {
+    std::lock_guard<std::mutex> lock(m_uploadMutex);
+    retireUploads(false);
+    return submitUploads();
+}
+
+void GfxVulkanRenderer::releaseAfterUploads(
+    uint64_t serial,
+    std::function<void()> release
+) const {
+    {
+        std::lock_guard<std::mutex> lock(m_uploadMutex);
+        if (serial > m_retiredUploadSerial) {
+            if (m_pendingUploads.commandBuffer != VK_NULL_HANDLE &&
+                m_pendingUploads.serial == serial) {
+                m_pendingUploads.releases.push_back(std::move(release));
+                return;
+            }
+            for (auto& batch : m_submittedUploads) {
+                if (batch.serial == serial) {
+                    batch.releases.push_back(std::move(release));
+                    return;
+                }
+            }
+        }
+    }
+    release(); // The batch has completed
+}
+
 VkCommandBuffer GfxVulkanRenderer::beginSingleTimeCommands() const {
+    // Immediate commands must run after the uploads recorded so far
+    flushUploads();
+
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
@@ -3545,8 +4688,11 @@ void GfxVulkanRenderer::endSingleTimeCommands(const VkCommandBuffer& commandBuff
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
 
-    vkQueueSubmit(m_vkGraphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(m_vkGraphicsQueue);
+    {
+        std::lock_guard<std::mutex> lock(m_uploadMutex); // The queue is shared with other threads
+        vkQueueSubmit(m_vkGraphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
+        vkQueueWaitIdle(m_vkGraphicsQueue);
+    }
 
     vkFreeCommandBuffers(s_vkDevice, m_vkCommandPool, 1, &commandBuffer);
 }
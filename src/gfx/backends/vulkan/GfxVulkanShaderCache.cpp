@@ -0,0 +1,224 @@
+/**
+ * @file GfxVulkanShaderCache.cpp
+ * @brief Implementation of GfxVulkanShaderCache class.
+ */
+
+#include "gfx/backends/vulkan/GfxVulkanShaderCache.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+constexpr uint32_t SPIRV_CACHE_MAGIC = 0x43565053; // "SPVC"
+constexpr uint32_t SPIRV_CACHE_VERSION = 2; // Version of the SPIR-V cache file layout
+constexpr uint32_t SPIRV_MAGIC = 0x07230203; // First word of every SPIR-V module
+
+/**
+ * @brief Header of a cache file, followed by the full key and the SPIR-V words.
+ */
+struct SpirvCacheHeader {
+    uint32_t magic = SPIRV_CACHE_MAGIC; // File magic
+    uint32_t version = SPIRV_CACHE_VERSION; // File layout version
+    uint64_t keyHash = 0; // Hash of the full key
+    uint64_t keySize = 0; // Length of the full key
+};
+
+GfxVulkanShaderCache::GfxVulkanShaderCache(const std::string& cacheDir) {
+    if (cacheDir.empty())
+        return;
+
+    std::error_code ec;
+    std::filesystem::path spirvDir = std::filesystem::path(cacheDir) / "spirv";
+    std::filesystem::create_directories(spirvDir, ec);
+    if (ec)
+        return; // Disk cache stays disabled
+    m_spirvDir = spirvDir.string();
+    m_pipelineCachePath = (std::filesystem::path(cacheDir) / "pipeline.cache").string();
+}
+
+int GfxVulkanShaderCache::loadSpirv(const std::string& key, std::vector<uint32_t>& code) const {
+    if (m_spirvDir.empty())
+        return 1; // Error: Disk cache disabled
+
+    uint64_t keyHash = hash(key);
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.spv", static_cast<unsigned long long>(keyHash));
+    std::ifstream file(std::filesystem::path(m_spirvDir) / name, std::ios::binary);
+    if (!file.is_open())
+        return 1; // Error: Not cached
+
+    SpirvCacheHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return 1; // Error: Truncated file
+    if (header.magic != SPIRV_CACHE_MAGIC || header.version != SPIRV_CACHE_VERSION ||
+        header.keyHash != keyHash || header.keySize != key.size()) {
+        return 1; // Error: Stale or foreign file
+    }
+    // Files are named by hash, a different key with the same hash must not be reused
+    std::vector<char> storedKey(key.size());
+    if (!file.read(storedKey.data(), static_cast<std::streamsize>(storedKey.size())))
+        return 1; // Error: Truncated file
+    if (memcmp(storedKey.data(), key.data(), key.size()) != 0)
+        return 1; // Error: Hash collision, the caller compiles and replaces the file
+
+    std::vector<char> bytes(
+        (std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>()
+    );
+    if (bytes.empty() || bytes.size() % sizeof(uint32_t) != 0)
+        return 1; // Error: Truncated SPIR-V
+    code.resize(bytes.size() / sizeof(uint32_t));
+    memcpy(code.data(), bytes.data(), bytes.size());
+    if (code[0] != SPIRV_MAGIC) {
+        code.clear();
+        return 1; // Error: Not a SPIR-V module
+    }
+
+    return 0;
+}
+
+int GfxVulkanShaderCache::storeSpirv(
+    const std::string& key,
+    const std::vector<uint32_t>& code
+) const {
+    if (m_spirvDir.empty() || code.empty())
+        return 1; // Error: Disk cache disabled or nothing to store
+
+    SpirvCacheHeader header{};
+    header.keyHash = hash(key);
+    header.keySize = key.size();
+    std::vector<char> bytes(sizeof(header) + key.size() + code.size() * sizeof(uint32_t));
+    memcpy(bytes.data(), &header, sizeof(header));
+    memcpy(bytes.data() + sizeof(header), key.data(), key.size());
+    memcpy(
+        bytes.data() + sizeof(header) + key.size(),
+        code.data(),
+        code.size() * sizeof(uint32_t)
+    );
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.spv", static_cast<unsigned long long>(header.keyHash));
+    std::string path = (std::filesystem::path(m_spirvDir) / name).string();
+    return writeFile(path, bytes.data(), bytes.size());
+}
+
+void GfxVulkanShaderCache::recordSpirv(bool hit, double ms) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (hit) {
+        m_stats.spirvHits++;
+        m_stats.spirvLoadMs += ms;
+    } else {
+        m_stats.spirvMisses++;
+        m_stats.spirvCompileMs += ms;
+    }
+}
+
+int GfxVulkanShaderCache::createPipelineCache(
+    VkPhysicalDevice physicalDevice,
+    VkDevice device,
+    VkPipelineCache& pipelineCache
+) {
+    std::vector<char> blob;
+    if (!m_pipelineCachePath.empty()) {
+        std::ifstream file(m_pipelineCachePath, std::ios::binary);
+        if (file.is_open()) {
+            blob.assign(
+                (std::istreambuf_iterator<char>(file)),
+                std::istreambuf_iterator<char>()
+            );
+        }
+    }
+
+    // Only reuse blobs written by the same device and driver
+    if (!blob.empty()) {
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        VkPipelineCacheHeaderVersionOne header{};
+        bool valid = blob.size() >= sizeof(header);
+        if (valid) {
+            memcpy(&header, blob.data(), sizeof(header));
+            valid =
+                header.headerSize >= sizeof(header) &&
+                header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                header.vendorID == properties.vendorID &&
+                header.deviceID == properties.deviceID &&
+                memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+        }
+        if (!valid)
+            blob.clear();
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = blob.size();
+    cacheInfo.pInitialData = blob.empty() ? nullptr : blob.data();
+    if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS) {
+        // The driver rejected the blob, start with an empty cache
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        blob.clear();
+        if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS)
+            return 1; // Error: Failed to create pipeline cache
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.pipelineCacheLoaded = !blob.empty();
+    m_stats.pipelineCacheBytes = blob.size();
+
+    return 0;
+}
+
+int GfxVulkanShaderCache::savePipelineCache(
+    VkDevice device,
+    VkPipelineCache pipelineCache
+) const {
+    if (m_pipelineCachePath.empty() || pipelineCache == VK_NULL_HANDLE)
+        return 1; // Error: Disk cache disabled or no cache to save
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(device, pipelineCache, &size, nullptr) != VK_SUCCESS || size == 0)
+        return 1; // Error: Failed to query pipeline cache size
+    std::vector<char> blob(size);
+    if (vkGetPipelineCacheData(device, pipelineCache, &size, blob.data()) != VK_SUCCESS)
+        return 1; // Error: Failed to read pipeline cache
+    return writeFile(m_pipelineCachePath, blob.data(), size);
+}
+
+GfxVulkanShaderCacheStats GfxVulkanShaderCache::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+uint64_t GfxVulkanShaderCache::hash(const std::string& data) {
+    uint64_t value = 0xcbf29ce484222325ull;
+    for (unsigned char c : data) {
+        value ^= c;
+        value *= 0x100000001b3ull;
+    }
+    return value;
+}
+
+int GfxVulkanShaderCache::writeFile(const std::string& path, const void* data, size_t size) {
+    // Renderers on other threads may write the same entry, each uses its own temporary file
+    std::string tmpPath =
+        path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) +
+        ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return 1; // Error: Failed to open cache file
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        if (!file)
+            return 1; // Error: Failed to write cache file
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return 1; // Error: Failed to replace cache file
+    }
+    return 0;
+}
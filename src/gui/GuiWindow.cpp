@@ -3,19 +3,64 @@
  * @brief Implementation of the GUI window class.
  */
 
+#include <atomic>
+#include <chrono>
+
 #include "gui/GuiPr.h"
 #include "gui/impl/GuiWindowGLFW.h"
 
 std::string GuiConfig::s_appName = "";
 GfxBackend GuiConfig::s_backend = GfxBackend::OpenGL;
+std::string GuiConfig::s_cacheDir = "";
+bool GuiConfig::s_timelineSemaphores = true;
 
 /**
  * @brief Implementation details for the GuiWindow class.
  */
 struct GuiWindow::Impl {
     std::unique_ptr<GuiWindowImpl> impl; // Pointer to the implementation of the GUI window
+
+    // Frames drawn after an input event, lets ImGui settle hover and popup states
+    static constexpr int INPUT_REDRAW_FRAMES = 3;
+    // Interval in seconds after which an idle window redraws in on-demand mode
+    static constexpr double IDLE_REDRAW_INTERVAL = 1.0;
+
+    bool redrawOnDemand = false; // Whether frames are only drawn on demand
+    std::atomic<int> pendingRedraws{ 0 }; // Number of requested frames not drawn yet
+    double minFrameInterval = 0.0; // Minimum time between frames in seconds, 0 for no cap
+    std::chrono::steady_clock::time_point lastFrameTime = {}; // Time the last frame began
+
+    /**
+     * @brief Sleeps until the next frame is due, processing events meanwhile.
+     */
+    void waitForNextFrame();
 };
 
+void GuiWindow::Impl::waitForNextFrame() {
+    using Seconds = std::chrono::duration<double>;
+    // Frame rate cap
+    while (true) {
+        Seconds elapsed = std::chrono::steady_clock::now() - lastFrameTime;
+        double remaining = minFrameInterval - elapsed.count();
+        if (remaining <= 0.0)
+            break;
+        impl->waitEvents(remaining);
+    }
+    if (!redrawOnDemand)
+        return;
+    // Sleep until an event or another thread requests a frame
+    while (pendingRedraws.load(std::memory_order_acquire) <= 0 && !impl->shouldClose()) {
+        Seconds elapsed = std::chrono::steady_clock::now() - lastFrameTime;
+        double remaining = IDLE_REDRAW_INTERVAL - elapsed.count();
+        if (remaining <= 0.0)
+            break;
+        impl->waitEvents(remaining);
+    }
+    // Only this thread consumes requests, others may only raise the count
+    if (pendingRedraws.load(std::memory_order_acquire) > 0)
+        pendingRedraws.fetch_sub(1, std::memory_order_acq_rel);
+}
+
 GuiWindow::GuiWindow(const std::string& title, int width, int height, int samples) :
     m_title(title),
     m_impl(std::make_unique<Impl>()) {
@@ -95,6 +140,9 @@ int GuiWindow::drawFrame() {
     if (!m_impl && !m_impl->impl)
         return 1;
 
+    m_impl->waitForNextFrame();
+    m_impl->lastFrameTime = std::chrono::steady_clock::now();
+
     if (m_impl->impl->beginFrame())
         return 1;
 
@@ -124,6 +172,31 @@ int GuiWindow::drawFrame() {
     return m_impl->impl->endFrame();
 }
 
+void GuiWindow::setRedrawOnDemand(bool enabled) {
+    if (!m_impl && !m_impl->impl)
+        return;
+    m_impl->redrawOnDemand = enabled;
+    requestRedraw();
+}
+
+void GuiWindow::requestRedraw(int nFrames) {
+    if (!m_impl && !m_impl->impl)
+        return;
+    int pending = m_impl->pendingRedraws.load(std::memory_order_relaxed);
+    while (pending < nFrames) {
+        if (m_impl->pendingRedraws.compare_exchange_weak(pending, nFrames))
+            break;
+    }
+    if (m_impl->redrawOnDemand)
+        m_impl->impl->postEmptyEvent();
+}
+
+void GuiWindow::setMaxFrameRate(int fps) {
+    if (!m_impl && !m_impl->impl)
+        return;
+    m_impl->minFrameInterval = fps > 0 ? 1.0 / static_cast<double>(fps) : 0.0;
+}
+
 void* GuiWindow::getNativeWindow() const {
     if (!m_impl && !m_impl->impl)
         return nullptr;
@@ -206,6 +279,7 @@ void GuiWindow::onResize(int width, int height) {
     if (!m_impl && !m_impl->impl)
         return;
     m_onResizeCb(width, height);
+    requestRedraw(Impl::INPUT_REDRAW_FRAMES);
     if (m_renderer->beginFrame())
         return;
     m_onDrawCb();
@@ -224,33 +298,41 @@ bool GuiWindow::onClose() {
 }
 
 void GuiWindow::onFocuse(bool focused) {
+    requestRedraw(Impl::INPUT_REDRAW_FRAMES);
     m_onFocuseCb(focused);
 }
 
 void GuiWindow::onResume(bool resume) {
+    requestRedraw(Impl::INPUT_REDRAW_FRAMES);
     m_onResumeCb(resume);
 }
 
 void GuiWindow::onKeyboardAction(GuiKey key, bool pressed, GuiFlags<GuiModKey> mod) {
+    requestRedraw(Impl::INPUT_REDRAW_FRAMES);
     m_onKeyboardActionCb(key, pressed, mod);
 }
 
 void GuiWindow::onMouseButton(GuiMouseButton button, bool pressed, GuiFlags<GuiModKey> mod) {
+    requestRedraw(Impl::INPUT_REDRAW_FRAMES);
     m_onMouseButtonCb(button, pressed, mod);
 }
 
 void GuiWindow::onMouseScroll(double x, double y) {
+    requestRedraw(Impl::INPUT_REDRAW_FRAMES);
     m_onMouseScrollCb(x, y);
 }
 
 void GuiWindow::onMouseMove(double x, double y) {
+    requestRedraw(Impl::INPUT_REDRAW_FRAMES);
     m_onMouseMoveCb(x, y);
 }
 
 void GuiWindow::onMouseEnter(bool entered) {
+    requestRedraw(Impl::INPUT_REDRAW_FRAMES);
     m_onMouseEnterCb(entered);
 }
 
 void GuiWindow::onDrop(const std::vector<std::string>& paths) {
+    requestRedraw(Impl::INPUT_REDRAW_FRAMES);
     m_onDropCb(paths);
 }
@@ -58,6 +58,8 @@ GuiWindowGLFW::GuiWindowGLFW
 
         GfxVulkanRendererConfig config;
         config.appName = m_title;
+        config.cacheDir = GuiConfig::getCacheDir();
+        config.timelineSemaphores = GuiConfig::getTimelineSemaphores();
         uint32_t glfwExtensionCount = 0;
         const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
         config.extensions.reserve(glfwExtensionCount);
@@ -168,6 +170,17 @@ int GuiWindowGLFW::endFrame() const {
     return 0;
 }
 
+void GuiWindowGLFW::waitEvents(double timeout) const {
+    if (timeout > 0.0)
+        glfwWaitEventsTimeout(timeout);
+    else
+        glfwPollEvents();
+}
+
+void GuiWindowGLFW::postEmptyEvent() const {
+    glfwPostEmptyEvent();
+}
+
 void GuiWindowGLFW::setWindowIcon(const std::vector<GuiIcon>& icons) {
     if (m_window && !icons.empty()) {
         std::vector<GLFWimage> glfwIcons;
@@ -0,0 +1,280 @@
+/**
+ * @file JobSystem.cpp
+ * @brief Implementation of the JobSystem class.
+ */
+
+#include "utils/JobSystem.h"
+
+#include <algorithm>
+
+#include "utils/Tracer.h"
+
+static thread_local int s_workerIndex = -1; // Index of the worker on this thread, -1 if none
+
+void JobSystem::init(int nWorkers) {
+    std::lock_guard<std::mutex> lock(m_initMutex);
+    if (m_running.load())
+        return;
+
+    if (nWorkers <= 0) {
+        int nThreads = static_cast<int>(std::thread::hardware_concurrency());
+        // Leave a thread for the main loop
+        nWorkers = std::max(1, nThreads - 1);
+    }
+    m_workers.clear();
+    for (int i = 0; i < nWorkers; i++)
+        m_workers.push_back(std::make_unique<Worker>());
+    m_running.store(true);
+    for (int i = 0; i < nWorkers; i++)
+        m_threads.emplace_back([this, i] { workerLoop(i); });
+}
+
+void JobSystem::term() {
+    std::lock_guard<std::mutex> lock(m_initMutex);
+    if (!m_running.load())
+        return;
+
+    {
+        std::lock_guard<std::mutex> sleepLock(m_sleepMutex);
+        m_running.store(false);
+    }
+    m_workCv.notify_all();
+    for (auto& thread : m_threads) {
+        if (thread.joinable())
+            thread.join();
+    }
+    m_threads.clear();
+    m_workers.clear();
+}
+
+int JobSystem::getWorkerCount() const {
+    return static_cast<int>(m_workers.size());
+}
+
+Job JobSystem::submit(
+    const std::function<void()>& func,
+    JobPriority priority,
+    const std::vector<Job>& dependencies,
+    const JobCancelToken& token
+) {
+    if (!m_running.load())
+        init();
+
+    Job job = std::make_shared<Job_T>();
+    job->m_func = func;
+    job->m_priority = priority;
+    job->m_token = token;
+    // Hold the job back until all dependencies are registered
+    job->m_nPendingDeps.store(1);
+    for (const auto& dependency : dependencies) {
+        if (!dependency)
+            continue;
+        std::lock_guard<std::mutex> lock(dependency->m_mutex);
+        if (dependency->m_done.load())
+            continue;
+        job->m_nPendingDeps.fetch_add(1);
+        dependency->m_dependents.push_back(job);
+    }
+    if (job->m_nPendingDeps.fetch_sub(1) == 1)
+        enqueue(job);
+    return job;
+}
+
+void JobSystem::wait(const Job& job) {
+    if (!job)
+        return;
+
+    while (!job->m_done.load()) {
+        Job other = dequeue(s_workerIndex);
+        if (other) {
+            execute(other);
+            continue;
+        }
+        m_nWaiters.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_doneCv.wait(lock, [&] { return job->m_done.load() || m_nQueued.load() > 0; });
+        }
+        m_nWaiters.fetch_sub(1);
+    }
+}
+
+void JobSystem::waitAll(const std::vector<Job>& jobs) {
+    for (const auto& job : jobs)
+        wait(job);
+}
+
+void JobSystem::parallelFor(
+    size_t begin,
+    size_t end,
+    size_t grainSize,
+    const std::function<void(size_t, size_t)>& func,
+    JobPriority priority,
+    const JobCancelToken& token
+) {
+    if (end <= begin)
+        return;
+
+    size_t count = end - begin;
+    if (grainSize == 0) {
+        // A few chunks per thread keeps the threads busy when chunks take uneven time
+        if (!m_running.load())
+            init();
+        size_t nChunks = static_cast<size_t>(getWorkerCount() + 1) * 4;
+        grainSize = std::max<size_t>(1, (count + nChunks - 1) / nChunks);
+    }
+    if (count <= grainSize) {
+        if (!token.isCancelled())
+            func(begin, end);
+        return;
+    }
+
+    std::vector<Job> jobs;
+    jobs.reserve((count + grainSize - 1) / grainSize);
+    for (size_t chunkBegin = begin; chunkBegin < end;) {
+        size_t chunkEnd = chunkBegin + std::min(grainSize, end - chunkBegin);
+        // The function outlives the chunks since this call waits for them
+        auto chunkFunc = [&func, chunkBegin, chunkEnd] { func(chunkBegin, chunkEnd); };
+        jobs.push_back(submit(chunkFunc, priority, {}, token));
+        chunkBegin = chunkEnd;
+    }
+    waitAll(jobs);
+}
+
+void JobSystem::postToMainThread(const std::function<void()>& func) {
+    std::function<void()> wakeup = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+        m_mainThreadTasks.push_back(func);
+        wakeup = m_mainThreadWakeup;
+    }
+    if (wakeup)
+        wakeup();
+}
+
+int JobSystem::runMainThreadTasks() {
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+        tasks.swap(m_mainThreadTasks);
+    }
+    for (const auto& task : tasks) {
+        if (task)
+            task();
+    }
+    return static_cast<int>(tasks.size());
+}
+
+void JobSystem::setMainThreadWakeup(const std::function<void()>& func) {
+    std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+    m_mainThreadWakeup = func;
+}
+
+void JobSystem::enqueue(const Job& job) {
+    int nWorkers = getWorkerCount();
+    int workerIndex = s_workerIndex;
+    if (workerIndex < 0 || workerIndex >= nWorkers)
+        workerIndex = static_cast<int>(m_nextWorker.fetch_add(1) % nWorkers);
+    Worker& worker = *m_workers[workerIndex];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.queues[static_cast<int>(job->m_priority)].push_back(job);
+    }
+    m_nQueued.fetch_add(1);
+
+    // Sleeping threads check the counters under the sleep mutex, so taking it here makes sure
+    // they either see the job or are already waiting for the notification
+    bool wakeWorker = m_nSleeping.load() > 0;
+    bool wakeWaiters = m_nWaiters.load() > 0;
+    if (wakeWorker || wakeWaiters) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    if (wakeWorker)
+        m_workCv.notify_one();
+    if (wakeWaiters)
+        m_doneCv.notify_all();
+}
+
+Job JobSystem::dequeue(int workerIndex) {
+    if (m_nQueued.load() <= 0)
+        return nullptr;
+
+    int nWorkers = getWorkerCount();
+    int start = workerIndex >= 0 ? workerIndex : 0;
+    for (int priority = 0; priority < N_PRIORITIES; priority++) {
+        // Newest job of the own queue, its data is likely still in the cache
+        if (workerIndex >= 0) {
+            Worker& worker = *m_workers[workerIndex];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            auto& queue = worker.queues[priority];
+            if (!queue.empty()) {
+                Job job = std::move(queue.back());
+                queue.pop_back();
+                m_nQueued.fetch_sub(1);
+                return job;
+            }
+        }
+        // Oldest job of another queue, it most likely spawns more work
+        for (int i = 0; i < nWorkers; i++) {
+            int victimIndex = (start + i) % nWorkers;
+            if (victimIndex == workerIndex)
+                continue;
+            Worker& victim = *m_workers[victimIndex];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            auto& queue = victim.queues[priority];
+            if (!queue.empty()) {
+                Job job = std::move(queue.front());
+                queue.pop_front();
+                m_nQueued.fetch_sub(1);
+                return job;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(const Job& job) {
+    if (!job->m_token.isCancelled() && job->m_func) {
+        TRACE_SCOPE("Job");
+        job->m_func();
+    }
+    job->m_func = nullptr; // Release the captures early
+
+    std::vector<Job> dependents;
+    {
+        std::lock_guard<std::mutex> lock(job->m_mutex);
+        job->m_done.store(true);
+        dependents.swap(job->m_dependents);
+    }
+    for (const auto& dependent : dependents) {
+        if (dependent->m_nPendingDeps.fetch_sub(1) == 1)
+            enqueue(dependent);
+    }
+
+    if (m_nWaiters.load() > 0) {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+        }
+        m_doneCv.notify_all();
+    }
+}
+
+void JobSystem::workerLoop(int workerIndex) {
+    s_workerIndex = workerIndex;
+    Tracer::instance().setThreadName("Job Worker");
+    while (true) {
+        Job job = dequeue(workerIndex);
+        if (job) {
+            execute(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_nSleeping.fetch_add(1);
+        m_workCv.wait(lock, [this] { return m_nQueued.load() > 0 || !m_running.load(); });
+        m_nSleeping.fetch_sub(1);
+        // Queued jobs are finished before the worker stops
+        if (!m_running.load() && m_nQueued.load() <= 0)
+            break;
+    }
+    s_workerIndex = -1;
+}
@@ -0,0 +1,367 @@
+/**
+ * @file Logger.cpp
+ * @brief Implementation of the Logger and LogSink classes.
+ */
+
+#include "utils/Logger.hpp"
+
+#include <algorithm>
+#include <ctime>
+
+/**
+ * @brief Stream buffer appending to a string, lets nested messages share a thread buffer.
+ */
+class LogStreamBuffer : public std::streambuf {
+public:
+    std::string text = {}; // Text of the messages being formatted on this thread
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (ch != traits_type::eof())
+            text.push_back(static_cast<char>(ch));
+        return ch;
+    }
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        text.append(s, static_cast<size_t>(n));
+        return n;
+    }
+};
+
+/**
+ * @brief Formatting state of a thread, reused by all of its messages.
+ */
+struct LogThreadState {
+    LogStreamBuffer buffer; // Text of the messages being formatted
+    std::ostream stream{ &buffer }; // Stream writing to the buffer
+    uint32_t index = 0; // Index of the thread in log lines
+};
+
+static std::atomic<uint32_t> s_nextThreadIndex{ 1 }; // Index of the next thread that logs
+
+static LogThreadState& getThreadState() {
+    static thread_local LogThreadState state;
+    if (state.index == 0)
+        state.index = s_nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+    return state;
+}
+
+static const char* getLevelName(LogLevel level) {
+    switch (level) {
+    case LogLevel::DEBUG:
+        return "DEBUG";
+    case LogLevel::INFO:
+        return "INFO";
+    case LogLevel::WARN:
+        return "WARN";
+    case LogLevel::ERR:
+        return "ERROR";
+    default:
+        return "";
+    }
+}
+
+static std::optional<LogLevel> parseLevel(std::string name) {
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    if (name == "debug")
+        return LogLevel::DEBUG;
+    if (name == "info")
+        return LogLevel::INFO;
+    if (name == "warn" || name == "warning")
+        return LogLevel::WARN;
+    if (name == "error")
+        return LogLevel::ERR;
+    if (name == "off")
+        return LogLevel::OFF;
+    return std::nullopt;
+}
+
+static std::string trim(const std::string& str) {
+    size_t begin = str.find_first_not_of(" \t");
+    if (begin == std::string::npos)
+        return "";
+    size_t end = str.find_last_not_of(" \t");
+    return str.substr(begin, end - begin + 1);
+}
+
+Logger::Logger(LogLevel level, const char* module) :
+    m_level(level),
+    m_module(module) {
+    if (!LogSink::instance().isEnabled(level, module))
+        return;
+    LogThreadState& state = getThreadState();
+    m_stream = &state.stream;
+    m_offset = state.buffer.text.size();
+}
+
+Logger::~Logger() {
+    if (!m_stream)
+        return;
+    // Messages formatted while this one was open have already been taken off the end
+    std::string& text = getThreadState().buffer.text;
+    LogSink::instance().push(m_level, m_module, text.data() + m_offset, text.size() - m_offset);
+    text.resize(m_offset);
+}
+
+LogSink::LogSink() :
+    m_slots(std::make_unique<std::array<Slot, QUEUE_SIZE>>()) {
+    for (size_t i = 0; i < QUEUE_SIZE; i++)
+        (*m_slots)[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+int LogSink::init(
+    const std::string& directory,
+    const std::string& baseName,
+    size_t maxFileSize,
+    int maxFiles
+) {
+    if (m_running.load())
+        return 0;
+
+    m_directory = directory;
+    m_baseName = baseName;
+    m_maxFileSize = maxFileSize;
+    m_maxFiles = std::max(0, maxFiles);
+    int result = 0;
+    if (!m_directory.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(m_directory, ec);
+        // Every run starts a new file, the previous runs become the rotated files
+        rotate();
+        if (!m_file.is_open())
+            result = 1;
+    }
+
+    m_running.store(true);
+    m_thread = std::thread([this] { sinkLoop(); });
+    return result;
+}
+
+void LogSink::term() {
+    if (!m_running.load())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_running.store(false);
+    }
+    m_wakeCv.notify_one();
+    if (m_thread.joinable())
+        m_thread.join();
+    if (m_file.is_open())
+        m_file.close();
+}
+
+void LogSink::setLevel(LogLevel level) {
+    m_level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+int LogSink::setModuleLevel(const char* module, LogLevel level) {
+    if (!module)
+        return 1;
+
+    std::lock_guard<std::mutex> lock(m_filterMutex);
+    for (auto& filter : m_moduleFilters) {
+        const char* name = filter.module.load(std::memory_order_acquire);
+        if (name && std::strcmp(name, module) != 0)
+            continue;
+        // Set the level before the name so readers never see a new filter without its level
+        filter.level.store(static_cast<int>(level), std::memory_order_relaxed);
+        if (!name)
+            filter.module.store(module, std::memory_order_release);
+        return 0;
+    }
+    return 1;
+}
+
+void LogSink::setFilters(const std::string& filters) {
+    // Module names are kept by pointer, so the names parsed here are never freed
+    static std::mutex namesMutex;
+    static std::vector<std::unique_ptr<std::string>> names;
+
+    std::stringstream ss(filters);
+    std::string entry;
+    while (std::getline(ss, entry, ',')) {
+        size_t separator = entry.find('=');
+        if (separator == std::string::npos) {
+            auto level = parseLevel(trim(entry));
+            if (level)
+                setLevel(level.value());
+            continue;
+        }
+        std::string module = trim(entry.substr(0, separator));
+        auto level = parseLevel(trim(entry.substr(separator + 1)));
+        if (module.empty() || !level)
+            continue;
+        const char* name = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(namesMutex);
+            for (const auto& existing : names) {
+                if (*existing == module)
+                    name = existing->c_str();
+            }
+            if (!name) {
+                names.push_back(std::make_unique<std::string>(module));
+                name = names.back()->c_str();
+            }
+        }
+        setModuleLevel(name, level.value());
+    }
+}
+
+bool LogSink::isEnabled(LogLevel level, const char* module) const {
+    int minLevel = m_level.load(std::memory_order_relaxed);
+    if (module) {
+        for (const auto& filter : m_moduleFilters) {
+            const char* name = filter.module.load(std::memory_order_acquire);
+            if (!name)
+                break;
+            if (name == module || std::strcmp(name, module) == 0) {
+                minLevel = filter.level.load(std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+    return level != LogLevel::OFF && static_cast<int>(level) >= minLevel;
+}
+
+void LogSink::push(LogLevel level, const char* module, const char* text, size_t length) {
+    auto& slots = *m_slots;
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    while (true) {
+        slot = &slots[pos & (QUEUE_SIZE - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // The sink thread has not caught up, never block the caller
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            wakeSink();
+            return;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    slot->level = level;
+    slot->module = module;
+    slot->time = std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+    slot->thread = getThreadState().index;
+    slot->length = static_cast<uint32_t>(std::min(length, MAX_MESSAGE_SIZE));
+    std::memcpy(slot->text, text, slot->length);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    // Errors are written right away in case the application is about to go down
+    if (level >= LogLevel::ERR)
+        wakeSink();
+}
+
+uint64_t LogSink::getDroppedCount() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+void LogSink::sinkLoop() {
+    static constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(100);
+
+    while (true) {
+        bool running = m_running.load();
+        if (drain() > 0 && m_file.is_open())
+            m_file.flush();
+        if (!running)
+            break;
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wakeCv.wait_for(lock, FLUSH_INTERVAL, [this] {
+            return m_wakeRequested.load() || !m_running.load();
+        });
+        m_wakeRequested.store(false);
+    }
+}
+
+void LogSink::wakeSink() {
+    // Producers skip the mutex, a wakeup missed by a sink about to wait is delayed by one
+    // flush interval at most
+    if (!m_wakeRequested.exchange(true) && m_running.load(std::memory_order_relaxed))
+        m_wakeCv.notify_one();
+}
+
+size_t LogSink::drain() {
+    auto& slots = *m_slots;
+    size_t count = 0;
+    std::string line;
+    while (true) {
+        Slot& slot = slots[m_dequeuePos & (QUEUE_SIZE - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1)
+            break;
+
+        std::time_t seconds = static_cast<std::time_t>(slot.time / 1000);
+        std::tm tm = {};
+#ifdef _WIN32
+        localtime_s(&tm, &seconds);
+#else
+        localtime_r(&seconds, &tm);
+#endif
+        char timeText[32] = {};
+        std::strftime(timeText, sizeof(timeText), "%Y-%m-%d %H:%M:%S", &tm);
+        std::ostringstream ss;
+        ss << timeText << '.' << std::setw(3) << std::setfill('0') << slot.time % 1000;
+        ss << " [" << getLevelName(slot.level) << "] [" << slot.thread << "]";
+        if (slot.module)
+            ss << " [" << slot.module << "]";
+        ss << " ";
+        ss.write(slot.text, slot.length);
+        line = ss.str();
+
+        slot.sequence.store(m_dequeuePos + QUEUE_SIZE, std::memory_order_release);
+        m_dequeuePos++;
+        writeLine(line);
+        count++;
+    }
+
+    uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped > m_reportedDrops) {
+        writeLine("Log queue full, dropped " + std::to_string(dropped - m_reportedDrops) +
+            " messages");
+        m_reportedDrops = dropped;
+        count++;
+    }
+    return count;
+}
+
+void LogSink::writeLine(const std::string& line) {
+#ifdef _DEBUG
+    std::cout << line << std::endl;
+#endif
+    if (!m_file.is_open())
+        return;
+    if (m_fileSize > 0 && m_fileSize + line.size() + 1 > m_maxFileSize)
+        rotate();
+    m_file << line << '\n';
+    m_fileSize += line.size() + 1;
+}
+
+void LogSink::rotate() {
+    if (m_file.is_open())
+        m_file.close();
+
+    std::error_code ec;
+    auto getPath = [this](int index) {
+        std::string name = m_baseName;
+        if (index > 0)
+            name += "." + std::to_string(index);
+        return m_directory / name;
+    };
+    if (m_maxFiles > 0) {
+        std::filesystem::remove(getPath(m_maxFiles), ec);
+        for (int i = m_maxFiles - 1; i >= 0; i--) {
+            if (std::filesystem::exists(getPath(i), ec))
+                std::filesystem::rename(getPath(i), getPath(i + 1), ec);
+        }
+    }
+    m_file.open(getPath(0), std::ios::trunc);
+    m_fileSize = 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file MemoryTracker.cpp
+ * @brief Implementation of the MemoryTracker class.
+ */
+
+#include "utils/MemoryTracker.h"
+
+#include <algorithm>
+#include <ctime>
+
+void MemoryTracker::add(MemoryTag tag, uint64_t bytes) {
+    Counters& counters = m_counters[getIndex(tag)];
+    counters.count.fetch_add(1, std::memory_order_relaxed);
+    updatePeak(counters, counters.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+void MemoryTracker::remove(MemoryTag tag, uint64_t bytes) {
+    Counters& counters = m_counters[getIndex(tag)];
+    counters.count.fetch_sub(1, std::memory_order_relaxed);
+    counters.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void MemoryTracker::resize(MemoryTag tag, uint64_t oldBytes, uint64_t newBytes) {
+    Counters& counters = m_counters[getIndex(tag)];
+    if (newBytes >= oldBytes) {
+        uint64_t added = newBytes - oldBytes;
+        updatePeak(counters, counters.bytes.fetch_add(added, std::memory_order_relaxed) + added);
+    } else
+        counters.bytes.fetch_sub(oldBytes - newBytes, std::memory_order_relaxed);
+}
+
+void MemoryTracker::set(MemoryTag tag, const MemoryTagStats& stats) {
+    Counters& counters = m_counters[getIndex(tag)];
+    counters.bytes.store(stats.bytes, std::memory_order_relaxed);
+    counters.count.store(stats.count, std::memory_order_relaxed);
+    updatePeak(counters, std::max(stats.bytes, stats.peakBytes));
+}
+
+MemoryTagStats MemoryTracker::getStats(MemoryTag tag) const {
+    const Counters& counters = m_counters[getIndex(tag)];
+    MemoryTagStats stats{};
+    stats.bytes = counters.bytes.load(std::memory_order_relaxed);
+    stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    stats.count = counters.count.load(std::memory_order_relaxed);
+    return stats;
+}
+
+const char* MemoryTracker::getTagName(MemoryTag tag) {
+    switch (tag) {
+    case MemoryTag::DB_OBJECTS:
+        return "db.objects";
+    case MemoryTag::DB_HISTORY:
+        return "db.history";
+    case MemoryTag::MESH:
+        return "mesh";
+    case MemoryTag::BVH:
+        return "bvh";
+    case MemoryTag::SCENE_BUFFERS:
+        return "scene_buffers";
+    case MemoryTag::TEXTURES:
+        return "textures";
+    case MemoryTag::GPU_VERTEX_BUFFERS:
+        return "gpu.vertex_buffers";
+    case MemoryTag::GPU_INDEX_BUFFERS:
+        return "gpu.index_buffers";
+    case MemoryTag::GPU_UNIFORM_BUFFERS:
+        return "gpu.uniform_buffers";
+    case MemoryTag::GPU_STORAGE_BUFFERS:
+        return "gpu.storage_buffers";
+    case MemoryTag::GPU_TEXTURES:
+        return "gpu.textures";
+    case MemoryTag::GPU_RENDER_TARGETS:
+        return "gpu.render_targets";
+    case MemoryTag::GPU_STORAGE_IMAGES:
+        return "gpu.storage_images";
+    default:
+        return "";
+    }
+}
+
+bool MemoryTracker::isGpuTag(MemoryTag tag) {
+    return tag >= MemoryTag::GPU_VERTEX_BUFFERS && tag < MemoryTag::COUNT;
+}
+
+std::string MemoryTracker::formatBytes(uint64_t bytes) {
+    static constexpr const char* UNITS[] = { "B", "KiB", "MiB", "GiB" };
+    double value = static_cast<double>(bytes);
+    int unit = 0;
+    while (value >= 1024.0 && unit < 3) {
+        value /= 1024.0;
+        unit++;
+    }
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(unit == 0 ? 0 : 2) << value << ' ' << UNITS[unit];
+    return ss.str();
+}
+
+int MemoryTracker::writeReport(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::trunc);
+    if (!file.is_open())
+        return 1;
+
+    std::time_t now = std::time(nullptr);
+    std::tm tm = {};
+#ifdef _WIN32
+    localtime_s(&tm, &now);
+#else
+    localtime_r(&now, &tm);
+#endif
+    char timeText[32] = {};
+    std::strftime(timeText, sizeof(timeText), "%Y-%m-%d %H:%M:%S", &tm);
+    file << "Memory report " << timeText << "\n\n";
+
+    auto writeRow = [&file](const std::string& name, const std::string& bytes,
+        const std::string& peak, const std::string& count) {
+            file << std::left << std::setw(24) << name << std::right << std::setw(14) << bytes;
+            file << std::setw(14) << peak << std::setw(10) << count << '\n';
+        };
+    writeRow("tag", "current", "peak", "count");
+    uint64_t totals[2] = {};
+    for (size_t i = 0; i < N_TAGS; i++) {
+        MemoryTag tag = static_cast<MemoryTag>(i);
+        MemoryTagStats stats = getStats(tag);
+        writeRow(
+            getTagName(tag),
+            formatBytes(stats.bytes),
+            formatBytes(stats.peakBytes),
+            std::to_string(stats.count)
+        );
+        totals[isGpuTag(tag) ? 1 : 0] += stats.bytes;
+    }
+    file << '\n';
+    writeRow("total.cpu", formatBytes(totals[0]), "", "");
+    writeRow("total.gpu", formatBytes(totals[1]), "", "");
+
+    return file.good() ? 0 : 1;
+}
+
+size_t MemoryTracker::getIndex(MemoryTag tag) {
+    size_t index = static_cast<size_t>(tag);
+    return index < N_TAGS ? index : 0;
+}
+
+void MemoryTracker::updatePeak(Counters& counters, uint64_t bytes) {
+    uint64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (bytes > peak &&
+        !counters.peakBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed));
+}
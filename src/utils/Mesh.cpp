@@ -580,6 +580,17 @@ private:
 
 } // namespace MeshParser
 
+size_t Mesh::getMemorySize(const Model& model) {
+    size_t size = model.meshes.capacity() * sizeof(Mesh);
+    for (const auto& mesh : model.meshes) {
+        size += mesh.vertices.capacity() * sizeof(Vertex);
+        size += mesh.submeshes.capacity() * sizeof(SubMesh);
+        for (const auto& submesh : mesh.submeshes)
+            size += submesh.indices.capacity() * sizeof(uint32_t);
+    }
+    return size;
+}
+
 int MeshLoader::loadOBJ(const std::string& filename, Mesh::Model& model) {
     model.meshes.clear();
     std::filesystem::path filePath(filename);
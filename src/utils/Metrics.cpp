@@ -0,0 +1,309 @@
+/**
+ * @file Metrics.cpp
+ * @brief Implementation of the MetricsRegistry class and its metric types.
+ */
+
+#include "utils/Metrics.h"
+
+#include <algorithm>
+
+/**
+ * @brief Update an atomic value with a function of its current value.
+ * @param value The atomic value.
+ * @param func Function returning the new value from the current one.
+ */
+template<typename T, typename Func>
+static void atomicUpdate(std::atomic<T>& value, Func func) {
+    T current = value.load(std::memory_order_relaxed);
+    while (!value.compare_exchange_weak(current, func(current), std::memory_order_relaxed));
+}
+
+/**
+ * @brief Write a string as a JSON string literal.
+ * @param out The stream to write to.
+ * @param str The string.
+ */
+static void writeJsonString(std::ostream& out, const std::string& str) {
+    out << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+            out << ' ';
+        else
+            out << c;
+    }
+    out << '"';
+}
+
+/**
+ * @brief Write a string as a CSV field.
+ * @param out The stream to write to.
+ * @param str The string.
+ */
+static void writeCsvField(std::ostream& out, const std::string& str) {
+    if (str.find_first_of(",\"\n") == std::string::npos) {
+        out << str;
+        return;
+    }
+    out << '"';
+    for (char c : str) {
+        if (c == '"')
+            out << '"';
+        out << c;
+    }
+    out << '"';
+}
+
+static const char* getTypeName(MetricType type) {
+    switch (type) {
+    case MetricType::COUNTER:
+        return "counter";
+    case MetricType::GAUGE:
+        return "gauge";
+    case MetricType::HISTOGRAM:
+        return "histogram";
+    default:
+        return "";
+    }
+}
+
+MetricHistogram::MetricHistogram(const std::vector<double>& bounds) :
+    m_bounds(bounds),
+    m_buckets(std::make_unique<std::atomic<uint64_t>[]>(bounds.size() + 1)) {
+    std::sort(m_bounds.begin(), m_bounds.end());
+    reset();
+}
+
+void MetricHistogram::record(double value) {
+    size_t bucket = std::lower_bound(m_bounds.begin(), m_bounds.end(), value) - m_bounds.begin();
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    atomicUpdate(m_sum, [value](double sum) { return sum + value; });
+    atomicUpdate(m_min, [value](double min) { return std::min(min, value); });
+    atomicUpdate(m_max, [value](double max) { return std::max(max, value); });
+    m_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MetricHistogram::reset() {
+    for (size_t i = 0; i <= m_bounds.size(); i++)
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0.0, std::memory_order_relaxed);
+    m_min.store(std::numeric_limits<double>::max(), std::memory_order_relaxed);
+    m_max.store(std::numeric_limits<double>::lowest(), std::memory_order_relaxed);
+}
+
+double MetricHistogram::getMin() const {
+    return getCount() > 0 ? m_min.load(std::memory_order_relaxed) : 0.0;
+}
+
+double MetricHistogram::getMax() const {
+    return getCount() > 0 ? m_max.load(std::memory_order_relaxed) : 0.0;
+}
+
+double MetricHistogram::getPercentile(double percentile) const {
+    uint64_t total = 0;
+    for (size_t i = 0; i <= m_bounds.size(); i++)
+        total += m_buckets[i].load(std::memory_order_relaxed);
+    if (total == 0)
+        return 0.0;
+
+    double rank = std::clamp(percentile, 0.0, 100.0) * 0.01 * static_cast<double>(total);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < m_bounds.size(); i++) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (static_cast<double>(seen) >= rank)
+            return std::min(m_bounds[i], getMax());
+    }
+    // Above the last bound, the largest value is the best estimate left
+    return getMax();
+}
+
+MetricCounter& MetricsRegistry::counter(const std::string& name, const std::string& unit) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry* entry = getEntry(name, MetricType::COUNTER, unit);
+    if (!entry) {
+        // The name is taken by another type, hand out a metric nobody exports
+        static MetricCounter s_orphan;
+        return s_orphan;
+    }
+    if (!entry->counter)
+        entry->counter = std::make_unique<MetricCounter>();
+    return *entry->counter;
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name, const std::string& unit) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry* entry = getEntry(name, MetricType::GAUGE, unit);
+    if (!entry) {
+        static MetricGauge s_orphan;
+        return s_orphan;
+    }
+    if (!entry->gauge)
+        entry->gauge = std::make_unique<MetricGauge>();
+    return *entry->gauge;
+}
+
+MetricHistogram& MetricsRegistry::histogram(
+    const std::string& name,
+    const std::string& unit,
+    const std::vector<double>& bounds
+) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry* entry = getEntry(name, MetricType::HISTOGRAM, unit);
+    if (!entry) {
+        static MetricHistogram s_orphan({});
+        return s_orphan;
+    }
+    if (!entry->histogram)
+        entry->histogram = std::make_unique<MetricHistogram>(bounds);
+    return *entry->histogram;
+}
+
+void MetricsRegistry::setLabel(const std::string& key, const std::string& value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_labels[key] = value;
+}
+
+std::vector<MetricSnapshot> MetricsRegistry::snapshot() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<MetricSnapshot> snapshots;
+    snapshots.reserve(m_entries.size());
+    for (const auto& [name, entry] : m_entries) {
+        MetricSnapshot snapshot = {};
+        snapshot.name = name;
+        snapshot.unit = entry.unit;
+        snapshot.type = entry.type;
+        switch (entry.type) {
+        case MetricType::COUNTER:
+            snapshot.value = static_cast<double>(entry.counter->get());
+            break;
+        case MetricType::GAUGE:
+            snapshot.value = entry.gauge->get();
+            break;
+        case MetricType::HISTOGRAM:
+            snapshot.count = entry.histogram->getCount();
+            if (snapshot.count > 0)
+                snapshot.value = entry.histogram->getSum() / static_cast<double>(snapshot.count);
+            snapshot.min = entry.histogram->getMin();
+            snapshot.max = entry.histogram->getMax();
+            snapshot.p50 = entry.histogram->getPercentile(50.0);
+            snapshot.p95 = entry.histogram->getPercentile(95.0);
+            break;
+        default:
+            break;
+        }
+        snapshots.push_back(snapshot);
+    }
+    return snapshots;
+}
+
+void MetricsRegistry::reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& [name, entry] : m_entries) {
+        if (entry.counter)
+            entry.counter->reset();
+        if (entry.histogram)
+            entry.histogram->reset();
+    }
+}
+
+int MetricsRegistry::exportJson(const std::string& filename) const {
+    std::map<std::string, std::string> labels;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        labels = m_labels;
+    }
+    std::vector<MetricSnapshot> snapshots = snapshot();
+
+    std::ofstream file(filename, std::ios::trunc);
+    if (!file.is_open())
+        return 1;
+
+    file << std::setprecision(10);
+    file << "{\n  \"labels\": {";
+    bool first = true;
+    for (const auto& [key, value] : labels) {
+        file << (first ? "\n    " : ",\n    ");
+        writeJsonString(file, key);
+        file << ": ";
+        writeJsonString(file, value);
+        first = false;
+    }
+    file << (first ? "},\n" : "\n  },\n");
+    file << "  \"metrics\": [";
+    first = true;
+    for (const auto& snapshot : snapshots) {
+        file << (first ? "\n    {" : ",\n    {");
+        first = false;
+        file << "\"name\": ";
+        writeJsonString(file, snapshot.name);
+        file << ", \"type\": \"" << getTypeName(snapshot.type) << "\", \"unit\": ";
+        writeJsonString(file, snapshot.unit);
+        file << ", \"value\": " << snapshot.value;
+        if (snapshot.type == MetricType::HISTOGRAM) {
+            file << ", \"count\": " << snapshot.count << ", \"min\": " << snapshot.min;
+            file << ", \"max\": " << snapshot.max << ", \"p50\": " << snapshot.p50;
+            file << ", \"p95\": " << snapshot.p95;
+        }
+        file << "}";
+    }
+    file << (first ? "]\n}\n" : "\n  ]\n}\n");
+
+    return file.good() ? 0 : 1;
+}
+
+int MetricsRegistry::exportCsv(const std::string& filename) const {
+    std::map<std::string, std::string> labels;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        labels = m_labels;
+    }
+    std::vector<MetricSnapshot> snapshots = snapshot();
+
+    std::error_code ec;
+    bool newFile = !std::filesystem::exists(filename, ec);
+    std::ofstream file(filename, std::ios::app);
+    if (!file.is_open())
+        return 1;
+
+    // Labels go into one column as key=value pairs, so the columns stay fixed across runs
+    std::string labelText;
+    for (const auto& [key, value] : labels) {
+        if (!labelText.empty())
+            labelText += ";";
+        labelText += key + "=" + value;
+    }
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    int64_t time = std::chrono::duration_cast<std::chrono::seconds>(now).count();
+
+    if (newFile)
+        file << "time,labels,name,type,unit,value,count,min,max,p50,p95\n";
+    file << std::setprecision(10);
+    for (const auto& snapshot : snapshots) {
+        file << time << ',';
+        writeCsvField(file, labelText);
+        file << ',';
+        writeCsvField(file, snapshot.name);
+        file << ',' << getTypeName(snapshot.type) << ',';
+        writeCsvField(file, snapshot.unit);
+        file << ',' << snapshot.value << ',' << snapshot.count << ',' << snapshot.min << ',';
+        file << snapshot.max << ',' << snapshot.p50 << ',' << snapshot.p95 << '\n';
+    }
+
+    return file.good() ? 0 : 1;
+}
+
+MetricsRegistry::Entry* MetricsRegistry::getEntry(
+    const std::string& name,
+    MetricType type,
+    const std::string& unit
+) {
+    auto it = m_entries.find(name);
+    if (it != m_entries.end())
+        return it->second.type == type ? &it->second : nullptr;
+    Entry& entry = m_entries[name];
+    entry.type = type;
+    entry.unit = unit;
+    return &entry;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file StartupProfiler.cpp
+ * @brief Implementation of the StartupProfiler class.
+ */
+
+#include "utils/StartupProfiler.h"
+
+#include <algorithm>
+
+void StartupProfiler::begin() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_begin = std::chrono::steady_clock::now();
+    m_mainThread = std::this_thread::get_id();
+    m_phases.clear();
+    m_firstFrameMs = 0.0;
+    m_finished = false;
+}
+
+void StartupProfiler::record(
+    const std::string& name,
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end
+) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_finished)
+        return;
+    StartupPhaseRecord phase{};
+    phase.name = name;
+    phase.startMs = std::chrono::duration<double, std::milli>(start - m_begin).count();
+    phase.durationMs = std::chrono::duration<double, std::milli>(end - start).count();
+    phase.mainThread = std::this_thread::get_id() == m_mainThread;
+    m_phases.push_back(phase);
+}
+
+double StartupProfiler::finish() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_finished) {
+        m_firstFrameMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - m_begin
+        ).count();
+        m_finished = true;
+    }
+    return m_firstFrameMs;
+}
+
+bool StartupProfiler::isFinished() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_finished;
+}
+
+std::vector<StartupPhaseRecord> StartupProfiler::getPhases() const {
+    std::vector<StartupPhaseRecord> phases;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        phases = m_phases;
+    }
+    std::stable_sort(
+        phases.begin(),
+        phases.end(),
+        [](const StartupPhaseRecord& a, const StartupPhaseRecord& b) {
+            return a.startMs < b.startMs;
+        }
+    );
+    return phases;
+}
+
+std::string StartupProfiler::getSummary() const {
+    std::vector<StartupPhaseRecord> phases = getPhases();
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(0);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ss << "first frame after " << m_firstFrameMs << " ms";
+    }
+    if (phases.empty())
+        return ss.str();
+    ss << " (";
+    for (size_t i = 0; i < phases.size(); i++) {
+        if (i > 0)
+            ss << ", ";
+        ss << phases[i].name << ' ' << phases[i].durationMs << " ms";
+        if (!phases[i].mainThread)
+            ss << " async";
+    }
+    ss << ')';
+    return ss.str();
+}
+
+int StartupProfiler::writeReport(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::trunc);
+    if (!file.is_open())
+        return 1;
+
+    std::vector<StartupPhaseRecord> phases = getPhases();
+    file << std::fixed << std::setprecision(2);
+    file << std::left << std::setw(24) << "phase" << std::right << std::setw(12) << "start_ms";
+    file << std::setw(12) << "duration_ms" << std::setw(10) << "thread" << '\n';
+    for (const auto& phase : phases) {
+        file << std::left << std::setw(24) << phase.name << std::right;
+        file << std::setw(12) << phase.startMs << std::setw(12) << phase.durationMs;
+        file << std::setw(10) << (phase.mainThread ? "main" : "worker") << '\n';
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        file << '\n' << std::left << std::setw(24) << "first_frame" << std::right;
+        file << std::setw(12) << m_firstFrameMs << '\n';
+    }
+
+    return file.good() ? 0 : 1;
+}
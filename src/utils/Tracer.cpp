@@ -0,0 +1,169 @@
+/**
+ * @file Tracer.cpp
+ * @brief Implementation of the Tracer class.
+ */
+
+#include "utils/Tracer.h"
+
+std::atomic<bool> Tracer::s_enabled{ false };
+
+static thread_local void* s_threadBuffer = nullptr; // Buffer of this thread, set on first use
+
+/**
+ * @brief Write a string as a JSON string literal.
+ * @param out The stream to write to.
+ * @param str The string.
+ */
+static void writeJsonString(std::ostream& out, const char* str) {
+    out << '"';
+    for (const char* c = str ? str : ""; *c; c++) {
+        if (*c == '"' || *c == '\\')
+            out << '\\' << *c;
+        else if (static_cast<unsigned char>(*c) < 0x20)
+            out << ' ';
+        else
+            out << *c;
+    }
+    out << '"';
+}
+
+Tracer::Tracer() :
+    m_epoch(std::chrono::steady_clock::now()) {}
+
+int64_t Tracer::now() const {
+    auto elapsed = std::chrono::steady_clock::now() - m_epoch;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+void Tracer::scope(const char* name, int64_t begin, int64_t end) {
+    Event event = {};
+    event.name = name;
+    event.time = begin;
+    event.duration = end - begin;
+    event.phase = 'X';
+    record(event);
+}
+
+void Tracer::counter(const char* name, double value) {
+    Event event = {};
+    event.name = name;
+    event.time = now();
+    event.value = value;
+    event.phase = 'C';
+    record(event);
+}
+
+void Tracer::flowBegin(const char* name, uint64_t id) {
+    Event event = {};
+    event.name = name;
+    event.time = now();
+    event.id = id;
+    event.phase = 's';
+    record(event);
+}
+
+void Tracer::flowEnd(const char* name, uint64_t id) {
+    Event event = {};
+    event.name = name;
+    event.time = now();
+    event.id = id;
+    event.phase = 'f';
+    record(event);
+}
+
+void Tracer::setThreadName(const char* name) {
+    getThreadBuffer().threadName.store(name, std::memory_order_release);
+}
+
+int Tracer::exportChromeTrace(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::trunc);
+    if (!file.is_open())
+        return 1;
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    auto beginEvent = [&]() {
+        if (!first)
+            file << ",\n";
+        first = false;
+    };
+
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    for (const auto& buffer : m_buffers) {
+        const char* threadName = buffer->threadName.load(std::memory_order_acquire);
+        if (threadName) {
+            beginEvent();
+            file << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid;
+            file << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+            writeJsonString(file, threadName);
+            file << "}}";
+        }
+
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            const auto* chunk = buffer->chunks[i / CHUNK_SIZE].load(std::memory_order_acquire);
+            const Event& event = (*chunk)[i % CHUNK_SIZE];
+            beginEvent();
+            // Chrome traces count in microseconds, keep the nanoseconds as fractions
+            file << "{\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":" << buffer->tid;
+            file << ",\"ts\":" << static_cast<double>(event.time) * 1e-3 << ",\"name\":";
+            writeJsonString(file, event.name);
+            switch (event.phase) {
+            case 'X':
+                file << ",\"dur\":" << static_cast<double>(event.duration) * 1e-3;
+                break;
+            case 'C':
+                file << ",\"args\":{\"value\":" << event.value << "}";
+                break;
+            case 's':
+            case 'f':
+                file << ",\"cat\":\"flow\",\"id\":" << event.id << ",\"bp\":\"e\"";
+                break;
+            default:
+                break;
+            }
+            file << "}";
+        }
+    }
+    file << "\n]}\n";
+
+    return file.good() ? 0 : 1;
+}
+
+uint64_t Tracer::getDroppedEventCount() const {
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    uint64_t dropped = 0;
+    for (const auto& buffer : m_buffers)
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    return dropped;
+}
+
+Tracer::ThreadBuffer& Tracer::getThreadBuffer() {
+    if (!s_threadBuffer) {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        m_buffers.push_back(std::make_unique<ThreadBuffer>());
+        m_buffers.back()->tid = static_cast<uint32_t>(m_buffers.size());
+        s_threadBuffer = m_buffers.back().get();
+    }
+    return *static_cast<ThreadBuffer*>(s_threadBuffer);
+}
+
+void Tracer::record(const Event& event) {
+    ThreadBuffer& buffer = getThreadBuffer();
+    // Only this thread writes the count, the relaxed load reads its own last store
+    size_t index = buffer.count.load(std::memory_order_relaxed);
+    size_t chunkIndex = index / CHUNK_SIZE;
+    if (chunkIndex >= MAX_CHUNKS) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ThreadBuffer::Chunk* chunk = buffer.chunks[chunkIndex].load(std::memory_order_relaxed);
+    if (!chunk) {
+        buffer.ownedChunks.push_back(std::make_unique<ThreadBuffer::Chunk>());
+        chunk = buffer.ownedChunks.back().get();
+        buffer.chunks[chunkIndex].store(chunk, std::memory_order_release);
+    }
+    (*chunk)[index % CHUNK_SIZE] = event;
+    buffer.count.store(index + 1, std::memory_order_release);
+}
@@ -0,0 +1,76 @@
+/**
+ * @file TestCommon.h
+ * @brief Checks and timing helpers shared by the test and benchmark executables.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+namespace Test {
+
+/**
+ * @brief Get the number of failed checks of the executable.
+ * @return Reference to the counter.
+ */
+inline int& getFailureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+/**
+ * @brief Report a failed check.
+ * @param file Source file of the check.
+ * @param line Source line of the check.
+ * @param what Description of the failure.
+ */
+inline void fail(const char* file, int line, const std::string& what) {
+    std::cerr << file << ":" << line << ": check failed: " << what << std::endl;
+    getFailureCount()++;
+}
+
+/**
+ * @brief Get the exit code of a test executable and print its summary.
+ * @param name Name of the test.
+ * @return 0 if all checks passed, 1 otherwise.
+ */
+inline int finish(const char* name) {
+    int failures = getFailureCount();
+    if (failures > 0)
+        std::cout << name << ": " << failures << " check(s) failed" << std::endl;
+    else
+        std::cout << name << ": passed" << std::endl;
+    return failures > 0 ? 1 : 0;
+}
+
+/**
+ * @brief Get the time elapsed since a point in seconds.
+ * @param start The point.
+ * @return Elapsed seconds.
+ */
+inline double getSeconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace Test
+
+// Record a failure if the condition is false, the test keeps running
+#define TEST_CHECK(cond) \
+    do { \
+        if (!(cond)) \
+            Test::fail(__FILE__, __LINE__, #cond); \
+    } while (0)
+
+// Record a failure if two values differ by more than a tolerance
+#define TEST_CHECK_NEAR(a, b, tolerance) \
+    do { \
+        double testA = static_cast<double>(a); \
+        double testB = static_cast<double>(b); \
+        if (!(std::abs(testA - testB) <= static_cast<double>(tolerance))) { \
+            Test::fail(__FILE__, __LINE__, std::string(#a " ~ " #b ": ") + \
+                std::to_string(testA) + " vs " + std::to_string(testB)); \
+        } \
+    } while (0)
@@ -0,0 +1,316 @@
+/**
+ * @file PathTracerConformanceTest.cpp
+ * @brief Energy conservation and analytic radiance checks of the path tracing kernel.
+ * @note Runs the CPU port of the shader, see PathTracerReference.
+ */
+
+#include "TestCommon.h"
+#include "app/core/PathTracerReference.h"
+
+using Ref = PathTracerReference;
+
+static const std::vector<float> WAVE_NUMBERS = { 500.0f, 1000.0f, 1500.0f, 2000.0f };
+static constexpr float SKY_TEMPERATURE = 300.0f; // Temperature of the furnace sky in Celsius
+
+/**
+ * @brief Mean and standard error of a series of samples.
+ */
+struct Estimate {
+    double sum = 0.0; // Sum of the samples
+    double sumSquares = 0.0; // Sum of the squared samples
+    size_t count = 0; // Number of samples
+
+    void add(double value) {
+        sum += value;
+        sumSquares += value * value;
+        count++;
+    };
+    double mean() const { return count > 0 ? sum / count : 0.0; };
+    double standardError() const {
+        if (count < 2)
+            return 0.0;
+        double variance = (sumSquares - sum * sum / count) / (count - 1);
+        return std::sqrt(std::max(0.0, variance) / count);
+    };
+};
+
+/**
+ * @brief Set up the spectral scene, every wavelength sample shares the emissivity.
+ * @param ref The reference kernel.
+ * @param emissivities Emissivity of each spectral material.
+ * @param idxSky Spectral material of the sky.
+ * @param skyTemperature Temperature of the sky in Celsius.
+ */
+static void setSpectrum(
+    Ref& ref,
+    const std::vector<float>& emissivities,
+    uint32_t idxSky,
+    float skyTemperature
+) {
+    ref.waveNumbers = WAVE_NUMBERS;
+    ref.spScene.nWaves = static_cast<int>(WAVE_NUMBERS.size());
+    ref.spScene.idxSkyMaterial = idxSky;
+    ref.spScene.skyTemperature = skyTemperature;
+    ref.emissivities.clear();
+    for (float emissivity : emissivities)
+        ref.emissivities.insert(ref.emissivities.end(), WAVE_NUMBERS.size(), emissivity);
+}
+
+/**
+ * @brief Set up a small image looking at the origin from -Z.
+ * @param ref The reference kernel.
+ * @param traceDepth Maximum number of bounces.
+ */
+static void setView(Ref& ref, int traceDepth) {
+    ref.scene.resX = 32;
+    ref.scene.resY = 24;
+    ref.scene.traceDepth = traceDepth;
+    ref.camera.pos = Math::Vec4(0.0f, 0.0f, -4.0f, 1.0f);
+    ref.camera.dir = Math::Vec4(0.0f, 0.0f, 1.0f, 0.0f);
+    ref.camera.up = Math::Vec4(0.0f, 1.0f, 0.0f, 0.0f);
+    ref.camera.focusDist = 4.0f;
+}
+
+/**
+ * @brief Create a material that emits through its spectral material only.
+ * @param type Material type.
+ * @param idxSpMaterial Spectral material.
+ * @return The material.
+ */
+static Ref::Material makeMaterial(int type, uint32_t idxSpMaterial) {
+    Ref::Material material = {};
+    material.type = type;
+    material.roughness = 0.5f;
+    material.temperature = 0.0f;
+    material.ior = 1.5f;
+    material.idxSpMaterial = idxSpMaterial;
+    return material;
+}
+
+/**
+ * @brief Trace every pixel of the image for some samples in a furnace, a scene without
+ *        emitters under a uniform sky.
+ * @param ref The reference kernel with the scene set up.
+ * @param nSamples Samples per pixel.
+ * @param[out] maxError Largest relative difference of a path from the sky radiance.
+ * @return Ratio of the path radiance to the sky radiance over all paths.
+ */
+static Estimate traceFurnace(Ref& ref, int nSamples, double& maxError) {
+    Estimate ratio;
+    maxError = 0.0;
+    for (int sample = 1; sample <= nSamples; sample++) {
+        ref.scene.currentSample = sample;
+        for (int y = 0; y < ref.scene.resY; y++) {
+            for (int x = 0; x < ref.scene.resX; x++) {
+                int idxWave = 0;
+                float radiance = ref.samplePixel(x, y, idxWave);
+                double sky = Ref::bbp(SKY_TEMPERATURE, WAVE_NUMBERS[idxWave]);
+                double value = radiance / (sky * ref.spScene.nWaves);
+                ratio.add(value);
+                maxError = std::max(maxError, std::isfinite(value) ? std::abs(value - 1.0) : 1e9);
+            }
+        }
+    }
+    return ratio;
+}
+
+/**
+ * @brief Every path of a furnace with a closed convex object and a lossless material
+ *        returns the sky radiance, whichever way it bounces.
+ * @param type Material type of the object.
+ * @param name Name of the case.
+ */
+static void testConvexFurnace(int type, const char* name) {
+    std::vector<Ref::Vertex> vertices;
+    std::vector<Ref::Triangle> triangles;
+    Ref::addSphere(vertices, triangles, Math::Vec3(0.0f), 1.0f, 96, 0);
+
+    Ref ref;
+    ref.buildScene(vertices, triangles, { makeMaterial(type, 1) });
+    setSpectrum(ref, { 1.0f, 0.0f }, 0, SKY_TEMPERATURE);
+    setView(ref, 8);
+
+    double maxError = 0.0;
+    Estimate ratio = traceFurnace(ref, 4, maxError);
+    std::cout << name << " furnace: mean " << ratio.mean() << ", max path error " <<
+        maxError << std::endl;
+    TEST_CHECK(ref.getStats().rays > ref.getStats().paths); // The sphere has been hit
+    TEST_CHECK_NEAR(maxError, 0.0, 1e-4);
+}
+
+/**
+ * @brief The mean radiance of a furnace with lossless materials is the sky radiance even when
+ *        paths bounce many times, Russian roulette must not lose or add energy.
+ * @param type Material type of the object inside a white diffuse box.
+ * @param name Name of the case.
+ */
+static void testConcaveFurnace(int type, const char* name) {
+    // A box open towards the camera with a sphere inside
+    std::vector<Ref::Vertex> vertices;
+    std::vector<Ref::Triangle> triangles;
+    Math::Vec3 x(2.0f, 0.0f, 0.0f), y(0.0f, 2.0f, 0.0f), z(0.0f, 0.0f, 2.0f);
+    Math::Vec3 corner(-1.0f, -1.0f, -1.0f);
+    Ref::addQuad(vertices, triangles, corner + z, x, y, 0); // Back
+    Ref::addQuad(vertices, triangles, corner, z, y, 0); // Left
+    Ref::addQuad(vertices, triangles, corner + x, y, z, 0); // Right
+    Ref::addQuad(vertices, triangles, corner, x, z, 0); // Bottom
+    Ref::addQuad(vertices, triangles, corner + y, z, x, 0); // Top
+    Ref::addSphere(vertices, triangles, Math::Vec3(0.0f, -0.5f, 0.3f), 0.4f, 32, 1);
+
+    Ref ref;
+    ref.buildScene(
+        vertices,
+        triangles,
+        { makeMaterial(Ref::MATERIAL_TYPE_DIFFUSE, 1), makeMaterial(type, 1) }
+    );
+    setSpectrum(ref, { 1.0f, 0.0f }, 0, SKY_TEMPERATURE);
+    setView(ref, 256);
+
+    double maxError = 0.0;
+    Estimate ratio = traceFurnace(ref, 64, maxError);
+    double tolerance = 4.0 * ratio.standardError() + 0.002;
+    std::cout << name << " open box furnace: mean " << ratio.mean() << " +- " <<
+        ratio.standardError() << ", " << ref.getStats().rays / double(ref.getStats().paths) <<
+        " rays per path" << std::endl;
+    TEST_CHECK_NEAR(ratio.mean(), 1.0, tolerance);
+}
+
+/**
+ * @brief A glossy material may absorb energy but never creates any.
+ */
+static void testGlossyFurnace() {
+    std::vector<Ref::Vertex> vertices;
+    std::vector<Ref::Triangle> triangles;
+    Ref::addSphere(vertices, triangles, Math::Vec3(0.0f), 1.0f, 96, 0);
+
+    Ref ref;
+    ref.buildScene(vertices, triangles, { makeMaterial(Ref::MATERIAL_TYPE_GLOSSY, 1) });
+    setSpectrum(ref, { 1.0f, 0.0f }, 0, SKY_TEMPERATURE);
+    setView(ref, 8);
+
+    double maxError = 0.0;
+    Estimate ratio = traceFurnace(ref, 16, maxError);
+    std::cout << "Glossy furnace: mean " << ratio.mean() << " +- " << ratio.standardError() <<
+        std::endl;
+    TEST_CHECK(std::isfinite(ratio.mean()));
+    TEST_CHECK(ratio.mean() > 0.0);
+    TEST_CHECK(ratio.mean() <= 1.0 + 4.0 * ratio.standardError());
+}
+
+/**
+ * @brief A diffuse emitter seen directly under a black sky returns its blackbody radiance
+ *        scaled by its emissivity, its reflections only see the black sky.
+ */
+static void testDirectEmitter() {
+    static constexpr float EMISSIVITY = 0.8f;
+    static constexpr float TEMPERATURE = 500.0f;
+    std::vector<Ref::Vertex> vertices;
+    std::vector<Ref::Triangle> triangles;
+    Ref::addQuad(
+        vertices,
+        triangles,
+        Math::Vec3(-50.0f, -50.0f, 1.0f),
+        Math::Vec3(100.0f, 0.0f, 0.0f),
+        Math::Vec3(0.0f, 100.0f, 0.0f),
+        0
+    );
+    Ref::Material emitter = makeMaterial(Ref::MATERIAL_TYPE_DIFFUSE, 1);
+    emitter.temperature = TEMPERATURE;
+
+    Ref ref;
+    ref.buildScene(vertices, triangles, { emitter });
+    setSpectrum(ref, { 0.0f, EMISSIVITY }, 0, SKY_TEMPERATURE);
+    setView(ref, 4);
+
+    double maxError = 0.0;
+    for (int y = 0; y < ref.scene.resY; y++) {
+        for (int x = 0; x < ref.scene.resX; x++) {
+            int idxWave = 0;
+            float radiance = ref.samplePixel(x, y, idxWave);
+            double expected = EMISSIVITY * Ref::bbp(TEMPERATURE, WAVE_NUMBERS[idxWave]) *
+                ref.spScene.nWaves;
+            maxError = std::max(maxError, std::abs(radiance / expected - 1.0));
+        }
+    }
+    std::cout << "Direct emitter: max path error " << maxError << std::endl;
+    TEST_CHECK_NEAR(maxError, 0.0, 1e-5);
+}
+
+/**
+ * @brief Get the form factor from a point to a parallel rectangle with a corner right above it.
+ * @param a Width of the rectangle over its height above the point.
+ * @param b Length of the rectangle over its height above the point.
+ * @return The form factor.
+ */
+static double getCornerFormFactor(double a, double b) {
+    double sa = std::sqrt(1.0 + a * a);
+    double sb = std::sqrt(1.0 + b * b);
+    return (a / sa * std::atan(b / sa) + b / sb * std::atan(a / sb)) / (2.0 * Math::PI);
+}
+
+/**
+ * @brief A white diffuse floor under a square emitter reflects the emitted radiance times the
+ *        form factor from the floor to the emitter, with a single bounce allowed.
+ */
+static void testEmitterOverFloor() {
+    static constexpr float EMISSIVITY = 0.9f;
+    static constexpr float TEMPERATURE = 800.0f;
+    static constexpr float HALF_SIZE = 1.0f; // Half the side of the emitter
+    static constexpr float HEIGHT = 1.0f; // Height of the emitter above the floor
+    std::vector<Ref::Vertex> vertices;
+    std::vector<Ref::Triangle> triangles;
+    Ref::addQuad(
+        vertices,
+        triangles,
+        Math::Vec3(-100.0f, 0.0f, -100.0f),
+        Math::Vec3(0.0f, 0.0f, 200.0f),
+        Math::Vec3(200.0f, 0.0f, 0.0f),
+        0
+    );
+    Ref::addQuad(
+        vertices,
+        triangles,
+        Math::Vec3(-HALF_SIZE, HEIGHT, -HALF_SIZE),
+        Math::Vec3(2.0f * HALF_SIZE, 0.0f, 0.0f),
+        Math::Vec3(0.0f, 0.0f, 2.0f * HALF_SIZE),
+        1
+    );
+    Ref::Material emitter = makeMaterial(Ref::MATERIAL_TYPE_DIFFUSE, 1);
+    emitter.temperature = TEMPERATURE;
+
+    Ref ref;
+    ref.buildScene(vertices, triangles, { makeMaterial(Ref::MATERIAL_TYPE_DIFFUSE, 0), emitter });
+    setSpectrum(ref, { 0.0f, EMISSIVITY }, 0, SKY_TEMPERATURE);
+    // The camera ray hits the floor and its bounce ends the path
+    ref.scene.traceDepth = 2;
+
+    static constexpr int N_PATHS = 400000;
+    static constexpr int IDX_WAVE = 1;
+    double emitted = EMISSIVITY * Ref::bbp(TEMPERATURE, WAVE_NUMBERS[IDX_WAVE]);
+    Ref::Ray ray;
+    ray.origin = Math::Vec3(0.0f, 0.5f * HEIGHT, 0.0f);
+    ray.direction = Math::Vec3(0.0f, -1.0f, 0.0f);
+    Estimate ratio;
+    for (int i = 0; i < N_PATHS; i++) {
+        ref.initRngState(i, 0, 1);
+        ratio.add(ref.trace(ray, IDX_WAVE) / emitted);
+    }
+
+    double formFactor = 4.0 * getCornerFormFactor(HALF_SIZE / HEIGHT, HALF_SIZE / HEIGHT);
+    double tolerance = 4.0 * ratio.standardError() + 0.002;
+    std::cout << "Emitter over floor: " << ratio.mean() << " +- " << ratio.standardError() <<
+        ", form factor " << formFactor << std::endl;
+    TEST_CHECK_NEAR(ratio.mean(), formFactor, tolerance);
+}
+
+int main() {
+    testConvexFurnace(Ref::MATERIAL_TYPE_DIFFUSE, "Diffuse");
+    testConvexFurnace(Ref::MATERIAL_TYPE_SPECULAR, "Specular");
+    testConcaveFurnace(Ref::MATERIAL_TYPE_DIFFUSE, "Diffuse");
+    testConcaveFurnace(Ref::MATERIAL_TYPE_SPECULAR, "Specular");
+    testConcaveFurnace(Ref::MATERIAL_TYPE_TRANSLUCENT, "Translucent");
+    testGlossyFurnace();
+    testDirectEmitter();
+    testEmitterOverFloor();
+    return Test::finish("PathTracerConformanceTest");
+}
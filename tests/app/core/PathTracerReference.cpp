@@ -0,0 +1,690 @@
+/**
+ * @file PathTracerReference.cpp
+ * @brief Implementation of the CPU port of the path tracing kernel.
+ */
+
+#include "PathTracerReference.h"
+
+static constexpr float SHADER_PI = 3.14159265359f; // PI as written in the shader
+
+/* GLSL built-ins, with the NaN and zero handling of the shader rather than of Math */
+
+static float glslMin(float x, float y) {
+    return y < x ? y : x;
+}
+
+static float glslMax(float x, float y) {
+    return x < y ? y : x;
+}
+
+static Math::Vec3 glslMin(const Math::Vec3& a, const Math::Vec3& b) {
+    return Math::Vec3(glslMin(a.x, b.x), glslMin(a.y, b.y), glslMin(a.z, b.z));
+}
+
+static Math::Vec3 glslMax(const Math::Vec3& a, const Math::Vec3& b) {
+    return Math::Vec3(glslMax(a.x, b.x), glslMax(a.y, b.y), glslMax(a.z, b.z));
+}
+
+static Math::Vec3 mul(const Math::Vec3& a, const Math::Vec3& b) {
+    return Math::Vec3(a.x * b.x, a.y * b.y, a.z * b.z);
+}
+
+static Math::Vec3 normalizeGlsl(const Math::Vec3& v) {
+    // A zero vector becomes NaN like on the GPU instead of staying zero
+    return v / std::sqrt(Math::dot(v, v));
+}
+
+static Math::Vec3 reflect(const Math::Vec3& i, const Math::Vec3& n) {
+    return i - n * (2.0f * Math::dot(n, i));
+}
+
+void PathTracerReference::buildScene(
+    const std::vector<Vertex>& vertices,
+    const std::vector<Triangle>& triangles,
+    const std::vector<Material>& materials
+) {
+    m_data = {};
+    m_data.vertices = vertices;
+    m_data.triangles = triangles;
+    m_data.materials = materials;
+
+    PathTracer::BvhBuilder bvhBuilder;
+    std::unique_ptr<PathTracer::BvhNode> bvh = bvhBuilder.build(m_data.vertices, m_data.triangles);
+    PathTracer::BvhBufferizer bvhBufferizer;
+    m_data.bvhBufferData = bvhBufferizer.bufferize(
+        bvh.get(),
+        m_data.vertices,
+        m_data.triangles,
+        m_data.intersectData
+    );
+    m_data.bvhDepth = bvhBufferizer.getDepth();
+}
+
+void PathTracerReference::addQuad(
+    std::vector<Vertex>& vertices,
+    std::vector<Triangle>& triangles,
+    const Math::Vec3& corner,
+    const Math::Vec3& edgeU,
+    const Math::Vec3& edgeV,
+    uint32_t idxMaterial
+) {
+    Math::Vec3 normal = Math::normalize(Math::cross(edgeU, edgeV));
+    uint32_t base = static_cast<uint32_t>(vertices.size());
+    const Math::Vec3 corners[] = { corner, corner + edgeU, corner + edgeU + edgeV, corner + edgeV };
+    const Math::Vec2 texCoords[] = {
+        { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f }
+    };
+    for (int i = 0; i < 4; i++) {
+        Vertex vertex = {};
+        vertex.pos = Math::Vec4(corners[i], 1.0f);
+        vertex.normal = Math::Vec4(normal, 0.0f);
+        vertex.tangent = Math::Vec4(Math::normalize(edgeU), 0.0f);
+        vertex.texCoord = texCoords[i];
+        vertices.push_back(vertex);
+    }
+    triangles.push_back({ base + 0, base + 1, base + 2, idxMaterial });
+    triangles.push_back({ base + 0, base + 2, base + 3, idxMaterial });
+}
+
+void PathTracerReference::addSphere(
+    std::vector<Vertex>& vertices,
+    std::vector<Triangle>& triangles,
+    const Math::Vec3& center,
+    float radius,
+    int nSegments,
+    uint32_t idxMaterial
+) {
+    int nRings = std::max(2, nSegments / 2);
+    uint32_t base = static_cast<uint32_t>(vertices.size());
+    for (int ring = 0; ring <= nRings; ring++) {
+        float theta = Math::PI * static_cast<float>(ring) / static_cast<float>(nRings);
+        for (int segment = 0; segment <= nSegments; segment++) {
+            float phi = 2.0f * Math::PI * static_cast<float>(segment) / nSegments;
+            Math::Vec3 normal(
+                std::sin(theta) * std::cos(phi),
+                std::cos(theta),
+                std::sin(theta) * std::sin(phi)
+            );
+            Vertex vertex = {};
+            vertex.pos = Math::Vec4(center + normal * radius, 1.0f);
+            vertex.normal = Math::Vec4(normal, 0.0f);
+            vertex.tangent = Math::Vec4(-std::sin(phi), 0.0f, std::cos(phi), 0.0f);
+            vertex.texCoord = Math::Vec2(
+                static_cast<float>(segment) / nSegments,
+                static_cast<float>(ring) / nRings
+            );
+            vertices.push_back(vertex);
+        }
+    }
+    uint32_t stride = static_cast<uint32_t>(nSegments + 1);
+    for (uint32_t ring = 0; ring < static_cast<uint32_t>(nRings); ring++) {
+        for (uint32_t segment = 0; segment < static_cast<uint32_t>(nSegments); segment++) {
+            uint32_t i0 = base + ring * stride + segment;
+            uint32_t i1 = i0 + stride;
+            // The rings at the poles collapse to a point, skip their degenerate halves
+            if (ring > 0)
+                triangles.push_back({ i0, i0 + 1, i1, idxMaterial });
+            if (ring + 1 < static_cast<uint32_t>(nRings))
+                triangles.push_back({ i0 + 1, i1 + 1, i1, idxMaterial });
+        }
+    }
+}
+
+float PathTracerReference::samplePixel(int x, int y, int& idxWave) {
+    initRngState(x, y, scene.currentSample);
+
+    Math::Vec2 uv(
+        (static_cast<float>(x) + 0.5f) / static_cast<float>(scene.resX),
+        (static_cast<float>(y) + 0.5f) / static_cast<float>(scene.resY)
+    );
+    Math::Vec2 ndc = uv * 2.0f - 1.0f;
+
+    Math::Vec3 forward = normalizeGlsl(Math::Vec3(camera.dir));
+    Math::Vec3 right = normalizeGlsl(Math::cross(forward, Math::Vec3(camera.up)));
+    Math::Vec3 up = Math::cross(right, forward);
+
+    float halfHeight = std::tan(camera.fov * 0.5f * SHADER_PI / 180.0f) * camera.focal;
+    float halfWidth = halfHeight * static_cast<float>(scene.resX) / static_cast<float>(scene.resY);
+
+    Math::Vec3 pos(camera.pos);
+    Math::Vec3 imageCenter = pos + forward * camera.focal;
+    Math::Vec3 imagePoint =
+        imageCenter + right * (ndc.x * halfWidth) + up * (ndc.y * halfHeight);
+
+    Math::Vec3 pinholeDir = normalizeGlsl(imagePoint - pos);
+    float tFocus = camera.focusDist / Math::dot(pinholeDir, forward);
+    Math::Vec3 focusPoint = pos + pinholeDir * tFocus;
+    float apertureRadius = 0.5f * (camera.focal / camera.fStop);
+    Math::Vec2 lensSample = sampleDisk() * apertureRadius;
+    Math::Vec3 lensOffset = right * lensSample.x + up * lensSample.y;
+
+    Ray ray;
+    ray.origin = pos + lensOffset;
+    ray.direction = normalizeGlsl(focusPoint - ray.origin);
+
+    idxWave = static_cast<int>(rand() * static_cast<float>(spScene.nWaves));
+    float radiance = trace(ray, idxWave);
+    float pLambda = 1.0f / static_cast<float>(spScene.nWaves);
+    m_stats.paths++;
+    return radiance / pLambda;
+}
+
+float PathTracerReference::trace(const Ray& ray, int idxWave) {
+    Ray newRay = ray;
+
+    float radiance = 0.0f;
+    float throughput = 1.0f;
+
+    int bounces = 0;
+    bool inside = false;
+
+    while (bounces < scene.traceDepth) {
+        HitRecord hit = traverse(newRay);
+        m_stats.rays++;
+
+        // ===== MISS : use sky =====
+        if (!hit.hit) {
+            size_t idxSky = static_cast<size_t>(spScene.idxSkyMaterial) * spScene.nWaves + idxWave;
+            float skyBB = bbp(spScene.skyTemperature, waveNumbers[idxWave]);
+            radiance += throughput * emissivities[idxSky] * skyBB;
+            break;
+        }
+
+        // ===== HIT =====
+        HitAttributes attribs = getHitAttributes(newRay, hit);
+        Math::Vec3 p = newRay.origin + newRay.direction * hit.t;
+        Math::Vec3 n = normalizeGlsl(attribs.normal);
+        const Material& material = m_data.materials[attribs.idxMaterial];
+
+        p += n * EPS;
+
+        // ===== Emission term =====
+        size_t idxEmiss = static_cast<size_t>(material.idxSpMaterial) * spScene.nWaves + idxWave;
+        float blackbodyRadiance = bbp(material.temperature, waveNumbers[idxWave]);
+        radiance += throughput * emissivities[idxEmiss] * blackbodyRadiance;
+
+        // ===== Sample next direction =====
+        Math::Vec3 wi = newRay.direction;
+        Math::Vec3 wo;
+
+        if (material.type == MATERIAL_TYPE_DIFFUSE) {
+            float pdf = 0.0f;
+            wo = cosineSampleHemisphere(n, pdf);
+            float cosTheta = glslMax(Math::dot(wo, n), 0.0f);
+            float brdf = 1.0f / SHADER_PI;
+            throughput *= brdf * cosTheta / pdf;
+        } else if (material.type == MATERIAL_TYPE_GLOSSY) {
+            float alpha = material.roughness * material.roughness;
+
+            Math::Vec3 v = wi * -1.0f;
+            float nDotV = glslMax(Math::dot(n, v), 0.0f);
+            if (nDotV <= 0.0f)
+                break;
+            float pdfH = 0.0f;
+            Math::Vec3 h = sampleGGX(n, alpha, pdfH);
+            Math::Vec3 l = reflect(wi, h);
+            float nDotL = glslMax(Math::dot(n, l), 0.0f);
+            float nDotH = glslMax(Math::dot(n, h), 0.0f);
+            float vDotH = glslMax(Math::dot(v, h), 0.0f);
+            if (nDotL <= 0.0f)
+                break;
+
+            auto dGgx = [](float nDotH, float alpha) {
+                float a2 = alpha * alpha;
+                float denom = nDotH * nDotH * (a2 - 1.0f) + 1.0f;
+                return a2 / (SHADER_PI * denom * denom);
+            };
+            auto gSchlickGgx = [](float nDotV, float alpha) {
+                float k = alpha + 1.0f;
+                k = (k * k) / 8.0f;
+                return nDotV / (nDotV * (1.0f - k) + k);
+            };
+            float d = dGgx(nDotH, alpha);
+            float g = gSchlickGgx(nDotV, alpha) * gSchlickGgx(nDotL, alpha);
+
+            float f0 = (material.ior - 1.0f) / (material.ior + 1.0f);
+            f0 *= f0;
+            float f = f0 + (1.0f - f0) * std::pow(1.0f - vDotH, 5.0f);
+
+            float pdf = pdfH / (4.0f * vDotH);
+            float brdf = (d * g * f) / (4.0f * nDotV * nDotL);
+            throughput *= brdf * nDotL / pdf;
+
+            wo = l;
+        } else if (material.type == MATERIAL_TYPE_TRANSLUCENT) {
+            wo = sampleGlass(wi, n, inside, material.ior);
+            // Refracted rays continue below the surface, whether they enter or leave
+            if (Math::dot(wo, n) < 0.0f)
+                p -= n * (EPS * 2.0f);
+        } else {
+            wo = reflect(wi, n);
+        }
+
+        newRay.origin = p;
+        newRay.direction = normalizeGlsl(wo);
+
+        bounces++;
+        // Russian roulette
+        if (bounces > 3) {
+            float pSurvive = std::min(std::max(throughput, 0.05f), 0.95f);
+            if (rand() > pSurvive) {
+                m_stats.rrTerminations++;
+                break;
+            }
+            throughput /= pSurvive;
+        }
+    }
+
+    return radiance;
+}
+
+PathTracerReference::HitRecord PathTracerReference::traverse(
+    const Ray& ray,
+    std::vector<uint32_t>* leafOrder
+) {
+    const auto& nodes = m_data.bvhBufferData;
+    HitRecord closest;
+
+    RayBoxTerms terms = getRayBoxTerms(ray);
+
+    // The shader sizes its stack by the depth of the BVH, see PathTracer::setWorkgroupSize()
+    std::vector<int> stackNodes;
+    std::vector<float> stackDists;
+
+    float tRoot = hitAABB(
+        terms,
+        Math::Vec3(nodes[0].aabbMin),
+        Math::Vec3(nodes[0].aabbMax),
+        closest.t
+    );
+    if (tRoot == INFINITY_T)
+        return closest;
+    stackNodes.push_back(0);
+    stackDists.push_back(tRoot);
+
+    while (!stackNodes.empty()) {
+        int nodeIdx = stackNodes.back();
+        float tEntry = stackDists.back();
+        stackNodes.pop_back();
+        stackDists.pop_back();
+        if (tEntry > closest.t)
+            continue;
+        m_stats.nodesVisited++;
+
+        const BufferBvhNode& node = nodes[nodeIdx];
+        if (node.leafFlag != 0) {
+            const IntersectTriangle& tri = m_data.intersectData[node.idxTriangle];
+            float t = 0.0f;
+            Math::Vec2 barycentric;
+            bool hit = hitTriangle(ray, tri, t, barycentric);
+            m_stats.triangleTests++;
+            if (leafOrder)
+                leafOrder->push_back(tri.idxTriangle);
+
+            if (hit && t < closest.t) {
+                closest.hit = true;
+                closest.t = t;
+                closest.barycentric = barycentric;
+                closest.idxTriangle = tri.idxTriangle;
+            }
+        } else {
+            int leftChild = nodeIdx + 1;
+            int rightChild = nodeIdx + static_cast<int>(node.rChildOffset);
+
+            float tLeft = hitAABB(
+                terms,
+                Math::Vec3(nodes[leftChild].aabbMin),
+                Math::Vec3(nodes[leftChild].aabbMax),
+                closest.t
+            );
+            float tRight = INFINITY_T;
+            if (node.rChildOffset != 0) {
+                tRight = hitAABB(
+                    terms,
+                    Math::Vec3(nodes[rightChild].aabbMin),
+                    Math::Vec3(nodes[rightChild].aabbMax),
+                    closest.t
+                );
+            }
+
+            // Push the far child first so the near one is popped next, the right one on a tie
+            int nearChild = tLeft < tRight ? leftChild : rightChild;
+            int farChild = tLeft < tRight ? rightChild : leftChild;
+            float tNear = glslMin(tLeft, tRight);
+            float tFar = glslMax(tLeft, tRight);
+            if (tFar < INFINITY_T) {
+                stackNodes.push_back(farChild);
+                stackDists.push_back(tFar);
+            }
+            if (tNear < INFINITY_T) {
+                stackNodes.push_back(nearChild);
+                stackDists.push_back(tNear);
+            }
+        }
+    }
+
+    return closest;
+}
+
+PathTracerReference::HitAttributes PathTracerReference::getHitAttributes(
+    const Ray& ray,
+    const HitRecord& hit
+) const {
+    HitAttributes result;
+
+    const Triangle& tri = m_data.triangles[hit.idxTriangle];
+    const Vertex& v0 = m_data.vertices[tri.v0];
+    const Vertex& v1 = m_data.vertices[tri.v1];
+    const Vertex& v2 = m_data.vertices[tri.v2];
+
+    float u = hit.barycentric.x;
+    float v = hit.barycentric.y;
+    float w = 1.0f - u - v;
+
+    result.normal = normalizeGlsl(
+        Math::Vec3(v0.normal) * w + Math::Vec3(v1.normal) * u + Math::Vec3(v2.normal) * v
+    );
+    if (Math::dot(result.normal, ray.direction) > 0.0f)
+        result.normal = result.normal * -1.0f;
+
+    Math::Vec3 tanInterp =
+        Math::Vec3(v0.tangent) * w + Math::Vec3(v1.tangent) * u + Math::Vec3(v2.tangent) * v;
+    result.tangent = normalizeGlsl(
+        tanInterp - result.normal * Math::dot(result.normal, tanInterp)
+    );
+
+    result.texCoord = v0.texCoord * w + v1.texCoord * u + v2.texCoord * v;
+    result.idxMaterial = tri.idxMaterial;
+
+    return result;
+}
+
+PathTracerReference::HitRecord PathTracerReference::traverseLegacy(
+    const Ray& ray,
+    HitAttributes& attribs,
+    std::vector<uint32_t>* leafOrder
+) {
+    const auto& nodes = m_data.bvhBufferData;
+    HitRecord closest;
+    attribs = {};
+
+    std::vector<int> stack;
+    stack.push_back(0); // root
+
+    while (!stack.empty()) {
+        int nodeIdx = stack.back();
+        stack.pop_back();
+        const BufferBvhNode& node = nodes[nodeIdx];
+        m_stats.nodesVisited++;
+
+        float nodeHit = hitAABBLegacy(ray, Math::Vec3(node.aabbMin), Math::Vec3(node.aabbMax));
+        if (nodeHit == INFINITY_T || nodeHit > closest.t)
+            continue;
+
+        if (node.leafFlag != 0) {
+            // Leaves used to index the triangle buffer, which the intersection buffer maps to
+            uint32_t idxTriangle = m_data.intersectData[node.idxTriangle].idxTriangle;
+            const Triangle& tri = m_data.triangles[idxTriangle];
+            const Vertex& v0 = m_data.vertices[tri.v0];
+            const Vertex& v1 = m_data.vertices[tri.v1];
+            const Vertex& v2 = m_data.vertices[tri.v2];
+            m_stats.triangleTests++;
+            if (leafOrder)
+                leafOrder->push_back(idxTriangle);
+
+            Math::Vec3 p0(v0.pos);
+            IntersectTriangle loaded = {};
+            loaded.p0 = p0;
+            loaded.e1 = Math::Vec4(Math::Vec3(v1.pos) - p0, 0.0f);
+            loaded.e2 = Math::Vec4(Math::Vec3(v2.pos) - p0, 0.0f);
+            float t = 0.0f;
+            Math::Vec2 barycentric;
+            if (!hitTriangle(ray, loaded, t, barycentric) || !(t < closest.t))
+                continue;
+
+            // Every hit interpolated its attributes before the closest one was known
+            closest.hit = true;
+            closest.t = t;
+            closest.barycentric = barycentric;
+            closest.idxTriangle = idxTriangle;
+            attribs = getHitAttributes(ray, closest);
+        } else {
+            int leftChild = nodeIdx + 1;
+            int rightChild = nodeIdx + static_cast<int>(node.rChildOffset);
+
+            float tLeft = hitAABBLegacy(
+                ray,
+                Math::Vec3(nodes[leftChild].aabbMin),
+                Math::Vec3(nodes[leftChild].aabbMax)
+            );
+            float tRight = INFINITY_T;
+            if (node.rChildOffset != 0) {
+                tRight = hitAABBLegacy(
+                    ray,
+                    Math::Vec3(nodes[rightChild].aabbMin),
+                    Math::Vec3(nodes[rightChild].aabbMax)
+                );
+            }
+
+            if (tLeft < tRight) {
+                if (tRight < INFINITY_T)
+                    stack.push_back(rightChild);
+                if (tLeft < INFINITY_T)
+                    stack.push_back(leftChild);
+            } else {
+                if (tLeft < INFINITY_T)
+                    stack.push_back(leftChild);
+                if (tRight < INFINITY_T)
+                    stack.push_back(rightChild);
+            }
+        }
+    }
+
+    return closest;
+}
+
+void PathTracerReference::initRngState(int x, int y, int currentSample) {
+    m_rngState = (static_cast<uint32_t>(x) * 1973u + static_cast<uint32_t>(y) * 9277u +
+        static_cast<uint32_t>(currentSample) * 26699u) | 1u;
+}
+
+float PathTracerReference::rand() {
+    m_rngState ^= m_rngState << 13;
+    m_rngState ^= m_rngState >> 17;
+    m_rngState ^= m_rngState << 5;
+    return static_cast<float>(m_rngState) * (1.0f / 4294967296.0f);
+}
+
+float PathTracerReference::bbp(float temperature, float waveNumber) {
+    const float c = 299792458.0f;
+    const float k = 1.0f * 138064852e-31f;
+    const float h = 2.0f * SHADER_PI * 105457180e-42f;
+    float v = waveNumber;
+    float t = temperature + 273.15f;
+    return 2e8f * (h * c * c * v * v * v) / (std::exp(100.0f * h * c * v / k / t) - 1.0f);
+}
+
+void PathTracerReference::buildOrthonormalBasis(
+    const Math::Vec3& axis,
+    Math::Vec3& u,
+    Math::Vec3& v
+) const {
+    Math::Vec3 tmp =
+        std::abs(axis.x) < 1.0f - EPS ? Math::Vec3(1.0f, 0.0f, 0.0f) : Math::Vec3(0.0f, 1.0f, 0.0f);
+    u = normalizeGlsl(Math::cross(tmp, axis));
+    v = Math::cross(axis, u);
+}
+
+Math::Vec3 PathTracerReference::cosineSampleHemisphere(const Math::Vec3& n, float& pdf) {
+    float r = std::sqrt(rand());
+    float phi = 2.0f * SHADER_PI * rand();
+
+    float x = r * std::cos(phi);
+    float y = r * std::sin(phi);
+    float z = std::sqrt(glslMax(0.0f, 1.0f - r * r));
+
+    Math::Vec3 u, v;
+    buildOrthonormalBasis(n, u, v);
+    Math::Vec3 dir = normalizeGlsl(u * x + v * y + n * z);
+    pdf = z / SHADER_PI;
+
+    return dir;
+}
+
+Math::Vec3 PathTracerReference::sampleGGX(const Math::Vec3& n, float alpha, float& pdf) {
+    float u1 = rand();
+    float u2 = rand();
+
+    float a2 = alpha * alpha;
+
+    float phi = 2.0f * SHADER_PI * u1;
+    float cosTheta = std::sqrt((1.0f - u2) / (1.0f + (a2 - 1.0f) * u2));
+    float sinTheta = std::sqrt(glslMax(0.0f, 1.0f - cosTheta * cosTheta));
+
+    Math::Vec3 u, v;
+    buildOrthonormalBasis(n, u, v);
+    Math::Vec3 h = normalizeGlsl(
+        u * (sinTheta * std::cos(phi)) +
+        v * (sinTheta * std::sin(phi)) +
+        n * cosTheta
+    );
+    float denom = cosTheta * cosTheta * (a2 - 1.0f) + 1.0f;
+    pdf = a2 / (SHADER_PI * denom * denom) * cosTheta;
+
+    return h;
+}
+
+Math::Vec3 PathTracerReference::sampleGlass(
+    const Math::Vec3& wi,
+    const Math::Vec3& n,
+    bool& inside,
+    float ior
+) {
+    float nc = 1.0f;
+    float ng = ior;
+
+    float eta = inside ? ng / nc : nc / ng;
+
+    float cosi = std::abs(Math::dot(wi, n));
+    float r0 = std::pow((nc - ng) / (nc + ng), 2.0f);
+    float k = 1.0f - eta * eta * (1.0f - cosi * cosi);
+
+    Math::Vec3 r = reflect(wi, n);
+
+    if (k < 0.0f)
+        return r; // Total internal reflection
+
+    float re = r0 + (1.0f - r0) * std::pow(1.0f - cosi, 2.0f);
+
+    if (rand() < re)
+        return r;
+    inside = !inside;
+    return normalizeGlsl(wi * eta - n * (eta * Math::dot(n, wi) + std::sqrt(k)));
+}
+
+Math::Vec2 PathTracerReference::sampleDisk() {
+    float r = std::sqrt(rand());
+    float theta = 2.0f * SHADER_PI * rand();
+    return Math::Vec2(std::cos(theta), std::sin(theta)) * r;
+}
+
+bool PathTracerReference::hitTriangle(
+    const Ray& ray,
+    const IntersectTriangle& tri,
+    float& t,
+    Math::Vec2& barycentric
+) {
+    t = INFINITY_T;
+    barycentric = Math::Vec2(0.0f, 0.0f);
+
+    Math::Vec3 p0 = tri.p0;
+    Math::Vec3 e1(tri.e1);
+    Math::Vec3 e2(tri.e2);
+
+    Math::Vec3 p = Math::cross(ray.direction, e2);
+    float det = Math::dot(e1, p);
+
+    if (std::abs(det) < EPS)
+        return false;
+
+    float invDet = 1.0f / det;
+    Math::Vec3 tvec = ray.origin - p0;
+
+    float u = Math::dot(tvec, p) * invDet;
+    if (u < 0.0f || u > 1.0f)
+        return false;
+
+    Math::Vec3 q = Math::cross(tvec, e1);
+    float v = Math::dot(ray.direction, q) * invDet;
+    if (v < 0.0f || (u + v) > 1.0f)
+        return false;
+
+    float tHit = Math::dot(e2, q) * invDet;
+    if (tHit < EPS)
+        return false;
+
+    t = tHit;
+    barycentric = Math::Vec2(u, v);
+    return true;
+}
+
+PathTracerReference::RayBoxTerms PathTracerReference::getRayBoxTerms(const Ray& ray) const {
+    // Keep zero components finite so that origin * invDir never becomes 0 * inf
+    const float MIN_DIR = 1e-12f;
+    Math::Vec3 dir(
+        std::abs(ray.direction.x) < MIN_DIR ? MIN_DIR : ray.direction.x,
+        std::abs(ray.direction.y) < MIN_DIR ? MIN_DIR : ray.direction.y,
+        std::abs(ray.direction.z) < MIN_DIR ? MIN_DIR : ray.direction.z
+    );
+    RayBoxTerms terms;
+    terms.invDir = Math::Vec3(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+    terms.originInvDir = mul(ray.origin, terms.invDir);
+    return terms;
+}
+
+float PathTracerReference::hitAABB(
+    const RayBoxTerms& terms,
+    const Math::Vec3& aabbMin,
+    const Math::Vec3& aabbMax,
+    float tMax
+) {
+    m_stats.boxTests++;
+
+    Math::Vec3 t0 = mul(aabbMin, terms.invDir) - terms.originInvDir;
+    Math::Vec3 t1 = mul(aabbMax, terms.invDir) - terms.originInvDir;
+
+    Math::Vec3 tmin = glslMin(t0, t1);
+    Math::Vec3 tmax = glslMax(t0, t1);
+
+    float tNear = glslMax(glslMax(tmin.x, tmin.y), tmin.z);
+    float tFar = glslMin(glslMin(tmax.x, tmax.y), tmax.z);
+
+    if (tFar < glslMax(tNear, 0.0f) || tNear > tMax)
+        return INFINITY_T;
+
+    return tNear;
+}
+
+float PathTracerReference::hitAABBLegacy(
+    const Ray& ray,
+    const Math::Vec3& aabbMin,
+    const Math::Vec3& aabbMax
+) {
+    m_stats.boxTests++;
+
+    Math::Vec3 invDir(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+
+    Math::Vec3 t0 = mul(aabbMin - ray.origin, invDir);
+    Math::Vec3 t1 = mul(aabbMax - ray.origin, invDir);
+
+    Math::Vec3 tmin = glslMin(t0, t1);
+    Math::Vec3 tmax = glslMax(t0, t1);
+
+    float tNear = glslMax(glslMax(tmin.x, tmin.y), tmin.z);
+    float tFar = glslMin(glslMin(tmax.x, tmax.y), tmax.z);
+
+    if (tFar < glslMax(tNear, 0.0f))
+        return INFINITY_T;
+
+    return tNear;
+}
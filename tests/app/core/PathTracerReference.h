@@ -0,0 +1,233 @@
+/**
+ * @file PathTracerReference.h
+ * @brief CPU port of the path tracing kernel for the tests.
+ */
+
+#pragma once
+
+#include "app/core/PathTracer.h"
+
+/**
+ * @brief CPU port of pathTracer.comp over the buffers PathTracer builds for the GPU.
+ * @note The functions mirror the shader function by function, including its random number
+ *       generator and ray statistics, so a change to one must be made to the other. Texture
+ *       maps are not supported, materials are shaded with their constant parameters.
+ */
+class PathTracerReference {
+public:
+    using Vertex = PathTracer::Vertex;
+    using Triangle = PathTracer::Triangle;
+    using Material = PathTracer::Material;
+    using BufferBvhNode = PathTracer::BufferBvhNode;
+    using IntersectTriangle = PathTracer::IntersectTriangle;
+    using Stats = PathTracer::GpuStats;
+
+    static constexpr int MATERIAL_TYPE_DIFFUSE = 0; // Diffuse material
+    static constexpr int MATERIAL_TYPE_SPECULAR = 1; // Specular material
+    static constexpr int MATERIAL_TYPE_GLOSSY = 2; // Glossy material
+    static constexpr int MATERIAL_TYPE_TRANSLUCENT = 3; // Translucent material
+
+    static constexpr float EPS = 0.00001f; // Small epsilon value
+    static constexpr float INFINITY_T = 1e20f; // Distance of a miss, INFINITY in the shader
+
+    /**
+     * @brief Struct representing a ray in 3D space.
+     */
+    struct Ray {
+        Math::Vec3 origin = {}; // Origin of the ray
+        Math::Vec3 direction = {}; // Direction of the ray
+    };
+    /**
+     * @brief Struct representing the result of a ray intersection.
+     */
+    struct HitRecord {
+        bool hit = false; // Flag indicating if an intersection occurred
+        float t = INFINITY_T; // Distance to intersection
+        Math::Vec2 barycentric = {}; // Barycentric weights of vertices 1 and 2
+        uint32_t idxTriangle = 0; // Index of the intersected triangle
+    };
+    /**
+     * @brief Struct representing the surface attributes at a ray intersection.
+     */
+    struct HitAttributes {
+        Math::Vec3 normal = {}; // Surface normal at intersection, facing against the ray
+        Math::Vec3 tangent = {}; // Interpolated tangent at intersection
+        Math::Vec2 texCoord = {}; // Texture coordinates at intersection
+        uint32_t idxMaterial = 0; // Index of the material at intersection
+    };
+
+public:
+    /* Scene */
+
+    /**
+     * @brief Build the BVH and the GPU buffers of a scene with the PathTracer builders.
+     * @param vertices Vertices of the scene.
+     * @param triangles Triangles of the scene.
+     * @param materials Materials of the scene.
+     */
+    void buildScene(
+        const std::vector<Vertex>& vertices,
+        const std::vector<Triangle>& triangles,
+        const std::vector<Material>& materials
+    );
+    /**
+     * @brief Get the buffers of the scene.
+     * @return The buffers as uploaded to the GPU.
+     */
+    const PathTracer::BufferData& getData() const { return m_data; };
+
+    /**
+     * @brief Append a quad with vertex normals facing along its normal.
+     * @param[out] vertices Vertices to append to.
+     * @param[out] triangles Triangles to append to.
+     * @param corner First corner of the quad.
+     * @param edgeU Edge from the first to the second corner.
+     * @param edgeV Edge from the first to the fourth corner.
+     * @param idxMaterial Material of the quad.
+     */
+    static void addQuad(
+        std::vector<Vertex>& vertices,
+        std::vector<Triangle>& triangles,
+        const Math::Vec3& corner,
+        const Math::Vec3& edgeU,
+        const Math::Vec3& edgeV,
+        uint32_t idxMaterial
+    );
+    /**
+     * @brief Append a latitude-longitude sphere with smooth normals.
+     * @param[out] vertices Vertices to append to.
+     * @param[out] triangles Triangles to append to.
+     * @param center Center of the sphere.
+     * @param radius Radius of the sphere.
+     * @param nSegments Number of segments around, half as many rings.
+     * @param idxMaterial Material of the sphere.
+     */
+    static void addSphere(
+        std::vector<Vertex>& vertices,
+        std::vector<Triangle>& triangles,
+        const Math::Vec3& center,
+        float radius,
+        int nSegments,
+        uint32_t idxMaterial
+    );
+
+    /* Kernel */
+
+    /**
+     * @brief Trace the sample of a pixel like main() of the shader.
+     * @param x Pixel X.
+     * @param y Pixel Y.
+     * @param[out] idxWave The hero wavelength of the sample.
+     * @return The radiance of the sample for the hero wavelength, divided by its probability.
+     */
+    float samplePixel(int x, int y, int& idxWave);
+    /**
+     * @brief Trace a ray through the scene for a wavelength sample, see trace() of the shader.
+     * @param ray The ray to trace.
+     * @param idxWave Index of the wavelength sample.
+     * @return The radiance of the ray.
+     */
+    float trace(const Ray& ray, int idxWave);
+    /**
+     * @brief Find the closest hit of a ray, see traverseBVH() of the shader.
+     * @param ray The ray.
+     * @param[out] leafOrder Appended the triangle of every tested leaf in order, may be null.
+     * @return The closest hit.
+     */
+    HitRecord traverse(const Ray& ray, std::vector<uint32_t>* leafOrder = nullptr);
+    /**
+     * @brief Reconstruct the surface attributes of a hit, see getHitAttributes() of the shader.
+     * @param ray The ray that produced the hit.
+     * @param hit The hit, must have hit set.
+     * @return The interpolated attributes.
+     */
+    HitAttributes getHitAttributes(const Ray& ray, const HitRecord& hit) const;
+    /**
+     * @brief Find the closest hit of a ray as the shader did before traversal was reworked.
+     * @note Every popped node tests its own box again and every triangle test reads the
+     *       triangle and vertex buffers and interpolates the attributes of each hit.
+     * @param ray The ray.
+     * @param[out] attribs Attributes of the closest hit.
+     * @param[out] leafOrder Appended the triangle of every tested leaf in order, may be null.
+     * @return The closest hit, the barycentric weights are those of the closest hit as well.
+     */
+    HitRecord traverseLegacy(
+        const Ray& ray,
+        HitAttributes& attribs,
+        std::vector<uint32_t>* leafOrder = nullptr
+    );
+
+    /**
+     * @brief Seed the random number generator like the shader does for a pixel.
+     * @param x Pixel X.
+     * @param y Pixel Y.
+     * @param currentSample The sample index.
+     */
+    void initRngState(int x, int y, int currentSample);
+    /**
+     * @brief Generate a random float in the range [0, 1) with the shader generator.
+     * @return A random float.
+     */
+    float rand();
+
+    /**
+     * @brief Compute the blackbody radiation power, see bbp() of the shader.
+     * @param temperature The temperature in Celsius.
+     * @param waveNumber The wave number of the wavelength sample.
+     * @return The blackbody radiation power.
+     */
+    static float bbp(float temperature, float waveNumber);
+
+    /**
+     * @brief Get the ray statistics counted since the last reset.
+     * @return The statistics, every traced sample counts as a path.
+     */
+    const Stats& getStats() const { return m_stats; };
+    /**
+     * @brief Reset the ray statistics.
+     */
+    void resetStats() { m_stats = {}; };
+
+public:
+    PathTracer::UScene scene = {}; // Scene parameters
+    PathTracer::UCamera camera = {}; // Camera parameters
+    PathTracer::USpScene spScene = {}; // Spectral scene parameters
+    std::vector<float> waveNumbers = {}; // Wave number of each wavelength sample
+    std::vector<float> emissivities = {}; // Emissivity of each spectral material and sample
+
+private:
+    /**
+     * @brief Struct holding the per-ray terms of the ray-AABB test.
+     */
+    struct RayBoxTerms {
+        Math::Vec3 invDir = {}; // Reciprocal of the ray direction
+        Math::Vec3 originInvDir = {}; // Ray origin scaled by the reciprocal direction
+    };
+
+    /* Ports of the shader functions of the same names, see pathTracer.comp */
+
+    void buildOrthonormalBasis(const Math::Vec3& axis, Math::Vec3& u, Math::Vec3& v) const;
+    Math::Vec3 cosineSampleHemisphere(const Math::Vec3& n, float& pdf);
+    Math::Vec3 sampleGGX(const Math::Vec3& n, float alpha, float& pdf);
+    Math::Vec3 sampleGlass(const Math::Vec3& wi, const Math::Vec3& n, bool& inside, float ior);
+    Math::Vec2 sampleDisk();
+
+    bool hitTriangle(const Ray& ray, const IntersectTriangle& tri, float& t, Math::Vec2& bary);
+    RayBoxTerms getRayBoxTerms(const Ray& ray) const;
+    float hitAABB(
+        const RayBoxTerms& terms,
+        const Math::Vec3& aabbMin,
+        const Math::Vec3& aabbMax,
+        float tMax
+    );
+    /**
+     * @brief Test a ray against a box as the shader did before the per-ray terms, counted as
+     *        a box test like hitAABB().
+     */
+    float hitAABBLegacy(const Ray& ray, const Math::Vec3& aabbMin, const Math::Vec3& aabbMax);
+
+private:
+    PathTracer::BufferData m_data = {}; // Buffers of the scene
+    uint32_t m_rngState = 0; // State of the random number generator
+    Stats m_stats = {}; // Ray statistics
+};
@@ -0,0 +1,296 @@
+/**
+ * @file PathTracerTraversalTest.cpp
+ * @brief Checks of the BVH traversal of the path tracing kernel against its previous version.
+ * @note Runs the CPU port of the shader, see PathTracerReference.
+ */
+
+#include <random>
+
+#include "TestCommon.h"
+#include "app/core/PathTracerReference.h"
+
+using Ref = PathTracerReference;
+
+static constexpr uint32_t SEED = 1234; // Seed of the scene and the rays
+static constexpr int N_RAYS = 50000; // Rays of the fixed ray set
+
+/**
+ * @brief Build the reference scene, a closed room with spheres and a cloud of small
+ *        triangles, the kind of mixed geometry where traversal order matters.
+ * @param ref The reference kernel to build the scene for.
+ */
+static void buildReferenceScene(Ref& ref) {
+    std::vector<Ref::Vertex> vertices;
+    std::vector<Ref::Triangle> triangles;
+    Math::Vec3 x(8.0f, 0.0f, 0.0f), y(0.0f, 8.0f, 0.0f), z(0.0f, 0.0f, 8.0f);
+    Math::Vec3 corner(-4.0f, -4.0f, -4.0f);
+    Ref::addQuad(vertices, triangles, corner + z, x, y, 0);
+    Ref::addQuad(vertices, triangles, corner, y, x, 0);
+    Ref::addQuad(vertices, triangles, corner, z, y, 0);
+    Ref::addQuad(vertices, triangles, corner + x, y, z, 0);
+    Ref::addQuad(vertices, triangles, corner, x, z, 0);
+    Ref::addQuad(vertices, triangles, corner + y, z, x, 0);
+    Ref::addSphere(vertices, triangles, Math::Vec3(-1.5f, -2.5f, 1.0f), 1.5f, 48, 1);
+    Ref::addSphere(vertices, triangles, Math::Vec3(2.0f, -3.0f, -1.0f), 1.0f, 32, 1);
+    Ref::addSphere(vertices, triangles, Math::Vec3(1.0f, 1.5f, 2.0f), 0.75f, 24, 1);
+
+    std::mt19937 rng(SEED);
+    std::uniform_real_distribution<float> position(-3.5f, 3.5f);
+    std::uniform_real_distribution<float> offset(-0.3f, 0.3f);
+    for (int i = 0; i < 2000; i++) {
+        Math::Vec3 center(position(rng), position(rng), position(rng));
+        uint32_t base = static_cast<uint32_t>(vertices.size());
+        for (int j = 0; j < 3; j++) {
+            Ref::Vertex vertex = {};
+            Math::Vec3 pos = center + Math::Vec3(offset(rng), offset(rng), offset(rng));
+            vertex.pos = Math::Vec4(pos, 1.0f);
+            vertex.normal = Math::Vec4(
+                Math::normalize(Math::Vec3(offset(rng), offset(rng), offset(rng))),
+                0.0f
+            );
+            vertex.tangent = Math::Vec4(1.0f, 0.0f, 0.0f, 0.0f);
+            vertex.texCoord = Math::Vec2(offset(rng), offset(rng));
+            vertices.push_back(vertex);
+        }
+        triangles.push_back({ base, base + 1, base + 2, 2 });
+    }
+
+    Ref::Material material = {};
+    ref.buildScene(vertices, triangles, { material, material, material });
+}
+
+/**
+ * @brief Generate the fixed ray set, rays from random points inside the room in random
+ *        directions, axis-aligned directions included.
+ * @return The rays.
+ */
+static std::vector<Ref::Ray> generateRays() {
+    std::mt19937 rng(SEED + 1);
+    std::uniform_real_distribution<float> position(-3.9f, 3.9f);
+    std::normal_distribution<float> direction(0.0f, 1.0f);
+    std::vector<Ref::Ray> rays(N_RAYS);
+    for (int i = 0; i < N_RAYS; i++) {
+        rays[i].origin = Math::Vec3(position(rng), position(rng), position(rng));
+        if (i % 16 == 0) {
+            Math::Vec3 axis(0.0f);
+            const float signs[] = { 1.0f, -1.0f };
+            if ((i / 16) % 3 == 0)
+                axis.x = signs[(i / 48) % 2];
+            else if ((i / 16) % 3 == 1)
+                axis.y = signs[(i / 48) % 2];
+            else
+                axis.z = signs[(i / 48) % 2];
+            rays[i].direction = axis;
+        } else {
+            rays[i].direction = Math::normalize(
+                Math::Vec3(direction(rng), direction(rng), direction(rng))
+            );
+        }
+    }
+    return rays;
+}
+
+/**
+ * @brief Deferring the attribute interpolation to the closest hit must not change which hit
+ *        is closest or what it looks like: every ray of the fixed set gets the same distance,
+ *        triangle and attributes, bit for bit, as with the previous shader.
+ * @param ref The reference kernel with the reference scene.
+ * @param rays The fixed ray set.
+ */
+static void testClosestHits(Ref& ref, const std::vector<Ref::Ray>& rays) {
+    int nHits = 0;
+    int nMismatches = 0;
+    for (const auto& ray : rays) {
+        Ref::HitAttributes legacyAttribs;
+        Ref::HitRecord legacy = ref.traverseLegacy(ray, legacyAttribs);
+        Ref::HitRecord hit = ref.traverse(ray);
+
+        bool same = legacy.hit == hit.hit;
+        if (same && hit.hit) {
+            nHits++;
+            Ref::HitAttributes attribs = ref.getHitAttributes(ray, hit);
+            same = legacy.t == hit.t &&
+                legacy.idxTriangle == hit.idxTriangle &&
+                legacyAttribs.normal == attribs.normal &&
+                legacyAttribs.tangent == attribs.tangent &&
+                legacyAttribs.texCoord == attribs.texCoord &&
+                legacyAttribs.idxMaterial == attribs.idxMaterial;
+        }
+        if (!same)
+            nMismatches++;
+    }
+    std::cout << "Closest hits: " << nHits << " of " << rays.size() << " rays hit, " <<
+        nMismatches << " differ from the previous traversal" << std::endl;
+    TEST_CHECK(nHits == static_cast<int>(rays.size())); // The room is closed
+    TEST_CHECK(nMismatches == 0);
+}
+
+/**
+ * @brief Generate rays whose direction components are powers of two. Scaling by their
+ *        reciprocals is exact, so the per-ray box terms of the traversal give the same entry
+ *        distances as the previous box test, bit for bit, and the traversal order can be
+ *        compared without rounding differences.
+ * @return The rays, not normalized.
+ */
+static std::vector<Ref::Ray> generateExactRays() {
+    std::mt19937 rng(SEED + 2);
+    std::uniform_real_distribution<float> position(-3.9f, 3.9f);
+    std::uniform_int_distribution<int> component(0, 7);
+    const float components[] = { 0.25f, 0.5f, 1.0f, 2.0f, -0.25f, -0.5f, -1.0f, -2.0f };
+    std::vector<Ref::Ray> rays(N_RAYS);
+    for (auto& ray : rays) {
+        ray.origin = Math::Vec3(position(rng), position(rng), position(rng));
+        ray.direction = Math::Vec3(
+            components[component(rng)],
+            components[component(rng)],
+            components[component(rng)]
+        );
+    }
+    return rays;
+}
+
+/**
+ * @brief Testing the boxes of both children at their parent must cut the box tests without
+ *        visiting more nodes. Prints the per-ray counts the stats buffer reports for both
+ *        traversals.
+ * @param ref The reference kernel with the reference scene.
+ * @param rays The ray set.
+ * @param name Name of the ray set.
+ * @param exact Whether both traversals get the same box entry distances for the ray set, in
+ *        which case the leaves must also be tested in the same order. Otherwise the entry
+ *        distances differ in the last bits and a leaf whose box only touches the closest hit
+ *        may be skipped by one traversal and tested by the other.
+ */
+static void testTraversalCost(
+    Ref& ref,
+    const std::vector<Ref::Ray>& rays,
+    const char* name,
+    bool exact
+) {
+    Ref::Stats legacyStats = {};
+    Ref::Stats stats = {};
+    int nOrderMismatches = 0;
+    for (const auto& ray : rays) {
+        std::vector<uint32_t> legacyOrder;
+        std::vector<uint32_t> order;
+        Ref::HitAttributes attribs;
+        ref.resetStats();
+        ref.traverseLegacy(ray, attribs, &legacyOrder);
+        legacyStats.nodesVisited += ref.getStats().nodesVisited;
+        legacyStats.boxTests += ref.getStats().boxTests;
+        legacyStats.triangleTests += ref.getStats().triangleTests;
+        ref.resetStats();
+        ref.traverse(ray, &order);
+        stats.nodesVisited += ref.getStats().nodesVisited;
+        stats.boxTests += ref.getStats().boxTests;
+        stats.triangleTests += ref.getStats().triangleTests;
+        if (order != legacyOrder)
+            nOrderMismatches++;
+    }
+
+    const double nRays = static_cast<double>(rays.size());
+    auto print = [nRays](const char* traversal, const Ref::Stats& s) {
+        std::cout << "  " << traversal << ": " << s.boxTests / nRays << " box tests, " <<
+            s.nodesVisited / nRays << " nodes visited, " <<
+            s.triangleTests / nRays << " triangle tests per ray" << std::endl;
+    };
+    std::cout << "Traversal cost, " << name << ":" << std::endl;
+    print("previous", legacyStats);
+    print("current", stats);
+    std::cout << "  leaf order differs for " << nOrderMismatches << " of " << rays.size() <<
+        " rays" << std::endl;
+    TEST_CHECK(stats.boxTests < legacyStats.boxTests);
+    TEST_CHECK(stats.nodesVisited <= legacyStats.nodesVisited);
+    if (exact) {
+        TEST_CHECK(nOrderMismatches == 0);
+        TEST_CHECK(stats.triangleTests == legacyStats.triangleTests);
+    }
+}
+
+/**
+ * @brief Intersecting against the BVH-ordered triangle buffer must cut the bytes a ray reads.
+ *        Prints the bytes per ray both traversals read from the node, triangle and vertex
+ *        buffers, counted from the loads of the kernel without the caches.
+ * @note A box test reads the box of a node and a visit its links. A triangle test used to
+ *       read the triangle and its three vertices, it now reads one intersection triangle, and
+ *       the closest hit reads the triangle and its vertices once for the attributes.
+ * @param ref The reference kernel with the reference scene.
+ * @param rays The fixed ray set.
+ */
+static void testMemoryTraffic(Ref& ref, const std::vector<Ref::Ray>& rays) {
+    const double boxBytes = 2.0 * sizeof(Math::Vec4);
+    const double linkBytes = sizeof(Ref::BufferBvhNode) - boxBytes;
+    const double triangleBytes = sizeof(Ref::Triangle) + 3.0 * sizeof(Ref::Vertex);
+    const double intersectBytes = sizeof(Ref::IntersectTriangle);
+
+    double legacyNodeBytes = 0.0;
+    double legacyTriangleBytes = 0.0;
+    double nodeBytes = 0.0;
+    double intersectionBytes = 0.0;
+    double attributeBytes = 0.0;
+    for (const auto& ray : rays) {
+        Ref::HitAttributes attribs;
+        ref.resetStats();
+        ref.traverseLegacy(ray, attribs);
+        legacyNodeBytes += ref.getStats().boxTests * boxBytes;
+        legacyNodeBytes += ref.getStats().nodesVisited * linkBytes;
+        legacyTriangleBytes += ref.getStats().triangleTests * triangleBytes;
+        ref.resetStats();
+        Ref::HitRecord hit = ref.traverse(ray);
+        nodeBytes += ref.getStats().boxTests * boxBytes;
+        nodeBytes += ref.getStats().nodesVisited * linkBytes;
+        intersectionBytes += ref.getStats().triangleTests * intersectBytes;
+        if (hit.hit)
+            attributeBytes += triangleBytes;
+    }
+
+    const double nRays = static_cast<double>(rays.size());
+    double legacyBytes = (legacyNodeBytes + legacyTriangleBytes) / nRays;
+    double bytes = (nodeBytes + intersectionBytes + attributeBytes) / nRays;
+    std::cout << "Memory traffic per ray:" << std::endl;
+    std::cout << "  previous: " << legacyNodeBytes / nRays << " B nodes, " <<
+        legacyTriangleBytes / nRays << " B triangles and vertices, " << legacyBytes <<
+        " B in all" << std::endl;
+    std::cout << "  current: " << nodeBytes / nRays << " B nodes, " <<
+        intersectionBytes / nRays << " B intersection triangles, " <<
+        attributeBytes / nRays << " B closest hit attributes, " << bytes << " B in all" <<
+        std::endl;
+    TEST_CHECK(intersectionBytes + attributeBytes < legacyTriangleBytes);
+    TEST_CHECK(bytes < legacyBytes);
+}
+
+/**
+ * @brief A scene without triangles must build a BVH the kernel can traverse: a single leaf
+ *        pointing to an intersection triangle that no ray hits.
+ * @param rays The fixed ray set.
+ */
+static void testEmptyScene(const std::vector<Ref::Ray>& rays) {
+    Ref ref;
+    ref.buildScene({}, {}, { Ref::Material() });
+    TEST_CHECK(ref.getData().bvhBufferData.size() == 1);
+    TEST_CHECK(ref.getData().bvhBufferData[0].leafFlag != 0);
+    TEST_CHECK(ref.getData().intersectData.size() == 1);
+    TEST_CHECK(ref.getData().bvhDepth == 1);
+
+    // Include a ray through the origin, where the box of the leaf is
+    std::vector<Ref::Ray> emptySceneRays(rays.begin(), rays.begin() + 1000);
+    emptySceneRays[0].origin = Math::Vec3(0.0f);
+    int nHits = 0;
+    for (const auto& ray : emptySceneRays) {
+        if (ref.traverse(ray).hit)
+            nHits++;
+    }
+    TEST_CHECK(nHits == 0);
+}
+
+int main() {
+    Ref ref;
+    buildReferenceScene(ref);
+    std::vector<Ref::Ray> rays = generateRays();
+    testClosestHits(ref, rays);
+    testTraversalCost(ref, rays, "random rays", false);
+    testTraversalCost(ref, generateExactRays(), "power-of-two directions", true);
+    testMemoryTraffic(ref, rays);
+    testEmptyScene(rays);
+    return Test::finish("PathTracerTraversalTest");
+}
@@ -0,0 +1,216 @@
+/**
+ * @file JobSystemBenchmark.cpp
+ * @brief Micro-benchmarks of the JobSystem scheduler.
+ * @note Measures the latency of a steal, the throughput of fanning jobs out and back in and
+ *       the cost of a job against starting a thread per task. Every benchmark also checks
+ *       that all work ran, so the executable fails if the scheduler loses a job.
+ */
+
+#include <algorithm>
+
+#include "TestCommon.h"
+#include "utils/JobSystem.h"
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr int N_STEALS = 2000; // Stolen jobs timed for the steal latency
+static constexpr int N_FAN_OUT_JOBS = 20000; // Jobs of a fan-out
+static constexpr int N_FAN_OUT_ROUNDS = 10; // Timed fan-outs
+static constexpr int N_THREAD_TASKS = 2000; // Tasks of the thread-per-task comparison
+static constexpr int TASK_WORK = 2000; // Iterations of the work of a task
+
+/**
+ * @brief Do a small amount of work the compiler cannot drop.
+ * @param seed Seed of the work.
+ * @return The result.
+ */
+static uint32_t doTaskWork(uint32_t seed) {
+    uint32_t x = seed | 1u;
+    for (int i = 0; i < TASK_WORK; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    }
+    return x;
+}
+
+/**
+ * @brief Get a percentile of samples.
+ * @param samples The samples, sorted in place.
+ * @param percentile The percentile in [0, 100].
+ * @return The sample at the percentile.
+ */
+static double getPercentile(std::vector<double>& samples, double percentile) {
+    std::sort(samples.begin(), samples.end());
+    size_t idx = static_cast<size_t>(percentile / 100.0 * (samples.size() - 1) + 0.5);
+    return samples[idx];
+}
+
+/**
+ * @brief Time how long a job queued on a busy worker waits until another worker steals it.
+ * @note A job submitted from a worker goes to the queue of that worker. The submitting job
+ *       keeps its worker busy until the child has started, so only a steal can run it. The
+ *       main thread polls instead of waiting so it does not take the child itself.
+ */
+static void benchmarkStealLatency() {
+    JobSystem& jobSystem = JobSystem::instance();
+    std::vector<double> latencies;
+    latencies.reserve(N_STEALS);
+    int nStolen = 0;
+    for (int i = 0; i < N_STEALS; i++) {
+        std::atomic<bool> started{ false };
+        Clock::time_point submitTime;
+        Clock::time_point startTime;
+        std::thread::id parentThread;
+        std::thread::id childThread;
+        Job parent = jobSystem.submit([&] {
+            parentThread = std::this_thread::get_id();
+            submitTime = Clock::now();
+            jobSystem.submit([&] {
+                childThread = std::this_thread::get_id();
+                startTime = Clock::now();
+                started.store(true, std::memory_order_release);
+            });
+            while (!started.load(std::memory_order_acquire))
+                std::this_thread::yield();
+        });
+        while (!parent->isDone())
+            std::this_thread::yield();
+        latencies.push_back(std::chrono::duration<double>(startTime - submitTime).count());
+        if (childThread != parentThread && childThread != std::this_thread::get_id())
+            nStolen++;
+    }
+    TEST_CHECK(nStolen == N_STEALS);
+
+    double median = getPercentile(latencies, 50.0) * 1e6;
+    double p99 = getPercentile(latencies, 99.0) * 1e6;
+    std::cout << "Steal latency: " << median << " us median, " << p99 << " us p99 over " <<
+        N_STEALS << " steals" << std::endl;
+}
+
+/**
+ * @brief Time submitting many small jobs from the main thread, waiting for all of them, and
+ *        joining them with one job that depends on all of them.
+ */
+static void benchmarkFanOutFanIn() {
+    JobSystem& jobSystem = JobSystem::instance();
+    std::vector<std::atomic<uint32_t>> results(N_FAN_OUT_JOBS);
+    std::vector<Job> jobs;
+    jobs.reserve(N_FAN_OUT_JOBS);
+
+    double waitSeconds = 0.0;
+    double joinSeconds = 0.0;
+    int nMissing = 0;
+    for (int round = 0; round < N_FAN_OUT_ROUNDS; round++) {
+        // Fan-out, fan-in through waitAll()
+        for (auto& result : results)
+            result.store(0);
+        jobs.clear();
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < N_FAN_OUT_JOBS; i++) {
+            jobs.push_back(jobSystem.submit([&results, i] {
+                results[i].store(doTaskWork(static_cast<uint32_t>(i)));
+            }));
+        }
+        jobSystem.waitAll(jobs);
+        waitSeconds += Test::getSeconds(start);
+        for (const auto& result : results) {
+            if (result.load() == 0)
+                nMissing++;
+        }
+
+        // Fan-out, fan-in through a job depending on all the others
+        for (auto& result : results)
+            result.store(0);
+        jobs.clear();
+        start = Clock::now();
+        for (int i = 0; i < N_FAN_OUT_JOBS; i++) {
+            jobs.push_back(jobSystem.submit([&results, i] {
+                results[i].store(doTaskWork(static_cast<uint32_t>(i)));
+            }));
+        }
+        std::atomic<int> nDone{ 0 };
+        Job join = jobSystem.submit([&] {
+            for (const auto& result : results) {
+                if (result.load() != 0)
+                    nDone++;
+            }
+        }, JobPriority::INTERACTIVE, jobs);
+        jobSystem.wait(join);
+        joinSeconds += Test::getSeconds(start);
+        nMissing += N_FAN_OUT_JOBS - nDone.load();
+    }
+    TEST_CHECK(nMissing == 0);
+
+    double nJobs = static_cast<double>(N_FAN_OUT_JOBS) * N_FAN_OUT_ROUNDS;
+    std::cout << "Fan-out/fan-in, waitAll: " << nJobs / waitSeconds << " jobs/s, " <<
+        waitSeconds / nJobs * 1e6 << " us per job" << std::endl;
+    std::cout << "Fan-out/fan-in, join job: " << nJobs / joinSeconds << " jobs/s, " <<
+        joinSeconds / nJobs * 1e6 << " us per job" << std::endl;
+}
+
+/**
+ * @brief Compare running tasks as jobs against starting and joining a thread per task, and
+ *        against running them inline for the cost of the work itself.
+ */
+static void benchmarkThreadPerTask() {
+    JobSystem& jobSystem = JobSystem::instance();
+    std::vector<uint32_t> results(N_THREAD_TASKS, 0);
+
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < N_THREAD_TASKS; i++)
+        results[i] = doTaskWork(static_cast<uint32_t>(i));
+    double inlineSeconds = Test::getSeconds(start);
+
+    std::fill(results.begin(), results.end(), 0);
+    start = Clock::now();
+    std::vector<Job> jobs;
+    jobs.reserve(N_THREAD_TASKS);
+    for (int i = 0; i < N_THREAD_TASKS; i++) {
+        jobs.push_back(jobSystem.submit([&results, i] {
+            results[i] = doTaskWork(static_cast<uint32_t>(i));
+        }));
+    }
+    jobSystem.waitAll(jobs);
+    double jobSeconds = Test::getSeconds(start);
+    TEST_CHECK(std::count(results.begin(), results.end(), 0u) == 0);
+
+    // Start as many threads at once as the job system has threads, then join them
+    std::fill(results.begin(), results.end(), 0);
+    size_t batchSize = static_cast<size_t>(jobSystem.getWorkerCount() + 1);
+    start = Clock::now();
+    std::vector<std::thread> threads;
+    threads.reserve(batchSize);
+    for (int i = 0; i < N_THREAD_TASKS; i++) {
+        threads.emplace_back([&results, i] {
+            results[i] = doTaskWork(static_cast<uint32_t>(i));
+        });
+        if (threads.size() == batchSize || i == N_THREAD_TASKS - 1) {
+            for (auto& thread : threads)
+                thread.join();
+            threads.clear();
+        }
+    }
+    double threadSeconds = Test::getSeconds(start);
+    TEST_CHECK(std::count(results.begin(), results.end(), 0u) == 0);
+
+    std::cout << "Per task, " << TASK_WORK << " iterations of work: " <<
+        inlineSeconds / N_THREAD_TASKS * 1e6 << " us inline, " <<
+        jobSeconds / N_THREAD_TASKS * 1e6 << " us as jobs, " <<
+        threadSeconds / N_THREAD_TASKS * 1e6 << " us with a thread per task" << std::endl;
+}
+
+int main() {
+    // Stealing needs a second worker even on a single core
+    int nThreads = static_cast<int>(std::thread::hardware_concurrency());
+    JobSystem::instance().init(std::max(2, nThreads - 1));
+    std::cout << JobSystem::instance().getWorkerCount() << " workers, " << nThreads <<
+        " hardware threads" << std::endl;
+
+    benchmarkStealLatency();
+    benchmarkFanOutFanIn();
+    benchmarkThreadPerTask();
+
+    JobSystem::instance().term();
+    return Test::finish("JobSystemBenchmark");
+}
@@ -0,0 +1,114 @@
+/**
+ * @file LoggerBenchmark.cpp
+ * @brief Micro-benchmarks of the cost of a log message to the calling thread.
+ * @note Measures a message dropped by the filters, a message queued to the ring and a message
+ *       dropped on a full ring, each formatted by Logger and pushed to LogSink directly.
+ */
+
+#include "TestCommon.h"
+#include "utils/Logger.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr size_t QUEUE_SIZE = 2048; // Slots of the ring of LogSink
+static constexpr int N_MESSAGES = 1000000; // Timed messages of the filter and drop paths
+static constexpr int N_BATCHES = 500; // Timed batches of queued messages
+static constexpr int BATCH_SIZE = 1024; // Messages of a batch, fits the ring
+static constexpr char MODULE[] = "benchmark"; // Module of the messages
+static constexpr char TEXT[] = "Frame 1234 took 16.7 ms"; // Text of the unformatted messages
+
+/**
+ * @brief Print the cost of a message.
+ * @param name Name of the path.
+ * @param seconds Time spent.
+ * @param nMessages Number of messages.
+ */
+static void printCost(const char* name, double seconds, int nMessages) {
+    std::cout << name << ": " << seconds / nMessages * 1e9 << " ns per message" << std::endl;
+}
+
+/**
+ * @brief Time messages below the level of their module.
+ */
+static void benchmarkFiltered() {
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < N_MESSAGES; i++)
+        Logger(LogLevel::DEBUG, MODULE) << "Frame " << i << " took " << 16.7f << " ms";
+    printCost("Filtered out", Test::getSeconds(start), N_MESSAGES);
+}
+
+/**
+ * @brief Time messages dropped on a full ring, the sink is not running yet so the ring stays
+ *        full. Checks that every message is counted.
+ */
+static void benchmarkDropped() {
+    LogSink& sink = LogSink::instance();
+    for (size_t i = 0; i < QUEUE_SIZE; i++)
+        sink.push(LogLevel::INFO, MODULE, TEXT, sizeof(TEXT) - 1);
+    uint64_t droppedBefore = sink.getDroppedCount();
+
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < N_MESSAGES; i++)
+        Logger(LogLevel::INFO, MODULE) << "Frame " << i << " took " << 16.7f << " ms";
+    printCost("Dropped, Logger", Test::getSeconds(start), N_MESSAGES);
+
+    start = Clock::now();
+    for (int i = 0; i < N_MESSAGES; i++)
+        sink.push(LogLevel::INFO, MODULE, TEXT, sizeof(TEXT) - 1);
+    printCost("Dropped, push", Test::getSeconds(start), N_MESSAGES);
+
+    TEST_CHECK(sink.getDroppedCount() - droppedBefore == 2ull * N_MESSAGES);
+}
+
+/**
+ * @brief Time messages queued to the running sink. Batches fit the ring and the sink is given
+ *        time to drain it between batches, so only the enqueue is timed.
+ * @param directory Directory of the log file.
+ */
+static void benchmarkQueued(const std::filesystem::path& directory) {
+    LogSink& sink = LogSink::instance();
+    sink.init(directory.string(), "benchmark.log");
+    // Let the sink write the full ring left by the drop benchmark
+    Logger(LogLevel::ERR, MODULE) << "Start of the queued messages";
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    uint64_t droppedBefore = sink.getDroppedCount();
+
+    double loggerSeconds = 0.0;
+    double pushSeconds = 0.0;
+    for (int batch = 0; batch < N_BATCHES; batch++) {
+        bool useLogger = batch % 2 == 0;
+        Clock::time_point start = Clock::now();
+        if (useLogger) {
+            for (int i = 0; i < BATCH_SIZE; i++)
+                Logger(LogLevel::INFO, MODULE) << "Frame " << i << " took " << 16.7f << " ms";
+            loggerSeconds += Test::getSeconds(start);
+        } else {
+            for (int i = 0; i < BATCH_SIZE; i++)
+                sink.push(LogLevel::INFO, MODULE, TEXT, sizeof(TEXT) - 1);
+            pushSeconds += Test::getSeconds(start);
+        }
+        // Wake the sink with an error and let it write the batch
+        Logger(LogLevel::ERR, MODULE) << "End of batch " << batch;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    sink.term();
+
+    uint64_t nDropped = sink.getDroppedCount() - droppedBefore;
+    printCost("Queued, Logger", loggerSeconds, N_BATCHES / 2 * BATCH_SIZE);
+    printCost("Queued, push", pushSeconds, N_BATCHES / 2 * BATCH_SIZE);
+    std::cout << "  " << nDropped << " messages dropped while queuing" << std::endl;
+}
+
+int main() {
+    std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / "SpectrumizerLoggerBenchmark";
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+
+    benchmarkFiltered();
+    benchmarkDropped();
+    benchmarkQueued(directory);
+
+    std::filesystem::remove_all(directory, ec);
+    return Test::finish("LoggerBenchmark");
+}
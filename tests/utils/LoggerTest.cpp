@@ -0,0 +1,138 @@
+/**
+ * @file LoggerTest.cpp
+ * @brief Checks of the drop counting and the file rotation of the LogSink.
+ * @note The sink is a singleton, the checks run one after the other in this process and
+ *       account for what the previous ones left behind.
+ */
+
+#include "TestCommon.h"
+#include "utils/Logger.hpp"
+
+static constexpr size_t QUEUE_SIZE = 2048; // Slots of the ring of LogSink
+static constexpr size_t MAX_FILE_SIZE = 16 * 1024; // Size at which the tests rotate the file
+static constexpr int MAX_FILES = 2; // Rotated files the tests keep
+static constexpr char MODULE[] = "logger_test"; // Module of the test messages
+
+/**
+ * @brief Read the lines of a file.
+ * @param path Path of the file.
+ * @return The lines, empty if the file cannot be read.
+ */
+static std::vector<std::string> readLines(const std::filesystem::path& path) {
+    std::vector<std::string> lines;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+        lines.push_back(line);
+    return lines;
+}
+
+/**
+ * @brief Sum the dropped counts reported in log lines.
+ * @param lines The lines.
+ * @return Total of the reported drops.
+ */
+static uint64_t getReportedDrops(const std::vector<std::string>& lines) {
+    static const std::string prefix = "Log queue full, dropped ";
+    uint64_t total = 0;
+    for (const auto& line : lines) {
+        if (line.compare(0, prefix.size(), prefix) == 0)
+            total += std::stoull(line.substr(prefix.size()));
+    }
+    return total;
+}
+
+/**
+ * @brief Messages logged before the sink starts fill the ring, the rest must be dropped and
+ *        counted, then reported once the sink writes the queued ones. Writing them must rotate
+ *        the file, keep the given number of rotated files and never exceed the maximum size.
+ * @param directory Directory of the log files.
+ */
+static void testSaturatedRing(const std::filesystem::path& directory) {
+    const size_t nMessages = QUEUE_SIZE + 1000;
+    for (size_t i = 0; i < nMessages; i++)
+        Logger(LogLevel::INFO, MODULE) << "Queued before init " << i;
+    TEST_CHECK(LogSink::instance().getDroppedCount() == nMessages - QUEUE_SIZE);
+
+    int result = LogSink::instance().init(
+        directory.string(),
+        "test.log",
+        MAX_FILE_SIZE,
+        MAX_FILES
+    );
+    TEST_CHECK(result == 0);
+    LogSink::instance().term();
+
+    std::vector<std::string> lines;
+    for (int i = 0; i <= MAX_FILES; i++) {
+        std::filesystem::path path = directory / "test.log";
+        if (i > 0)
+            path += "." + std::to_string(i);
+        TEST_CHECK(std::filesystem::exists(path));
+        TEST_CHECK(std::filesystem::file_size(path) <= MAX_FILE_SIZE);
+        std::vector<std::string> fileLines = readLines(path);
+        lines.insert(lines.begin(), fileLines.begin(), fileLines.end());
+    }
+    std::string removedName = "test.log." + std::to_string(MAX_FILES + 1);
+    TEST_CHECK(!std::filesystem::exists(directory / removedName));
+
+    // The oldest messages went out with the removed files, the newest ones must all be there
+    TEST_CHECK(!lines.empty());
+    TEST_CHECK(lines.back() == "Log queue full, dropped " +
+        std::to_string(nMessages - QUEUE_SIZE) + " messages");
+    std::string last = lines.size() > 1 ? lines[lines.size() - 2] : "";
+    std::string lastText = "[" + std::string(MODULE) + "] Queued before init " +
+        std::to_string(QUEUE_SIZE - 1);
+    TEST_CHECK(last.size() >= lastText.size() &&
+        last.compare(last.size() - lastText.size(), lastText.size(), lastText) == 0);
+}
+
+/**
+ * @brief Threads logging faster than the sink writes must never block, and every message must
+ *        either be written or be counted and reported as dropped.
+ * @param directory Directory of the log files.
+ */
+static void testConcurrentDrops(const std::filesystem::path& directory) {
+    const int nThreads = 4;
+    const int nMessagesPerThread = 50000;
+    uint64_t droppedBefore = LogSink::instance().getDroppedCount();
+
+    // Large enough not to rotate, so all written messages stay in the file
+    int result = LogSink::instance().init(directory.string(), "concurrent.log", 1ull << 30, 0);
+    TEST_CHECK(result == 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nThreads; t++) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < nMessagesPerThread; i++)
+                Logger(LogLevel::INFO, MODULE) << "Thread " << t << " message " << i;
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    LogSink::instance().term();
+
+    std::vector<std::string> lines = readLines(directory / "concurrent.log");
+    size_t nWritten = 0;
+    for (const auto& line : lines) {
+        if (line.find("] Thread ") != std::string::npos)
+            nWritten++;
+    }
+    uint64_t nDropped = LogSink::instance().getDroppedCount() - droppedBefore;
+    std::cout << "Concurrent logging: " << nWritten << " written, " << nDropped <<
+        " dropped of " << nThreads * nMessagesPerThread << " messages" << std::endl;
+    TEST_CHECK(nWritten + nDropped == static_cast<uint64_t>(nThreads) * nMessagesPerThread);
+    TEST_CHECK(getReportedDrops(lines) == nDropped);
+}
+
+int main() {
+    std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / "SpectrumizerLoggerTest";
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+
+    testSaturatedRing(directory);
+    testConcurrentDrops(directory);
+
+    std::filesystem::remove_all(directory, ec);
+    return Test::finish("LoggerTest");
+}